@@ -0,0 +1,655 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench.c
+ * Benchmark suite: ns/sample of each sig-func, of the scope and of synthetic graphs, printed as JSON
+ * usage: bench.out [repetitions] [filter]
+ * @n Each case is run BENCH_WARMUP times, then timed over repetitions runs of samples samples, with samples chosen so
+ * that a run evaluates about BENCH_EVALS signals. The median, p99 and minimum of the time per sample are reported.
+ * filter only runs the cases whose name contains it.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "sigreg.h"
+#include "scope.h"
+
+#define BENCH_INPUT			4096					//!< size of the input buffer. Must be a power of 2
+#define BENCH_EVALS			65536					//!< signal evaluations per repetition
+#define BENCH_MIN_SAMPLES	16						//!< minimum samples per repetition
+#define BENCH_WARMUP		10						//!< untimed repetitions
+#define BENCH_REPETITIONS	101						//!< default number of timed repetitions
+#define BENCH_GRAPH_WIDTH	64						//!< signals per layer of the synthetic graphs
+#define BENCH_FIR_MULTI_TAPS	512						//!< taps of the multirate filters
+#define BENCH_LUT_SIZE		4096					//!< breakpoints of the lookup tables
+
+static float bench_input[BENCH_INPUT];
+static volatile float bench_sink;
+
+/**
+ * @brief one benchmark case
+ */
+struct bench_case {
+	const char *name;
+	int param;										//!< taps, channels or depth. 0 if unused
+	int fanout;										//!< fan-out of the synthetic graphs. 0 if unused
+	void *(*init)(const struct bench_case *c);		//!< build the signals. Returns the state given to run and free
+	void (*run)(void *state, n_t n, int count);		//!< evaluate count samples, from n
+	void (*free)(void *state);
+	int nodes;										//!< signals evaluated per sample
+};
+
+
+static double bench_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;			// 1e9 is a float constant with -fsingle-precision-constant
+}
+
+
+static int bench_cmp(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+
+/***************************************************************************************/
+/*                              Single sig-func                                        */
+/***************************************************************************************/
+
+/**
+ * one sig-func under test. Its sources are sig-ptr, updated before each sample, so that only the
+ * sig-func itself is measured (except for sig_buf_read_f)
+ */
+struct bench_sig {
+	float in[3];
+	struct signal_float src[3];
+	struct sig_buf_read_param_f buf_p;
+	struct sig_add_param_f add_p;
+	struct sig_interpolate_lin_param_f ramp_p;
+	struct sig_iirlp1_param_f iir_p;
+	struct sig_fir_n_param_f fir_p;
+	struct sig_fir_long_param_f fir_long_p;
+	struct sig_fir_decim_param_f fir_decim_p;
+	struct sig_fir_interp_param_f fir_interp_p;
+	struct sig_biquad_cascade_param_f biquad_p;
+	struct sig_lut_table_f lut;
+	struct sig_lut_param_f lut_p;
+	struct sig_pid_param_f pid_p;
+	struct signal_float buf;							//!< buffer reader source of the block cases
+	struct signal_float sig;
+};
+
+static struct bench_sig *bench_sig_new(void)
+{
+	struct bench_sig *s = calloc(1, sizeof(*s));
+	int i;
+
+	for (i=0; i<3; i++)
+		s->src[i] = (struct signal_float) SIG_PTR(&s->in[i]);
+	return s;
+}
+
+static void *bench_add_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+
+	s->add_p = (struct sig_add_param_f) {.a = &s->src[0], .b = &s->src[1]};
+	s->sig = (struct signal_float) SIG_FN(sig_add_f, &s->add_p);
+	return s;
+}
+
+static void *bench_ramp_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+
+	s->ramp_p = (struct sig_interpolate_lin_param_f) {.a = 1e-3, .b = -1};
+	s->sig = (struct signal_float) SIG_FNB(sig_interpolate_lin_f, sig_interpolate_lin_block_f, &s->ramp_p);
+	return s;
+}
+
+static void *bench_iirlp1_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+
+	s->iir_p = (struct sig_iirlp1_param_f) {.a = 0.1, .oma = 0.9, .source = &s->src[0]};
+	s->sig = (struct signal_float) SIG_FN(sig_iirlp1_f, &s->iir_p);
+	return s;
+}
+
+static void *bench_fir_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float *taps = malloc(c->param * sizeof(float));
+	int i;
+
+	for (i=0; i<c->param; i++)
+		taps[i] = 1.0 / c->param;
+	s->fir_p.source = &s->src[0];
+	sig_fir_n_init_f(&s->fir_p, taps, c->param);
+	s->sig = (struct signal_float) SIG_FN(sig_fir_n_f, &s->fir_p);
+	free(taps);
+	return s;
+}
+
+static void *bench_fir_long_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float *taps = malloc(c->param * sizeof(float));
+	int i;
+
+	for (i=0; i<c->param; i++)
+		taps[i] = 1.0 / c->param;
+	s->fir_long_p.source = &s->src[0];
+	sig_fir_long_init_f(&s->fir_long_p, taps, c->param, 0);
+	s->sig = (struct signal_float) SIG_FN(sig_fir_long_f, &s->fir_long_p);
+	free(taps);
+	return s;
+}
+
+/**
+ * @brief multirate filters of BENCH_FIR_MULTI_TAPS taps. param is the factor, the time is per output sample
+ */
+static void *bench_fir_decim_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float taps[BENCH_FIR_MULTI_TAPS];
+	int i;
+
+	for (i=0; i<BENCH_FIR_MULTI_TAPS; i++)
+		taps[i] = 1.0 / BENCH_FIR_MULTI_TAPS;
+	s->fir_decim_p.source = &s->src[0];
+	sig_fir_decim_init_f(&s->fir_decim_p, taps, BENCH_FIR_MULTI_TAPS, c->param);
+	s->sig = (struct signal_float) SIG_FN(sig_fir_decim_f, &s->fir_decim_p);
+	return s;
+}
+
+static void *bench_fir_interp_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float taps[BENCH_FIR_MULTI_TAPS];
+	int i;
+
+	for (i=0; i<BENCH_FIR_MULTI_TAPS; i++)
+		taps[i] = 1.0 / BENCH_FIR_MULTI_TAPS;
+	s->fir_interp_p.source = &s->src[0];
+	sig_fir_interp_init_f(&s->fir_interp_p, taps, BENCH_FIR_MULTI_TAPS, c->param);
+	s->sig = (struct signal_float) SIG_FN(sig_fir_interp_f, &s->fir_interp_p);
+	return s;
+}
+
+static void *bench_biquad_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float *coef = malloc(c->param * 5 * sizeof(float));
+
+	sig_biquad_butterworth_f(coef, 2 * c->param, 0.1, 0);
+	s->biquad_p.source = &s->src[0];
+	sig_biquad_cascade_init_f(&s->biquad_p, coef, c->param);
+	s->sig = (struct signal_float) SIG_FNB(sig_biquad_cascade_f, sig_biquad_cascade_block_f, &s->biquad_p);
+	free(coef);
+	return s;
+}
+
+/**
+ * block evaluation of the cascade, reading its input with a buffer reader
+ */
+static void *bench_biquad_block_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_biquad_init(c);
+
+	s->buf_p = (struct sig_buf_read_param_f) {.buffer = bench_input, .size = BENCH_INPUT, .circular = 1, .check_buffer = 1};
+	s->buf = (struct signal_float) SIG_FNB(sig_buf_read_f, sig_buf_read_block_f, &s->buf_p);
+	s->biquad_p.source = &s->buf;
+	return s;
+}
+
+static void *bench_pid_init(const struct bench_case *c, sig_func_f x)
+{
+	struct bench_sig *s = bench_sig_new();
+
+	s->pid_p = (struct sig_pid_param_f) {.p = 1.0, .i = 0.1, .d = 0.5, .max_output = 5.0,
+		.setpoint = &s->src[0], .feedback = &s->src[1], .ff = {1.0}, .ff0 = &s->src[2]};
+	s->sig = (struct signal_float) SIG_FN(x, &s->pid_p);
+	sig_pid_compute_k_f(&s->sig);
+	return s;
+}
+
+/**
+ * @brief table of BENCH_LUT_SIZE breakpoints over [-1; 1], fed with the random input. param is 1 for a uniform table
+ */
+static void *bench_lut_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+	float x[BENCH_LUT_SIZE], y[BENCH_LUT_SIZE];
+	int i;
+
+	for (i=0; i<BENCH_LUT_SIZE; i++)
+	{
+		x[i] = (float)(2 * i - (BENCH_LUT_SIZE - 1)) / (BENCH_LUT_SIZE - 1);
+		y[i] = x[i] * x[i];
+	}
+	if (c->param)
+		sig_lut_uniform_init_f(&s->lut, -1, 1, y, BENCH_LUT_SIZE);
+	else
+		sig_lut_pwl_init_f(&s->lut, x, y, BENCH_LUT_SIZE);
+	s->buf_p = (struct sig_buf_read_param_f) {.buffer = bench_input, .size = BENCH_INPUT, .circular = 1, .check_buffer = 1};
+	s->buf = (struct signal_float) SIG_FNB(sig_buf_read_f, sig_buf_read_block_f, &s->buf_p);
+	s->lut_p = (struct sig_lut_param_f) {.table = &s->lut, .source = &s->buf};
+	s->sig = (struct signal_float) SIG_FNB(sig_lut_f, sig_lut_block_f, &s->lut_p);
+	return s;
+}
+
+static void *bench_pid_naive_init(const struct bench_case *c)
+{
+	return bench_pid_init(c, sig_pid_naive_f);
+}
+
+static void *bench_pid_opt_init(const struct bench_case *c)
+{
+	return bench_pid_init(c, sig_pid_opt_f);
+}
+
+static void *bench_buf_read_init(const struct bench_case *c)
+{
+	struct bench_sig *s = bench_sig_new();
+
+	s->buf_p = (struct sig_buf_read_param_f) {.buffer = bench_input, .size = BENCH_INPUT, .circular = 1, .check_buffer = 1};
+	s->sig = (struct signal_float) SIG_FN(sig_buf_read_f, &s->buf_p);
+	return s;
+}
+
+static void bench_sig_run(void *state, n_t n, int count)
+{
+	struct bench_sig *s = (struct bench_sig *)state;
+	float sink = 0;
+	int i;
+
+	for (i=0; i<count; i++, n++)
+	{
+		s->in[0] = bench_input[n & (BENCH_INPUT - 1)];
+		s->in[1] = bench_input[(n + 1) & (BENCH_INPUT - 1)];
+		s->in[2] = bench_input[(n + 2) & (BENCH_INPUT - 1)];
+		sink += sig_get_value_f(&s->sig, n);
+	}
+	bench_sink = sink;
+}
+
+static void bench_sig_block_run(void *state, n_t n, int count)
+{
+	struct bench_sig *s = (struct bench_sig *)state;
+	float out[SIG_BLOCK_CHUNK * 16], sink = 0;
+	int len;
+
+	for (; count > 0; count -= len, n += len)
+	{
+		len = min(count, SIG_BLOCK_CHUNK * 16);
+		sig_get_block_f(&s->sig, n, len, out);
+		sink += out[len - 1];
+	}
+	bench_sink = sink;
+}
+
+static void bench_sig_free(void *state)
+{
+	struct bench_sig *s = (struct bench_sig *)state;
+
+	if (s->sig.x == sig_fir_n_f)
+		sig_fir_n_free_f(&s->fir_p);
+	if (s->sig.x == sig_fir_long_f)
+		sig_fir_long_free_f(&s->fir_long_p);
+	if (s->sig.x == sig_fir_decim_f)
+		sig_fir_decim_free_f(&s->fir_decim_p);
+	if (s->sig.x == sig_fir_interp_f)
+		sig_fir_interp_free_f(&s->fir_interp_p);
+	if (s->sig.x == sig_biquad_cascade_f)
+		sig_biquad_cascade_free_f(&s->biquad_p);
+	if (s->sig.x == sig_lut_f)
+		sig_lut_free_f(&s->lut);
+	free(s);
+}
+
+
+/***************************************************************************************/
+/*                              Scope                                                  */
+/***************************************************************************************/
+
+/**
+ * scope armed with a trigger that never fires: it samples all its channels continuously into its circular buffer
+ */
+struct bench_scope {
+	float in[SCOPE_MAX_SIGNALS];
+	struct signal_float sig[SCOPE_MAX_SIGNALS];
+	char buffer[64 * 1024];
+	scope_t scope;
+};
+
+static void *bench_scope_init(const struct bench_case *c)
+{
+	struct bench_scope *s = calloc(1, sizeof(*s));
+	struct scope_trigger_t trig = {.type = SCOPE_TRIG_RISING, .channel = 0, .level = 1e30};
+	char name[16], list[SCOPE_MAX_SIGNALS * 16] = "";
+	int i;
+
+	scope_init(&s->scope, s->buffer, sizeof(s->buffer));
+	for (i=0; i<c->param; i++)
+	{
+		sprintf(name, "c%d", i);
+		s->sig[i] = (struct signal_float) SIG_PTR(&s->in[i]);
+		s->sig[i].name = sig_name_intern(name);
+		scope_enlist_sig_float(&s->scope, &s->sig[i]);
+		strcat(list, name);
+		strcat(list, ",");
+	}
+	scope_setup(&s->scope, list, 1);
+	if (scope_set_trigger(&s->scope, &trig))
+		printf("bench: cannot arm the scope\n");
+	return s;
+}
+
+static void bench_scope_run(void *state, n_t n, int count)
+{
+	struct bench_scope *s = (struct bench_scope *)state;
+	int i;
+
+	for (i=0; i<count; i++, n++)
+	{
+		s->in[0] = bench_input[n & (BENCH_INPUT - 1)];
+		scope_update(&s->scope, n);
+	}
+}
+
+static void bench_scope_free(void *state)
+{
+	struct bench_scope *s = (struct bench_scope *)state;
+
+	scope_free(&s->scope);
+	free(s);
+}
+
+
+/***************************************************************************************/
+/*                              Synthetic graphs                                       */
+/***************************************************************************************/
+
+/**
+ * depth layers of BENCH_GRAPH_WIDTH adders. Adder j of a layer sums the signals j and (j / fanout) * fanout of the
+ * previous layer, so one signal out of fanout feeds fanout + 1 adders. The first layer reads sig-ptr inputs.
+ * The last layer is evaluated either recursively (memoized) or as a compiled graph.
+ */
+struct bench_graph {
+	float in[BENCH_GRAPH_WIDTH];
+	struct signal_float src[BENCH_GRAPH_WIDTH];
+	struct sig_add_param_f *add_p;
+	struct signal_float *sig;
+	struct signal_float **roots;
+	struct sig_graph_node *nodes;
+	struct sig_graph graph;
+	int count;
+};
+
+static void *bench_graph_init(const struct bench_case *c)
+{
+	struct bench_graph *g = aligned_alloc(64, (sizeof(struct bench_graph) + 63) / 64 * 64);
+	struct signal_float *prev = g->src;
+	int i, j, fanout = c->fanout;
+
+	memset(g, 0, sizeof(*g));
+	g->count = c->param * BENCH_GRAPH_WIDTH;
+	g->add_p = calloc(g->count, sizeof(*g->add_p));
+	g->sig = calloc(g->count, sizeof(*g->sig));
+	g->nodes = calloc(g->count, sizeof(*g->nodes));
+	for (j=0; j<BENCH_GRAPH_WIDTH; j++)
+		g->src[j] = (struct signal_float) SIG_PTR(&g->in[j]);
+	for (i=0; i<g->count; i+=BENCH_GRAPH_WIDTH)
+	{
+		for (j=0; j<BENCH_GRAPH_WIDTH; j++)
+		{
+			g->add_p[i + j] = (struct sig_add_param_f) {.a = &prev[j], .b = &prev[(j / fanout) * fanout]};
+			g->sig[i + j] = (struct signal_float) SIG_FN(sig_add_f, &g->add_p[i + j]);
+		}
+		prev = &g->sig[i];
+	}
+	g->roots = malloc(BENCH_GRAPH_WIDTH * sizeof(*g->roots));
+	for (j=0; j<BENCH_GRAPH_WIDTH; j++)
+		g->roots[j] = &prev[j];
+	sig_graph_init(&g->graph, g->nodes, g->count);
+	if (sig_graph_compile(&g->graph, g->roots, BENCH_GRAPH_WIDTH, NULL, 0))
+		printf("bench: cannot compile the graph\n");
+	return g;
+}
+
+static void bench_graph_inputs(struct bench_graph *g, n_t n)
+{
+	int j;
+
+	for (j=0; j<BENCH_GRAPH_WIDTH; j++)
+		g->in[j] = bench_input[(n + j) & (BENCH_INPUT - 1)];
+}
+
+static void bench_graph_rec_run(void *state, n_t n, int count)
+{
+	struct bench_graph *g = (struct bench_graph *)state;
+	float sink = 0;
+	int i, j;
+
+	for (i=0; i<count; i++, n++)
+	{
+		bench_graph_inputs(g, n);
+		for (j=0; j<BENCH_GRAPH_WIDTH; j++)
+			sink += sig_get_value_f(g->roots[j], n);
+	}
+	bench_sink = sink;
+}
+
+static void bench_graph_run_run(void *state, n_t n, int count)
+{
+	struct bench_graph *g = (struct bench_graph *)state;
+	int i;
+
+	for (i=0; i<count; i++, n++)
+	{
+		bench_graph_inputs(g, n);
+		sig_graph_run(&g->graph, n);
+	}
+	bench_sink = g->roots[0]->x_cst;
+}
+
+static void bench_graph_free(void *state)
+{
+	struct bench_graph *g = (struct bench_graph *)state;
+
+	free(g->roots);
+	free(g->nodes);
+	free(g->sig);
+	free(g->add_p);
+	free(g);
+}
+
+
+/***************************************************************************************/
+/*                              Harness                                                */
+/***************************************************************************************/
+
+#define BENCH_SIG(name, init, param)		{name, param, 0, init, bench_sig_run, bench_sig_free, 1}
+#define BENCH_BLOCK(name, init, param)		{name, param, 0, init, bench_sig_block_run, bench_sig_free, 1}
+#define BENCH_SCOPE(channels)				{"scope_update", channels, 0, bench_scope_init, bench_scope_run, bench_scope_free, channels}
+#define BENCH_GRAPH(depth, fanout)			{"graph_recursive", depth, fanout, bench_graph_init, bench_graph_rec_run, bench_graph_free, depth * BENCH_GRAPH_WIDTH}, \
+											{"graph_compiled", depth, fanout, bench_graph_init, bench_graph_run_run, bench_graph_free, depth * BENCH_GRAPH_WIDTH}
+
+static const struct bench_case bench_cases[] = {
+	BENCH_SIG("sig_add_f", bench_add_init, 0),
+	BENCH_SIG("sig_interpolate_lin_f", bench_ramp_init, 0),
+	BENCH_BLOCK("sig_interpolate_lin_block_f", bench_ramp_init, 0),
+	BENCH_SIG("sig_iirlp1_f", bench_iirlp1_init, 0),
+	BENCH_SIG("sig_fir_n_f", bench_fir_init, 8),
+	BENCH_SIG("sig_fir_n_f", bench_fir_init, 32),
+	BENCH_SIG("sig_fir_n_f", bench_fir_init, 128),
+	BENCH_SIG("sig_fir_n_f", bench_fir_init, 512),
+	BENCH_SIG("sig_fir_n_f", bench_fir_init, 4096),
+	BENCH_SIG("sig_fir_long_f", bench_fir_long_init, 4096),
+	BENCH_SIG("sig_fir_long_f", bench_fir_long_init, 16384),
+	BENCH_SIG("sig_fir_decim_f", bench_fir_decim_init, 1),
+	BENCH_SIG("sig_fir_decim_f", bench_fir_decim_init, 4),
+	BENCH_SIG("sig_fir_decim_f", bench_fir_decim_init, 16),
+	BENCH_SIG("sig_fir_interp_f", bench_fir_interp_init, 4),
+	BENCH_SIG("sig_fir_interp_f", bench_fir_interp_init, 16),
+	BENCH_SIG("sig_biquad_cascade_f", bench_biquad_init, 2),
+	BENCH_SIG("sig_biquad_cascade_f", bench_biquad_init, 8),
+	BENCH_BLOCK("sig_biquad_cascade_block_f", bench_biquad_block_init, 2),
+	BENCH_BLOCK("sig_biquad_cascade_block_f", bench_biquad_block_init, 8),
+	BENCH_SIG("sig_lut_f", bench_lut_init, 0),
+	BENCH_SIG("sig_lut_f", bench_lut_init, 1),
+	BENCH_BLOCK("sig_lut_block_f", bench_lut_init, 0),
+	BENCH_BLOCK("sig_lut_block_f", bench_lut_init, 1),
+	BENCH_SIG("sig_pid_naive_f", bench_pid_naive_init, 0),
+	BENCH_SIG("sig_pid_opt_f", bench_pid_opt_init, 0),
+	BENCH_SIG("sig_buf_read_f", bench_buf_read_init, 0),
+	BENCH_SCOPE(1),
+	BENCH_SCOPE(4),
+	BENCH_SCOPE(16),
+	BENCH_GRAPH(4, 1),
+	BENCH_GRAPH(4, 8),
+	BENCH_GRAPH(16, 1),
+	BENCH_GRAPH(16, 8),
+	BENCH_GRAPH(64, 1),
+	BENCH_GRAPH(64, 8),
+};
+
+
+/**
+ * @brief print a JSON string. Only the characters that need it are escaped
+ */
+static void bench_json_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++)
+	{
+		if ((*s == '"') || (*s == '\\'))
+			putchar('\\');
+		if ((unsigned char)*s >= 0x20)
+			putchar(*s);
+	}
+	putchar('"');
+}
+
+
+static void bench_cpu(void)
+{
+	char line[256], model[256] = "unknown", *p;
+	FILE *f = fopen("/proc/cpuinfo", "r");
+
+	if (f)
+	{
+		while (fgets(line, sizeof(line), f))
+			if ((strncmp(line, "model name", 10) == 0) && (p = strchr(line, ':')))
+			{
+				strcpy(model, p + 2);
+				model[strcspn(model, "\n")] = 0;
+				break;
+			}
+		fclose(f);
+	}
+	printf("  \"cpu\": {\"model\": ");
+	bench_json_string(model);
+	printf(", \"cores\": %ld", sysconf(_SC_NPROCESSORS_ONLN));
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	printf(", \"sse2\": %s, \"avx2\": %s, \"fma\": %s, \"avx512f\": %s",
+		__builtin_cpu_supports("sse2") ? "true" : "false", __builtin_cpu_supports("avx2") ? "true" : "false",
+		__builtin_cpu_supports("fma") ? "true" : "false", __builtin_cpu_supports("avx512f") ? "true" : "false");
+#endif
+	printf("},\n");
+}
+
+
+/**
+ * @brief run one case, and print its JSON result
+ */
+static void bench_run(const struct bench_case *c, int repetitions, n_t *n, int first)
+{
+	double *t = malloc(repetitions * sizeof(double));
+	double start, median;
+	int samples = max(BENCH_EVALS / c->nodes, BENCH_MIN_SAMPLES);
+	void *state;
+	int r;
+
+	state = c->init(c);
+	for (r=0; r<BENCH_WARMUP; r++, *n += samples)
+		c->run(state, *n, samples);
+	for (r=0; r<repetitions; r++, *n += samples)
+	{
+		start = bench_now();
+		c->run(state, *n, samples);
+		t[r] = (bench_now() - start) / samples;
+	}
+	c->free(state);
+
+	qsort(t, repetitions, sizeof(double), bench_cmp);
+	median = t[repetitions / 2];
+	printf("%s    {\"name\": \"%s\", \"param\": %d, \"fanout\": %d, \"nodes\": %d, \"samples\": %d, ", first ? "" : ",\n",
+		c->name, c->param, c->fanout, c->nodes, samples);
+	printf("\"ns_per_sample\": {\"median\": %.3f, \"p99\": %.3f, \"min\": %.3f}, \"samples_per_s\": %.0f}",
+		median, t[(repetitions * 99 + 99) / 100 - 1], t[0], 1e9 / median);
+	fflush(stdout);
+	free(t);
+}
+
+
+int main(int argc, char *argv[])
+{
+	int repetitions = argc > 1 ? atoi(argv[1]) : BENCH_REPETITIONS;
+	const char *filter = argc > 2 ? argv[2] : "";
+	unsigned int i;
+	int first = 1;
+	n_t n = 1;												// the memoization considers n = 0 as already evaluated
+
+	if (repetitions < 1)
+	{
+		fprintf(stderr, "usage: %s [repetitions] [filter]\n", argv[0]);
+		return -1;
+	}
+	srand(1);
+	for (i=0; i<BENCH_INPUT; i++)
+		bench_input[i] = (float)rand() / RAND_MAX - 0.5;
+
+	printf("{\n");
+	bench_cpu();
+	printf("  \"compiler\": ");
+	bench_json_string(__VERSION__);
+	printf(",\n  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"results\": [\n", BENCH_WARMUP, repetitions);
+	for (i=0; i<sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+	{
+		if (strstr(bench_cases[i].name, filter) == NULL)
+			continue;
+		bench_run(&bench_cases[i], repetitions, &n, first);
+		first = 0;
+	}
+	printf("\n  ]\n}\n");
+	return 0;
+}
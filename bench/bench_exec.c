@@ -0,0 +1,135 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench_exec.c
+ * Executor benchmark: many independent PID loops, evaluated with 1 to N workers
+ * usage: bench_exec.out [max workers] [loops]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "sigexec.h"
+
+#define BENCH_EXEC_INPUT	4096
+#define BENCH_EXEC_TICKS	20000
+#define BENCH_EXEC_TAPS		32
+
+/**
+ * one axis: pid_opt(fir(setpoint), feedback, ff0) with a 32-tap FIR on the setpoint
+ */
+struct bench_exec_loop {
+	struct sig_buf_read_param_f buf_p[3];
+	struct signal_float buf[3];
+	struct sig_fir_n_param_f fir_p;
+	struct signal_float fir;
+	struct sig_pid_param_f pid_p;
+	struct signal_float pid;
+};
+
+static double bench_exec_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+	int max_workers = argc > 1 ? atoi(argv[1]) : sysconf(_SC_NPROCESSORS_ONLN);
+	int loops = argc > 2 ? atoi(argv[2]) : 256;
+	struct bench_exec_loop *l;
+	struct signal_float **roots;
+	struct sig_graph_node *nodes;
+	struct sig_graph graph;
+	struct sig_exec *exec;
+	float *input, taps[BENCH_EXEC_TAPS];
+	double t, t1 = 0;
+	int i, k, workers;
+	n_t n;
+
+	input = malloc(BENCH_EXEC_INPUT * sizeof(float));
+	for (i=0; i<BENCH_EXEC_INPUT; i++)
+		input[i] = (float)rand() / RAND_MAX - 0.5;
+	for (i=0; i<BENCH_EXEC_TAPS; i++)
+		taps[i] = 1.0 / BENCH_EXEC_TAPS;
+
+	l = calloc(loops, sizeof(*l));
+	roots = malloc(loops * sizeof(*roots));
+	nodes = malloc(loops * 5 * sizeof(*nodes));
+	exec = aligned_alloc(64, sizeof(*exec));
+	for (i=0; i<loops; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			l[i].buf_p[k] = (struct sig_buf_read_param_f) {.buffer = input, .size = BENCH_EXEC_INPUT, .delta = i + k, .circular = 1, .check_buffer = 1};
+			l[i].buf[k] = (struct signal_float) SIG_FN(sig_buf_read_f, &l[i].buf_p[k]);
+		}
+		l[i].fir_p.source = &l[i].buf[0];
+		sig_fir_n_init_f(&l[i].fir_p, taps, BENCH_EXEC_TAPS);
+		l[i].fir = (struct signal_float) SIG_FN(sig_fir_n_f, &l[i].fir_p);
+		l[i].pid_p = (struct sig_pid_param_f) {.p = 1.0, .i = 0.1, .d = 0.5, .max_output = 5.0,
+			.setpoint = &l[i].fir, .feedback = &l[i].buf[1], .ff = {1.0}, .ff0 = &l[i].buf[2]};
+		l[i].pid = (struct signal_float) SIG_FN(sig_pid_opt_f, &l[i].pid_p);
+		sig_pid_compute_k_f(&l[i].pid);
+		roots[i] = &l[i].pid;
+	}
+	sig_graph_init(&graph, nodes, loops * 5);
+	if (sig_graph_compile(&graph, roots, loops, NULL, 0))
+	{
+		printf("cannot compile the graph\n");
+		return -1;
+	}
+
+	printf("%d loops, %d nodes, %d ticks\n", loops, graph.count, BENCH_EXEC_TICKS);
+	printf("%8s %12s %12s %8s\n", "workers", "us/tick", "ticks/s", "speedup");
+	for (workers=1; workers<=max_workers; workers++)
+	{
+		if (sig_exec_init(exec, &graph, workers, NULL))
+		{
+			printf("cannot start %d workers\n", workers);
+			break;
+		}
+		for (n=1; n<100; n++)										// warmup
+			sig_exec_run(exec, n);
+		t = bench_exec_now();
+		for (n=100; n<100+BENCH_EXEC_TICKS; n++)
+			sig_exec_run(exec, n);
+		t = (bench_exec_now() - t) / BENCH_EXEC_TICKS;
+		sig_exec_free(exec);
+		if (workers == 1)
+			t1 = t;
+		printf("%8d %12.2f %12.0f %7.2fx\n", workers, t / 1000, 1e9 / t, t1 / t);
+	}
+
+	for (i=0; i<loops; i++)
+		sig_fir_n_free_f(&l[i].fir_p);
+	free(exec);
+	free(nodes);
+	free(roots);
+	free(l);
+	free(input);
+	return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench_fir.c
+ * FIR benchmark: legacy layout against the mirrored layout, for each kernel and several tap counts
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "sig.h"
+#include "sigf.h"
+
+#define BENCH_FIR_INPUT		4096
+#define BENCH_FIR_SAMPLES	200000
+
+static const int bench_fir_taps[] = {16, 32, 64, 128, 256, 512, 1024};
+static const char *bench_fir_kernels[] = {"auto", "c", "sse", "avx2", "avx512"};
+
+static double bench_fir_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @return the time spent per sample, in ns
+ */
+static double bench_fir_run(struct signal_float *fir)
+{
+	volatile float sink;
+	double start;
+	n_t n;
+
+	for (n=1; n<1000; n++)									// warmup
+		sink = sig_get_value_f(fir, n);
+	start = bench_fir_now();
+	for (n=1000; n<1000+BENCH_FIR_SAMPLES; n++)
+		sink = sig_get_value_f(fir, n);
+	(void)sink;
+	return (bench_fir_now() - start) / BENCH_FIR_SAMPLES;
+}
+
+int main(int argc, char *argv[])
+{
+	float *input, *taps;
+	struct sig_buf_read_param_f src_p = {.size = BENCH_FIR_INPUT, .circular = 1, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_fir_n_param_f fir_p;
+	struct signal_float fir = SIG_FN(sig_fir_n_f, &fir_p);
+	double legacy, t;
+	int i, k, tap_count;
+
+	input = malloc(BENCH_FIR_INPUT * sizeof(float));
+	for (i=0; i<BENCH_FIR_INPUT; i++)
+		input[i] = (float)rand() / RAND_MAX - 0.5;
+	src_p.buffer = input;
+
+	printf("%6s %12s", "taps", "legacy ns");
+	for (k=SIG_FIR_KERNEL_C; k<=SIG_FIR_KERNEL_AVX512; k++)
+		printf(" %10s ns %8s", bench_fir_kernels[k], "speedup");
+	printf("\n");
+
+	for (i=0; i<sizeof(bench_fir_taps)/sizeof(bench_fir_taps[0]); i++)
+	{
+		tap_count = bench_fir_taps[i];
+		taps = malloc(tap_count * sizeof(float));
+		for (k=0; k<tap_count; k++)
+			taps[k] = 1.0 / tap_count;
+
+		fir_p = (struct sig_fir_n_param_f) {.tap_count = tap_count, .taps = taps, .source = &src};
+		fir_p.samples = calloc(tap_count, sizeof(float));
+		legacy = bench_fir_run(&fir);
+		free(fir_p.samples);
+		printf("%6d %12.1f", tap_count, legacy);
+
+		for (k=SIG_FIR_KERNEL_C; k<=SIG_FIR_KERNEL_AVX512; k++)
+		{
+			if (sig_fir_kernel_f(k))
+			{
+				printf(" %13s %8s", "n/a", "");
+				continue;
+			}
+			fir_p = (struct sig_fir_n_param_f) {.source = &src};
+			sig_fir_n_init_f(&fir_p, taps, tap_count);
+			t = bench_fir_run(&fir);
+			sig_fir_n_free_f(&fir_p);
+			printf(" %13.1f %7.1fx", t, legacy / t);
+		}
+		printf("\n");
+		free(taps);
+	}
+	free(input);
+	return 0;
+}
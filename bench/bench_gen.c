@@ -0,0 +1,107 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench_gen.c
+ * Code generator benchmark: the test_gen() controller (12 signals), evaluated recursively, as a compiled graph and
+ * by the code generated from it (test/test_gen_step.c, written by make test_gen)
+ * usage: bench_gen.out [ticks]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggen.h"
+#include "csv.h"
+#include "test_gen.h"
+#include "test_gen_step.c"
+
+static double bench_gen_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+	int ticks = argc > 1 ? atoi(argv[1]) : (1 << 22);
+	static struct test_gen_graph g;
+	struct sig_gen gen;
+	FILE *out = tmpfile();
+	float **data, sum = 0;
+	double t_rec, t_graph, t_gen;
+	int i, data_l;
+	n_t n;
+
+	if (csv_load("test/data_pidf.csv", &data_l, &data))
+	{
+		printf("cannot load test/data_pidf.csv\n");
+		return -1;
+	}
+	// the generated FIR is summed as the C kernel: same arithmetic on both sides
+	sig_fir_kernel_f(SIG_FIR_KERNEL_C);
+	if ((out == NULL) || test_gen_build(&g, data, data_l) || sig_gen_c(&gen, &g.graph, "test_gen", out))
+	{
+		printf("cannot generate the code\n");
+		return -1;
+	}
+	fclose(out);
+	for (i=0; i<gen.vars; i++)
+		test_gen_var[i] = gen.var[i];
+	for (i=0; i<gen.buffers; i++)
+		test_gen_buffer[i] = gen.buffer[i];
+
+	// n starts at 1: the memoization considers n = 0 as already evaluated
+	t_rec = bench_gen_now();
+	for (n=1; n<=(n_t)ticks; n++)
+	{
+		sum += sig_get_value_f(&g.pid, n);
+		sum += sig_get_value_f(&g.add, n);
+		sum += sig_get_value_f(&g.naive, n);
+	}
+	t_rec = (bench_gen_now() - t_rec) / ticks;
+
+	t_graph = bench_gen_now();
+	for (n=1; n<=(n_t)ticks; n++)
+	{
+		sig_graph_run(&g.graph, n);
+		sum += g.naive.x_cst;
+	}
+	t_graph = (bench_gen_now() - t_graph) / ticks;
+
+	t_gen = bench_gen_now();
+	for (n=1; n<=(n_t)ticks; n++)
+	{
+		test_gen_step(n);
+		sum += test_gen_state.x[g.graph.count - 1];
+	}
+	t_gen = (bench_gen_now() - t_gen) / ticks;
+
+	printf("%-20s %10s\n", "12 signals", "ns/tick");
+	printf("%-20s %10.2f\n", "recursive", t_rec);
+	printf("%-20s %10.2f\n", "compiled graph", t_graph);
+	printf("%-20s %10.2f\n", "generated", t_gen);
+	printf("(%g)\n", sum);
+	test_gen_free(&g);
+	csv_free(data);
+	return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench_graph.c
+ * Large graph benchmark: a binary tree of adders, evaluated recursively and as a compiled graph
+ * usage: bench_graph.out [max leaves]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+
+#define BENCH_GRAPH_NODES	(1 << 24)					//!< evaluated nodes per measure
+
+static double bench_graph_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief tree of 2 * leaves - 1 signals, in heap order: sig[i] = sig[2i + 1] + sig[2i + 2]. The leaves read input
+ */
+static void bench_graph_build(struct signal_float *sig, struct sig_add_param_f *add_p, float *input, int leaves)
+{
+	int i;
+
+	for (i=0; i<leaves-1; i++)
+	{
+		add_p[i] = (struct sig_add_param_f) {.a = &sig[2*i + 1], .b = &sig[2*i + 2]};
+		sig[i] = (struct signal_float) SIGN_FN("add", sig_add_f, &add_p[i]);
+	}
+	for (; i<2*leaves-1; i++)
+		sig[i] = (struct signal_float) SIGN_PTR("input", &input[i % 16]);
+}
+
+int main(int argc, char *argv[])
+{
+	int max_leaves = argc > 1 ? atoi(argv[1]) : (1 << 18);
+	struct signal_float *sig, *root;
+	struct sig_add_param_f *add_p;
+	struct sig_graph_node *nodes;
+	struct sig_graph graph;
+	float input[16];
+	double t_rec, t_graph;
+	int i, leaves, ticks;
+	n_t n;
+
+	for (i=0; i<16; i++)
+		input[i] = i;
+	printf("sizeof(struct signal_float) = %zu\n", sizeof(struct signal_float));
+	printf("%10s %10s %14s %14s\n", "signals", "KiB", "ns/node rec", "ns/node graph");
+	for (leaves=256; leaves<=max_leaves; leaves*=4)
+	{
+		sig = malloc((2 * leaves - 1) * sizeof(*sig));
+		add_p = calloc(leaves - 1, sizeof(*add_p));
+		nodes = malloc(leaves * sizeof(*nodes));
+		bench_graph_build(sig, add_p, input, leaves);
+		root = &sig[0];
+		sig_graph_init(&graph, nodes, leaves);
+		if (sig_graph_compile(&graph, &root, 1, NULL, 0))
+		{
+			printf("cannot compile the graph\n");
+			return -1;
+		}
+		ticks = BENCH_GRAPH_NODES / leaves;
+
+		// n starts at 1: the memoization considers n = 0 as already evaluated
+		for (n=1; n<4; n++)										// warmup
+			sig_get_value_f(root, n);
+		t_rec = bench_graph_now();
+		for (n=4; n<4+ticks; n++)
+			sig_get_value_f(root, n);
+		t_rec = (bench_graph_now() - t_rec) / ticks / (leaves - 1);
+
+		for (n=1; n<4; n++)
+			sig_graph_run(&graph, n);
+		t_graph = bench_graph_now();
+		for (n=4; n<4+ticks; n++)
+			sig_graph_run(&graph, n);
+		t_graph = (bench_graph_now() - t_graph) / ticks / (leaves - 1);
+
+		printf("%10d %10zu %14.2f %14.2f\n", 2 * leaves - 1,
+			((2 * leaves - 1) * sizeof(*sig) + (leaves - 1) * sizeof(*add_p)) / 1024, t_rec, t_graph);
+		free(nodes);
+		free(add_p);
+		free(sig);
+	}
+	return 0;
+}
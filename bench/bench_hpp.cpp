@@ -0,0 +1,133 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file bench_hpp.cpp
+ * Expression templates benchmark: a PID with 3 Feed-Forward terms reading 5 buffers, filtered by a 1st order low
+ * pass, evaluated through the function pointers, as a compiled graph, as an expression and through its adapter
+ * usage: bench_hpp.out [ticks]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "sig.hpp"
+extern "C" {
+#include "siggraph.h"
+}
+
+#define BENCH_HPP_LEN		4096						//!< length of the input buffers
+#define BENCH_HPP_BLOCK		64							//!< block size of the adapter
+
+static double bench_hpp_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+	int ticks = argc > 1 ? atoi(argv[1]) : (1 << 24);
+	static float input[5][BENCH_HPP_LEN];
+	struct sig_buf_read_param_f buf_p[5] = {};
+	struct signal_float buf[5];
+	struct sig_pid_param_f pid_p = {};
+	struct signal_float pid = SIG_FN(sig_pid_opt_f, &pid_p);
+	struct sig_iirlp1_param_f lp_p = {.a = 0.25, .oma = 0.75, .n_last = 0, .source = &pid};
+	struct signal_float lp = SIG_FN(sig_iirlp1_f, &lp_p);
+	struct signal_float *root = &lp;
+	struct sig_graph_node nodes[8];
+	struct sig_graph graph;
+	const sig::pid_gains gains = {1.0, 0.1, 1.0, 5.0, {1.0, 2.0, 3.0}};
+	float out[BENCH_HPP_BLOCK], sum = 0;
+	double t_fn, t_graph, t_expr, t_node;
+	int i, j;
+	n_t n;
+
+	for (i=0; i<5; i++)
+	{
+		for (j=0; j<BENCH_HPP_LEN; j++)
+			input[i][j] = (float)rand() / RAND_MAX - 0.5;
+		buf_p[i].buffer = input[i];
+		buf_p[i].size = BENCH_HPP_LEN;
+		buf_p[i].circular = 1;
+		buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &buf_p[i]);
+	}
+	pid_p.p = gains.p;
+	pid_p.i = gains.i;
+	pid_p.d = gains.d;
+	pid_p.max_output = gains.max_output;
+	for (i=0; i<3; i++)
+		pid_p.ff[i] = gains.ff[i];
+	pid_p.setpoint = &buf[0];
+	pid_p.feedback = &buf[1];
+	pid_p.ff0 = &buf[2];
+	pid_p.ff1 = &buf[3];
+	pid_p.ff2 = &buf[4];
+	sig_pid_compute_k_f(&pid);
+	sig_graph_init(&graph, nodes, 8);
+	if (sig_graph_compile(&graph, &root, 1, NULL, 0))
+	{
+		printf("cannot compile the graph\n");
+		return -1;
+	}
+
+	auto expr = sig::iirlp1(sig::pid(
+		sig::buf_circular(input[0], BENCH_HPP_LEN) - sig::buf_circular(input[1], BENCH_HPP_LEN), gains,
+		sig::buf_circular(input[2], BENCH_HPP_LEN), sig::buf_circular(input[3], BENCH_HPP_LEN),
+		sig::buf_circular(input[4], BENCH_HPP_LEN)), 0.25);
+	auto node = sig::to_signal(expr);
+	ticks = ticks / BENCH_HPP_BLOCK * BENCH_HPP_BLOCK;
+
+	// n starts at 1: the memoization considers n = 0 as already evaluated
+	t_fn = bench_hpp_now();
+	for (n=1; n<=(n_t)ticks; n++)
+		sum += sig_get_value_f(&lp, n);
+	t_fn = (bench_hpp_now() - t_fn) / ticks;
+
+	t_graph = bench_hpp_now();
+	for (n=1; n<=(n_t)ticks; n++)
+	{
+		sig_graph_run(&graph, n);
+		sum += lp.x_cst;
+	}
+	t_graph = (bench_hpp_now() - t_graph) / ticks;
+
+	t_expr = bench_hpp_now();
+	for (n=1; n<=(n_t)ticks; n++)
+		sum += expr(n);
+	t_expr = (bench_hpp_now() - t_expr) / ticks;
+
+	t_node = bench_hpp_now();
+	for (n=1; n<=(n_t)ticks; n+=BENCH_HPP_BLOCK)
+	{
+		sig_get_block_f(&node.signal, n, BENCH_HPP_BLOCK, out);
+		sum += out[BENCH_HPP_BLOCK - 1];
+	}
+	t_node = (bench_hpp_now() - t_node) / ticks;
+
+	printf("%-24s %10s\n", "7 signals", "ns/tick");
+	printf("%-24s %10.2f\n", "function pointers", t_fn);
+	printf("%-24s %10.2f\n", "compiled graph", t_graph);
+	printf("%-24s %10.2f\n", "expression", t_expr);
+	printf("%-24s %10.2f\n", "to_signal, blocks of 64", t_node);
+	printf("(%g)\n", sum);
+	return 0;
+}
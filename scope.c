@@ -24,6 +24,9 @@
 
 #include "scope.h"
 #include <string.h>
+#if SCOPE_STREAM_THREAD
+#include <time.h>
+#endif
 
 void scope_init(scope_t *self, void *data, int size)
 {
@@ -36,57 +39,63 @@ void scope_init(scope_t *self, void *data, int size)
 
 
 void scope_setup(scope_t *self, char *signals, int prediv)
+{
+	scope_setup_format(self, signals, prediv, NULL);
+}
+
+
+void scope_setup_format(scope_t *self, char *signals, int prediv, const struct scope_format_t *formats)
 {
 	self->state = SCOPE_INIT;					// disable scope
 	self->prediv = max(1, prediv);
 	self->count = 0;
 
 	#if defined(SIG_DBG_NAME)
-	int i;
-	char *signame;
-	char delimiter = ',';
+	char *signame, *save;
+	struct signal_int *sig_i;
+	struct signal_float *sig_f;
+	struct scope_format_t raw = {SCOPE_FMT_RAW, 1, 0};
+	int name_int[SCOPE_MAX_SIGNALS], name_float[SCOPE_MAX_SIGNALS];		// name index of each channel
+	int name = 0, c = 0, i;
+
+	strncpy(self->signals_names, signals, sizeof(self->signals_names) - 1);
+	self->signals_names[sizeof(self->signals_names) - 1] = '\0';
 		#if defined(SCOPE_USE_INT)
-			memcpy(self->signals_names, signals, min(SCOPE_MAX_SIGNALS * SIG_DBG_NAME_LENGHT, strlen(signals)));
-			signame = strtok(self->signals_names, &delimiter);
 			self->signals_count_int = 0;
-			while(signame)
+		#endif
+		#if defined(SCOPE_USE_FLOAT)
+			self->signals_count_float = 0;
+		#endif
+	for(signame = strtok_r(self->signals_names, ",", &save); signame; signame = strtok_r(NULL, ",", &save))
+	{
+		#if defined(SCOPE_USE_INT)
+			sig_i = sig_reg_find_i(&self->registry, signame);
+			if(sig_i && (self->signals_count_int < SCOPE_MAX_SIGNALS))
 			{
-				for(i=0; (i<SCOPE_MAX_SIGNALS_LIST) && (self->signals_count_int < SCOPE_MAX_SIGNALS); i++)
-				{
-					if(self->signals_list_i[i] == 0)
-						break;
-					if(strcmp(self->signals_list_i[i]->name, signame) == 0)
-					{
-						self->signals_int[self->signals_count_int] = self->signals_list_i[i];
-						self->signals_count_int++;
-						break;
-					}
-				}
-				signame = strtok(NULL, &delimiter);
+				name_int[self->signals_count_int] = name;
+				self->signals_int[self->signals_count_int++] = sig_i;
 			}
 		#endif
 		#if defined(SCOPE_USE_FLOAT)
-			memcpy(self->signals_names, signals, min(SCOPE_MAX_SIGNALS * SIG_DBG_NAME_LENGHT, strlen(signals)));
-			signame = strtok(self->signals_names, &delimiter);
-			self->signals_count_float = 0;
-			while(signame)
+			sig_f = sig_reg_find_f(&self->registry, signame);
+			if(sig_f && (self->signals_count_float < SCOPE_MAX_SIGNALS))
 			{
-				for(i=0; (i<SCOPE_MAX_SIGNALS_LIST) && (self->signals_count_float < SCOPE_MAX_SIGNALS); i++)
-				{
-					if(self->signals_list_f[i] == 0)
-					{
-						break;
-					}
-					if(strcmp(self->signals_list_f[i]->name, signame) == 0)
-					{
-						self->signals_float[self->signals_count_float] = self->signals_list_f[i];
-						self->signals_count_float++;
-						break;
-					}
-				}
-				signame = strtok(NULL, &delimiter);
+				name_float[self->signals_count_float] = name;
+				self->signals_float[self->signals_count_float++] = sig_f;
 			}
 		#endif
+		name++;
+	}
+
+	// channels: signals_int[], then signals_float[]
+		#if defined(SCOPE_USE_INT)
+			for(i=0; i<self->signals_count_int; i++, c++)
+				self->channel[c].format = formats ? formats[name_int[i]] : raw;
+		#endif
+		#if defined(SCOPE_USE_FLOAT)
+			for(i=0; i<self->signals_count_float; i++, c++)
+				self->channel[c].format = formats ? formats[name_float[i]] : raw;
+		#endif
 	#endif
 
 	self->state = SCOPE_READY;					// enable scope
@@ -96,43 +105,472 @@ void scope_setup(scope_t *self, char *signals, int prediv)
 #if(SCOPE_USE_INT)
 int scope_enlist_sig_int(scope_t *self, struct signal_int *sig)
 {
-	if(self->signal_list_count_i < SCOPE_MAX_SIGNALS)
-	{
-		self->signals_list_i[self->signal_list_count_i] = sig;
-		self->signal_list_count_i++;
-		return (SCOPE_MAX_SIGNALS - self->signal_list_count_i);
-	}
-	else
-		return -1;
+	#if defined(SIG_DBG_NAME)
+		if(sig->name && *sig->name)
+			return sig_reg_add_i(&self->registry, sig);
+	#endif
+	return -1;
 }
 #endif
 
 #if(SCOPE_USE_FLOAT)
 int scope_enlist_sig_float(scope_t *self, struct signal_float *sig)
 {
-	if((self->signal_list_count_f < SCOPE_MAX_SIGNALS) && *sig->name)
+	#if defined(SIG_DBG_NAME)
+		if(sig->name && *sig->name)
+			return sig_reg_add_f(&self->registry, sig);
+	#endif
+	return -1;
+}
+#endif
+
+
+void scope_free(scope_t *self)
+{
+	#if defined(SIG_DBG_NAME)
+		sig_reg_free(&self->registry);
+	#endif
+}
+
+
+/**
+ * @brief size (in bytes) of a value stored in the format type
+ */
+static int scope_format_bytes(enum scope_fmt_type_t type)
+{
+	switch(type)
 	{
-		self->signals_list_f[self->signal_list_count_f] = sig;
-		self->signal_list_count_f++;
-		return (SCOPE_MAX_SIGNALS - self->signal_list_count_f);
+		case SCOPE_FMT_INT8:
+			return sizeof(int8_t);
+		case SCOPE_FMT_INT16:
+		case SCOPE_FMT_FLOAT16:
+		case SCOPE_FMT_DELTA16:
+			return sizeof(int16_t);
+		case SCOPE_FMT_RAW:
+		default:
+			return sizeof(float);
 	}
-	else
-		return -1;
 }
-#endif
+
+
+/**
+ * @brief place the channels in a sample, in channel order and without padding
+ */
+static void scope_layout(scope_t *self)
+{
+	struct scope_channel_t *ch = self->channel;
+	int channels = 0, ints = 0, pos = 0, c;
+
+	#if(SCOPE_USE_INT)
+		ints = self->signals_count_int;
+		channels += ints;
+	#endif
+	#if(SCOPE_USE_FLOAT)
+		channels += self->signals_count_float;
+	#endif
+
+	for(c=0; c<channels; c++, ch++)
+	{
+		ch->is_int = c < ints;
+		ch->inv_scale = ch->format.scale ? 1 / ch->format.scale : 0;
+		ch->pos = pos;
+		pos += scope_format_bytes(ch->format.type);
+	}
+	self->sample_bytes = pos;
+}
+
 
 int scope_max_samples(scope_t *self)
+{
+	scope_layout(self);
+	return (self->buffer_size_bytes / max(1, self->sample_bytes));
+}
+
+
+int scope_set_trigger(scope_t *self, const struct scope_trigger_t *trig)
+{
+	int channels = 0;
+
+	#if(SCOPE_USE_INT)
+		channels += self->signals_count_int;
+	#endif
+	#if(SCOPE_USE_FLOAT)
+		channels += self->signals_count_float;
+	#endif
+
+	if((trig->type != SCOPE_TRIG_NONE) && (trig->type != SCOPE_TRIG_NWINDOW) && ((trig->channel < 0) || (trig->channel >= channels)))
+		return -1;
+	if((trig->type != SCOPE_TRIG_NONE) && ((trig->pretrig < 0) || (trig->pretrig >= scope_max_samples(self))))
+		return -1;
+	self->trig = *trig;
+	return 0;
+}
+
+
+/**
+ * @brief rotate the len bytes of buf left by k bytes
+ */
+static void scope_rotate(char *buf, int len, int k)
+{
+	int i, j;
+	char tmp;
+
+	// reverse [0; k[, reverse [k; len[, then reverse the whole buffer
+	for(i=0, j=k-1; i<j; i++, j--)
+		{ tmp = buf[i]; buf[i] = buf[j]; buf[j] = tmp; }
+	for(i=k, j=len-1; i<j; i++, j--)
+		{ tmp = buf[i]; buf[i] = buf[j]; buf[j] = tmp; }
+	for(i=0, j=len-1; i<j; i++, j--)
+		{ tmp = buf[i]; buf[i] = buf[j]; buf[j] = tmp; }
+}
+
+
+/**
+ * @brief IEEE 754 half precision of x, rounded to the nearest even
+ */
+static inline uint16_t scope_half(float x)
+{
+	uint32_t f, sign, m, rem, half, r;
+	int shift;
+
+	memcpy(&f, &x, sizeof(f));
+	sign = (f >> 16) & 0x8000;
+	f &= 0x7fffffff;
+	if(f > 0x7f800000)								// NaN
+		return sign | 0x7e00;
+	if(f >= 0x477ff000)								// inf, or rounds to inf (65520 and above)
+		return sign | 0x7c00;
+	if(f >= 0x38800000)								// normal: rebias the exponent, round the mantissa to 10 bits
+		return sign | ((f - 0x38000000 + 0xfff + ((f >> 13) & 1)) >> 13);
+	if(f < 0x33000000)								// below half of the smallest subnormal
+		return sign;
+
+	// subnormal: code = x / 2^-24
+	m = (f & 0x7fffff) | 0x800000;
+	shift = 126 - (f >> 23);
+	r = m >> shift;
+	rem = m & ((1u << shift) - 1);
+	half = 1u << (shift - 1);
+	if((rem > half) || ((rem == half) && (r & 1)))
+		r++;
+	return sign | r;
+}
+
+
+/**
+ * @brief value of the IEEE 754 half precision h
+ */
+static inline float scope_half_f(uint16_t h)
+{
+	uint32_t sign = (uint32_t)(h & 0x8000) << 16, exp = (h >> 10) & 0x1f, mant = h & 0x3ff, f;
+	float x;
+
+	if(exp == 0)									// zero or subnormal
+	{
+		x = mant * (1.0f / 16777216);
+		return sign ? -x : x;
+	}
+	if(exp == 0x1f)									// inf or NaN
+		f = sign | 0x7f800000 | (mant << 13);
+	else
+		f = sign | ((exp + 112) << 23) | (mant << 13);
+	memcpy(&x, &f, sizeof(x));
+	return x;
+}
+
+
+/**
+ * @brief code of x in the format of the channel, rounded and saturated to [lo; hi]. NaN gives lo
+ */
+static inline int scope_quantize(const struct scope_channel_t *ch, float x, float lo, float hi)
+{
+	x = (x - ch->format.offset) * ch->inv_scale;
+	if(!(x >= lo))
+		x = lo;
+	if(x > hi)
+		x = hi;
+	return (int)(x >= 0 ? x + 0.5f : x - 0.5f);
+}
+
+
+/**
+ * @brief store x in the format of the channel
+ * @param[in] overwrite : the sample replaces the oldest one of the circular buffer
+ */
+static inline void scope_encode(scope_t *self, struct scope_channel_t *ch, char *ptr, float x, int overwrite)
+{
+	int16_t d;
+	int q;
+
+	switch(ch->format.type)
+	{
+		case SCOPE_FMT_INT8:
+			*(int8_t*)ptr = scope_quantize(ch, x, INT8_MIN, INT8_MAX);
+			break;
+		case SCOPE_FMT_INT16:
+			d = scope_quantize(ch, x, INT16_MIN, INT16_MAX);
+			memcpy(ptr, &d, sizeof(d));
+			break;
+		case SCOPE_FMT_FLOAT16:
+			d = scope_half(x);
+			memcpy(ptr, &d, sizeof(d));
+			break;
+		case SCOPE_FMT_DELTA16:
+			q = scope_quantize(ch, x, -(1 << 30), 1 << 30);
+			if(!self->delta_ready)
+				ch->base = ch->last = q;
+			if(overwrite)									// the oldest sample leaves: its delta moves to the base
+			{
+				memcpy(&d, ptr, sizeof(d));
+				ch->base += d;
+			}
+			d = max(INT16_MIN, min(INT16_MAX, (long long)q - ch->last));	// both in +-2^30: the difference may not fit an int
+			ch->last += d;
+			memcpy(ptr, &d, sizeof(d));
+			break;
+		case SCOPE_FMT_RAW:
+		default:
+			memcpy(ptr, &x, sizeof(x));
+	}
+}
+
+
+/**
+ * @brief sample all the channels at n into the sample pointed by frame, each in its format
+ * @param[in] overwrite : the sample replaces the oldest one of the circular buffer
+ * @return the value of the trigger channel, before encoding
+ */
+static inline float scope_store(scope_t *self, char *frame, n_t n, int overwrite)
+{
+	struct scope_channel_t *ch = self->channel;
+	float x, trig_x = 0;
+	int c = 0, i;
+
+	#if(SCOPE_USE_INT)
+		int v;
+		for(i=0; i<self->signals_count_int; i++, c++, ch++)
+		{
+			v = sig_value(self->signals_int[i], n);
+			x = v;
+			if(c == self->trig.channel)
+				trig_x = x;
+			if(ch->format.type == SCOPE_FMT_RAW)
+				memcpy(frame + ch->pos, &v, sizeof(v));
+			else
+				scope_encode(self, ch, frame + ch->pos, x, overwrite);
+		}
+	#endif
+	#if(SCOPE_USE_FLOAT)
+		for(i=0; i<self->signals_count_float; i++, c++, ch++)
+		{
+			x = sig_value(self->signals_float[i], n);
+			if(c == self->trig.channel)
+				trig_x = x;
+			scope_encode(self, ch, frame + ch->pos, x, overwrite);
+		}
+	#endif
+	self->delta_ready = 1;
+	return trig_x;
+}
+
+
+void scope_decode_f(const struct scope_channel_t *ch, const void *data, int stride, int first, int count, float *out)
+{
+	const char *ptr = (const char*)data + ch->pos;
+	float scale = ch->format.scale, offset = ch->format.offset;
+	int16_t d;
+	int i, v, acc;
+
+	switch(ch->format.type)
+	{
+		case SCOPE_FMT_INT8:
+			for(i=0, ptr+=first*stride; i<count; i++, ptr+=stride)
+				out[i] = *(const int8_t*)ptr * scale + offset;
+			break;
+		case SCOPE_FMT_INT16:
+			for(i=0, ptr+=first*stride; i<count; i++, ptr+=stride)
+			{
+				memcpy(&d, ptr, sizeof(d));
+				out[i] = d * scale + offset;
+			}
+			break;
+		case SCOPE_FMT_FLOAT16:
+			for(i=0, ptr+=first*stride; i<count; i++, ptr+=stride)
+			{
+				memcpy(&d, ptr, sizeof(d));
+				out[i] = scope_half_f(d);
+			}
+			break;
+		case SCOPE_FMT_DELTA16:
+			// the code of a sample is the sum of the deltas since the start of the buffer
+			for(i=0, acc=ch->base; i<first; i++, ptr+=stride)
+			{
+				memcpy(&d, ptr, sizeof(d));
+				acc += d;
+			}
+			for(i=0; i<count; i++, ptr+=stride)
+			{
+				memcpy(&d, ptr, sizeof(d));
+				acc += d;
+				out[i] = acc * scale + offset;
+			}
+			break;
+		case SCOPE_FMT_RAW:
+		default:
+			for(i=0, ptr+=first*stride; i<count; i++, ptr+=stride)
+			{
+				if(ch->is_int)
+				{
+					memcpy(&v, ptr, sizeof(v));
+					out[i] = v;
+				}
+				else
+					memcpy(&out[i], ptr, sizeof(float));
+			}
+	}
+}
+
+
+int scope_read_f(scope_t *self, int channel, int first, int count, float *out)
 {
 	int channels = 0;
 
 	#if(SCOPE_USE_INT)
-		channels += self->signals_count_int * sizeof(int);
+		channels += self->signals_count_int;
 	#endif
 	#if(SCOPE_USE_FLOAT)
-		channels += self->signals_count_float * sizeof(float);
+		channels += self->signals_count_float;
 	#endif
 
-	return (self->buffer_size_bytes / min(1, channels));
+	if((self->state != SCOPE_SAMPLED) && (self->state != SCOPE_SAMPLING))
+		return -1;
+	if((channel < 0) || (channel >= channels) || (first < 0) || (count < 0) || (first + count > self->samples))
+		return -1;
+	scope_decode_f(&self->channel[channel], self->buffer, self->sample_bytes, first, count, out);
+	return 0;
+}
+
+
+/**
+ * @brief returns 1 if the trigger fires on the value x of the trigger channel at n
+ */
+static inline int scope_trig_check(scope_t *self, n_t n, float x)
+{
+	struct scope_trigger_t *trig = &self->trig;
+	int fire;
+
+	switch(trig->type)
+	{
+		case SCOPE_TRIG_RISING:
+			fire = self->trig_has_last && (self->trig_last < trig->level) && (x >= trig->level);
+			break;
+		case SCOPE_TRIG_FALLING:
+			fire = self->trig_has_last && (self->trig_last > trig->level) && (x <= trig->level);
+			break;
+		case SCOPE_TRIG_LEVEL:
+			fire = x >= trig->level;
+			break;
+		case SCOPE_TRIG_WINDOW:
+			fire = (x < trig->level) || (x > trig->high);
+			break;
+		case SCOPE_TRIG_NWINDOW:
+			fire = SIG_NWINDOW_VALID(n, trig);
+			break;
+		default:
+			fire = 1;
+	}
+	self->trig_last = x;
+	self->trig_has_last = 1;
+	return fire;
+}
+
+
+/**
+ * @brief armed / triggered scope: sample into the circular buffer and check the trigger
+ */
+static void scope_trig_update(scope_t *self, n_t n)
+{
+	int sample_bytes = self->sample_bytes, total, start, i;
+	float x;
+
+	i = self->count;
+	if(++self->count == self->prediv)
+		self->count = 0;
+	if(i != 0)
+		return;
+
+	x = scope_store(self, (char*)self->buffer + self->write_index * sample_bytes, n, self->wrapped);
+	if(++self->write_index == self->depth)
+	{
+		self->write_index = 0;
+		self->wrapped = 1;
+	}
+
+	if(self->state == SCOPE_ARMED)
+	{
+		if(!scope_trig_check(self, n, x))
+		{
+			self->samples++;								// samples taken while armed
+			return;
+		}
+		self->trig_n = n;
+		self->trig_index = min(self->samples, self->trig.pretrig);
+		self->post = self->depth - self->trig.pretrig;
+		self->state = SCOPE_TRIGGERED;
+	}
+
+	if(--self->post)
+		return;
+
+	// done: move the capture to the start of the buffer, oldest sample first
+	total = self->trig_index + self->depth - self->trig.pretrig;
+	start = self->write_index - total;
+	if(start < 0)
+		start += self->depth;
+	scope_rotate(self->buffer, self->depth * sample_bytes, start * sample_bytes);
+	self->samples = total;
+	self->n_first = self->trig_n - self->trig_index * self->prediv;
+	self->next_data = (char*)self->buffer + total * sample_bytes;
+	self->state = SCOPE_SAMPLED;
+}
+
+
+/**
+ * @brief streaming producer: writes one frame into the ring, or drops it if the ring is full
+ */
+static inline void scope_stream_push(scope_t *self, n_t n)
+{
+	unsigned int head = self->stream_head;
+	char *frame;
+	int i;
+
+	i = self->count;
+	if(++self->count == self->prediv)
+		self->count = 0;
+	if(i != 0)
+		return;
+
+	// the consumer releases a frame after reading it
+	if(head - __atomic_load_n(&self->stream_tail, __ATOMIC_ACQUIRE) > self->stream_mask)
+	{
+		__atomic_store_n(&self->overruns, self->overruns + 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	frame = (char*)self->buffer + (head & self->stream_mask) * self->frame_bytes;
+	*(n_t*)frame = n;
+	frame += sizeof(n_t);
+#if(SCOPE_USE_INT)
+	for(i=0; i<self->signals_count_int; i++)
+		((int*)frame)[i] = sig_value(self->signals_int[i], n);
+	frame += self->signals_count_int * sizeof(int);
+#endif
+#if(SCOPE_USE_FLOAT)
+	for(i=0; i<self->signals_count_float; i++)
+		((float*)frame)[i] = sig_value(self->signals_float[i], n);
+#endif
+	self->samples++;
+	__atomic_store_n(&self->stream_head, head + 1, __ATOMIC_RELEASE);	// publish the frame
 }
 
 
@@ -140,51 +578,156 @@ void scope_update(scope_t *self, n_t n)
 {
 	switch(self->state)
 	{
+		case SCOPE_STREAMING:
+			scope_stream_push(self, n);
+			break;
+		case SCOPE_ARMED:
+		case SCOPE_TRIGGERED:
+			scope_trig_update(self, n);
+			break;
 		case SCOPE_INIT:
 		case SCOPE_SAMPLED:
 		default:
 			break;
 		case SCOPE_READY:
+			if(self->trig.type != SCOPE_TRIG_NONE)
+			{
+				self->depth = scope_max_samples(self);
+				if(self->trig.pretrig >= self->depth)
+					break;								// the channels changed since scope_set_trigger(): not armed
+				self->state = SCOPE_ARMED;
+				self->write_index = 0;
+				self->samples = 0;
+				self->count = 0;
+				self->trig_has_last = 0;
+				self->wrapped = 0;
+				self->delta_ready = 0;
+				scope_trig_update(self, n);
+				break;
+			}
 			self->state = SCOPE_SAMPLING;
+			scope_layout(self);
 			self->next_data = self->buffer;
 			self->count = 0;
+			self->samples = 0;
+			self->n_first = n;
+			self->delta_ready = 0;
 		case SCOPE_SAMPLING:
 			if(self->count == 0)
 			{
-				int i;
-
-			#if(SCOPE_USE_INT)
-				int *ptr_i;
-				for(i=0; i<self->signals_count_int; i++)
-				{
-					if(self->next_data + sizeof(int) > self->buffer + self->buffer_size_bytes)
-					{
-						self->state = SCOPE_SAMPLED;
-						return;
-					}
-					ptr_i = (int*)self->next_data;
-					*ptr_i = sig_value(self->signals_int[i], n);
-					self->next_data += sizeof(int);
-				}
-			#endif
-
-			#if(SCOPE_USE_FLOAT)
-				float *ptr_f;
-				for(i=0; i<self->signals_count_float; i++)
+				if(self->next_data + self->sample_bytes > self->buffer + self->buffer_size_bytes)
 				{
-					if(self->next_data + sizeof(float) > self->buffer + self->buffer_size_bytes)
-					{
-						self->state = SCOPE_SAMPLED;
-						return;
-					}
-					ptr_f = (float*)self->next_data;
-					*ptr_f = sig_value(self->signals_float[i], n);
-					self->next_data += sizeof(int);
+					self->state = SCOPE_SAMPLED;
+					return;
 				}
-			#endif
+				scope_store(self, self->next_data, n, 0);
+				self->next_data += self->sample_bytes;
+				self->samples++;
 			}
-			self->samples++;
 			self->count++;
 			self->count %= self->prediv;
 	};
 }
+
+
+int scope_stream_drain(scope_t *self)
+{
+	unsigned int tail = self->stream_tail;
+	unsigned int head = __atomic_load_n(&self->stream_head, __ATOMIC_ACQUIRE);
+	unsigned int count = head - tail;
+	unsigned int index, len;
+
+	if(count == 0)
+		return 0;
+
+	// the frames may wrap around the end of the ring: hand them in two contiguous parts
+	index = tail & self->stream_mask;
+	len = min(count, self->stream_mask + 1 - index);
+	self->stream_cb(self, (char*)self->buffer + index * self->frame_bytes, len, self->stream_arg);
+	if(len < count)
+		self->stream_cb(self, self->buffer, count - len, self->stream_arg);
+
+	__atomic_store_n(&self->stream_tail, head, __ATOMIC_RELEASE);		// release the frames to the producer
+	return count;
+}
+
+
+#if(SCOPE_STREAM_THREAD)
+static void *scope_stream_thread(void *arg)
+{
+	scope_t *self = (scope_t*)arg;
+	struct timespec ts = {.tv_sec = 0, .tv_nsec = SCOPE_STREAM_POLL_US * 1000};
+
+	while(!__atomic_load_n(&self->stream_stop, __ATOMIC_ACQUIRE))
+	{
+		if(scope_stream_drain(self) == 0)
+			nanosleep(&ts, NULL);
+	}
+	return NULL;
+}
+#endif
+
+
+int scope_stream_start(scope_t *self, scope_stream_cb cb, void *arg, int thread)
+{
+	unsigned int frames;
+
+	self->state = SCOPE_INIT;					// disable scope
+	self->frame_bytes = sizeof(n_t);
+	#if(SCOPE_USE_INT)
+		self->frame_bytes += self->signals_count_int * sizeof(int);
+	#endif
+	#if(SCOPE_USE_FLOAT)
+		self->frame_bytes += self->signals_count_float * sizeof(float);
+	#endif
+
+	frames = self->buffer_size_bytes / self->frame_bytes;
+	if((frames == 0) || (cb == NULL))
+		return -1;
+	while(frames & (frames - 1))				// round down to a power of 2, so that the ring index is a mask
+		frames &= frames - 1;
+
+	self->stream_mask = frames - 1;
+	self->stream_head = 0;
+	self->stream_tail = 0;
+	self->overruns = 0;
+	self->samples = 0;
+	self->count = 0;
+	self->stream_cb = cb;
+	self->stream_arg = arg;
+
+	#if(SCOPE_STREAM_THREAD)
+		self->stream_stop = 0;
+		self->stream_threaded = 0;
+		if(thread)
+		{
+			if(pthread_create(&self->stream_thread, NULL, scope_stream_thread, self))
+				return -1;
+			self->stream_threaded = 1;
+		}
+	#else
+		if(thread)
+			return -1;
+	#endif
+
+	self->state = SCOPE_STREAMING;				// enable scope
+	return 0;
+}
+
+
+void scope_stream_stop(scope_t *self)
+{
+	if(self->state != SCOPE_STREAMING)
+		return;
+	self->state = SCOPE_INIT;
+
+	#if(SCOPE_STREAM_THREAD)
+		if(self->stream_threaded)
+		{
+			__atomic_store_n(&self->stream_stop, 1, __ATOMIC_RELEASE);
+			pthread_join(self->stream_thread, NULL);
+			self->stream_threaded = 0;
+		}
+	#endif
+	scope_stream_drain(self);
+}
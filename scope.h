@@ -26,7 +26,9 @@
 #define SIG_SCOPE_H__
 
 #include <stdlib.h>
+#include <stdint.h>
 #include "sig.h"
+#include "sigreg.h"
 
 /** @addtogroup config
  * @{
@@ -54,15 +56,94 @@
 #endif
 
 /** @ingroup scope
- * @brief Amount of signals referenced (known).
- * Ignered if @SIG_DBG_NAME is FALSE
+ * @brief If TRUE, scope_stream_start() can drain the streaming ring from a consumer thread (pthread)
  */
-#if !defined(SCOPE_MAX_SIGNALS_LIST) || defined(__DOXYGEN__)
-	#define SCOPE_MAX_SIGNALS_LIST	64
+#if !defined(SCOPE_STREAM_THREAD) || defined(__DOXYGEN__)
+	#define SCOPE_STREAM_THREAD	TRUE
+#endif
+
+/** @ingroup scope
+ * @brief Sleep time (in us) of the consumer thread when the streaming ring is empty
+ */
+#if !defined(SCOPE_STREAM_POLL_US) || defined(__DOXYGEN__)
+	#define SCOPE_STREAM_POLL_US	100
 #endif
 
 /** @} */
 
+#if SCOPE_STREAM_THREAD
+	#include <pthread.h>
+#endif
+
+struct scope_type;
+
+/** @ingroup scope
+ * @brief trigger types, see scope_trigger_t
+ */
+enum scope_trig_type_t {
+	SCOPE_TRIG_NONE,				//!< no trigger: the capture starts as soon as the scope is ready
+	SCOPE_TRIG_RISING,				//!< the channel crosses level upwards (x[n-1] < level <= x[n])
+	SCOPE_TRIG_FALLING,				//!< the channel crosses level downwards (x[n-1] > level >= x[n])
+	SCOPE_TRIG_LEVEL,				//!< the channel is at or above level
+	SCOPE_TRIG_WINDOW,				//!< the channel is out of [level; high]
+	SCOPE_TRIG_NWINDOW,				//!< n is inside the n-Window [n_min; n_max]. @see SIG_NWINDOW_VALID
+};
+
+/** @ingroup scope
+ * @struct scope_trigger_t
+ * @brief trigger configuration of a scope
+ */
+struct scope_trigger_t {
+	enum scope_trig_type_t type;	//!< trigger type
+	int channel;					//!< channel the trigger watches: index in signals_int[], then in signals_float[] (signals_count_int + i)
+	float level;					//!< threshold of the edge and level triggers, lower bound of the window trigger
+	float high;						//!< upper bound of the window trigger
+	n_t n_min;						//!< lower boundary of the n-Window
+	n_t n_max;						//!< upper boundary of the n-Window
+	int pretrig;					//!< pre-trigger depth: samples kept before the trigger sample. Must be lower than scope_max_samples()
+};
+
+/** @ingroup scope
+ * @brief storage formats of a captured channel, see scope_format_t
+ */
+enum scope_fmt_type_t {
+	SCOPE_FMT_RAW,					//!< int or float, as sampled (4 bytes)
+	SCOPE_FMT_INT8,					//!< x = code * scale + offset, code rounded and saturated to int8 (1 byte)
+	SCOPE_FMT_INT16,				//!< same, code on int16 (2 bytes)
+	SCOPE_FMT_FLOAT16,				//!< IEEE 754 half precision: 11 significant bits, up to 65504 (2 bytes)
+	SCOPE_FMT_DELTA16,				//!< code as SCOPE_FMT_INT16, on 31 bits. Stores the difference with the previous code, saturated to int16: a step larger than 32767 codes is caught up by the next samples (2 bytes)
+};
+
+/** @ingroup scope
+ * @struct scope_format_t
+ * @brief storage format of a captured channel
+ */
+struct scope_format_t {
+	enum scope_fmt_type_t type;		//!< storage format
+	float scale;					//!< quantization step of the integer formats. Must not be 0
+	float offset;					//!< value of the code 0 of the integer formats
+};
+
+/** @ingroup scope
+ * @struct scope_channel_t
+ * @brief storage of a captured channel in the scope buffer
+ */
+struct scope_channel_t {
+	struct scope_format_t format;	//!< storage format. SCOPE_FMT_RAW after scope_init()
+	float inv_scale;				//!< 1 / format.scale
+	int pos;						//!< position (in bytes) of the channel in a sample
+	int is_int;						//!< 1 for a signal_int
+	int last;						//!< SCOPE_FMT_DELTA16: code of the last sample written
+	int base;						//!< SCOPE_FMT_DELTA16: code before the first sample of the buffer
+};
+
+/** @ingroup scope
+ * @brief streaming consumer callback
+ * @details called with count frames, contiguous in memory, each self->frame_bytes long. A frame holds n (n_t),
+ * then the values of signals_int[], then the values of signals_float[]. The frames are released when it returns.
+ */
+typedef void (*scope_stream_cb)(struct scope_type *self, const void *frames, int count, void *arg);
+
 /** @ingroup scope
  * @struct scope_type
  * @brief structure representing a signal Scope
@@ -80,33 +161,56 @@ typedef struct scope_type
 
 	#if defined(SIG_DBG_NAME) || defined(__DOXYGEN__)
 		char signals_names[SCOPE_MAX_SIGNALS * SIG_DBG_NAME_LENGHT];	//!< Names of the signals, ',' separeted
-
-		#if defined(SCOPE_USE_INT) || defined(__DOXYGEN__)
-			struct signal_int *signals_list_i[SCOPE_MAX_SIGNALS_LIST];	//!< Available (known) signal_int
-			int signal_list_count_i;									//!< Number of known signal_int
-		#endif
-		#if defined(SCOPE_USE_FLOAT) || defined(__DOXYGEN__)
-			struct signal_float *signals_list_f[SCOPE_MAX_SIGNALS_LIST];//!< Available (known) signals_float
-			int signal_list_count_f;									//!< Number of known signal_int
-		#endif
+		struct sig_reg registry;										//!< Available (known) signals, see scope_enlist_sig_int() and scope_enlist_sig_float()
 	#endif
 
+	// capture storage: a sample holds one value per channel, each in its format, without padding
+	struct scope_channel_t channel[2 * SCOPE_MAX_SIGNALS];	//!< storage of each channel: signals_int[], then signals_float[]
+	int sample_bytes;			//!< size (in bytes) of a captured sample
+	int delta_ready;			//!< 1 once the SCOPE_FMT_DELTA16 channels hold their first code
+	int wrapped;				//!< armed or triggered: 1 once the circular buffer is full
+
 	void *buffer;				//!< points to the memory dedicated to the buffer
 	void *next_data;			//!< points to the next address where the signal's value must be saved
 	int buffer_size_bytes;		//!< size (in bytes) of the buffer memory
 	int buffer_size;			//!< buffer size (in samples)
 	int samples;				//!< samples already collected
-	enum scope_state_t {SCOPE_INIT, SCOPE_READY, SCOPE_SAMPLING, SCOPE_SAMPLED} state;	//!< state of the scope
+	n_t n_first;				//!< n of the first sample in buffer
+	enum scope_state_t {SCOPE_INIT, SCOPE_READY, SCOPE_SAMPLING, SCOPE_SAMPLED, SCOPE_STREAMING, SCOPE_ARMED, SCOPE_TRIGGERED} state;	//!< state of the scope
 	int prediv;					//!< Sampling predivisor
 	int count;					//!< counter used by the predivisor
 
+	// trigger: while armed, buffer is a circular buffer of depth frames
+	struct scope_trigger_t trig;	//!< trigger configuration, see scope_set_trigger()
+	n_t trig_n;					//!< n of the trigger sample
+	int trig_index;				//!< index of the trigger sample in buffer, once @SCOPE_SAMPLED
+	float trig_last;			//!< previous value of the trigger channel (edge triggers)
+	int trig_has_last;			//!< 1 if trig_last is valid
+	int depth;					//!< buffer depth in samples
+	int write_index;			//!< index in buffer of the next sample
+	int post;					//!< samples still to capture after the trigger
+
+	// streaming mode: buffer is a single-producer / single-consumer ring of frames
+	int frame_bytes;			//!< size (in bytes) of a frame: n, then one value per channel
+	unsigned int stream_mask;	//!< ring capacity (in frames, a power of 2) - 1
+	unsigned int overruns;		//!< frames dropped because the ring was full
+	scope_stream_cb stream_cb;	//!< consumer callback
+	void *stream_arg;			//!< argument of stream_cb
+	unsigned int stream_head __attribute__((aligned(64)));	//!< frames written. Only written by the producer (scope_update())
+	unsigned int stream_tail __attribute__((aligned(64)));	//!< frames consumed. Only written by the consumer (scope_stream_drain())
+	#if SCOPE_STREAM_THREAD || defined(__DOXYGEN__)
+		pthread_t stream_thread;	//!< consumer thread
+		int stream_threaded;		//!< 1 if stream_thread is running
+		int stream_stop;			//!< asks the consumer thread to exit
+	#endif
+
 } scope_t;
 
 
 /** @ingroup scope
  * scope scope init
  * @pre: none
- * @post: the internal variables are reset, and the state is set to @SCOPE_INIT.
+ * @post: the internal variables are reset, and the state is set to @SCOPE_INIT. The known signals are forgotten: call scope_free() first to release them.
  * @param[in] self : pointer to the scope_t struct
  * @param[in] *data : pointer to the memory used as buffer by the scope
  * @param[in] size : size of the buffer in bytes
@@ -119,18 +223,31 @@ void scope_init(scope_t *self, void *data, int size);
  * @detils if @SIG_DBG_NAME is TRUE, the function searches for the signals names 
  * @param[in] self : pointer to the scope_t sctuct
  * @param[in] *signals : list of signal names to sample.
- *   these are ',' separated, and searched into @signals_list_int and @signals_list_float.
+ *   these are ',' separated, and searched into @registry: each name selects the signal_int and the signal_float of that name, if any.
  *   ignored if @SIG_DBG_NAME is FALSE, you have to fill @signal_int and @signal_float yourself
  * @param[in] prediv predivisor for the sampling period
  */
 void scope_setup(scope_t *self, char *signals, int prediv);
 
+/** @ingroup scope
+ * same as scope_setup(), choosing the storage format of each channel
+ * @details the captured samples (sampling and triggered captures) hold each channel in its format: with 8 and 16
+ * bits formats, scope_max_samples() is 2 to 4 times deeper in the same memory. The values are encoded when sampled,
+ * and decoded by scope_read_f(). The streamed frames are not affected: they always hold the raw values.
+ * @n if @SIG_DBG_NAME is FALSE, set the format of channel[] yourself (SCOPE_FMT_RAW after scope_init())
+ * @param[in] self : pointer to the scope_t sctuct
+ * @param[in] *signals : list of signal names to sample, see scope_setup()
+ * @param[in] prediv predivisor for the sampling period
+ * @param[in] formats : format of the channels selected by each name of signals, in the same order. NULL: all the channels are SCOPE_FMT_RAW
+ */
+void scope_setup_format(scope_t *self, char *signals, int prediv, const struct scope_format_t *formats);
+
 #if(SCOPE_USE_INT) || defined(__DOXYGEN__)
 /** @ingroup scope
  * add a signal to the list of known signals
  * @param[in] self : pointer to the scope_t sctuct
  * @param[in] *signal pointer to a struct @signal_int
- * @return number of signals that can still be added (-1 if @sig was not added)
+ * @return 0 (-1 if @sig was not added: unnamed, already known or out of memory)
  */
 	int scope_enlist_sig_int(scope_t *self, struct signal_int *sig);
 #endif
@@ -140,17 +257,61 @@ void scope_setup(scope_t *self, char *signals, int prediv);
  * add a signal to the list of known signals
  * @param[in] self : pointer to the scope_t sctuct
  * @param[in] *signal pointer to a struct @signal_float
- * @return number of signals that can still be added (-1 if @sig was not added)
+ * @return 0 (-1 if @sig was not added: unnamed, already known or out of memory)
  */
 	int scope_enlist_sig_float(scope_t *self, struct signal_float *sig);
 #endif
 
 /** @ingroup scope
- * returns the buffer depth in samples (how many samples the scope can hold)
+ * set the trigger of the scope. Call after scope_setup(): the channels must be known.
+ * @details With a trigger, a @SCOPE_READY scope becomes @SCOPE_ARMED: it samples continuously into a circular buffer
+ * and checks the trigger on each sample. When the trigger fires, the scope becomes @SCOPE_TRIGGERED and captures
+ * (scope_max_samples() - pretrig) samples, the trigger sample included. Then the buffer is rotated so that it reads
+ * linearly (oldest sample first), and the scope becomes @SCOPE_SAMPLED: samples holds the captured count, and the
+ * trigger sample is at trig_index (lower than pretrig if the trigger fired before pretrig samples were taken).
+ * @n pretrig is checked again when the scope is armed: if a later scope_setup() made scope_max_samples() lower or
+ * equal to it, the scope stays @SCOPE_READY and samples nothing until a valid trigger is set.
+ * @param[in] self : pointer to the scope_t sctuct
+ * @param[in] trig : trigger configuration. Copied. type = @SCOPE_TRIG_NONE removes the trigger
+ * @return 0 on success, -1 if the channel or the pre-trigger depth is invalid
+ */
+int scope_set_trigger(scope_t *self, const struct scope_trigger_t *trig);
+
+/** @ingroup scope
+ * free the memory used by the scope (the registry of known signals). scope_init() must be called before using it again
+ * @param[in] self : pointer to the scope_t sctuct
+ */
+void scope_free(scope_t *self);
+
+/** @ingroup scope
+ * returns the buffer depth in samples (how many samples the scope can hold), with the storage format of each channel
  * @param[in] self : pointer to the scope_t sctuct
  */
 int scope_max_samples(scope_t *self);
 
+/** @ingroup scope
+ * decode samples of a channel of the capture
+ * @details the scope should be @SCOPE_SAMPLED (or @SCOPE_SAMPLING, for the samples collected so far)
+ * @param[in] self : pointer to the scope_t sctuct
+ * @param[in] channel : channel index: in signals_int[], then in signals_float[] (signals_count_int + i)
+ * @param[in] first : index of the first sample
+ * @param[in] count : number of samples
+ * @param[out] out : receives count values
+ * @return 0 on success, -1 if the scope is not sampling or sampled, or the channel or the samples are out of range
+ */
+int scope_read_f(scope_t *self, int channel, int first, int count, float *out);
+
+/** @ingroup scope
+ * decode samples of a channel stored in a buffer of samples. Used by scope_read_f() and scope_file_read_f()
+ * @param[in] ch : storage of the channel
+ * @param[in] data : first sample of the buffer
+ * @param[in] stride : size (in bytes) of a sample
+ * @param[in] first : index of the first sample to decode
+ * @param[in] count : number of samples
+ * @param[out] out : receives count values
+ */
+void scope_decode_f(const struct scope_channel_t *ch, const void *data, int stride, int first, int count, float *out);
+
 /** @ingroup scope
  * update the scope.
  * If the scope must sample, then it samples.
@@ -158,4 +319,33 @@ int scope_max_samples(scope_t *self);
  */
 void scope_update(scope_t *self, n_t n);
 
+/** @ingroup scope
+ * start streaming the signals selected by scope_setup().
+ * @details The buffer becomes a lock-free single-producer / single-consumer ring of frames: scope_update() (the
+ * producer) writes one frame per sample, and never blocks nor allocates. If the ring is full, the frame is dropped
+ * and overruns is incremented. The frames are handed to cb by scope_stream_drain(), either called by the user or
+ * by a consumer thread.
+ * @param[in] self : pointer to the scope_t sctuct
+ * @param[in] cb : consumer callback
+ * @param[in] arg : argument passed to cb
+ * @param[in] thread : if non-zero, a consumer thread calls scope_stream_drain() until scope_stream_stop(). Requires @SCOPE_STREAM_THREAD
+ * @return 0 on success, -1 if the buffer cannot hold a frame or the thread cannot be created
+ */
+int scope_stream_start(scope_t *self, scope_stream_cb cb, void *arg, int thread);
+
+/** @ingroup scope
+ * hand the frames written so far to the consumer callback, and release them.
+ * @details Must only be called by one consumer at a time: the user, or the consumer thread.
+ * @param[in] self : pointer to the scope_t sctuct
+ * @return the number of frames consumed
+ */
+int scope_stream_drain(scope_t *self);
+
+/** @ingroup scope
+ * stop streaming: the consumer thread (if any) is joined, the remaining frames are drained, and the scope goes
+ * back to @SCOPE_INIT. Must be called from the producer's thread (the one calling scope_update()).
+ * @param[in] self : pointer to the scope_t sctuct
+ */
+void scope_stream_stop(scope_t *self);
+
 #endif
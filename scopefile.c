@@ -0,0 +1,271 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY
+{
+	
+}
+
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include "scopefile.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+/**
+ * @brief channel type in a capture file, and size (in bytes) of its values
+ */
+static const struct {
+	enum scope_file_type_t type;
+	int bytes;
+} scope_file_types[] = {
+	[SCOPE_FMT_RAW] = {SCOPE_FILE_FLOAT32, sizeof(float)},		// or SCOPE_FILE_INT32 for a signal_int
+	[SCOPE_FMT_INT8] = {SCOPE_FILE_INT8, sizeof(int8_t)},
+	[SCOPE_FMT_INT16] = {SCOPE_FILE_INT16, sizeof(int16_t)},
+	[SCOPE_FMT_FLOAT16] = {SCOPE_FILE_FLOAT16, sizeof(int16_t)},
+	[SCOPE_FMT_DELTA16] = {SCOPE_FILE_DELTA16, sizeof(int16_t)},
+};
+
+/** size of the header and channel table, padded to SCOPE_FILE_ALIGN */
+#define SCOPE_FILE_HEAD_BYTES(channels) \
+	((sizeof(struct scope_file_header) + (channels) * sizeof(struct scope_file_channel) + SCOPE_FILE_ALIGN - 1) / SCOPE_FILE_ALIGN * SCOPE_FILE_ALIGN)
+
+int scope_file_write(scope_t *self, int fd)
+{
+	char head[SCOPE_FILE_HEAD_BYTES(2 * SCOPE_MAX_SIGNALS)] __attribute__((aligned(8)));
+	struct scope_file_header *header = (struct scope_file_header*)head;
+	struct scope_file_channel *channel = (struct scope_file_channel*)(header + 1);
+	struct scope_channel_t *ch = self->channel;
+	struct iovec iov[2];
+	int channels = 0, i, iovcnt;
+	ssize_t len;
+
+	if((self->state != SCOPE_SAMPLED) && (self->state != SCOPE_SAMPLING))
+	{
+		errno = EBUSY;				// armed, triggered or streaming: the buffer is circular
+		return -1;
+	}
+
+	memset(head, 0, sizeof(head));
+	#if(SCOPE_USE_INT)
+		for(i=0; i<self->signals_count_int; i++, channels++)
+		{
+			#if(SIG_DBG_NAME)
+				memcpy(channel[channels].name, SIG_NAME(self->signals_int[i]), strnlen(SIG_NAME(self->signals_int[i]), SCOPE_FILE_NAME_LENGTH - 1));
+			#endif
+		}
+	#endif
+	#if(SCOPE_USE_FLOAT)
+		for(i=0; i<self->signals_count_float; i++, channels++)
+		{
+			#if(SIG_DBG_NAME)
+				memcpy(channel[channels].name, SIG_NAME(self->signals_float[i]), strnlen(SIG_NAME(self->signals_float[i]), SCOPE_FILE_NAME_LENGTH - 1));
+			#endif
+		}
+	#endif
+	for(i=0; i<channels; i++, ch++)
+	{
+		channel[i].type = scope_file_types[ch->format.type].type;
+		if((ch->format.type == SCOPE_FMT_RAW) && ch->is_int)
+			channel[i].type = SCOPE_FILE_INT32;
+		channel[i].offset = ch->pos;
+		channel[i].scale = ch->format.scale;
+		channel[i].value_offset = ch->format.offset;
+		channel[i].base = ch->base;
+	}
+
+	memcpy(header->magic, SCOPE_FILE_MAGIC, sizeof(header->magic));
+	header->version = SCOPE_FILE_VERSION;
+	header->bom = SCOPE_FILE_BOM;
+	header->data_offset = SCOPE_FILE_HEAD_BYTES(channels);
+	header->channels = channels;
+	header->samples = self->samples;
+	header->frame_bytes = self->sample_bytes;
+	header->prediv = self->prediv;
+	header->n_first = self->n_first;
+	if(self->trig.type != SCOPE_TRIG_NONE)
+	{
+		header->trig_index = self->trig_index;
+		header->trig_n = self->trig_n;
+	}
+
+	// header and samples in one system call, straight from the scope buffer
+	iov[0].iov_base = head;
+	iov[0].iov_len = header->data_offset;
+	iov[1].iov_base = self->buffer;
+	iov[1].iov_len = (size_t)header->samples * header->frame_bytes;
+	iovcnt = 2;
+	while(iovcnt)
+	{
+		len = writev(fd, iov + 2 - iovcnt, iovcnt);
+		if(len < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		// short write: skip what was written
+		for(i=2-iovcnt; (i<2) && (len >= (ssize_t)iov[i].iov_len); i++)
+		{
+			len -= iov[i].iov_len;
+			iovcnt--;
+		}
+		if(iovcnt)
+		{
+			iov[i].iov_base = (char*)iov[i].iov_base + len;
+			iov[i].iov_len -= len;
+		}
+	}
+	return 0;
+}
+
+
+int scope_file_save(scope_t *self, const char *path)
+{
+	int fd, ret;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return -1;
+	ret = scope_file_write(self, fd);
+	if(close(fd))
+		ret = -1;
+	return ret;
+}
+
+
+/**
+ * @brief size (in bytes) of a value of the channel type
+ */
+static int scope_file_bytes(uint32_t type)
+{
+	unsigned int i;
+
+	for(i=0; i<sizeof(scope_file_types)/sizeof(scope_file_types[0]); i++)
+		if(scope_file_types[i].type == type)
+			return scope_file_types[i].bytes;
+	return sizeof(int);									// SCOPE_FILE_INT32
+}
+
+
+int scope_file_open(struct scope_file *self, const char *path)
+{
+	const struct scope_file_header *header;
+	struct stat st;
+	uint32_t i;
+	int fd;
+
+	memset(self, 0, sizeof(struct scope_file));
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return -1;
+	if(fstat(fd, &st) || (st.st_size < (off_t)sizeof(struct scope_file_header)))
+	{
+		close(fd);
+		return -1;
+	}
+	self->size = st.st_size;
+	self->map = mmap(NULL, self->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(self->map == MAP_FAILED)
+	{
+		self->map = NULL;
+		return -1;
+	}
+
+	header = (const struct scope_file_header*)self->map;
+	if(memcmp(header->magic, SCOPE_FILE_MAGIC, sizeof(header->magic))
+			|| (header->version != SCOPE_FILE_VERSION)
+			|| (header->bom != SCOPE_FILE_BOM)
+			|| (header->data_offset < sizeof(struct scope_file_header) + (uint64_t)header->channels * sizeof(struct scope_file_channel))
+			|| ((uint64_t)header->data_offset + (uint64_t)header->samples * header->frame_bytes > self->size))
+	{
+		scope_file_close(self);
+		return -1;
+	}
+	self->header = header;
+	self->channel = (const struct scope_file_channel*)(header + 1);
+	self->data = (const char*)self->map + header->data_offset;
+	for(i=0; i<header->channels; i++)
+	{
+		if((self->channel[i].type < SCOPE_FILE_INT32) || (self->channel[i].type > SCOPE_FILE_DELTA16)
+				|| ((uint64_t)self->channel[i].offset + scope_file_bytes(self->channel[i].type) > header->frame_bytes))
+		{
+			scope_file_close(self);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+void scope_file_close(struct scope_file *self)
+{
+	if(self->map)
+		munmap(self->map, self->size);
+	memset(self, 0, sizeof(struct scope_file));
+}
+
+
+int scope_file_find(const struct scope_file *self, const char *name)
+{
+	uint32_t i;
+
+	for(i=0; i<self->header->channels; i++)
+		if(strncmp(self->channel[i].name, name, SCOPE_FILE_NAME_LENGTH) == 0)
+			return i;
+	return -1;
+}
+
+
+const void *scope_file_channel(const struct scope_file *self, int channel)
+{
+	if((channel < 0) || (channel >= (int)self->header->channels))
+		return NULL;
+	return self->data + self->channel[channel].offset;
+}
+
+
+int scope_file_read_f(const struct scope_file *self, int channel, int first, int count, float *out)
+{
+	const struct scope_file_channel *file_ch;
+	struct scope_channel_t ch;
+	unsigned int i;
+
+	if((channel < 0) || (channel >= (int)self->header->channels) || (first < 0) || (count < 0)
+			|| ((uint64_t)first + count > self->header->samples))
+		return -1;
+
+	// decode as the scope does, with the storage of the channel rebuilt from the file
+	file_ch = &self->channel[channel];
+	memset(&ch, 0, sizeof(ch));
+	for(i=0; i<sizeof(scope_file_types)/sizeof(scope_file_types[0]); i++)
+		if(scope_file_types[i].type == file_ch->type)
+			ch.format.type = i;
+	ch.is_int = file_ch->type == SCOPE_FILE_INT32;
+	ch.format.scale = file_ch->scale;
+	ch.format.offset = file_ch->value_offset;
+	ch.pos = file_ch->offset;
+	ch.base = file_ch->base;
+	scope_decode_f(&ch, self->data, self->header->frame_bytes, first, count, out);
+	return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file scopefile.h
+ * Scope capture file Header
+ */
+
+#ifndef SIG_SCOPEFILE_H__
+#define SIG_SCOPEFILE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "scope.h"
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup scope
+ * @brief Length (in chars) of a channel name in a capture file
+ */
+#if !defined(SCOPE_FILE_NAME_LENGTH) || defined(__DOXYGEN__)
+	#define SCOPE_FILE_NAME_LENGTH	64
+#endif
+
+/** @} */
+
+#define SCOPE_FILE_MAGIC		"SIGSCOPE"		//!< first 8 bytes of a capture file
+#define SCOPE_FILE_VERSION		2				//!< version of the capture file format. 2: quantized channels
+#define SCOPE_FILE_BOM			0x01020304		//!< byte order mark: the file is written in the byte order of the host
+#define SCOPE_FILE_ALIGN		64				//!< the sample data starts on a multiple of SCOPE_FILE_ALIGN bytes
+
+/** @ingroup scope
+ * @brief sample type of a channel in a capture file
+ */
+enum scope_file_type_t {
+	SCOPE_FILE_INT32 = 1,						//!< int, from a signal_int
+	SCOPE_FILE_FLOAT32 = 2,						//!< float, from a signal_float
+	SCOPE_FILE_INT8 = 3,						//!< SCOPE_FMT_INT8: x = code * scale + value_offset
+	SCOPE_FILE_INT16 = 4,						//!< SCOPE_FMT_INT16: x = code * scale + value_offset
+	SCOPE_FILE_FLOAT16 = 5,						//!< SCOPE_FMT_FLOAT16: IEEE 754 half precision
+	SCOPE_FILE_DELTA16 = 6,						//!< SCOPE_FMT_DELTA16: int16 differences of the codes, starting from base
+};
+
+/** @ingroup scope
+ * @struct scope_file_header
+ * @brief header of a capture file
+ * @details A capture file is:
+ * -# this header
+ * -# channels times struct scope_file_channel
+ * -# padding up to data_offset
+ * -# samples frames of frame_bytes bytes. A frame holds one value per channel, at the channel offset, as in scope_t::buffer
+ * (each channel in its storage format, without padding)
+ */
+struct scope_file_header {
+	char magic[8];								//!< SCOPE_FILE_MAGIC
+	uint32_t version;							//!< SCOPE_FILE_VERSION
+	uint32_t bom;								//!< SCOPE_FILE_BOM
+	uint32_t data_offset;						//!< offset (in bytes) of the first frame
+	uint32_t channels;							//!< number of channels
+	uint32_t samples;							//!< number of frames
+	uint32_t frame_bytes;						//!< size of a frame: stride between two samples of a channel
+	uint32_t prediv;							//!< sampling predivisor: frame i was sampled at n = n_first + i * prediv
+	uint32_t trig_index;						//!< index of the trigger frame. 0 if the capture was not triggered
+	uint64_t n_first;							//!< n of the first frame
+	uint64_t trig_n;							//!< n of the trigger frame. 0 if the capture was not triggered
+};
+
+/** @ingroup scope
+ * @struct scope_file_channel
+ * @brief description of a channel in a capture file
+ */
+struct scope_file_channel {
+	char name[SCOPE_FILE_NAME_LENGTH];			//!< name of the signal, '\0' terminated. Empty if SIG_DBG_NAME is FALSE
+	uint32_t type;								//!< enum scope_file_type_t
+	uint32_t offset;							//!< offset (in bytes) of the channel in a frame
+	float scale;								//!< quantized types: value of a code step
+	float value_offset;							//!< quantized types: value of the code 0
+	int32_t base;								//!< SCOPE_FILE_DELTA16: code before the first frame
+	uint32_t reserved;							//!< 0
+};
+
+/** @ingroup scope
+ * @struct scope_file
+ * @brief a capture file opened by scope_file_open()
+ */
+struct scope_file {
+	void *map;									//!< file mapping
+	size_t size;								//!< size of the mapping
+	const struct scope_file_header *header;		//!< header of the file
+	const struct scope_file_channel *channel;	//!< channels of the file
+	const char *data;							//!< first frame
+};
+
+/** @ingroup scope
+ * write the capture of a scope into a file, in a single writev() from the scope buffer
+ * @details the scope should be @SCOPE_SAMPLED. The samples collected so far are written otherwise.
+ * @param[in] self : pointer to the scope_t sctuct
+ * @param[in] fd : file descriptor to write to
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int scope_file_write(scope_t *self, int fd);
+
+/** @ingroup scope
+ * same as scope_file_write(), creating (or truncating) the file path
+ */
+int scope_file_save(scope_t *self, const char *path);
+
+/** @ingroup scope
+ * map a capture file and check its header
+ * @param[out] self : the opened file
+ * @param[in] path : file name
+ * @return 0 on success, -1 if the file cannot be mapped or is not a valid capture file
+ */
+int scope_file_open(struct scope_file *self, const char *path);
+
+/** @ingroup scope
+ * unmap a capture file
+ */
+void scope_file_close(struct scope_file *self);
+
+/** @ingroup scope
+ * returns the index of the channel called name, or -1
+ */
+int scope_file_find(const struct scope_file *self, const char *name);
+
+/** @ingroup scope
+ * returns a pointer to the first sample of a channel, without copying
+ * @details sample i of the channel is at ((const char*)ptr + i * self->header->frame_bytes)
+ * @param[in] self : the opened file
+ * @param[in] channel : channel index
+ * @return pointer to a value of the channel type (int, float, int8_t or int16_t codes...). NULL if channel is out of range
+ */
+const void *scope_file_channel(const struct scope_file *self, int channel);
+
+/** @ingroup scope
+ * decode samples of a channel, whatever its type
+ * @param[in] self : the opened file
+ * @param[in] channel : channel index
+ * @param[in] first : index of the first sample
+ * @param[in] count : number of samples
+ * @param[out] out : receives count values
+ * @return 0 on success, -1 if the channel or the samples are out of range
+ */
+int scope_file_read_f(const struct scope_file *self, int channel, int first, int count, float *out);
+
+#endif
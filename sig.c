@@ -26,11 +26,61 @@
 #include <string.h>
 #include "sig.h"
 
-int sig_errno = 0;
-void *sig_err_ptr = NULL;
+SIG_THREAD int sig_errno = 0;
+SIG_THREAD void *sig_err_ptr = NULL;
 
 #if SIG_DBG_NAME
-char sig_err_name[SIG_DBG_NAME_LENGHT] = "";
+SIG_THREAD const char *sig_err_name = "";
 #endif
 
 
+void sig_err_save(struct sig_err_state *state)
+{
+	state->err = sig_errno;
+	state->err_ptr = sig_err_ptr;
+#if SIG_DBG_NAME
+	state->err_name = sig_err_name;
+#else
+	state->err_name = NULL;
+#endif
+}
+
+
+void sig_err_restore(const struct sig_err_state *state)
+{
+	sig_errno = state->err;
+	sig_err_ptr = state->err_ptr;
+#if SIG_DBG_NAME
+	sig_err_name = state->err_name;
+#endif
+}
+
+
+void sig_ctx_clear(struct sig_ctx *ctx)
+{
+	ctx->err = 0;
+	ctx->err_ptr = NULL;
+	ctx->err_name = NULL;
+}
+
+
+int sig_ctx_collect(struct sig_ctx *ctx)
+{
+	ctx->ticks++;
+	if (sig_errno == 0)
+		return ctx->err;
+	ctx->errors++;
+	if (ctx->err == 0)
+	{
+		ctx->err = sig_errno;
+		ctx->err_ptr = sig_err_ptr;
+#if SIG_DBG_NAME
+		ctx->err_name = sig_err_name;
+#endif
+	}
+	sig_errno = 0;
+	sig_err_ptr = NULL;
+	return ctx->err;
+}
+
+
@@ -68,6 +68,22 @@
 #define SIG_SEARCH	TRUE							//!< If TRUE, enables search operations on arrays and lists of signals.
 #endif
 
+#if !defined(SIG_BLOCK) || defined(__DOXYGEN__)
+#define SIG_BLOCK	TRUE							//!< If TRUE, signals carry an optional block evaluation function (xb). Set to FALSE to save data space
+#endif
+
+#if !defined(SIG_BLOCK_CHUNK) || defined(__DOXYGEN__)
+#define SIG_BLOCK_CHUNK		64						//!< Number of samples a block sig-func processes at once (size of its stack buffers)
+#endif
+
+#if !defined(SIG_MAX_SOURCES) || defined(__DOXYGEN__)
+#define SIG_MAX_SOURCES		5						//!< Maximum number of source signals of a sig-func known by the graph compiler
+#endif
+
+#if !defined(SIG_TLS) || defined(__DOXYGEN__)
+#define SIG_TLS		TRUE							//!< If TRUE, sig_errno, sig_err_ptr and sig_err_name are thread-local. Set to FALSE on targets without TLS
+#endif
+
 /** Specify the type of 'n'. @warning default is @c unsigned @c int . Changing this for any other thing should be done carefully and checking all used sig-func is recommended! */
 typedef unsigned int n_t;
 
@@ -77,13 +93,35 @@ typedef unsigned int n_t;
 /** @addtogroup siglib
  * @{
  */
-extern int sig_errno;								//!< last Error number. If non-zero, all signals exit returning 0
-extern void *sig_err_ptr;							//!< points to the signal struct that had error
+#if SIG_TLS || defined(__DOXYGEN__)
+#define SIG_THREAD	__thread						//!< storage class of the error state
+#else
+#define SIG_THREAD
+#endif
+
+extern SIG_THREAD int sig_errno;					//!< last Error number of the calling thread. If non-zero, all signals exit returning 0
+extern SIG_THREAD void *sig_err_ptr;				//!< points to the signal struct that had error
 
-#if defined(SIG_DBG_NAME) || defined(__DOXYGEN__)
-extern char sig_err_name[SIG_DBG_NAME_LENGHT];		//!< name of the signal that had an error
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+extern SIG_THREAD const char *sig_err_name;			//!< name of the signal that had an error, "" if unnamed. See SIG_NAME()
 #endif
 
+/**
+ * @struct sig_ctx
+ * @brief evaluation context of a graph or of an executor worker
+ * @details Holds the error state of its own evaluations, so that graphs evaluated concurrently don't share any
+ * error state. The context is 64-byte aligned to avoid false sharing with its neighbours.
+ * @see sig_ctx_collect
+ */
+struct sig_ctx {
+	int err;											//!< first Error number, 0 if none. Evaluation stops until cleared by sig_ctx_clear()
+	void *err_ptr;										//!< points to the signal struct that had error
+	const char *err_name;								//!< name of the signal that had an error, NULL if SIG_DBG_NAME is FALSE
+	n_t n;												//!< n of the last evaluation
+	unsigned long ticks;								//!< number of evaluations
+	unsigned long errors;								//!< number of evaluations that ended with an error
+} __attribute__((aligned(64)));
+
 /** @brief returns 1 if 'n' is valid in the signal *sig 's N-Window
  * @see n-Window
  */
@@ -95,6 +133,45 @@ extern char sig_err_name[SIG_DBG_NAME_LENGHT];		//!< name of the signal that had
 #define SIG_ERR_NO_SELF			-1					//!< the signal pointer was not passed correctly to the function
 #define SIG_ERR_NO_CONFIG		-2					//!< the signal should contain parameters, but it's pointer is NULL
 #define SIG_ERR_NWINDOW			-3					//!< 'n' was out of the signal's N-validity windows
+#define SIG_ERR_CYCLE			-4					//!< the graph contains a cycle
+#define SIG_ERR_FULL			-5					//!< not enough memory was given to hold the result
+#define SIG_ERR_UNSUPPORTED		-6					//!< the signal can't be handled by the function (e.g. sig-func unknown to the code generator)
+
+/**
+ * @struct sig_err_state
+ * @brief copy of the error state of the calling thread, see sig_err_save()
+ */
+struct sig_err_state {
+	int err;											//!< sig_errno
+	void *err_ptr;										//!< sig_err_ptr
+	const char *err_name;								//!< sig_err_name, NULL if SIG_DBG_NAME is FALSE
+};
+
+/**
+ * @brief save the error state of the calling thread
+ * @details Used by the functions evaluating signals into their own context (graphs, executors...), so that the
+ * error state of the caller is left untouched: they save it on entry, and restore it with sig_err_restore() on exit.
+ */
+void sig_err_save(struct sig_err_state *state);
+
+/**
+ * @brief restore the error state of the calling thread saved by sig_err_save()
+ */
+void sig_err_restore(const struct sig_err_state *state);
+
+/**
+ * @brief clear the error state of a context
+ */
+void sig_ctx_clear(struct sig_ctx *ctx);
+
+/**
+ * @brief move the error state of the calling thread into a context
+ * @details Called after an evaluation on ctx. If sig_errno is set, it is stored in ctx (unless ctx already holds an
+ * error) and the thread error state is cleared. ctx->ticks and ctx->errors are updated.
+ * @param[in,out] ctx evaluation context
+ * @return ctx->err
+ */
+int sig_ctx_collect(struct sig_ctx *ctx);
 
 /**
  * @def SIG_ERRNO_FAIL
@@ -110,13 +187,13 @@ extern char sig_err_name[SIG_DBG_NAME_LENGHT];		//!< name of the signal that had
  * @def SIG_ERRNO(a)
  * @brief end function and fill errno
  * @details Called by a signal evaluation function (*x) on error.
- * Fills the sig_errno variable and copies signal's name in sig_err_name (if SIG_DBG_NAME is defined).
+ * Fills the sig_errno variable and points sig_err_name to the signal's name (if SIG_DBG_NAME is defined).
  * Returns 0
  * @pre should be called from (*x) function
  */
 #if SIG_DBG_NAME || defined(__DOXYGEN__)
 	#define SIG_ERRNO(a) {sig_errno = a; \
-	strcpy(sig_err_name, self->name); \
+	sig_err_name = SIG_NAME(self); \
 	sig_err_ptr = self; \
 	return 0;}
 #else
@@ -125,49 +202,130 @@ extern char sig_err_name[SIG_DBG_NAME_LENGHT];		//!< name of the signal that had
 	return 0;}
 #endif
 
+/**
+ * @def SIG_ERRNO_STEP(a)
+ * @brief end step function and fill errno
+ * @details Same as SIG_ERRNO(a), for the step functions of compiled graphs, which return nothing.
+ * @pre should be called from a step function, with @c self in scope
+ */
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	#define SIG_ERRNO_STEP(a) {sig_errno = a; \
+	sig_err_name = SIG_NAME(self); \
+	sig_err_ptr = self; \
+	return;}
+#else
+	#define SIG_ERRNO_STEP(a) {sig_errno = a; \
+	sig_err_ptr = self; \
+	return;}
+#endif
+
 /**
  * generic macro to get the value of a signal. It's advantage is that it's type independent and inline so this should help with speed.
  */
 #define sig_value(s,n) (sig_errno !=0 ? 0 : ( (s)->x != NULL ? (s)->x((s), n) : ( (s)->x_var ? *((s)->x_var) : (s)->x_cst ) ) )
 
+/**
+ * @def SIG_ERRNO_FAIL_BLOCK
+ * @brief Checks if an error occurred, block version
+ * @details Same as SIG_ERRNO_FAIL, but for block evaluation functions (*xb): the output block is filled with 0.
+ * @pre should be called from (*xb) function, with @c out and @c count in scope
+ */
+#define SIG_ERRNO_FAIL_BLOCK if(sig_errno) { \
+	memset(out, 0, count * sizeof(*out)); \
+	return;}
+
+/**
+ * @def SIG_ERRNO_BLOCK(a)
+ * @brief end block function and fill errno
+ * @details Same as SIG_ERRNO(a), but for block evaluation functions (*xb): the output block is filled with 0.
+ * @pre should be called from (*xb) function, with @c out and @c count in scope
+ */
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	#define SIG_ERRNO_BLOCK(a) {sig_errno = a; \
+	sig_err_name = SIG_NAME(self); \
+	sig_err_ptr = self; \
+	memset(out, 0, count * sizeof(*out)); \
+	return;}
+#else
+	#define SIG_ERRNO_BLOCK(a) {sig_errno = a; \
+	sig_err_ptr = self; \
+	memset(out, 0, count * sizeof(*out)); \
+	return;}
+#endif
+
 
 /** @} */
 
 /** @ingroup float
  * @struct signal_float
  * @brief structure representing a floating-point signal
+ * @details The fields used by the evaluation (x, x_var, x_cst, params) come first and fit in 32 bytes. The name is
+ * only a pointer, at the end of the structure, so that it doesn't take cache space in the evaluation path.
+ * @n On 64-bit targets, the whole structure is 48 bytes with SIG_BLOCK and SIG_DBG_NAME (xb and name follow the 32
+ * bytes of the evaluation fields), 40 bytes with only one of them, and 32 bytes without both.
  */
 struct signal_float {
-#if SIG_DBG_NAME || defined(__DOXYGEN__)
-	char name[SIG_DBG_NAME_LENGHT];						//!< name of the signal
-#endif
 	float (*x)(struct signal_float *self, n_t n);		//!< pointer to the evaluation function (*x)
 	float *x_var;										//!< points to a variable. used if x == NULL
 	float x_cst;										//!< constant value. used if x == NULL && x_var == NULL
 	void *params;										//!< points to the signal parameter(s), if any.
+#if SIG_BLOCK || defined(__DOXYGEN__)
+	void (*xb)(struct signal_float *self, n_t n, int count, float *out);	//!< optional block evaluation function. Evaluates x[n] to x[n + count - 1] into out. Used by sig_get_block_f() if not NULL
+#endif
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	const char *name;									//!< name of the signal, NULL if unnamed. String literal or sig_name_intern()
+#endif
 };
 typedef float (*sig_func_f)(struct signal_float *self, n_t n);
+typedef void (*sig_block_func_f)(struct signal_float *self, n_t n, int count, float *out);
 
 /** @ingroup int
  * @struct signal_int
  * @brief structure representing an integer signal
+ * @details same layout as signal_float
  */
 struct signal_int {
-#if SIG_DBG_NAME || defined(__DOXYGEN__)
-	char name[SIG_DBG_NAME_LENGHT];						//!< name of the signal
-#endif
 	int (*x)(struct signal_int *self, n_t n);			//!< pointer to the evaluation function (*x)
 	int *x_var;											//!< points to a variable. used if x == NULL
 	int x_cst;											//!< constant value. used if x == NULL && x_var == NULL
 	void *params;										//!< points to the signal parameter(s), if any.
+#if SIG_BLOCK || defined(__DOXYGEN__)
+	void (*xb)(struct signal_int *self, n_t n, int count, int *out);	//!< optional block evaluation function. Evaluates x[n] to x[n + count - 1] into out. Used by sig_get_block_i() if not NULL
+#endif
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	const char *name;									//!< name of the signal, NULL if unnamed. String literal or sig_name_intern()
+#endif
+};
+typedef int (*sig_func_i)(struct signal_int *self, n_t n);
+typedef void (*sig_block_func_i)(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup siglib
+ * @brief FIR dot product kernels, see sig_fir_kernel_f() and sig_fir_kernel_q()
+ */
+enum sig_fir_kernel_t {
+	SIG_FIR_KERNEL_AUTO,								//!< best kernel supported by the CPU
+	SIG_FIR_KERNEL_C,									//!< portable C
+	SIG_FIR_KERNEL_SSE,									//!< x86 SSE (SSE2 for the fixed-point kernel)
+	SIG_FIR_KERNEL_AVX2,								//!< x86 AVX2 + FMA (AVX2 for the fixed-point kernel)
+	SIG_FIR_KERNEL_AVX512,								//!< x86 AVX-512F (AVX-512BW for the fixed-point kernel)
 };
 
 #define SIG_FN(a,b) {.x=a, .x_var=NULL, .x_cst=0, .params=(void*)b}
 #define SIG_PTR(a) {.x=NULL, .x_var=a, .x_cst=0, .params=NULL}
 #define SIG_CST(a) {.x=NULL, .x_var=NULL, .x_cst=a, .params=NULL}
 
+/**
+ * name of a signal, "" if unnamed
+ */
+#define SIG_NAME(s) ((s)->name ? (s)->name : "")
+
 #define SIGN_FN(n,a,b) {.name=n, .x=a, .x_var=NULL, .x_cst=0, .params=(void*)b}
 #define SIGN_PTR(n,a) {.name=n, .x=NULL, .x_var=a, .x_cst=0, .params=NULL}
 #define SIGN_CST(n,a) {.name=n, .x=NULL, .x_var=NULL, .x_cst=a, .params=NULL}
 
+#if SIG_BLOCK || defined(__DOXYGEN__)
+#define SIG_FNB(a,ab,b) {.x=a, .x_var=NULL, .x_cst=0, .params=(void*)b, .xb=ab}
+#define SIGN_FNB(n,a,ab,b) {.name=n, .x=a, .x_var=NULL, .x_cst=0, .params=(void*)b, .xb=ab}
+#endif
+
 #endif
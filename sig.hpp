@@ -0,0 +1,406 @@
+/**
+ * SigLib, simple Signals Library
+ *
+ * Copyright (C) 2013 Charles-Henri Mousset
+ *
+ * This file is part of SigLib.
+ *
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file sig.hpp
+ * SigLib Header, C++17 expression templates for graphs known at compile time
+ */
+
+#ifndef SIG_HPP__
+#define SIG_HPP__
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "sig.h"
+#include "sigf.h"
+}
+
+// sig.h defines min and max as macros, which would break the standard C++ headers included after this one
+#undef min
+#undef max
+
+
+/** @ingroup expr
+ * @brief expression templates
+ * @details A graph is written as an expression, such as
+ * @code{.cpp}
+ auto g = sig::pid(sig::buf(setpoint, len) - sig::buf(measure, len), gains, sig::buf(ff, len));
+ float y = g(n);
+ @endcode
+ * Each node of the expression is a small struct holding its state and its operands by value: the whole graph is a
+ * single struct, and its evaluation is one function the compiler inlines completely (no function pointer, no
+ * params cast, no memoization check).
+ * @n An expression is a tree: it must be evaluated once per n, for consecutive n. An operand used twice is copied,
+ * together with its state; share a signal through the sig::from() and sig::to_signal() adapters instead.
+ * @n The values are the ones of the equivalent sig-func.
+ */
+namespace sig {
+
+/** @ingroup expr
+ * @brief base of the expression nodes
+ */
+struct expr {};
+
+/** @ingroup expr
+ * @brief true if T is an expression node
+ */
+template<class T>
+inline constexpr bool is_expr_v = std::is_base_of_v<expr, std::decay_t<T>>;
+
+/** @ingroup expr
+ * @brief constant, see SIG_CST()
+ */
+struct cst : expr {
+	float value;
+
+	constexpr explicit cst(float v) : value(v) {}
+	float operator()(n_t) const { return value; }
+};
+
+/** @ingroup expr
+ * @brief variable read at each evaluation, see SIG_PTR()
+ */
+struct var : expr {
+	const float *ptr;
+
+	constexpr explicit var(const float &v) : ptr(&v) {}
+	float operator()(n_t) const { return *ptr; }
+};
+
+/** @ingroup expr
+ * @brief buffer reader, see sig_buf_read_f()
+ * @details Circular: index = (n + delta) % size. Otherwise the output sticks at the last value of the buffer.
+ */
+template<bool Circular>
+struct buf_expr : expr {
+	const float *buffer;
+	n_t size;
+	n_t delta;
+
+	float operator()(n_t n) const
+	{
+		n_t i = n + delta;
+
+		if constexpr (Circular)
+			return buffer[i % size];
+		else
+			return buffer[i < size - 1 ? i : size - 1];
+	}
+};
+
+/** @ingroup expr
+ * @brief buffer reader, sticking at the last value
+ */
+inline buf_expr<false> buf(const float *buffer, int size, int delta = 0)
+{
+	return {{}, buffer, (n_t)size, (n_t)delta};
+}
+
+/** @ingroup expr
+ * @brief circular buffer reader
+ */
+inline buf_expr<true> buf_circular(const float *buffer, int size, int delta = 0)
+{
+	return {{}, buffer, (n_t)size, (n_t)delta};
+}
+
+/** @ingroup expr
+ * @brief adapter from a signal_float: the signal is evaluated with sig_value(), so it keeps its memoization and
+ * can be shared with other signals
+ */
+struct from : expr {
+	struct signal_float *signal;
+
+	constexpr explicit from(struct signal_float &s) : signal(&s) {}
+	float operator()(n_t n) const { return sig_value(signal, n); }
+};
+
+/** @ingroup expr
+ * @brief operands: expressions are kept by value, numbers become a cst
+ */
+template<class T>
+constexpr auto operand(T &&x)
+{
+	if constexpr (is_expr_v<T>)
+		return std::decay_t<T>(std::forward<T>(x));
+	else
+		return cst((float)x);
+}
+
+template<class T>
+using operand_t = decltype(operand(std::declval<T>()));
+
+/** @ingroup expr
+ * @brief binary operation. a is evaluated before b, like the sources of a sig-func
+ */
+template<class Op, class A, class B>
+struct binary : expr {
+	A a;
+	B b;
+
+	float operator()(n_t n)
+	{
+		float x = a(n);
+
+		return Op::apply(x, b(n));
+	}
+};
+
+struct add_op { static float apply(float x, float y) { return x + y; } };
+struct sub_op { static float apply(float x, float y) { return x - y; } };
+struct mul_op { static float apply(float x, float y) { return x * y; } };
+struct div_op { static float apply(float x, float y) { return x / y; } };
+
+/** @ingroup expr
+ * @brief negation
+ */
+template<class A>
+struct neg : expr {
+	A a;
+
+	float operator()(n_t n) { return -a(n); }
+};
+
+/** at least one operand is an expression: the other one can be a number */
+template<class A, class B>
+inline constexpr bool is_binary_v = (is_expr_v<A> || is_expr_v<B>) &&
+	(is_expr_v<A> || std::is_arithmetic_v<std::decay_t<A>>) && (is_expr_v<B> || std::is_arithmetic_v<std::decay_t<B>>);
+
+#define SIG_HPP_BINARY(op, name) \
+	template<class A, class B, std::enable_if_t<is_binary_v<A, B>, int> = 0> \
+	constexpr auto operator op(A &&a, B &&b) \
+	{ \
+		return binary<name, operand_t<A>, operand_t<B>>{{}, operand(std::forward<A>(a)), operand(std::forward<B>(b))}; \
+	}
+
+SIG_HPP_BINARY(+, add_op)
+SIG_HPP_BINARY(-, sub_op)
+SIG_HPP_BINARY(*, mul_op)
+SIG_HPP_BINARY(/, div_op)
+
+#undef SIG_HPP_BINARY
+
+template<class A, std::enable_if_t<is_expr_v<A>, int> = 0>
+constexpr auto operator-(A &&a)
+{
+	return neg<std::decay_t<A>>{{}, std::forward<A>(a)};
+}
+
+/** @ingroup expr
+ * @brief IIR Low Pass 1st order filter, see sig_iirlp1_f()
+ */
+template<class A>
+struct iirlp1_expr : expr {
+	A x;
+	float a;											//!< damping factor
+	float oma;											//!< 1 - a
+	float y;											//!< last output
+
+	float operator()(n_t n)
+	{
+		y = (y * oma) + (x(n) * a);
+		return y;
+	}
+};
+
+/** @ingroup expr
+ * @brief IIR Low Pass 1st order filter of x, y[n] = y[n-1] * (1 - a) + x[n] * a
+ */
+template<class A>
+constexpr auto iirlp1(A &&x, float a)
+{
+	return iirlp1_expr<operand_t<A>>{{}, operand(std::forward<A>(x)), a, 1 - a, 0};
+}
+
+/** @ingroup expr
+ * @brief gains of a PID, see sig_pid_param_f
+ */
+struct pid_gains {
+	float p;											//!< Proportional gain
+	float i;											//!< Integral gain
+	float d;											//!< Derivative gain
+	float max_output;									//!< output limit. Also used for anti-windup
+	float ff[3];										//!< Feed-Forward gains
+};
+
+/** @ingroup expr
+ * @brief missing Feed-Forward term of a PID
+ */
+struct none : expr {
+	float operator()(n_t) const { return 0; }
+};
+
+/** @ingroup expr
+ * @brief PID controller, optimized form, with up to 3 Feed-Forward terms. See sig_pid_opt_f()
+ */
+template<class E, class F0 = none, class F1 = none, class F2 = none>
+struct pid_expr : expr {
+	E error;
+	F0 ff0;
+	F1 ff1;
+	F2 ff2;
+	float ff[3];										//!< Feed-Forward gains
+	float k[3];											//!< K-params, see sig_pid_compute_k_f()
+	float max_output;									//!< output limit
+	float integral;										//!< integral term
+	float history[3];									//!< history of the error
+
+	/** clamp to [-max_output; max_output], as sig_pid_limit_f() */
+	float limit(float x) const
+	{
+		if (x > max_output)
+			return max_output;
+		else if (x < (-1 * max_output))
+			return -1 * max_output;
+		return x;
+	}
+
+	float operator()(n_t n)
+	{
+		float x;
+
+		history[2] = history[1];
+		history[1] = history[0];
+		history[0] = error(n);
+		integral += history[0] * k[0];
+		integral += history[1] * k[1];
+		integral += history[2] * k[2];
+		integral = limit(integral);
+		x = integral;
+		if constexpr (!std::is_same_v<F0, none>)
+			x += ff0(n) * ff[0];
+		if constexpr (!std::is_same_v<F1, none>)
+			x += ff1(n) * ff[1];
+		if constexpr (!std::is_same_v<F2, none>)
+			x += ff2(n) * ff[2];
+		return limit(x);
+	}
+};
+
+/** @ingroup expr
+ * @brief PID controller of the error, with the Feed-Forward terms ff (up to 3) weighted by gains.ff
+ */
+template<class E, class... F>
+constexpr auto pid(E &&error, const pid_gains &gains, F &&... ff)
+{
+	static_assert(sizeof...(F) <= 3, "a PID has up to 3 Feed-Forward terms");
+	pid_expr<operand_t<E>, operand_t<F>...> x{{}, operand(std::forward<E>(error)), operand(std::forward<F>(ff))...};
+
+	x.ff[0] = gains.ff[0];
+	x.ff[1] = gains.ff[1];
+	x.ff[2] = gains.ff[2];
+	x.k[0] = gains.p + gains.i + gains.d;
+	x.k[1] = -1 * gains.p - 2 * gains.d;
+	x.k[2] = gains.d;
+	x.max_output = gains.max_output;
+	x.integral = 0;
+	x.history[0] = x.history[1] = x.history[2] = 0;
+	return x;
+}
+
+/** @ingroup expr
+ * @brief evaluate count consecutive samples of an expression, from n to n + count - 1
+ * @details the state is copied to a local during the loop: the compiler keeps it in registers, as out can't alias it
+ */
+template<class E>
+void run(E &e, n_t n, int count, float *out)
+{
+	E local = e;
+
+	for (int i=0; i<count; i++)
+		out[i] = local(n + i);
+	e = local;
+}
+
+/** @ingroup expr
+ * @brief adapter to a signal_float: the expression can be the source of any sig-func
+ * @details The signal memoizes its value (n_last), and provides a block function. It points to the node, which can't
+ * be copied nor moved: create it with sig::to_signal().
+ */
+template<class E>
+class node {
+public:
+	struct signal_float signal;							//!< the signal to give to the C sig-func
+
+	explicit node(E e) : signal(), expr_(std::move(e)), n_last_(0)
+	{
+		signal.x = &node::x;
+#if SIG_BLOCK
+		signal.xb = &node::xb;
+#endif
+		signal.params = this;
+	}
+	node(const node &) = delete;
+	node &operator=(const node &) = delete;
+
+	/** the expression, with its state */
+	E &expression() { return expr_; }
+
+private:
+	E expr_;
+	n_t n_last_;
+
+	static float x(struct signal_float *self, n_t n)
+	{
+		node *ptr = static_cast<node *>(self->params);
+		SIG_ERRNO_FAIL
+
+		if (n == ptr->n_last_)
+			return self->x_cst;
+		self->x_cst = ptr->expr_(n);
+		ptr->n_last_ = n;
+		return self->x_cst;
+	}
+
+	static void xb(struct signal_float *self, n_t n, int count, float *out)
+	{
+		node *ptr = static_cast<node *>(self->params);
+		SIG_ERRNO_FAIL_BLOCK
+
+		if (count > 0 && n == ptr->n_last_)
+		{
+			*out++ = self->x_cst;
+			n++;
+			count--;
+		}
+		if (count <= 0)
+			return;
+		run(ptr->expr_, n, count, out);
+		self->x_cst = out[count - 1];
+		ptr->n_last_ = n + count - 1;
+	}
+};
+
+/** @ingroup expr
+ * @brief make a signal_float adapter of an expression. Use: auto s = sig::to_signal(expr); then &s.signal
+ */
+template<class E>
+node<std::decay_t<E>> to_signal(E &&e)
+{
+	return node<std::decay_t<E>>(std::forward<E>(e));
+}
+
+}	// namespace sig
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigds.c
+ * SigLib Code, memory-mapped columnar datasets
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sigds.h"
+
+/** offset of the first column, or size of a column, padded to SIG_DS_ALIGN */
+#define SIG_DS_PAD(bytes)	(((uint64_t)(bytes) + SIG_DS_ALIGN - 1) / SIG_DS_ALIGN * SIG_DS_ALIGN)
+
+
+/**
+ * @brief write all of buf at offset, retrying short writes
+ */
+static int sig_ds_pwrite(int fd, const void *buf, size_t len, off_t offset)
+{
+	ssize_t ret;
+
+	while(len)
+	{
+		ret = pwrite(fd, buf, len, offset);
+		if(ret < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf = (const char*)buf + ret;
+		len -= ret;
+		offset += ret;
+	}
+	return 0;
+}
+
+
+int sig_ds_write_f(const char *path, const char * const *names, const float * const *data, int count, size_t length)
+{
+	size_t head_bytes = sizeof(struct sig_ds_header) + count * sizeof(struct sig_ds_column);
+	struct sig_ds_header *header;
+	struct sig_ds_column *column;
+	uint64_t offset = SIG_DS_PAD(head_bytes);
+	int fd, i, ret = 0;
+
+	header = calloc(1, head_bytes);
+	if(header == NULL)
+		return -1;
+	column = (struct sig_ds_column*)(header + 1);
+	memcpy(header->magic, SIG_DS_MAGIC, sizeof(header->magic));
+	header->version = SIG_DS_VERSION;
+	header->bom = SIG_DS_BOM;
+	header->columns = count;
+	header->align = SIG_DS_ALIGN;
+	header->length = length;
+	for(i=0; i<count; i++)
+	{
+		memcpy(column[i].name, names[i], strnlen(names[i], SIG_DS_NAME_LENGTH - 1));
+		column[i].type = SIG_DS_FLOAT32;
+		column[i].offset = offset;
+		offset += SIG_DS_PAD(length * sizeof(float));
+	}
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+	{
+		free(header);
+		return -1;
+	}
+	// the padding is left as a hole
+	if(ftruncate(fd, offset) || sig_ds_pwrite(fd, header, head_bytes, 0))
+		ret = -1;
+	for(i=0; (i<count) && (ret == 0); i++)
+		ret = sig_ds_pwrite(fd, data[i], length * sizeof(float), column[i].offset);
+	if(close(fd))
+		ret = -1;
+	free(header);
+	return ret;
+}
+
+
+int sig_ds_open(struct sig_ds *self, const char *path)
+{
+	const struct sig_ds_header *header;
+	struct stat st;
+	uint32_t i;
+	int fd;
+
+	memset(self, 0, sizeof(struct sig_ds));
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return -1;
+	if(fstat(fd, &st) || (st.st_size < (off_t)sizeof(struct sig_ds_header)))
+	{
+		close(fd);
+		return -1;
+	}
+	self->size = st.st_size;
+	self->map = mmap(NULL, self->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(self->map == MAP_FAILED)
+	{
+		self->map = NULL;
+		return -1;
+	}
+	madvise(self->map, self->size, MADV_SEQUENTIAL);
+
+	header = (const struct sig_ds_header*)self->map;
+	if(memcmp(header->magic, SIG_DS_MAGIC, sizeof(header->magic))
+			|| (header->version != SIG_DS_VERSION)
+			|| (header->bom != SIG_DS_BOM)
+			|| (header->length > self->size)
+			|| (sizeof(struct sig_ds_header) + (uint64_t)header->columns * sizeof(struct sig_ds_column) > self->size))
+	{
+		sig_ds_close(self);
+		return -1;
+	}
+	self->header = header;
+	self->column = (const struct sig_ds_column*)(header + 1);
+	for(i=0; i<header->columns; i++)
+	{
+		if((self->column[i].offset % sizeof(float))
+				|| (self->column[i].offset > self->size)
+				|| (header->length * sizeof(float) > self->size - self->column[i].offset))
+		{
+			sig_ds_close(self);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+void sig_ds_close(struct sig_ds *self)
+{
+	if(self->map)
+		munmap(self->map, self->size);
+	memset(self, 0, sizeof(struct sig_ds));
+}
+
+
+int sig_ds_find(const struct sig_ds *self, const char *name)
+{
+	uint32_t i;
+
+	for(i=0; i<self->header->columns; i++)
+		if(strncmp(self->column[i].name, name, SIG_DS_NAME_LENGTH) == 0)
+			return i;
+	return -1;
+}
+
+
+const float *sig_ds_column_f(const struct sig_ds *self, int column)
+{
+	if((column < 0) || ((uint32_t)column >= self->header->columns) || (self->column[column].type != SIG_DS_FLOAT32))
+		return NULL;
+	return (const float*)((const char*)self->map + self->column[column].offset);
+}
+
+
+int sig_ds_buf_read_f(const struct sig_ds *self, const char *name, struct sig_buf_read_param_f *param)
+{
+	const float *data = sig_ds_column_f(self, sig_ds_find(self, name));
+
+	if((data == NULL) || (self->header->length == 0) || (self->header->length > INT_MAX))
+		return -1;
+	param->buffer = (float*)data;						// sig_buf_read_f() only reads the buffer
+	param->size = self->header->length;
+	return 0;
+}
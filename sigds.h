@@ -0,0 +1,151 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigds.h
+ * SigLib Header, memory-mapped columnar datasets
+ */
+
+#ifndef SIG_DS_H__
+#define SIG_DS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sig.h"
+#include "sigf.h"
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup dataset
+ * @brief Length (in chars) of a column name in a dataset file
+ */
+#if !defined(SIG_DS_NAME_LENGTH) || defined(__DOXYGEN__)
+	#define SIG_DS_NAME_LENGTH		64
+#endif
+
+/** @ingroup dataset
+ * @brief alignment (in bytes) of the columns in a dataset file. Must be a multiple of the page size
+ */
+#if !defined(SIG_DS_ALIGN) || defined(__DOXYGEN__)
+	#define SIG_DS_ALIGN			4096
+#endif
+
+/** @} */
+
+#define SIG_DS_MAGIC			"SIGDSET"		//!< first 8 bytes of a dataset file (including the '\0')
+#define SIG_DS_VERSION			1				//!< version of the dataset file format
+#define SIG_DS_BOM				0x01020304		//!< byte order mark: the file is written in the byte order of the host
+
+/** @ingroup dataset
+ * @brief value type of a column
+ */
+enum sig_ds_type_t {
+	SIG_DS_FLOAT32 = 2,							//!< float. Same value as SCOPE_FILE_FLOAT32
+};
+
+/** @ingroup dataset
+ * @struct sig_ds_header
+ * @brief header of a dataset file
+ * @details A dataset file is:
+ * -# this header
+ * -# columns times struct sig_ds_column
+ * -# the columns, each one a contiguous array starting on a multiple of align bytes
+ */
+struct sig_ds_header {
+	char magic[8];								//!< SIG_DS_MAGIC
+	uint32_t version;							//!< SIG_DS_VERSION
+	uint32_t bom;								//!< SIG_DS_BOM
+	uint32_t columns;							//!< number of columns
+	uint32_t align;								//!< alignment of the columns (SIG_DS_ALIGN of the writer)
+	uint64_t length;							//!< number of values of each column
+};
+
+/** @ingroup dataset
+ * @struct sig_ds_column
+ * @brief description of a column in a dataset file
+ */
+struct sig_ds_column {
+	char name[SIG_DS_NAME_LENGTH];				//!< name of the column, '\0' terminated
+	uint32_t type;								//!< enum sig_ds_type_t
+	uint32_t reserved;							//!< 0
+	uint64_t offset;							//!< offset (in bytes) of the first value, from the start of the file
+};
+
+/** @ingroup dataset
+ * @struct sig_ds
+ * @brief a dataset file opened by sig_ds_open()
+ */
+struct sig_ds {
+	void *map;									//!< file mapping
+	size_t size;								//!< size of the mapping
+	const struct sig_ds_header *header;			//!< header of the file
+	const struct sig_ds_column *column;			//!< columns of the file
+};
+
+/** @ingroup dataset
+ * @brief write float columns into a dataset file
+ * @param[in] path file name. Created, or truncated
+ * @param[in] names count column names. Truncated to SIG_DS_NAME_LENGTH - 1 chars
+ * @param[in] data count columns of length floats
+ * @param[in] count number of columns
+ * @param[in] length number of values of each column
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int sig_ds_write_f(const char *path, const char * const *names, const float * const *data, int count, size_t length);
+
+/** @ingroup dataset
+ * @brief map a dataset file and check its header
+ * @details Only the header is read: the columns are paged in from the page cache as they are read, so opening
+ * takes the same time whatever the size of the dataset. The mapping is advised as sequential.
+ * @param[out] self the opened file
+ * @param[in] path file name
+ * @return 0 on success, -1 if the file cannot be mapped or is not a valid dataset file
+ */
+int sig_ds_open(struct sig_ds *self, const char *path);
+
+/** @ingroup dataset
+ * @brief unmap a dataset file. The pointers to its columns become invalid
+ */
+void sig_ds_close(struct sig_ds *self);
+
+/** @ingroup dataset
+ * @brief returns the index of the column called name, or -1
+ */
+int sig_ds_find(const struct sig_ds *self, const char *name);
+
+/** @ingroup dataset
+ * @brief returns a pointer to the values of a float column, without copying
+ * @return header->length floats, or NULL if the column is out of range or is not a float column
+ */
+const float *sig_ds_column_f(const struct sig_ds *self, int column);
+
+/** @ingroup dataset
+ * @brief point a buffer reader to a float column, without copying
+ * @details buffer and size are set, the other parameters are left untouched. The buffer is read-only.
+ * @param[in] self the opened file
+ * @param[in] name column name
+ * @param[out] param buffer reader parameters
+ * @return 0 on success, -1 if there is no such float column, or if it is empty or too long for a buffer reader
+ */
+int sig_ds_buf_read_f(const struct sig_ds *self, const char *name, struct sig_buf_read_param_f *param);
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file sigexec.c
+ * SigLib Code, multi-core executor of compiled graphs
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "sigexec.h"
+
+
+/**
+ * @brief sense-reversing barrier: spins, then yields, until all the workers reached it
+ */
+static void sig_exec_barrier(struct sig_exec *self, struct sig_exec_worker *worker)
+{
+	int spin = 0;
+
+	worker->sense = !worker->sense;
+	if (__atomic_add_fetch(&self->tick.waiting, 1, __ATOMIC_ACQ_REL) == self->workers)
+	{
+		__atomic_store_n(&self->tick.waiting, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&self->tick.sense, worker->sense, __ATOMIC_RELEASE);
+		return;
+	}
+	while (__atomic_load_n(&self->tick.sense, __ATOMIC_ACQUIRE) != worker->sense)
+		if (++spin > SIG_EXEC_SPIN)
+			sched_yield();
+}
+
+
+static void sig_exec_tick(struct sig_exec_worker *worker, n_t n)
+{
+	struct sig_graph_node *node = worker->nodes;
+	struct sig_graph_node *end = worker->nodes + worker->count;
+
+	for (; node < end; node++)
+		node->step(node, n);
+}
+
+
+static void *sig_exec_thread(void *arg)
+{
+	struct sig_exec_worker *worker = (struct sig_exec_worker *)arg;
+	struct sig_exec *self = worker->exec;
+
+#if defined(__linux__)
+	if (worker->cpu >= 0)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(worker->cpu, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	}
+#endif
+	for (;;)
+	{
+		sig_exec_barrier(self, worker);					// wait for the tick start
+		if (self->tick.stop)
+			return NULL;
+		sig_exec_tick(worker, self->tick.n);
+		sig_ctx_collect(&worker->ctx);
+		sig_exec_barrier(self, worker);					// tick done
+	}
+}
+
+
+int sig_exec_init(struct sig_exec *self, struct sig_graph *graph, int workers, const int *cpus)
+{
+	int *component, *size, *order, *fill;
+	int i, j, k, best, ret = 0;
+
+	memset(self, 0, sizeof(*self));
+	if ((workers < 1) || (workers > SIG_EXEC_MAX_WORKERS))
+		return SIG_ERR_FULL;
+	self->workers = workers;
+
+	component = malloc((graph->count + 1) * sizeof(int));
+	size = calloc(graph->count + 1, sizeof(int));
+	order = malloc((graph->count + 1) * sizeof(int));
+	fill = calloc(workers, sizeof(int));
+	if ((component == NULL) || (size == NULL) || (order == NULL) || (fill == NULL))
+		ret = SIG_ERR_FULL;
+	else
+		self->components = sig_graph_components(graph, component);
+	if (self->components < 0)
+		ret = self->components;
+
+	if (ret == 0)
+	{
+		// sort the components, largest first (stable, so the assignment is deterministic)
+		for (i=0; i<graph->count; i++)
+			size[component[i]]++;
+		for (i=0; i<self->components; i++)
+		{
+			for (j=i; (j>0) && (size[order[j-1]] < size[i]); j--)
+				order[j] = order[j-1];
+			order[j] = i;
+		}
+
+		// assign each component to the least loaded worker. order[] now maps component -> worker
+		for (i=0; i<self->components; i++)
+		{
+			for (best=0, k=1; k<workers; k++)
+				if (self->worker[k].count < self->worker[best].count)
+					best = k;
+			self->worker[best].count += size[order[i]];
+			size[order[i]] = best;
+		}
+
+		// copy the entries of each worker, in schedule order
+		for (k=0; k<workers; k++)
+		{
+			self->worker[k].exec = self;
+			self->worker[k].cpu = (k == 0) ? -1 : (cpus ? cpus[k] : k);
+			self->worker[k].nodes = aligned_alloc(64, (self->worker[k].count * sizeof(struct sig_graph_node) + 63) / 64 * 64 + 64);
+			if (self->worker[k].nodes == NULL)
+				ret = SIG_ERR_FULL;
+		}
+		for (i=0; (i<graph->count) && (ret == 0); i++)
+		{
+			k = size[component[i]];
+			self->worker[k].nodes[fill[k]++] = graph->nodes[i];
+		}
+	}
+
+	free(component);
+	free(size);
+	free(order);
+	free(fill);
+
+	if (ret)
+	{
+		self->workers = 1;								// no worker thread started
+		sig_exec_free(self);
+		return ret;
+	}
+
+	for (k=1; k<workers; k++)
+		if (pthread_create(&self->worker[k].thread, NULL, sig_exec_thread, &self->worker[k]))
+		{
+			self->workers = k;							// only stop the started workers
+			sig_exec_free(self);
+			return SIG_ERR_FULL;
+		}
+	return 0;
+}
+
+
+int sig_exec_run(struct sig_exec *self, n_t n)
+{
+	struct sig_exec_worker *worker;
+	struct sig_err_state saved;
+	int k, failed = 0;
+
+	if (self->ctx.err)
+		return self->ctx.err;
+	self->ctx.n = n;
+	self->tick.n = n;
+	sig_err_save(&saved);								// error state of the caller, restored on exit
+	sig_errno = 0;
+	sig_exec_barrier(self, &self->worker[0]);			// start the tick
+	sig_exec_tick(&self->worker[0], n);
+	sig_ctx_collect(&self->worker[0].ctx);
+	sig_exec_barrier(self, &self->worker[0]);			// wait for all the workers
+	sig_err_restore(&saved);
+
+	// the workers are waiting for the next tick: their context can be read and cleared
+	for (k=0; k<self->workers; k++)
+	{
+		worker = &self->worker[k];
+		if (worker->ctx.err == 0)
+			continue;
+		if (failed++ == 0)
+		{
+			self->ctx.err = worker->ctx.err;
+			self->ctx.err_ptr = worker->ctx.err_ptr;
+			self->ctx.err_name = worker->ctx.err_name;
+		}
+		sig_ctx_clear(&worker->ctx);
+	}
+	self->ctx.ticks++;
+	if (failed)
+		self->ctx.errors++;
+	return self->ctx.err;
+}
+
+
+void sig_exec_free(struct sig_exec *self)
+{
+	int k;
+
+	if (self->workers > 1)
+	{
+		self->tick.stop = 1;
+		sig_exec_barrier(self, &self->worker[0]);		// release the workers, which see stop
+		for (k=1; k<self->workers; k++)
+			pthread_join(self->worker[k].thread, NULL);
+	}
+	for (k=0; k<SIG_EXEC_MAX_WORKERS; k++)
+	{
+		free(self->worker[k].nodes);
+		self->worker[k].nodes = NULL;
+	}
+	self->workers = 0;
+}
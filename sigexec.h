@@ -0,0 +1,126 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file sigexec.h
+ * SigLib Header, multi-core executor of compiled graphs
+ */
+
+#ifndef SIG_EXEC_H__
+#define SIG_EXEC_H__
+
+#include <pthread.h>
+#include "siggraph.h"
+
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup exec
+ * @brief Maximum number of workers of an executor
+ */
+#if !defined(SIG_EXEC_MAX_WORKERS) || defined(__DOXYGEN__)
+	#define SIG_EXEC_MAX_WORKERS	64
+#endif
+
+/** @ingroup exec
+ * @brief Number of polls of the tick barrier before a waiting worker yields its CPU
+ */
+#if !defined(SIG_EXEC_SPIN) || defined(__DOXYGEN__)
+	#define SIG_EXEC_SPIN			4096
+#endif
+
+/** @} */
+
+
+struct sig_exec;
+
+/** @ingroup exec
+ * @struct sig_exec_worker
+ * @brief state of one worker. Each worker has its own cache lines
+ */
+struct sig_exec_worker {
+	struct sig_exec *exec;								//!< executor the worker belongs to
+	struct sig_graph_node *nodes;						//!< private copy of the schedule entries evaluated by this worker
+	int count;											//!< number of entries in nodes
+	int cpu;											//!< CPU the worker is pinned to, -1 if not pinned
+	int sense;											//!< barrier sense of the worker
+	pthread_t thread;									//!< worker thread (unused for worker 0, the calling thread)
+	struct sig_ctx ctx;									//!< error state and statistics of the entries evaluated by this worker
+} __attribute__((aligned(64)));
+
+
+/** @ingroup exec
+ * @struct sig_exec
+ * @brief executor evaluating the independent subgraphs of a compiled graph on a pool of workers
+ */
+struct sig_exec {
+	struct sig_exec_worker worker[SIG_EXEC_MAX_WORKERS];	//!< workers. worker[0] is the thread calling sig_exec_run()
+	int workers;										//!< number of workers
+	int components;										//!< number of independent subgraphs
+	struct {
+		volatile n_t n;									//!< n of the current tick
+		volatile int stop;								//!< set to stop the workers
+		int waiting;									//!< number of workers that reached the barrier
+		int sense;										//!< current sense of the barrier
+	} tick __attribute__((aligned(64)));				//!< tick shared state, on its own cache line
+	struct sig_ctx ctx;									//!< evaluation context: first error of all the workers, and statistics of sig_exec_run()
+};
+
+
+/** @ingroup exec
+ * @brief setup an executor and start its workers
+ * @details The graph is split into independent components with sig_graph_components(). Components are
+ * assigned whole to the workers, largest first, each to the least loaded worker. Each worker evaluates its
+ * components in the schedule order, so the results are identical to sig_graph_run().
+ * @n A graph holding a signal evaluated through (*x) (undescribed sig-func, or integer signal) is a single component,
+ * evaluated by one worker.
+ * @n The executor must be 64-byte aligned (static, automatic or aligned_alloc() storage).
+ * @n Each worker collects its errors in its own context. sig_exec_run() gathers them into the executor context
+ * (ctx): the error state of the calling thread (sig_errno) is left untouched.
+ * @pre sig_graph_compile() succeeded. The graph must not be recompiled while the executor runs
+ * @param[out] self pointer to the executor
+ * @param[in] graph compiled graph
+ * @param[in] workers number of workers, including the calling thread (1 to SIG_EXEC_MAX_WORKERS)
+ * @param[in] cpus CPU to pin each worker to, or NULL to pin worker i to CPU i. Worker 0 is the calling thread, and is not pinned
+ * @return 0 on success, SIG_ERR_FULL if workers is out of range or resources can't be allocated
+ */
+int sig_exec_init(struct sig_exec *self, struct sig_graph *graph, int workers, const int *cpus);
+
+
+/** @ingroup exec
+ * @brief evaluate all the signals of the graph at n, on all the workers
+ * @details returns when every worker completed the tick. If several workers had an error, ctx keeps the one of the
+ * lowest worker. Once an error occurred, the graph is not evaluated anymore until sig_ctx_clear() is called on ctx.
+ * @param[in] self pointer to the executor
+ * @param[in] n the value of n
+ * @return ctx.err. If it is non-zero when the function is called, no signal is evaluated
+ */
+int sig_exec_run(struct sig_exec *self, n_t n);
+
+
+/** @ingroup exec
+ * @brief stop the workers and free the executor resources
+ */
+void sig_exec_free(struct sig_exec *self);
+
+#endif
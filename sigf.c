@@ -23,8 +23,16 @@
  * SigLib Code
  */
 
+#include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "sigf.h"
+#include "siggraph.h"
+
+#if SIG_FIR_SIMD && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIG_FIR_X86		TRUE
+#include <immintrin.h>
+#endif
 
 
 float sig_get_value_f(struct signal_float *self, n_t n)
@@ -38,6 +46,50 @@ float sig_get_value_f(struct signal_float *self, n_t n)
 }
 
 
+void sig_get_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	int i;
+	float value;
+
+	SIG_ERRNO_FAIL_BLOCK
+#if SIG_BLOCK
+	if(self->xb)
+	{
+		self->xb(self, n, count, out);
+		return;
+	}
+#endif
+	if(self->x)
+	{
+		for(i=0; i<count; i++)
+			out[i] = sig_value(self, n + i);
+		return;
+	}
+	value = self->x_var ? *self->x_var : self->x_cst;
+	for(i=0; i<count; i++)
+		out[i] = value;
+}
+
+
+/**
+ * @brief fill a block with the values of an operand that can be a signal, a variable or a constant
+ */
+static void sig_operand_block_f(struct signal_float *sig, float *var, float cst, n_t n, int count, float *out)
+{
+	int i;
+
+	if(sig)
+	{
+		sig_get_block_f(sig, n, count, out);
+		return;
+	}
+	if(var)
+		cst = *var;
+	for(i=0; i<count; i++)
+		out[i] = cst;
+}
+
+
 float sig_sampler_f(struct signal_float *self, n_t n)
 {
 	SIG_ERRNO_FAIL
@@ -89,19 +141,1614 @@ float sig_add_f(struct signal_float *self, n_t n)
 	else
 		b = ptr->b_cst;
 	self->x_cst = a+b;
+	ptr->n_last = n;
 	return self->x_cst;
 }
 
+
+void sig_add_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_add_param_f *ptr;
+	float b[SIG_BLOCK_CHUNK];
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_add_param_f*)self->params;
+
+	if (count > 0 && ptr->n_last == n)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_operand_block_f(ptr->a, ptr->a_var, ptr->a_cst, n, len, out);
+		SIG_ERRNO_FAIL_BLOCK
+		sig_operand_block_f(ptr->b, ptr->b_var, ptr->b_cst, n, len, b);
+		SIG_ERRNO_FAIL_BLOCK
+		for (i=0; i<len; i++)
+			out[i] += b[i];
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+#define SIG_RAMP_LANES			8						// samples computed at once by sig_interpolate_lin_block_f()
+
+/**
+ * @brief value of the ramp at n. p is incremented if n - delay advanced by one since the last call
+ */
+static inline float sig_interpolate_lin_core_f(struct sig_interpolate_lin_param_f *ptr, n_t n)
+{
+	n_t t = n - ptr->delay;
+	double ma;
+	int e;
+
+	if ((t - 1 != ptr->t_last) || (t - 1 >= ptr->t_max) || (ptr->a != ptr->a_last))
+	{
+		// closed form. a * t is exact as long as ma * t, ma being the integer mantissa of a, is below 2^53
+		ptr->a_last = ptr->a;
+		ma = ldexp(frexpf(ptr->a, &e), 24);
+		ptr->t_max = (fabs(ma) >= 1) ? (n_t)(ldexp(1, 53) / fabs(ma)) : (n_t)-1;	// 0 or NaN: any t
+		ptr->p = (double)ptr->a * t;
+	}
+	else
+		ptr->p += ptr->a;
+	ptr->t_last = t;
+	return (float)(ptr->p + ptr->b);
+}
+
+
 float sig_interpolate_lin_f(struct signal_float *self, n_t n)
 {
+	struct sig_interpolate_lin_param_f *ptr = (struct sig_interpolate_lin_param_f *) self->params;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	self->x_cst = sig_interpolate_lin_core_f(ptr, n);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_interpolate_lin_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_interpolate_lin_param_f *ptr;
+	double p[SIG_RAMP_LANES], step, b;
+	int i, j;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_interpolate_lin_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	out[0] = sig_interpolate_lin_core_f(ptr, n);
+	if ((ptr->t_last < ptr->t_max) && (ptr->t_max - ptr->t_last >= count - 1))
+	{
+		// every sample of the block is on the incremental path: p + i * a is exact, whatever the order
+		for (j=0; j<SIG_RAMP_LANES; j++)
+			p[j] = ptr->p + (double)ptr->a * (j + 1);
+		step = (double)ptr->a * SIG_RAMP_LANES;
+		b = ptr->b;
+		for (i=1; i+SIG_RAMP_LANES<=count; i+=SIG_RAMP_LANES)
+			for (j=0; j<SIG_RAMP_LANES; j++)
+			{
+				out[i + j] = (float)(p[j] + b);
+				p[j] += step;
+			}
+		for (j=0; i+j<count; j++)
+			out[i + j] = (float)(p[j] + b);
+		ptr->p += (double)ptr->a * (count - 1);
+		ptr->t_last += count - 1;
+	}
+	else
+		for (i=1; i<count; i++)
+			out[i] = sig_interpolate_lin_core_f(ptr, n + i);
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
+}
+
+float sig_iirlp1_f(struct signal_float *self, n_t n)
+{
+	struct sig_iirlp1_param_f *ptr = (struct sig_iirlp1_param_f *) self->params;
+	float source_value;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
 	
-	return 0.0;
+	source_value = sig_value(ptr->source, n);		//source_value = sig_get_value_f(ptr->source, n);
+
+	self->x_cst = (self->x_cst * ptr->oma) +  (source_value * ptr->a);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_iirlp1_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_iirlp1_param_f *ptr;
+	float y;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_iirlp1_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_get_block_f(ptr->source, n, len, out);					// the source is read in place
+		SIG_ERRNO_FAIL_BLOCK
+		y = self->x_cst;
+		for (i=0; i<len; i++)
+		{
+			y = (y * ptr->oma) +  (out[i] * ptr->a);
+			out[i] = y;
+		}
+		self->x_cst = y;
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+float sig_step_f(struct signal_float *self, n_t n)
+{
+	struct sig_step_param_f *ptr = (struct sig_step_param_f *)self->params;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (SIG_NWINDOW_VALID(n, ptr))
+		return ptr->x_active;
+	else
+		return ptr->x_inact;
+}
+
+
+void sig_step_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_step_param_f *ptr;
+	int i;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_step_param_f *)self->params;
+	for (i=0; i<count; i++, n++)
+		out[i] = SIG_NWINDOW_VALID(n, ptr) ? ptr->x_active : ptr->x_inact;
+}
+
+
+/***************************************************************************************/
+/*                              FIR dot product kernels                                */
+/***************************************************************************************/
+
+/**
+ * @brief portable kernel. len is a multiple of SIG_FIR_PAD
+ */
+static float sig_fir_dot_c(const float *taps, const float *x, int len)
+{
+	float acc[4] = {0, 0, 0, 0};
+	int i;
+
+	for (i=0; i<len; i+=4)
+	{
+		acc[0] += taps[i] * x[i];
+		acc[1] += taps[i+1] * x[i+1];
+		acc[2] += taps[i+2] * x[i+2];
+		acc[3] += taps[i+3] * x[i+3];
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#if defined(SIG_FIR_X86)
+__attribute__((target("sse")))
+static float sig_fir_dot_sse(const float *taps, const float *x, int len)
+{
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	float out[4];
+	int i;
+
+	for (i=0; i<len; i+=8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load_ps(taps + i), _mm_loadu_ps(x + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load_ps(taps + i + 4), _mm_loadu_ps(x + i + 4)));
+	}
+	_mm_storeu_ps(out, _mm_add_ps(acc0, acc1));
+	return (out[0] + out[1]) + (out[2] + out[3]);
+}
+
+__attribute__((target("avx2,fma")))
+static float sig_fir_dot_avx2(const float *taps, const float *x, int len)
+{
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	__m128 acc;
+	int i;
+
+	for (i=0; i<len; i+=16)
+	{
+		acc0 = _mm256_fmadd_ps(_mm256_load_ps(taps + i), _mm256_loadu_ps(x + i), acc0);
+		acc1 = _mm256_fmadd_ps(_mm256_load_ps(taps + i + 8), _mm256_loadu_ps(x + i + 8), acc1);
+	}
+	acc0 = _mm256_add_ps(acc0, acc1);
+	acc = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	return _mm_cvtss_f32(acc);
+}
+
+__attribute__((target("avx512f")))
+static float sig_fir_dot_avx512(const float *taps, const float *x, int len)
+{
+	__m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+	int i;
+
+	for (i=0; i+32<=len; i+=32)
+	{
+		acc0 = _mm512_fmadd_ps(_mm512_load_ps(taps + i), _mm512_loadu_ps(x + i), acc0);
+		acc1 = _mm512_fmadd_ps(_mm512_load_ps(taps + i + 16), _mm512_loadu_ps(x + i + 16), acc1);
+	}
+	if (i < len)
+		acc0 = _mm512_fmadd_ps(_mm512_load_ps(taps + i), _mm512_loadu_ps(x + i), acc0);
+	return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+#endif	// SIG_FIR_X86
+
+static float sig_fir_dot_auto(const float *taps, const float *x, int len);
+static void sig_fir_cmac_c(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len);
+static void sig_fir_cmac_auto(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len);
+#if defined(SIG_FIR_X86)
+static void sig_fir_cmac_avx2(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len);
+#endif
+
+/** kernel used by the mirrored FIR layout. Resolved on first use */
+static float (*sig_fir_dot)(const float *taps, const float *x, int len) = sig_fir_dot_auto;
+
+/** spectral product kernel used by sig_fir_long_f(). Resolved on first use */
+static void (*sig_fir_cmac)(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len) = sig_fir_cmac_auto;
+
+static float sig_fir_dot_auto(const float *taps, const float *x, int len)
+{
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+	return sig_fir_dot(taps, x, len);
+}
+
+int sig_fir_kernel_f(enum sig_fir_kernel_t kernel)
+{
+#if defined(SIG_FIR_X86)
+	__builtin_cpu_init();
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+	{
+		if (__builtin_cpu_supports("avx512f"))
+			kernel = SIG_FIR_KERNEL_AVX512;
+		else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			kernel = SIG_FIR_KERNEL_AVX2;
+		else if (__builtin_cpu_supports("sse"))
+			kernel = SIG_FIR_KERNEL_SSE;
+		else
+			kernel = SIG_FIR_KERNEL_C;
+	}
+	switch (kernel)
+	{
+		case SIG_FIR_KERNEL_C:
+			sig_fir_dot = sig_fir_dot_c;
+			sig_fir_cmac = sig_fir_cmac_c;
+			return 0;
+		case SIG_FIR_KERNEL_SSE:
+			if (!__builtin_cpu_supports("sse"))
+				return -1;
+			sig_fir_dot = sig_fir_dot_sse;
+			sig_fir_cmac = sig_fir_cmac_c;
+			return 0;
+		case SIG_FIR_KERNEL_AVX2:
+			if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+				return -1;
+			sig_fir_dot = sig_fir_dot_avx2;
+			sig_fir_cmac = sig_fir_cmac_avx2;
+			return 0;
+		case SIG_FIR_KERNEL_AVX512:
+			if (!__builtin_cpu_supports("avx512f"))
+				return -1;
+			sig_fir_dot = sig_fir_dot_avx512;
+			sig_fir_cmac = sig_fir_cmac_avx2;				// avx512f implies avx2 and fma
+			return 0;
+		default:
+			return -1;
+	}
+#else
+	if ((kernel != SIG_FIR_KERNEL_AUTO) && (kernel != SIG_FIR_KERNEL_C))
+		return -1;
+	sig_fir_dot = sig_fir_dot_c;
+	sig_fir_cmac = sig_fir_cmac_c;
+	return 0;
+#endif
+}
+
+
+int sig_fir_n_init_f(struct sig_fir_n_param_f *ptr, const float *taps, int tap_count)
+{
+	int length = (tap_count + SIG_FIR_PAD - 1) / SIG_FIR_PAD * SIG_FIR_PAD;
+	float *t, *x;
+
+	t = aligned_alloc(64, length * sizeof(float));
+	x = aligned_alloc(64, 2 * length * sizeof(float));
+	if ((t == NULL) || (x == NULL) || (tap_count <= 0))
+	{
+		free(t);
+		free(x);
+		return -1;
+	}
+	memset(t, 0, length * sizeof(float));
+	memcpy(t, taps, tap_count * sizeof(float));
+	memset(x, 0, 2 * length * sizeof(float));
+
+	ptr->tap_count = tap_count;
+	ptr->length = length;
+	ptr->index_last = 0;
+	ptr->taps = t;
+	ptr->samples = x;
+	return 0;
+}
+
+
+void sig_fir_n_free_f(struct sig_fir_n_param_f *ptr)
+{
+	free(ptr->taps);
+	free(ptr->samples);
+	ptr->taps = NULL;
+	ptr->samples = NULL;
+	ptr->length = 0;
+}
+
+
+/**
+ * @brief push a new input sample into a mirrored FIR history, without computing the filter output
+ */
+static inline void sig_fir_n_push_f(struct sig_fir_n_param_f *ptr, float x)
+{
+	// mirrored layout: x[n-i] is at samples[index_last + i] for 0 <= i < length
+	int index = ptr->index_last != 0 ? ptr->index_last - 1 : ptr->length - 1;
+
+	ptr->samples[index] = x;
+	ptr->samples[index + ptr->length] = x;
+	ptr->index_last = index;
+}
+
+
+/**
+ * @brief push a new input sample into the FIR history and compute the filter output
+ */
+static inline float sig_fir_n_core_f(struct sig_fir_n_param_f *ptr, float x)
+{
+	int i;
+	int index;
+	float y;
+
+	if (ptr->length)
+	{
+		sig_fir_n_push_f(ptr, x);
+		return sig_fir_dot(ptr->taps, ptr->samples + ptr->index_last, ptr->length);
+	}
+
+	ptr->samples[ptr->index_last++] = x;									// store the input into the buffer
+	ptr->index_last %= ptr->tap_count;										// make sure the index rollback
+	index = ptr->index_last;
+
+	y = 0;																	// this is the output of the filter, initialize it at 0
+	for (i=0; i< ptr->tap_count; i++)
+	{
+		index = index != 0 ? index - 1 : ptr->tap_count-1;
+		y += ptr->samples[i] * ptr->taps[index];							// MAC the samples by the taps
+	}
+	return y;
+}
+
+
+float sig_fir_n_f(struct signal_float *self, n_t n)
+{
+	struct sig_fir_n_param_f *ptr = (struct sig_fir_n_param_f *) self->params;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	self->x_cst = sig_fir_n_core_f(ptr, sig_value(ptr->source, n));
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_fir_n_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_fir_n_param_f *ptr;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_fir_n_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_get_block_f(ptr->source, n, len, out);					// the source is read in place
+		SIG_ERRNO_FAIL_BLOCK
+		for (i=0; i<len; i++)
+			out[i] = sig_fir_n_core_f(ptr, out[i]);
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+/***************************************************************************************/
+/*                              Long FIR, partitioned convolution                      */
+/***************************************************************************************/
+
+/**
+ * @brief portable spectral product kernel: acc += x * h, on len complex values. len is a multiple of 16
+ */
+static void sig_fir_cmac_c(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len)
+{
+	int k;
+
+	for (k=0; k<len; k++)
+	{
+		acc_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+		acc_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+	}
+}
+
+#if defined(SIG_FIR_X86)
+__attribute__((target("avx2,fma")))
+static void sig_fir_cmac_avx2(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len)
+{
+	__m256 ar, ai, xr, xi, hr, hi;
+	int k;
+
+	for (k=0; k<len; k+=8)
+	{
+		xr = _mm256_load_ps(x_re + k);
+		xi = _mm256_load_ps(x_im + k);
+		hr = _mm256_load_ps(h_re + k);
+		hi = _mm256_load_ps(h_im + k);
+		ar = _mm256_fmadd_ps(xr, hr, _mm256_load_ps(acc_re + k));
+		ai = _mm256_fmadd_ps(xr, hi, _mm256_load_ps(acc_im + k));
+		_mm256_store_ps(acc_re + k, _mm256_fnmadd_ps(xi, hi, ar));
+		_mm256_store_ps(acc_im + k, _mm256_fmadd_ps(xi, hr, ai));
+	}
+}
+#endif	// SIG_FIR_X86
+
+static void sig_fir_cmac_auto(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re,
+	const float *h_im, int len)
+{
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+	sig_fir_cmac(acc_re, acc_im, x_re, x_im, h_re, h_im, len);
+}
+
+
+int sig_fir_long_init_f(struct sig_fir_long_param_f *ptr, const float *taps, int tap_count, int block)
+{
+	int p, k, len, size;
+	float *mem;
+
+	ptr->tap_count = tap_count;
+	ptr->block = 0;
+	ptr->latency = 0;
+	ptr->fill = 0;
+	ptr->head = 0;
+	ptr->input = NULL;
+	ptr->direct.taps = ptr->direct.samples = NULL;
+	memset(&ptr->fft, 0, sizeof(ptr->fft));
+	if (tap_count <= 0)
+		return -1;
+	if (block == 0)
+	{
+		if (tap_count <= SIG_FIR_LONG_DIRECT)
+			return sig_fir_n_init_f(&ptr->direct, taps, tap_count);
+		for (block=64; block*SIG_FIR_LONG_PARTITIONS<tap_count; block*=2)
+			;
+	}
+	if ((block < 16) || (block & (block - 1)))
+		return -1;
+
+	ptr->partitions = (tap_count + block - 1) / block;
+	size = (7 + 4 * ptr->partitions) * block;
+	mem = aligned_alloc(64, size * sizeof(float));
+	if ((mem == NULL) || sig_fft_init(&ptr->fft, 2 * block))
+	{
+		free(mem);
+		return -1;
+	}
+	memset(mem, 0, size * sizeof(float));
+	ptr->block = block;
+	ptr->latency = block;
+	ptr->input = mem;
+	ptr->frame = mem + 2 * block;
+	ptr->output = mem + 4 * block;
+	ptr->acc_re = mem + 5 * block;
+	ptr->acc_im = mem + 6 * block;
+	ptr->taps_re = mem + 7 * block;
+	ptr->taps_im = ptr->taps_re + ptr->partitions * block;
+	ptr->fdl_re = ptr->taps_im + ptr->partitions * block;
+	ptr->fdl_im = ptr->fdl_re + ptr->partitions * block;
+
+	// spectra of the partitions, zero-padded to 2 * block. The 1 / (2 * block) of the inverse FFT is applied here
+	for (p=0; p<ptr->partitions; p++)
+	{
+		len = min(block, tap_count - p * block);
+		for (k=0; k<2*block; k++)
+			ptr->frame[k] = (k < len) ? taps[p * block + k] / (2 * block) : 0;
+		sig_fft_real(&ptr->fft, ptr->frame, ptr->taps_re + p * block, ptr->taps_im + p * block);
+	}
+	memset(ptr->frame, 0, 2 * block * sizeof(float));
+	return 0;
+}
+
+
+void sig_fir_long_free_f(struct sig_fir_long_param_f *ptr)
+{
+	free(ptr->input);
+	ptr->input = NULL;
+	sig_fft_free(&ptr->fft);
+	sig_fir_n_free_f(&ptr->direct);
+	ptr->block = 0;
+}
+
+
+/**
+ * @brief filter the last 2 * block inputs: the outputs of the block are computed
+ */
+static void sig_fir_long_process_f(struct sig_fir_long_param_f *ptr)
+{
+	int b = ptr->block;
+	int p, i;
+	float re0, im0;
+	const float *x_re, *x_im, *h_re, *h_im;
+
+	ptr->head = (ptr->head != 0) ? ptr->head - 1 : ptr->partitions - 1;
+	sig_fft_real(&ptr->fft, ptr->input, ptr->fdl_re + ptr->head * b, ptr->fdl_im + ptr->head * b);
+
+	memset(ptr->acc_re, 0, b * sizeof(float));
+	memset(ptr->acc_im, 0, b * sizeof(float));
+	for (p=0, i=ptr->head; p<ptr->partitions; p++, i = (i + 1 < ptr->partitions) ? i + 1 : 0)
+	{
+		// the input spectrum of p blocks ago, by the spectrum of the partition p
+		x_re = ptr->fdl_re + i * b;
+		x_im = ptr->fdl_im + i * b;
+		h_re = ptr->taps_re + p * b;
+		h_im = ptr->taps_im + p * b;
+		re0 = ptr->acc_re[0] + x_re[0] * h_re[0];					// DC and Nyquist bins are real
+		im0 = ptr->acc_im[0] + x_im[0] * h_im[0];
+		sig_fir_cmac(ptr->acc_re, ptr->acc_im, x_re, x_im, h_re, h_im, b);
+		ptr->acc_re[0] = re0;
+		ptr->acc_im[0] = im0;
+	}
+	sig_fft_real_inverse(&ptr->fft, ptr->acc_re, ptr->acc_im, ptr->frame);
+
+	// overlap-save: only the last block points are not aliased
+	memcpy(ptr->output, ptr->frame + b, b * sizeof(float));
+	memcpy(ptr->input, ptr->input + b, b * sizeof(float));
+}
+
+
+/**
+ * @brief filter len samples of x, in place
+ */
+static void sig_fir_long_core_f(struct sig_fir_long_param_f *ptr, float *x, int len)
+{
+	int i, k;
+	float t;
+
+	if (ptr->block == 0)
+	{
+		for (i=0; i<len; i++)
+			x[i] = sig_fir_n_core_f(&ptr->direct, x[i]);
+		return;
+	}
+	while (len > 0)
+	{
+		k = min(len, ptr->block - ptr->fill);
+		for (i=0; i<k; i++)
+		{
+			t = x[i];
+			x[i] = ptr->output[ptr->fill + i];
+			ptr->input[ptr->block + ptr->fill + i] = t;
+		}
+		ptr->fill += k;
+		x += k;
+		len -= k;
+		if (ptr->fill == ptr->block)
+		{
+			sig_fir_long_process_f(ptr);
+			ptr->fill = 0;
+		}
+	}
+}
+
+
+float sig_fir_long_f(struct signal_float *self, n_t n)
+{
+	struct sig_fir_long_param_f *ptr = (struct sig_fir_long_param_f *) self->params;
+	float x;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	x = sig_value(ptr->source, n);
+	sig_fir_long_core_f(ptr, &x, 1);
+	self->x_cst = x;
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_fir_long_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_fir_long_param_f *ptr;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_fir_long_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	sig_get_block_f(ptr->source, n, count, out);					// the source is read in place
+	SIG_ERRNO_FAIL_BLOCK
+	sig_fir_long_core_f(ptr, out, count);
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
+}
+
+
+/***************************************************************************************/
+/*                              Multirate FIR                                          */
+/***************************************************************************************/
+
+int sig_fir_decim_init_f(struct sig_fir_decim_param_f *ptr, const float *taps, int tap_count, int factor)
+{
+	int size;
+
+	ptr->input = NULL;
+	ptr->fir.taps = NULL;
+	ptr->fir.samples = NULL;
+	if (factor < 1)
+		return -1;
+	size = max(SIG_BLOCK_CHUNK / factor, 1) * factor;				// whole outputs per block
+	ptr->input = malloc(size * sizeof(float));
+	if ((ptr->input == NULL) || sig_fir_n_init_f(&ptr->fir, taps, tap_count))
+	{
+		free(ptr->input);
+		ptr->input = NULL;
+		return -1;
+	}
+	ptr->factor = factor;
+	ptr->input_size = size;
+	return 0;
+}
+
+
+void sig_fir_decim_free_f(struct sig_fir_decim_param_f *ptr)
+{
+	sig_fir_n_free_f(&ptr->fir);
+	free(ptr->input);
+	ptr->input = NULL;
+}
+
+
+/**
+ * @brief push factor inputs per output into the history, and compute the outputs
+ */
+static inline void sig_fir_decim_core_f(struct sig_fir_decim_param_f *ptr, const float *x, int count, float *out)
+{
+	int i, j;
+
+	for (i=0; i<count; i++)
+	{
+		for (j=0; j<ptr->factor; j++)
+			sig_fir_n_push_f(&ptr->fir, *x++);
+		out[i] = sig_fir_dot(ptr->fir.taps, ptr->fir.samples + ptr->fir.index_last, ptr->fir.length);
+	}
+}
+
+
+float sig_fir_decim_f(struct signal_float *self, n_t n)
+{
+	struct sig_fir_decim_param_f *ptr = (struct sig_fir_decim_param_f *) self->params;
+	n_t m;
+	int i;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	m = (n - 1) * ptr->factor + 1;									// first input of the output n
+	for (i=0; i<ptr->factor; i++)
+		ptr->input[i] = sig_value(ptr->source, m + i);
+	SIG_ERRNO_FAIL
+	sig_fir_decim_core_f(ptr, ptr->input, 1, &self->x_cst);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_fir_decim_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_fir_decim_param_f *ptr;
+	int len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_fir_decim_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, ptr->input_size / ptr->factor);
+		sig_get_block_f(ptr->source, (n - 1) * ptr->factor + 1, len * ptr->factor, ptr->input);
+		SIG_ERRNO_FAIL_BLOCK
+		sig_fir_decim_core_f(ptr, ptr->input, len, out);
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+int sig_fir_interp_init_f(struct sig_fir_interp_param_f *ptr, const float *taps, int tap_count, int factor)
+{
+	int length, i;
+	float *t, *x;
+
+	ptr->input = NULL;
+	ptr->fir.taps = NULL;
+	ptr->fir.samples = NULL;
+	if ((factor < 1) || (tap_count <= 0))
+		return -1;
+	length = ((tap_count + factor - 1) / factor + SIG_FIR_PAD - 1) / SIG_FIR_PAD * SIG_FIR_PAD;
+	t = aligned_alloc(64, factor * length * sizeof(float));
+	x = aligned_alloc(64, 2 * length * sizeof(float));
+	ptr->input = malloc(SIG_BLOCK_CHUNK * sizeof(float));
+	if ((t == NULL) || (x == NULL) || (ptr->input == NULL))
+	{
+		free(t);
+		free(x);
+		free(ptr->input);
+		ptr->input = NULL;
+		return -1;
+	}
+	memset(t, 0, factor * length * sizeof(float));
+	for (i=0; i<tap_count; i++)
+		t[(i % factor) * length + i / factor] = taps[i];				// phase p: taps p, p + factor...
+	memset(x, 0, 2 * length * sizeof(float));
+
+	ptr->factor = factor;
+	ptr->fir.tap_count = (tap_count + factor - 1) / factor;
+	ptr->fir.length = length;
+	ptr->fir.index_last = 0;
+	ptr->fir.taps = t;
+	ptr->fir.samples = x;
+	ptr->n_in = (n_t)-1;
+	return 0;
+}
+
+
+void sig_fir_interp_free_f(struct sig_fir_interp_param_f *ptr)
+{
+	sig_fir_n_free_f(&ptr->fir);
+	free(ptr->input);
+	ptr->input = NULL;
+}
+
+
+/**
+ * @brief output of the phase of n, with the current history
+ */
+static inline float sig_fir_interp_core_f(struct sig_fir_interp_param_f *ptr, n_t n)
+{
+	const float *taps = ptr->fir.taps + (n % ptr->factor) * ptr->fir.length;
+
+	return sig_fir_dot(taps, ptr->fir.samples + ptr->fir.index_last, ptr->fir.length);
+}
+
+
+float sig_fir_interp_f(struct signal_float *self, n_t n)
+{
+	struct sig_fir_interp_param_f *ptr = (struct sig_fir_interp_param_f *) self->params;
+	n_t m;
+	float x;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	m = n / ptr->factor;
+	if (m != ptr->n_in)
+	{
+		x = sig_value(ptr->source, m);
+		SIG_ERRNO_FAIL
+		sig_fir_n_push_f(&ptr->fir, x);
+		ptr->n_in = m;
+	}
+	self->x_cst = sig_fir_interp_core_f(ptr, n);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_fir_interp_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_fir_interp_param_f *ptr;
+	n_t first, m;
+	int i, j, k, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_fir_interp_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		if ((n_t)(n + len - 1) < n)
+			len = -n;													// stop at the roll over, where the input n restarts at 0
+		// the inputs of the block are consecutive: read the new ones at once
+		first = n / ptr->factor;
+		j = (first == ptr->n_in) ? 1 : 0;								// first input already in the history
+		k = (n + len - 1) / ptr->factor - first + 1 - j;
+		if (k > 0)
+		{
+			sig_get_block_f(ptr->source, first + j, k, ptr->input);
+			SIG_ERRNO_FAIL_BLOCK
+		}
+		for (i=0, j=0; i<len; i++)
+		{
+			m = (n + i) / ptr->factor;
+			if (m != ptr->n_in)
+			{
+				sig_fir_n_push_f(&ptr->fir, ptr->input[j++]);
+				ptr->n_in = m;
+			}
+			out[i] = sig_fir_interp_core_f(ptr, n + i);
+		}
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+/***************************************************************************************/
+/*                              Biquad cascade                                         */
+/***************************************************************************************/
+
+#define SIG_BIQUAD_LANES		8						// sections evaluated at once by the AVX2 kernel
+#define SIG_BIQUAD_CHUNK		1024					// samples processed by a kernel call, section after section
+#define SIG_BIQUAD_PI			3.14159265358979323846L	// long double: not affected by -fsingle-precision-constant
+
+/**
+ * @brief flush a state to 0 before it becomes denormal
+ */
+static inline float sig_biquad_flush_f(float s)
+{
+	return (fabsf(s) < SIG_BIQUAD_FLUSH) ? 0 : s;
+}
+
+
+/**
+ * @brief evaluate all the sections for one input sample
+ */
+static inline float sig_biquad_cascade_core_f(struct sig_biquad_cascade_param_f *ptr, float x)
+{
+	const float *c = ptr->coef;
+	float *s1 = ptr->state;
+	float *s2 = ptr->state + ptr->length;
+	int l = ptr->length;
+	int k;
+	float y;
+
+	for (k=0; k<ptr->sections; k++)
+	{
+		y = c[k] * x + s1[k];
+		s1[k] = sig_biquad_flush_f(c[l + k] * x - c[3*l + k] * y + s2[k]);
+		s2[k] = sig_biquad_flush_f(c[2*l + k] * x - c[4*l + k] * y);
+		x = y;
+	}
+	return x;
+}
+
+
+/**
+ * @brief portable kernel. Sample after sample, so that the out-of-order core overlaps the sections
+ */
+static void sig_biquad_run_c(struct sig_biquad_cascade_param_f *ptr, float *x, int len)
+{
+	int i;
+
+	for (i=0; i<len; i++)
+		x[i] = sig_biquad_cascade_core_f(ptr, x[i]);
+}
+
+#if defined(SIG_FIR_X86)
+/**
+ * @brief AVX2 kernel: lane k evaluates section k on the sample t - k, the output of lane k - 1 at t - 1.
+ * @details The sections of a group of 8 thus run in parallel, with a latency of one sample per section. Lanes with
+ * no sample to evaluate (the first and last steps of the chunk) keep their state. No FMA, so that the results
+ * are the ones of sig_biquad_run_c()
+ */
+__attribute__((target("avx2")))
+static void sig_biquad_run_avx2(struct sig_biquad_cascade_param_f *ptr, float *x, int len)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f), flush = _mm256_set1_ps(SIG_BIQUAD_FLUSH);
+	const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i shift = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+	__m256 b0, b1, b2, a1, a2, s1, s2, in, y, n1, n2, active;
+	__m256i out;
+	const float *c;
+	float *s;
+	int l = ptr->length;
+	int g, t, last;
+
+	for (g=0; g<ptr->sections; g+=SIG_BIQUAD_LANES)
+	{
+		c = ptr->coef + g;
+		s = ptr->state + g;
+		last = min(ptr->sections - g, SIG_BIQUAD_LANES) - 1;		// lane of the last section of the group
+		out = _mm256_set1_epi32(last);
+		b0 = _mm256_load_ps(c);
+		b1 = _mm256_load_ps(c + l);
+		b2 = _mm256_load_ps(c + 2*l);
+		a1 = _mm256_load_ps(c + 3*l);
+		a2 = _mm256_load_ps(c + 4*l);
+		s1 = _mm256_load_ps(s);
+		s2 = _mm256_load_ps(s + l);
+		in = _mm256_setzero_ps();
+		for (t=0; t<len+last; t++)
+		{
+			in = _mm256_blend_ps(in, _mm256_set1_ps(t < len ? x[t] : 0), 0x01);
+			active = _mm256_castsi256_ps(_mm256_and_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(t + 1), lane),
+				_mm256_cmpgt_epi32(lane, _mm256_set1_epi32(t - len))));			// 0 <= t - k < len
+			y = _mm256_add_ps(_mm256_mul_ps(b0, in), s1);
+			n1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, in), _mm256_mul_ps(a1, y)), s2);
+			n2 = _mm256_sub_ps(_mm256_mul_ps(b2, in), _mm256_mul_ps(a2, y));
+			n1 = _mm256_and_ps(n1, _mm256_cmp_ps(_mm256_andnot_ps(sign, n1), flush, _CMP_NLT_UQ));
+			n2 = _mm256_and_ps(n2, _mm256_cmp_ps(_mm256_andnot_ps(sign, n2), flush, _CMP_NLT_UQ));
+			s1 = _mm256_blendv_ps(s1, n1, active);
+			s2 = _mm256_blendv_ps(s2, n2, active);
+			if (t >= last)
+				x[t - last] = _mm256_cvtss_f32(_mm256_permutevar8x32_ps(y, out));
+			in = _mm256_permutevar8x32_ps(y, shift);
+		}
+		_mm256_store_ps(s, s1);
+		_mm256_store_ps(s + l, s2);
+	}
+}
+#endif	// SIG_FIR_X86
+
+static void sig_biquad_run_auto(struct sig_biquad_cascade_param_f *ptr, float *x, int len);
+
+/** kernel used by sig_biquad_cascade_block_f(). Resolved on first use */
+static void (*sig_biquad_run)(struct sig_biquad_cascade_param_f *ptr, float *x, int len) = sig_biquad_run_auto;
+
+static void sig_biquad_run_auto(struct sig_biquad_cascade_param_f *ptr, float *x, int len)
+{
+	sig_biquad_kernel_f(SIG_FIR_KERNEL_AUTO);
+	sig_biquad_run(ptr, x, len);
+}
+
+int sig_biquad_kernel_f(enum sig_fir_kernel_t kernel)
+{
+#if defined(SIG_FIR_X86)
+	__builtin_cpu_init();
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = __builtin_cpu_supports("avx2") ? SIG_FIR_KERNEL_AVX2 : SIG_FIR_KERNEL_C;
+	if ((kernel == SIG_FIR_KERNEL_AVX2) && __builtin_cpu_supports("avx2"))
+	{
+		sig_biquad_run = sig_biquad_run_avx2;
+		return 0;
+	}
+#else
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = SIG_FIR_KERNEL_C;
+#endif
+	if (kernel != SIG_FIR_KERNEL_C)
+		return -1;
+	sig_biquad_run = sig_biquad_run_c;
+	return 0;
+}
+
+
+int sig_biquad_cascade_init_f(struct sig_biquad_cascade_param_f *ptr, const float *coef, int sections)
+{
+	int length = (sections + SIG_BIQUAD_LANES - 1) / SIG_BIQUAD_LANES * SIG_BIQUAD_LANES;
+	float *c, *s;
+	int i, k;
+
+	if (sections < 1)
+		return -1;
+	// aligned_alloc() sizes must be a multiple of the alignment
+	c = aligned_alloc(64, (5 * length * sizeof(float) + 63) / 64 * 64);
+	s = aligned_alloc(64, (2 * length * sizeof(float) + 63) / 64 * 64);
+	if ((c == NULL) || (s == NULL))
+	{
+		free(c);
+		free(s);
+		return -1;
+	}
+	memset(c, 0, 5 * length * sizeof(float));
+	for (k=0; k<length; k++)
+		for (i=0; i<5; i++)
+			c[i * length + k] = (k < sections) ? coef[5 * k + i] : (i == 0);	// pass-through padding: b0 = 1
+	memset(s, 0, 2 * length * sizeof(float));
+
+	ptr->sections = sections;
+	ptr->length = length;
+	ptr->coef = c;
+	ptr->state = s;
+	return 0;
+}
+
+
+void sig_biquad_cascade_free_f(struct sig_biquad_cascade_param_f *ptr)
+{
+	free(ptr->coef);
+	free(ptr->state);
+	ptr->coef = NULL;
+	ptr->state = NULL;
+	ptr->sections = 0;
+}
+
+
+float sig_biquad_cascade_f(struct signal_float *self, n_t n)
+{
+	struct sig_biquad_cascade_param_f *ptr = (struct sig_biquad_cascade_param_f *) self->params;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	self->x_cst = sig_biquad_cascade_core_f(ptr, sig_value(ptr->source, n));
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_biquad_cascade_block_f(struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_biquad_cascade_param_f *ptr;
+	int i;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_biquad_cascade_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	sig_get_block_f(ptr->source, n, count, out);					// the source is read in place
+	SIG_ERRNO_FAIL_BLOCK
+	for (i=0; i<count; i+=SIG_BIQUAD_CHUNK)
+		sig_biquad_run(ptr, out + i, min(count - i, SIG_BIQUAD_CHUNK));
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
+}
+
+
+/**
+ * @brief normalize and store the coefficients of a section
+ */
+static void sig_biquad_store_f(float *coef, double b0, double b1, double b2, double a0, double a1, double a2)
+{
+	coef[0] = b0 / a0;
+	coef[1] = b1 / a0;
+	coef[2] = b2 / a0;
+	coef[3] = a1 / a0;
+	coef[4] = a2 / a0;
+}
+
+
+int sig_biquad_design_f(float *coef, enum sig_biquad_type_t type, float fc, float q, float gain_db)
+{
+	double w, cw, alpha, a, sa, shelf;
+
+	if ((fc <= 0) || (fc >= 0.5) || (q <= 0))
+		return -1;
+	w = 2 * (double)SIG_BIQUAD_PI * fc;
+	cw = cos(w);
+	alpha = sin(w) / (2 * q);
+	a = pow(10, gain_db / 40.0);
+	switch (type)
+	{
+		case SIG_BIQUAD_LOWPASS:
+			sig_biquad_store_f(coef, (1 - cw) / 2, 1 - cw, (1 - cw) / 2, 1 + alpha, -2 * cw, 1 - alpha);
+			return 0;
+		case SIG_BIQUAD_HIGHPASS:
+			sig_biquad_store_f(coef, (1 + cw) / 2, -(1 + cw), (1 + cw) / 2, 1 + alpha, -2 * cw, 1 - alpha);
+			return 0;
+		case SIG_BIQUAD_BANDPASS:
+			sig_biquad_store_f(coef, alpha, 0, -alpha, 1 + alpha, -2 * cw, 1 - alpha);
+			return 0;
+		case SIG_BIQUAD_NOTCH:
+			sig_biquad_store_f(coef, 1, -2 * cw, 1, 1 + alpha, -2 * cw, 1 - alpha);
+			return 0;
+		case SIG_BIQUAD_PEAK:
+			sig_biquad_store_f(coef, 1 + alpha * a, -2 * cw, 1 - alpha * a, 1 + alpha / a, -2 * cw, 1 - alpha / a);
+			return 0;
+		case SIG_BIQUAD_LOWSHELF:
+		case SIG_BIQUAD_HIGHSHELF:
+			shelf = (a + 1 / a) * (1 / q - 1) + 2;
+			if (shelf < 0)
+				return -1;
+			sa = sin(w) * sqrt(shelf) * sqrt(a);			// 2 * sqrt(A) * alpha
+			if (type == SIG_BIQUAD_LOWSHELF)
+				sig_biquad_store_f(coef, a * ((a + 1) - (a - 1) * cw + sa), 2 * a * ((a - 1) - (a + 1) * cw),
+					a * ((a + 1) - (a - 1) * cw - sa), (a + 1) + (a - 1) * cw + sa, -2 * ((a - 1) + (a + 1) * cw),
+					(a + 1) + (a - 1) * cw - sa);
+			else
+				sig_biquad_store_f(coef, a * ((a + 1) + (a - 1) * cw + sa), -2 * a * ((a - 1) + (a + 1) * cw),
+					a * ((a + 1) + (a - 1) * cw - sa), (a + 1) - (a - 1) * cw + sa, 2 * ((a - 1) - (a + 1) * cw),
+					(a + 1) - (a - 1) * cw - sa);
+			return 0;
+		default:
+			return -1;
+	}
+}
+
+
+/**
+ * @brief bilinear transform of the analog prototype with poles sinh_mu * -sin(theta) +- j * cosh_mu * cos(theta),
+ * theta = (2k + 1) * pi / (2 * order). sinh_mu = cosh_mu = 1 gives a Butterworth filter
+ */
+static int sig_biquad_prototype_f(float *coef, int order, float fc, double sinh_mu, double cosh_mu, double gain, int highpass)
+{
+	double k, kw, theta, sigma, omega, w, q, norm;
+	int i;
+
+	if ((order < 1) || (fc <= 0) || (fc >= 0.5))
+		return -1;
+	k = tan((double)SIG_BIQUAD_PI * fc);					// pre-warped cutoff
+	for (i=0; i<order/2; i++, coef+=5)
+	{
+		theta = (2 * i + 1) * (double)SIG_BIQUAD_PI / (2 * order);
+		sigma = sinh_mu * sin(theta);
+		omega = cosh_mu * cos(theta);
+		w = sqrt(sigma * sigma + omega * omega);			// natural frequency of the pole pair
+		q = w / (2 * sigma);
+		kw = highpass ? k / w : k * w;
+		norm = 1 / (1 + kw / q + kw * kw);
+		if (highpass)
+			sig_biquad_store_f(coef, norm, -2 * norm, norm, 1, 2 * (kw * kw - 1) * norm, (1 - kw / q + kw * kw) * norm);
+		else
+			sig_biquad_store_f(coef, kw * kw * norm, 2 * kw * kw * norm, kw * kw * norm, 1, 2 * (kw * kw - 1) * norm,
+				(1 - kw / q + kw * kw) * norm);
+	}
+	if (order & 1)
+	{
+		// real pole at -sinh_mu: first-order section
+		kw = highpass ? k / sinh_mu : k * sinh_mu;
+		norm = 1 / (1 + kw);
+		if (highpass)
+			sig_biquad_store_f(coef, norm, -norm, 0, 1, (kw - 1) * norm, 0);
+		else
+			sig_biquad_store_f(coef, kw * norm, kw * norm, 0, 1, (kw - 1) * norm, 0);
+	}
+	else
+	{
+		// even orders: the gain applies to the first section
+		coef -= 5 * (order / 2);
+		coef[0] *= gain;
+		coef[1] *= gain;
+		coef[2] *= gain;
+	}
+	return (order + 1) / 2;
+}
+
+
+int sig_biquad_butterworth_f(float *coef, int order, float fc, int highpass)
+{
+	return sig_biquad_prototype_f(coef, order, fc, 1, 1, 1, highpass);
+}
+
+
+int sig_biquad_chebyshev_f(float *coef, int order, float fc, float ripple_db, int highpass)
+{
+	double mu;
+
+	if ((ripple_db <= 0) || (order < 1))
+		return -1;
+	mu = asinh(1 / sqrt(pow(10, ripple_db / 10.0) - 1)) / order;
+	return sig_biquad_prototype_f(coef, order, fc, sinh(mu), cosh(mu), pow(10, -ripple_db / 20.0), highpass);
+}
+
+
+/***************************************************************************************/
+/*                              Lookup table                                           */
+/***************************************************************************************/
+
+/**
+ * @brief fill the complete search tree of a non-uniform table, in order (breakpoints, then +inf)
+ */
+static void sig_lut_tree_f(float *tree, int nodes, int k, const float *x, int size, int *pos)
+{
+	if (k > nodes)
+		return;
+	sig_lut_tree_f(tree, nodes, 2 * k, x, size, pos);
+	tree[k] = (*pos < size) ? x[*pos] : INFINITY;
+	(*pos)++;
+	sig_lut_tree_f(tree, nodes, 2 * k + 1, x, size, pos);
+}
+
+
+int sig_lut_uniform_init_f(struct sig_lut_table_f *table, float x0, float x1, const float *y, int size)
+{
+	int i;
+
+	memset(table, 0, sizeof(*table));
+	if ((size < 2) || !(x1 > x0))
+		return -1;
+	table->seg = aligned_alloc(64, (2 * (size - 1) * sizeof(float) + 63) / 64 * 64);
+	if (table->seg == NULL)
+		return -1;
+	for (i=0; i<size-1; i++)
+	{
+		table->seg[2*i] = y[i];
+		table->seg[2*i + 1] = y[i + 1] - y[i];
+	}
+	table->size = size;
+	table->uniform = 1;
+	table->x0 = x0;
+	table->inv_dx = (double)(size - 1) / ((double)x1 - x0);
+	return 0;
+}
+
+
+int sig_lut_pwl_init_f(struct sig_lut_table_f *table, const float *x, const float *y, int size)
+{
+	int i, pos = 0;
+
+	memset(table, 0, sizeof(*table));
+	if (size < 2)
+		return -1;
+	for (i=1; i<size; i++)
+		if (!(x[i] > x[i - 1]))
+			return -1;
+	while ((1 << table->depth) - 1 < size)
+		table->depth++;
+	table->seg = aligned_alloc(64, (4 * (size - 1) * sizeof(float) + 63) / 64 * 64);
+	table->tree = aligned_alloc(64, ((1 << table->depth) * sizeof(float) + 63) / 64 * 64);
+	if ((table->seg == NULL) || (table->tree == NULL))
+	{
+		sig_lut_free_f(table);
+		return -1;
+	}
+	for (i=0; i<size-1; i++)
+	{
+		table->seg[4*i] = x[i];
+		table->seg[4*i + 1] = y[i];
+		table->seg[4*i + 2] = ((double)y[i + 1] - y[i]) / ((double)x[i + 1] - x[i]);
+		table->seg[4*i + 3] = x[i + 1];
+	}
+	table->tree[0] = 0;
+	sig_lut_tree_f(table->tree, (1 << table->depth) - 1, 1, x, size, &pos);
+	table->size = size;
+	table->x_min = x[0];
+	table->x_max = x[size - 1];
+	return 0;
+}
+
+
+void sig_lut_free_f(struct sig_lut_table_f *table)
+{
+	free(table->seg);
+	free(table->tree);
+	table->seg = NULL;
+	table->tree = NULL;
+	table->size = 0;
+}
+
+
+/**
+ * @brief map x through the table. cursor is the segment of the last input (non-uniform tables)
+ */
+static inline float sig_lut_core_f(const struct sig_lut_table_f *t, int *cursor, float x)
+{
+	const float *s;
+	float u;
+	int i, k, l;
+
+	if (t->uniform)
+	{
+		u = min(max((x - t->x0) * t->inv_dx, 0), (float)(t->size - 1));	// NaN is mapped to 0
+		i = min((int)u, t->size - 2);
+		s = t->seg + 2 * i;
+		return s[0] + (u - i) * s[1];
+	}
+
+	x = min(max(x, t->x_min), t->x_max);
+	i = *cursor;
+	if ((i > t->size - 2) || ((i != 0) && (x < t->seg[4*i])) || ((i != t->size - 2) && (x >= t->seg[4*i + 3])))
+	{
+		// k - 2^depth breakpoints are <= x
+		for (k=1, l=0; l<t->depth; l++)
+			k = 2 * k + (t->tree[k] <= x);
+		i = min(max(k - (1 << t->depth) - 1, 0), t->size - 2);
+		*cursor = i;
+	}
+	s = t->seg + 4 * i;
+	return s[1] + (x - s[0]) * s[2];
+}
+
+
+static void sig_lut_run_c(const struct sig_lut_table_f *t, int *cursor, float *x, int len)
+{
+	int i;
+
+	for (i=0; i<len; i++)
+		x[i] = sig_lut_core_f(t, cursor, x[i]);
+}
+
+
+#if defined(SIG_FIR_X86)
+/**
+ * @brief AVX2 kernel: 8 inputs at once, with gathers. No FMA, so that the values are the ones of sig_lut_core_f()
+ */
+__attribute__((target("avx2")))
+static void sig_lut_run_avx2(const struct sig_lut_table_f *t, int *cursor, float *x, int len)
+{
+	const __m256i last = _mm256_set1_epi32(t->size - 2), zero = _mm256_setzero_si256();
+	__m256 u, v, y;
+	__m256i k;
+	int i = 0, l;
+
+	if (t->uniform)
+	{
+		const __m256 x0 = _mm256_set1_ps(t->x0), inv_dx = _mm256_set1_ps(t->inv_dx);
+		const __m256 top = _mm256_set1_ps(t->size - 1);
+
+		for (; i+8<=len; i+=8)
+		{
+			u = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), x0), inv_dx);
+			u = _mm256_min_ps(_mm256_max_ps(u, _mm256_setzero_ps()), top);
+			k = _mm256_min_epi32(_mm256_cvttps_epi32(u), last);
+			u = _mm256_sub_ps(u, _mm256_cvtepi32_ps(k));
+			k = _mm256_add_epi32(k, k);
+			y = _mm256_mul_ps(u, _mm256_i32gather_ps(t->seg + 1, k, 4));
+			_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_i32gather_ps(t->seg, k, 4), y));
+		}
+	}
+	else if (len >= 8)
+	{
+		const __m256 x_min = _mm256_set1_ps(t->x_min), x_max = _mm256_set1_ps(t->x_max);
+		const __m256i leaf = _mm256_set1_epi32((1 << t->depth) + 1);
+
+		for (; i+8<=len; i+=8)
+		{
+			v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(x + i), x_min), x_max);
+			k = _mm256_set1_epi32(1);
+			for (l=0; l<t->depth; l++)			// the compare mask is -1 where the node is <= x
+				k = _mm256_sub_epi32(_mm256_add_epi32(k, k),
+					_mm256_castps_si256(_mm256_cmp_ps(_mm256_i32gather_ps(t->tree, k, 4), v, _CMP_LE_OQ)));
+			k = _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(k, leaf), zero), last);
+			k = _mm256_slli_epi32(k, 2);
+			u = _mm256_sub_ps(v, _mm256_i32gather_ps(t->seg, k, 4));
+			y = _mm256_mul_ps(u, _mm256_i32gather_ps(t->seg + 2, k, 4));
+			_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_i32gather_ps(t->seg + 1, k, 4), y));
+		}
+		*cursor = _mm256_extract_epi32(k, 7) / 4;
+	}
+	sig_lut_run_c(t, cursor, x + i, len - i);
+}
+#endif	// SIG_FIR_X86
+
+static void sig_lut_run_auto(const struct sig_lut_table_f *t, int *cursor, float *x, int len);
+
+/** kernel used by sig_lut_block_f(). Resolved on first use */
+static void (*sig_lut_run)(const struct sig_lut_table_f *t, int *cursor, float *x, int len) = sig_lut_run_auto;
+
+static void sig_lut_run_auto(const struct sig_lut_table_f *t, int *cursor, float *x, int len)
+{
+	sig_lut_kernel_f(SIG_FIR_KERNEL_AUTO);
+	sig_lut_run(t, cursor, x, len);
+}
+
+int sig_lut_kernel_f(enum sig_fir_kernel_t kernel)
+{
+#if defined(SIG_FIR_X86)
+	__builtin_cpu_init();
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = __builtin_cpu_supports("avx2") ? SIG_FIR_KERNEL_AVX2 : SIG_FIR_KERNEL_C;
+	if ((kernel == SIG_FIR_KERNEL_AVX2) && __builtin_cpu_supports("avx2"))
+	{
+		sig_lut_run = sig_lut_run_avx2;
+		return 0;
+	}
+#else
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = SIG_FIR_KERNEL_C;
+#endif
+	if (kernel != SIG_FIR_KERNEL_C)
+		return -1;
+	sig_lut_run = sig_lut_run_c;
+	return 0;
 }
 
-float sig_iirlp1_f(struct signal_float *self, n_t n)
+
+float sig_lut_f(struct signal_float *self, n_t n)
 {
-	struct sig_iirlp1_param_f *ptr = (struct sig_iirlp1_param_f *) self->params;
-	float source_value;
+	struct sig_lut_param_f *ptr = (struct sig_lut_param_f *) self->params;
+	float x;
 	SIG_ERRNO_FAIL
 
 	if(self == NULL)
@@ -110,61 +1757,114 @@ float sig_iirlp1_f(struct signal_float *self, n_t n)
 	if(self->params == NULL)
 		SIG_ERRNO(-2);
 
+	if(ptr->table == NULL)
+		SIG_ERRNO(-3);
+
 	if (n == ptr->n_last)
 		return self->x_cst;
-	
-	source_value = sig_value(ptr->source, n);		//source_value = sig_get_value_f(ptr->source, n);
 
-	self->x_cst = (self->x_cst * ptr->oma) +  (source_value * ptr->a);
+	x = sig_value(ptr->source, n);
+	self->x_cst = sig_lut_core_f(ptr->table, &ptr->cursor, x);
 	ptr->n_last = n;
 	return self->x_cst;
 }
 
 
-float sig_step_f(struct signal_float *self, n_t n)
+void sig_lut_block_f(struct signal_float *self, n_t n, int count, float *out)
 {
-	struct sig_step_param_f *ptr = (struct sig_step_param_f *)self->params;
-	SIG_ERRNO_FAIL
+	struct sig_lut_param_f *ptr;
+
+	SIG_ERRNO_FAIL_BLOCK
 
 	if(self == NULL)
-		SIG_ERRNO(-1);
+		SIG_ERRNO_BLOCK(-1);
 
 	if(self->params == NULL)
-		SIG_ERRNO(-2);
+		SIG_ERRNO_BLOCK(-2);
 
-	if (SIG_NWINDOW_VALID(n, ptr))
-		return ptr->x_active;
-	else
-		return ptr->x_inact;
+	ptr = (struct sig_lut_param_f *) self->params;
+
+	if(ptr->table == NULL)
+		SIG_ERRNO_BLOCK(-3);
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	sig_get_block_f(ptr->source, n, count, out);					// the source is read in place
+	SIG_ERRNO_FAIL_BLOCK
+	sig_lut_run(ptr->table, &ptr->cursor, out, count);
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
 }
 
-float sig_fir_n_f(struct signal_float *self, n_t n)
+
+/***************************************************************************************/
+/*                              PID                                                    */
+/***************************************************************************************/
+
+/**
+ * @brief clamp x to [-max_output; max_output]
+ */
+static inline float sig_pid_limit_f(struct sig_pid_param_f *ptr, float x)
 {
-	struct sig_fir_n_param_f *ptr = (struct sig_fir_n_param_f *) self->params;
-	int i;
-	int index;
-	SIG_ERRNO_FAIL
+	if (x > ptr->max_output)
+		return ptr->max_output;
+	else if (x < (-1 * ptr->max_output))
+		return -1 * ptr->max_output;
+	return x;
+}
 
-	if(self == NULL)
-		SIG_ERRNO(-1);
 
-	if(self->params == NULL)
-		SIG_ERRNO(-2);
+/**
+ * @brief push a new error sample into the PID history
+ */
+static inline void sig_pid_push_f(struct sig_pid_param_f *ptr, float error)
+{
+	ptr->history[2] = ptr->history[1];
+	ptr->history[1] = ptr->history[0];
+	ptr->history[0] = error;
+}
 
-	if (n == ptr->n_last)
-		return self->x_cst;
 
-	ptr->samples[ptr->index_last++] = sig_value(ptr->source, n);		// store the input into the buffer
-	ptr->index_last %= ptr->tap_count;										// make sure the index rollback
-	index = ptr->index_last;
+/**
+ * @brief optimized form PID step, without Feed-Forward
+ */
+static inline float sig_pid_opt_core_f(struct sig_pid_param_f *ptr, float error)
+{
+	sig_pid_push_f(ptr, error);
 
-	self->x_cst = 0;														// this is the output of the filter, initialize it at 0
-	for (i=0; i< ptr->tap_count; i++)
-	{
-		index = index != 0 ? index - 1 : ptr->tap_count-1;
-		self->x_cst += ptr->samples[i] * ptr->taps[index];					// MAC the samples by the taps
-	}
-	return self->x_cst;
+	// compute the PID output
+	ptr->integral += ptr->history[0] * ptr->k[0];
+	ptr->integral += ptr->history[1] * ptr->k[1];
+	ptr->integral += ptr->history[2] * ptr->k[2];
+
+	// limit the integral part to max_output
+	ptr->integral = sig_pid_limit_f(ptr, ptr->integral);
+	return ptr->integral;
+}
+
+
+/**
+ * @brief naive form PID step, without Feed-Forward nor output limit
+ */
+static inline float sig_pid_naive_core_f(struct sig_pid_param_f *ptr, float error)
+{
+	float x;
+
+	sig_pid_push_f(ptr, error);
+
+	// compute the PID output
+	x = ptr->history[0] * ptr->p;
+	ptr->integral += ptr->history[0] * ptr->i;
+	x += ptr->integral;
+	x += (ptr->history[0] - ptr->history[1]) * ptr->d;
+	return x;
 }
 
 
@@ -187,23 +1887,7 @@ float sig_pid_opt_f (struct signal_float *self, n_t n)
 	if (ptr->feedback)
 		error -= sig_get_value_f(ptr->feedback, n);
 	
-	// push new error sample into the history
-	ptr->history[2] = ptr->history[1];
-	ptr->history[1] = ptr->history[0];
-	ptr->history[0] = error;
-	
-	// compute the PID output
-	ptr->integral += ptr->history[0] * ptr->k[0];
-	ptr->integral += ptr->history[1] * ptr->k[1];
-	ptr->integral += ptr->history[2] * ptr->k[2];
-	
-	// limit the integral part to max_output
-	if (ptr->integral > ptr->max_output)
-		ptr->integral = ptr->max_output;
-	else if (ptr->integral < (-1 * ptr->max_output))
-		ptr->integral = -1 * ptr->max_output;
-	
-	self->x_cst = ptr->integral;
+	self->x_cst = sig_pid_opt_core_f(ptr, error);
 	// compute Feed-Forward
 	#if SIG_PID_FF
 	if (ptr->ff0)
@@ -214,10 +1898,7 @@ float sig_pid_opt_f (struct signal_float *self, n_t n)
 		self->x_cst += sig_get_value_f(ptr->ff2, n) * ptr->ff[2];
 	
 	// limit the output to max_output
-	if (self->x_cst > ptr->max_output)
-		self->x_cst = ptr->max_output;
-	else if (self->x_cst < (-1 * ptr->max_output))
-		self->x_cst = -1 * ptr->max_output;
+	self->x_cst = sig_pid_limit_f(ptr, self->x_cst);
 	#endif
 	
 	return self->x_cst;
@@ -237,25 +1918,14 @@ float sig_pid_naive_f (struct signal_float *self, n_t n)
 	
 	if (n == ptr->n_last)
 		return self->x_cst;
-	
-	if (n == ptr->n_last)
-		return self->x_cst;
+	ptr->n_last = n;
 	
 	// get the current error
 	error = sig_get_value_f(ptr->setpoint, n);
 	if (ptr->feedback)
 		error -= sig_get_value_f(ptr->feedback, n);
 	
-	// push new error sample into the history
-	ptr->history[2] = ptr->history[1];
-	ptr->history[1] = ptr->history[0];
-	ptr->history[0] = error;
-	
-	// compute the PID output
-	self->x_cst = ptr->history[0] * ptr->p;
-	ptr->integral += ptr->history[0] * ptr->i;
-	self->x_cst += ptr->integral;
-	self->x_cst += (ptr->history[0] - ptr->history[1]) * ptr->d;
+	self->x_cst = sig_pid_naive_core_f(ptr, error);
 	
 	// compute Feed-Forward
 	#if SIG_PID_FF
@@ -268,21 +1938,103 @@ float sig_pid_naive_f (struct signal_float *self, n_t n)
 	#endif
 	
 	// limit the integral part to max_output
-	if (ptr->integral > ptr->max_output)
-		ptr->integral = ptr->max_output;
-	else if (ptr->integral < (-1 * ptr->max_output))
-		ptr->integral = -1 * ptr->max_output;
+	ptr->integral = sig_pid_limit_f(ptr, ptr->integral);
 	
 	// limit the output to max_output
-	if (self->x_cst > ptr->max_output)
-		self->x_cst = ptr->max_output;
-	else if (self->x_cst < (-1 * ptr->max_output))
-		self->x_cst = -1 * ptr->max_output;
+	self->x_cst = sig_pid_limit_f(ptr, self->x_cst);
 	
 	return self->x_cst;
 }
 
 
+/**
+ * @brief common block evaluation of both PID forms
+ * @param[in] naive if non-zero, use the naive form. Else use the optimized form
+ */
+static void sig_pid_block_f(struct signal_float *self, n_t n, int count, float *out, int naive)
+{
+	struct sig_pid_param_f *ptr;
+	float fb[SIG_BLOCK_CHUNK];
+#if SIG_PID_FF
+	float ff0[SIG_BLOCK_CHUNK], ff1[SIG_BLOCK_CHUNK], ff2[SIG_BLOCK_CHUNK];
+#endif
+	float x;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_pid_param_f *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+
+		// get the inputs, in the same order as the per-sample evaluation
+		sig_get_block_f(ptr->setpoint, n, len, out);
+		if (ptr->feedback)
+			sig_get_block_f(ptr->feedback, n, len, fb);
+		#if SIG_PID_FF
+		if (ptr->ff0)
+			sig_get_block_f(ptr->ff0, n, len, ff0);
+		if (ptr->ff1)
+			sig_get_block_f(ptr->ff1, n, len, ff1);
+		if (ptr->ff2)
+			sig_get_block_f(ptr->ff2, n, len, ff2);
+		#endif
+		SIG_ERRNO_FAIL_BLOCK
+
+		for (i=0; i<len; i++)
+		{
+			x = out[i];
+			if (ptr->feedback)
+				x -= fb[i];
+			x = naive ? sig_pid_naive_core_f(ptr, x) : sig_pid_opt_core_f(ptr, x);
+			#if SIG_PID_FF
+			if (ptr->ff0)
+				x += ff0[i] * ptr->ff[0];
+			if (ptr->ff1)
+				x += ff1[i] * ptr->ff[1];
+			if (ptr->ff2)
+				x += ff2[i] * ptr->ff[2];
+			#endif
+			if (naive)
+				ptr->integral = sig_pid_limit_f(ptr, ptr->integral);
+			if (naive || SIG_PID_FF)								// the optimized form only limits its output with Feed-Forward
+				x = sig_pid_limit_f(ptr, x);
+			out[i] = x;
+		}
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+void sig_pid_opt_block_f (struct signal_float *self, n_t n, int count, float *out)
+{
+	sig_pid_block_f(self, n, count, out, 0);
+}
+
+
+void sig_pid_naive_block_f (struct signal_float *self, n_t n, int count, float *out)
+{
+	sig_pid_block_f(self, n, count, out, 1);
+}
+
+
 void sig_pid_compute_k_f (struct signal_float *self)
 {
 	struct sig_pid_param_f *ptr = (struct sig_pid_param_f *) self->params;
@@ -323,13 +2075,324 @@ float sig_buf_read_f (struct signal_float *self, n_t n)
 }
 
 
+void sig_buf_read_block_f (struct signal_float *self, n_t n, int count, float *out)
+{
+	struct sig_buf_read_param_f *ptr;
+	n_t m, last;
+	int i, index;
+
+	SIG_ERRNO_FAIL_BLOCK
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_buf_read_param_f *) self->params;
+	if ((ptr->buffer == NULL) && (ptr->check_buffer))
+		SIG_ERRNO_BLOCK(-3);
+	if (count <= 0)
+		return;
+	if (n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+		if (count == 0)
+			return;
+	}
+	ptr->n_last = n + count - 1;
+
+	if (ptr->buffer == NULL)
+	{
+		for (i=0; i<count; i++)
+			out[i] = self->x_cst;
+		return;
+	}
+
+	m = n + ptr->delta;
+	if (ptr->circular)
+	{
+		// walk the buffer instead of computing a modulo for each sample
+		index = m % ptr->size;
+		for (i=0; i<count; i++)
+		{
+			out[i] = ptr->buffer[index];
+			m++;
+			index++;
+			if ((index == ptr->size) | (m == 0))				// (n + delta) rollover restarts at index 0, as the modulo does
+				index = 0;
+		}
+	}
+	else
+	{
+		last = (n_t)ptr->size - 1;
+		for (i=0; i<count; i++, m++)
+			out[i] = ptr->buffer[min(m, last)];
+	}
+	self->x_cst = out[count - 1];
+}
+
+
+/***************************************************************************************/
+/*                           Graph compiler descriptions                               */
+/***************************************************************************************/
+
+/** value of the source i of a compiled node */
+#define SIG_SRC_F(node, i)		(*(const float *)(node)->src[i])
+
+/**
+ * start of the step of a node that may also be read through (*x) (see sig_graph_node.shared): keep the value
+ * already computed at n, as (*x) does
+ */
+#define SIG_STEP_SHARED(node, ptr, n)	if ((node)->shared && ((ptr)->n_last == (n))) \
+		return;
+
+static int sig_no_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	return 0;
+}
+
+static void sig_sampler_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+
+	SIG_STEP_SHARED(node, (struct sig_sampler_param_f*)self->params, n)
+	self->x_cst = *self->x_var;
+	((struct sig_sampler_param_f*)self->params)->n_last = n;
+}
+
+static int sig_add_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	struct sig_add_param_f *ptr = (struct sig_add_param_f*)self->params;
+
+	src[0] = ptr->a;
+	val[0] = ptr->a_var ? ptr->a_var : &ptr->a_cst;
+	src[1] = ptr->b;
+	val[1] = ptr->b_var ? ptr->b_var : &ptr->b_cst;
+	return 2;
+}
+
+static void sig_add_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+
+	SIG_STEP_SHARED(node, (struct sig_add_param_f*)self->params, n)
+	self->x_cst = SIG_SRC_F(node, 0) + SIG_SRC_F(node, 1);
+	((struct sig_add_param_f*)self->params)->n_last = n;
+}
+
+static int sig_iirlp1_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	src[0] = ((struct sig_iirlp1_param_f *)self->params)->source;
+	return 1;
+}
+
+static void sig_iirlp1_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_iirlp1_param_f *ptr = (struct sig_iirlp1_param_f *)self->params;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	self->x_cst = (self->x_cst * ptr->oma) +  (SIG_SRC_F(node, 0) * ptr->a);
+	ptr->n_last = n;
+}
+
+static void sig_interpolate_lin_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_interpolate_lin_param_f *ptr = (struct sig_interpolate_lin_param_f *)self->params;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	self->x_cst = sig_interpolate_lin_core_f(ptr, n);
+	ptr->n_last = n;
+}
+
+static void sig_step_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_step_param_f *ptr = (struct sig_step_param_f *)self->params;
+
+	self->x_cst = SIG_NWINDOW_VALID(n, ptr) ? ptr->x_active : ptr->x_inact;
+}
+
+static int sig_fir_n_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	src[0] = ((struct sig_fir_n_param_f *)self->params)->source;
+	return 1;
+}
+
+static void sig_fir_n_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_fir_n_param_f *ptr = (struct sig_fir_n_param_f *)self->params;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	self->x_cst = sig_fir_n_core_f(ptr, SIG_SRC_F(node, 0));
+	ptr->n_last = n;
+}
+
+static int sig_fir_long_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	src[0] = ((struct sig_fir_long_param_f *)self->params)->source;
+	return 1;
+}
+
+static void sig_fir_long_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_fir_long_param_f *ptr = (struct sig_fir_long_param_f *)self->params;
+	float x = SIG_SRC_F(node, 0);
+
+	SIG_STEP_SHARED(node, ptr, n)
+	sig_fir_long_core_f(ptr, &x, 1);
+	self->x_cst = x;
+	ptr->n_last = n;
+}
+
+static int sig_biquad_cascade_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	src[0] = ((struct sig_biquad_cascade_param_f *)self->params)->source;
+	return 1;
+}
+
+static void sig_biquad_cascade_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_biquad_cascade_param_f *ptr = (struct sig_biquad_cascade_param_f *)self->params;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	self->x_cst = sig_biquad_cascade_core_f(ptr, SIG_SRC_F(node, 0));
+	ptr->n_last = n;
+}
+
+static int sig_lut_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	src[0] = ((struct sig_lut_param_f *)self->params)->source;
+	return 1;
+}
+
+static void sig_lut_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_lut_param_f *ptr = (struct sig_lut_param_f *)self->params;
+
+	if (ptr->table == NULL)
+		SIG_ERRNO_STEP(-3);
+	SIG_STEP_SHARED(node, ptr, n)
+	self->x_cst = sig_lut_core_f(ptr->table, &ptr->cursor, SIG_SRC_F(node, 0));
+	ptr->n_last = n;
+}
+
+static int sig_pid_sources_f(struct signal_float *self, struct signal_float **src, const float **val)
+{
+	struct sig_pid_param_f *ptr = (struct sig_pid_param_f *)self->params;
+
+	src[0] = ptr->setpoint;
+	src[1] = ptr->feedback;
+#if SIG_PID_FF
+	src[2] = ptr->ff0;
+	src[3] = ptr->ff1;
+	src[4] = ptr->ff2;
+	return 5;
+#else
+	return 2;
+#endif
+}
+
+/**
+ * @brief common step of both PID forms, see sig_pid_block_f()
+ */
+static inline void sig_pid_step_f(struct sig_graph_node *node, n_t n, int naive)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_pid_param_f *ptr = (struct sig_pid_param_f *)self->params;
+	float x;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	ptr->n_last = n;
+	x = SIG_SRC_F(node, 0);
+	if (node->src[1])
+		x -= SIG_SRC_F(node, 1);
+	x = naive ? sig_pid_naive_core_f(ptr, x) : sig_pid_opt_core_f(ptr, x);
+	#if SIG_PID_FF
+	if (node->src[2])
+		x += SIG_SRC_F(node, 2) * ptr->ff[0];
+	if (node->src[3])
+		x += SIG_SRC_F(node, 3) * ptr->ff[1];
+	if (node->src[4])
+		x += SIG_SRC_F(node, 4) * ptr->ff[2];
+	#endif
+	if (naive)
+		ptr->integral = sig_pid_limit_f(ptr, ptr->integral);
+	if (naive || SIG_PID_FF)
+		x = sig_pid_limit_f(ptr, x);
+	self->x_cst = x;
+}
+
+static void sig_pid_opt_step_f(struct sig_graph_node *node, n_t n)
+{
+	sig_pid_step_f(node, n, 0);
+}
+
+static void sig_pid_naive_step_f(struct sig_graph_node *node, n_t n)
+{
+	sig_pid_step_f(node, n, 1);
+}
+
+static void sig_buf_read_step_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *self = (struct signal_float *)node->sig;
+	struct sig_buf_read_param_f *ptr = (struct sig_buf_read_param_f *)self->params;
+	int index;
+
+	SIG_STEP_SHARED(node, ptr, n)
+	ptr->n_last = n;
+	if (ptr->buffer == NULL)
+	{
+		if (ptr->check_buffer)
+			SIG_ERRNO_STEP(-3);
+		return;
+	}
+	if (ptr->circular)
+		index = (n + ptr->delta) % ptr->size;
+	else
+		index = min((n + (n_t)ptr->delta), (n_t)ptr->size - 1);
+	self->x_cst = ptr->buffer[index];
+}
+
+static const struct sig_desc_f sig_desc_table_f[] = {
+	{sig_sampler_f, sig_sampler_step_f, sig_no_sources_f},
+	{sig_add_f, sig_add_step_f, sig_add_sources_f},
+	{sig_iirlp1_f, sig_iirlp1_step_f, sig_iirlp1_sources_f},
+	{sig_interpolate_lin_f, sig_interpolate_lin_step_f, sig_no_sources_f},
+	{sig_step_f, sig_step_step_f, sig_no_sources_f},
+	{sig_fir_n_f, sig_fir_n_step_f, sig_fir_n_sources_f},
+	{sig_fir_long_f, sig_fir_long_step_f, sig_fir_long_sources_f},
+	{sig_biquad_cascade_f, sig_biquad_cascade_step_f, sig_biquad_cascade_sources_f},
+	{sig_lut_f, sig_lut_step_f, sig_lut_sources_f},
+	{sig_pid_opt_f, sig_pid_opt_step_f, sig_pid_sources_f},
+	{sig_pid_naive_f, sig_pid_naive_step_f, sig_pid_sources_f},
+	{sig_buf_read_f, sig_buf_read_step_f, sig_no_sources_f},
+};
+
+const struct sig_desc_f *sig_desc_find_f(sig_func_f x)
+{
+	int i;
+
+	for (i=0; i<sizeof(sig_desc_table_f)/sizeof(sig_desc_table_f[0]); i++)
+		if (sig_desc_table_f[i].x == x)
+			return &sig_desc_table_f[i];
+	return NULL;
+}
+
+
 #if SIG_DBG_NAME || defined(__DOXYGEN__)
 #if SIG_SEARCH || defined(__DOXYGEN__)
 struct signal_float *sig_search_f(char *name, struct signal_float *array, int len)
 {
 	int i = 0;
 	for(i = 0; i < len; i++)
-		if (strcmp(array[i].name, name) == 0)
+		if (array[i].name && (strcmp(array[i].name, name) == 0))
 			return &array[i];
 	return NULL;
 }
@@ -337,9 +2400,9 @@ struct signal_float *sig_search_f(char *name, struct signal_float *array, int le
 
 struct signal_float *sig_search_list_f(char *name, struct signal_float **list)
 {
-	int i = 0;
-	while(list[i++])
-		if (strcmp(list[i]->name, name) == 0)
+	int i;
+	for(i = 0; list[i]; i++)
+		if (list[i]->name && (strcmp(list[i]->name, name) == 0))
 			return list[i];
 	return NULL;
 }
@@ -24,6 +24,7 @@
  */
 
 #include "sig.h"
+#include "sigfft.h"
 
 #ifndef SIG_LIBF_H__
 #define SIG_LIBF_H__
@@ -51,6 +52,44 @@
 #define SIG_PID_FF                  TRUE
 #endif
 
+/**
+ * @brief Enables the SSE/AVX2/AVX-512 FIR kernels, selected at run-time. If FALSE, only the portable kernel is used
+ */
+#if !defined(SIG_FIR_SIMD) || defined(__DOXYGEN__)
+#define SIG_FIR_SIMD                TRUE
+#endif
+
+/**
+ * @brief Mirrored FIR layout: the taps count is rounded up to a multiple of SIG_FIR_PAD (in floats)
+ * @details Must be a multiple of 16 (the AVX-512 vector width)
+ */
+#if !defined(SIG_FIR_PAD) || defined(__DOXYGEN__)
+#define SIG_FIR_PAD                 16
+#endif
+
+/**
+ * @brief sig_fir_long_init_f() uses the direct form (no latency) for filters of up to SIG_FIR_LONG_DIRECT taps
+ */
+#if !defined(SIG_FIR_LONG_DIRECT) || defined(__DOXYGEN__)
+#define SIG_FIR_LONG_DIRECT         256
+#endif
+
+/**
+ * @brief sig_fir_long_init_f() picks the smallest block size splitting the taps into at most SIG_FIR_LONG_PARTITIONS
+ * partitions. Fewer partitions means a lower cost per sample, but a higher latency
+ */
+#if !defined(SIG_FIR_LONG_PARTITIONS) || defined(__DOXYGEN__)
+#define SIG_FIR_LONG_PARTITIONS     16
+#endif
+
+/**
+ * @brief Biquad states smaller than this (in absolute value) are flushed to 0, so that a decaying filter never
+ * reaches the (slow) denormal range
+ */
+#if !defined(SIG_BIQUAD_FLUSH) || defined(__DOXYGEN__)
+#define SIG_BIQUAD_FLUSH            1e-30f
+#endif
+
 /** @} */
 
 
@@ -96,12 +135,22 @@ struct sig_sampler_param_f {
 /** @ingroup float
  * @struct sig_interpolate_lin_param_f
  * @brief structure representing the parameters of a 'linear interpolation' signal
- * @details the 'linear interpolation' signal returns (a * (n - delay) + b)
+ * @details the 'linear interpolation' signal returns (a * (n - delay) + b), n - delay being an n_t.
+ * @n a is a 24 bits integer times a power of 2, so p = a * (n - delay) is exact in double precision up to t_max.
+ * When n advances by one, p is incremented by a instead of being computed again: the output is the same, and the
+ * closed form is only used after a jump, a change of a, or past t_max.
+ * The output is computed in double precision and rounded once to float.
+ * @n a, b and delay can be changed at any time. The other fields are the internal state, and start at 0.
  */
 struct sig_interpolate_lin_param_f {
-	float a;
-	float b;
-	n_t delay;
+	float a;											//!< slope
+	float b;											//!< value at n = delay
+	n_t delay;											//!< n of the start of the ramp
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	n_t t_last;											//!< n - delay of the last evaluation
+	n_t t_max;											//!< largest n - delay for which p is exact
+	float a_last;										//!< a at the last closed form evaluation
+	double p;											//!< a * t_last
 };
 
 /** @ingroup float
@@ -130,14 +179,163 @@ struct sig_step_param_f {
  * @struct sig_fir_n_param_f
  * @brief structure representing the parameters of a generic n-tap FIR filter
  * you can design your filter with http://t-filter.appspot.com/fir/index.html
+ * @details Two memory layouts are supported:
+ * - legacy (length == 0): taps and samples are tap_count long, and samples is a circular buffer.
+ * - mirrored (length != 0), set by sig_fir_n_init_f(): taps is padded with 0 up to length, and samples is
+ *   2 * length long. Each input is written twice (at index_last and index_last + length), so that the
+ *   x[n-i] history is always contiguous and the filter is a single vectorized dot product.
  */
 struct sig_fir_n_param_f {
 	int tap_count;										//!< how many taps are present
-	int index_last;										//!< index is where the next input should be saved in the samples array
+	int index_last;										//!< index is where the next input should be saved in the samples array. Mirrored layout: index of x[n] in samples
 	float *taps;										//!< points to the taps array
 	float *samples;										//!< points to the x[n-i] history of the source (samples of the source)
 	struct signal_float *source;						//!< source signal for the filter
 	n_t n_last;											//!< the evaluation was done at n = n_last
+	int length;											//!< mirrored layout: tap_count rounded up to SIG_FIR_PAD. 0 for the legacy layout
+};
+
+/** @ingroup float
+ * @struct sig_fir_long_param_f
+ * @brief structure representing the parameters of a long FIR filter, evaluated in the frequency domain
+ * @details The taps are split into partitions of block taps. The input is buffered, and every block samples, the
+ * spectrum of the last 2 * block inputs is multiplied by the spectra of the partitions (uniformly partitioned
+ * overlap-save convolution). The cost per sample is thus about partitions complex products, plus two FFTs of
+ * 2 * block points amortized over block samples, instead of tap_count products.
+ * @n The output of a block is only known when its last input is, so the filter adds a latency of block samples:
+ * the output at n is the one of sig_fir_n_f() at n - latency. Set up by sig_fir_long_init_f(), which keeps the
+ * direct form (latency 0) for short filters.
+ */
+struct sig_fir_long_param_f {
+	int tap_count;										//!< how many taps are present
+	int block;											//!< partition size, power of 2. 0 for the direct form
+	int partitions;										//!< number of partitions
+	int latency;										//!< added latency in samples: block, or 0 for the direct form
+	int fill;											//!< number of inputs of the current block
+	int head;											//!< index of the spectrum of the current block in fdl_re and fdl_im
+	float *input;										//!< last 2 * block inputs
+	float *output;										//!< outputs of the previous block
+	float *taps_re;										//!< spectra of the partitions, block values each (see sig_fft)
+	float *taps_im;
+	float *fdl_re;										//!< frequency-domain delay line: spectra of the last partitions input frames
+	float *fdl_im;
+	float *acc_re;										//!< sum of the products, block values
+	float *acc_im;
+	float *frame;										//!< 2 * block values, output of the inverse FFT
+	struct sig_fft fft;									//!< 2 * block points FFT plan
+	struct sig_fir_n_param_f direct;					//!< direct form filter (mirrored layout), used if block is 0
+	struct signal_float *source;						//!< source signal for the filter
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup float
+ * @struct sig_fir_decim_param_f
+ * @brief structure representing the parameters of a FIR decimator
+ * @details The output runs factor times slower than the source: the output at n is the one of sig_fir_n_f() with
+ * the same taps at the input n * factor. Each evaluation reads the factor inputs (n - 1) * factor + 1 to
+ * n * factor, pushes them into the history, and computes a single dot product: only the kept outputs are
+ * computed. The input n is computed modulo 2^32, so consecutive outputs always read consecutive inputs, even
+ * when n or n * factor rolls over. Set up by sig_fir_decim_init_f().
+ */
+struct sig_fir_decim_param_f {
+	int factor;											//!< decimation factor
+	struct sig_fir_n_param_f fir;						//!< filter at the input rate (mirrored layout). Its source and n_last are not used
+	float *input;										//!< block buffer of the inputs, input_size values
+	int input_size;										//!< size of input: a multiple of factor
+	struct signal_float *source;						//!< source signal, at the input rate
+	n_t n_last;											//!< the evaluation was done at n = n_last (output rate)
+};
+
+/** @ingroup float
+ * @struct sig_fir_interp_param_f
+ * @brief structure representing the parameters of a polyphase FIR interpolator
+ * @details The output runs factor times faster than the source: the output at n is the one of sig_fir_n_f() with
+ * the same taps, fed with the source zero-stuffed (x[n / factor] if n % factor is 0, 0 otherwise). The taps are
+ * split into factor phases, phase p holding taps p, p + factor, p + 2 * factor... so that the output at n only
+ * costs the dot product of phase n % factor with the input history, and the zeros are never multiplied.
+ * @n The input read at n is n / factor. A new input is pushed into the history when it differs from n_in, the
+ * last one read. If factor is a power of 2, the input n rolls over together with the output n (at 2^32 / factor);
+ * otherwise the last input before the roll over has less than factor outputs.
+ * @n The gain of the zero-stuffing is 1 / factor: multiply the taps by factor for a unity gain interpolator.
+ * Set up by sig_fir_interp_init_f().
+ */
+struct sig_fir_interp_param_f {
+	int factor;											//!< interpolation factor
+	struct sig_fir_n_param_f fir;						//!< input history (mirrored layout). taps holds the factor phases, length taps each
+	float *input;										//!< block buffer of the inputs, SIG_BLOCK_CHUNK values
+	struct signal_float *source;						//!< source signal, at the input rate
+	n_t n_in;											//!< input n of the last input pushed into the history
+	n_t n_last;											//!< the evaluation was done at n = n_last (output rate)
+};
+
+/** @ingroup float
+ * @struct sig_biquad_cascade_param_f
+ * @brief structure representing the parameters of a cascade of second-order IIR sections (biquads)
+ * @details Each section is evaluated in transposed direct form II:
+ *   - y = b0 * x + s1
+ *   - s1 = b1 * x - a1 * y + s2
+ *   - s2 = b2 * x - a2 * y
+ *
+ * The output of a section is the input of the next one. Set up by sig_biquad_cascade_init_f(): the coefficients
+ * and states are stored as arrays of length values each (b0[], b1[], b2[], a1[], a2[] then s1[], s2[]), padded
+ * with pass-through sections.
+ */
+struct sig_biquad_cascade_param_f {
+	int sections;										//!< number of second-order sections
+	int length;											//!< sections rounded up to the number of sections evaluated at once by the block kernels
+	float *coef;										//!< b0[], b1[], b2[], a1[] and a2[] arrays, length values each. a0 is 1
+	float *state;										//!< s1[] and s2[] arrays, length values each
+	struct signal_float *source;						//!< source signal for the filter
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup float
+ * @brief response of a single biquad, see sig_biquad_design_f()
+ */
+enum sig_biquad_type_t {
+	SIG_BIQUAD_LOWPASS,									//!< low-pass, resonance q
+	SIG_BIQUAD_HIGHPASS,								//!< high-pass, resonance q
+	SIG_BIQUAD_BANDPASS,								//!< band-pass, 0dB peak gain, bandwidth fc / q
+	SIG_BIQUAD_NOTCH,									//!< notch, bandwidth fc / q
+	SIG_BIQUAD_PEAK,									//!< peaking equalizer, gain_db at fc, bandwidth fc / q
+	SIG_BIQUAD_LOWSHELF,								//!< low shelf, gain_db below fc, slope q
+	SIG_BIQUAD_HIGHSHELF,								//!< high shelf, gain_db above fc, slope q
+};
+
+/** @ingroup float
+ * @struct sig_lut_table_f
+ * @brief piecewise-linear table, shared read-only by any number of sig_lut_f() signals
+ * @details The input is clamped to the first and last breakpoints, and the output is interpolated linearly between
+ * the two breakpoints around it. Two kinds of tables:
+ * - uniform (sig_lut_uniform_init_f()): the segment is found in O(1), without branch, from (x - x0) * inv_dx.
+ *   Each segment is stored as {y_i, y_i+1 - y_i}.
+ * - non-uniform (sig_lut_pwl_init_f()): each signal remembers the segment of its last input (cursor), which is
+ *   checked first. Otherwise, the segment is found by a branchless descent of a complete binary search tree stored
+ *   in Eytzinger (breadth-first) order, padded with +inf: after depth steps, the node index minus 2^depth is the
+ *   number of breakpoints below or equal to the input. Each segment is stored as {x_i, y_i, slope_i, x_i+1}, on
+ *   16 bytes.
+ */
+struct sig_lut_table_f {
+	int size;											//!< number of breakpoints, 2 or more
+	int uniform;										//!< 1 for a uniform grid
+	int depth;											//!< non-uniform: depth of the search tree
+	float x_min;										//!< non-uniform: first breakpoint
+	float x_max;										//!< non-uniform: last breakpoint
+	float x0;											//!< uniform: first breakpoint
+	float inv_dx;										//!< uniform: inverse of the distance between two breakpoints
+	float *seg;											//!< segments, size - 1 of them
+	float *tree;										//!< non-uniform: search tree, 2^depth values. tree[0] is unused
+};
+
+/** @ingroup float
+ * @struct sig_lut_param_f
+ * @brief structure representing the parameters of a lookup-table (piecewise-linear mapping) signal
+ */
+struct sig_lut_param_f {
+	const struct sig_lut_table_f *table;				//!< table, can be shared by several signals
+	int cursor;											//!< non-uniform: segment of the last input
+	struct signal_float *source;						//!< input signal
+	n_t n_last;											//!< the evaluation was done at n = n_last
 };
 
 /** @ingroup float
@@ -185,6 +383,19 @@ struct sig_buf_read_param_f {
 };
 
 
+struct sig_graph_node;
+
+/** @ingroup float
+ * @struct sig_desc_f
+ * @brief describes a sig-func to the graph compiler
+ * @see sig_graph_compile
+ */
+struct sig_desc_f {
+	sig_func_f x;										//!< the sig-func described
+	void (*step)(struct sig_graph_node *node, n_t n);	//!< evaluates the signal at n, reading its sources through node->src. Updates x_cst and n_last as (*x) does
+	int (*sources)(struct signal_float *self, struct signal_float **src, const float **val);	//!< fills the sources of the signal, returns their count (<= SIG_MAX_SOURCES). For each source i, src[i] is the source signal, or NULL; in that case val[i] points to the value to use, or is NULL if the source is absent
+};
+
 /***************************************************************************************/
 /*                              Function definitions                                   */
 /***************************************************************************************/
@@ -203,6 +414,28 @@ struct sig_buf_read_param_f {
 float sig_get_value_f(struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @brief evaluate the signal for count consecutive values of n
+ * @details out[i] receives the value of the signal at (n + i), for 0 <= i < count. The signal is evaluated with
+ * (in order of priority)
+ * -# the @b (*xb) block function, if xb != NULL
+ * -# the @b (*x) function, called for each sample, if x != NULL
+ * -# content of x_var pointer (if x_var != NULL), or x_cst
+ * 
+ * Block functions give the same outputs, bit for bit, as the per-sample evaluation of the same range.
+ * On error, the rest of the block is filled with 0.
+ * @warning a block function evaluates its sources over the whole range before computing its own output.
+ * A stateful signal (IIR, FIR, PID...) used as source by several signals must thus be evaluated per-sample,
+ * or the block must be limited to one sample.
+ * 
+ * @param[in] self pointer to the signal structure
+ * @param[in] n value of n for out[0]
+ * @param[in] count number of samples to evaluate
+ * @param[out] out array of at least count elements receiving the signal values
+ */
+void sig_get_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  *
  * @brief return sampled value of a variable
@@ -228,6 +461,14 @@ float sig_sampler_f(struct signal_float *self, n_t n);
 float sig_add_f(struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_add_f()
+ * @see sig_get_block_f
+ */
+void sig_add_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @brief linear interpolation (ax + b) form
  * @details if n = n_last, then the cached value (x_cst) is returned.
@@ -240,6 +481,16 @@ float sig_add_f(struct signal_float *self, n_t n);
 float sig_interpolate_lin_f(struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_interpolate_lin_f()
+ * @details the samples of a block are computed in independent lanes, from the same exact p, so that they can be
+ * vectorized and still give the values of sig_interpolate_lin_f().
+ * @see sig_get_block_f
+ */
+void sig_interpolate_lin_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @ingroup sig-func
  * @brief Infinite Impulse Response low-pass filter, first order
@@ -253,6 +504,14 @@ float sig_interpolate_lin_f(struct signal_float *self, n_t n);
 float sig_iirlp1_f(struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_iirlp1_f()
+ * @see sig_get_block_f
+ */
+void sig_iirlp1_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @ingroup sig-func
  * @brief Finite Impulse Response filter
@@ -265,9 +524,320 @@ float sig_iirlp1_f(struct signal_float *self, n_t n);
  */
 float sig_fir_n_f(struct signal_float *self, n_t n);
 
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_fir_n_f()
+ * @see sig_get_block_f
+ */
+void sig_fir_n_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a FIR filter with the mirrored layout
+ * @details allocates 64-byte aligned taps (copied from @p taps and padded with 0) and samples (cleared) arrays.
+ * The filter output is computed with the vectorized kernel selected by sig_fir_kernel_f(). The sum is not done
+ * in the same order as with the legacy layout, so outputs are not bit-identical; both stay within
+ * tap_count * FLT_EPSILON * sum(|taps[i] * x[n-i]|) of the exact result.
+ * @param[out] ptr parameters to setup. source and n_last are left untouched
+ * @param[in] taps taps array, copied
+ * @param[in] tap_count number of taps
+ * @return 0 on success, -1 if the memory cannot be allocated
+ */
+int sig_fir_n_init_f(struct sig_fir_n_param_f *ptr, const float *taps, int tap_count);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_fir_n_init_f()
+ */
+void sig_fir_n_free_f(struct sig_fir_n_param_f *ptr);
+
+
+/** @ingroup float
+ * @brief select the dot product kernel used by the mirrored FIR layout
+ * @param[in] kernel kernel to use. SIG_FIR_KERNEL_AUTO selects the best one supported by the CPU
+ * @details also selects the spectral product kernel of sig_fir_long_f(): portable C for the C and SSE kernels, AVX2 +
+ * FMA for the others
+ * @return 0 on success, -1 if the kernel is not supported (the current kernel is kept)
+ */
+int sig_fir_kernel_f(enum sig_fir_kernel_t kernel);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief long Finite Impulse Response filter, with partitioned FFT convolution
+ * @details if n = n_last, then the cached value (x_cst) is returned.
+ * returns the output of sig_fir_n_f() with the same taps at n - latency.
+ * @see sig_fir_long_param_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+float sig_fir_long_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_fir_long_f()
+ * @see sig_get_block_f
+ */
+void sig_fir_long_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a long FIR filter
+ * @details With block = 0, filters of up to SIG_FIR_LONG_DIRECT taps use the direct form, and longer ones the
+ * smallest block size (64 or more) giving at most SIG_FIR_LONG_PARTITIONS partitions.
+ * @param[out] ptr parameters to setup. source and n_last are left untouched
+ * @param[in] taps taps array, copied
+ * @param[in] tap_count number of taps
+ * @param[in] block partition size (power of 2, 16 or more), or 0 to choose it
+ * @return 0 on success, -1 if block is not valid or the memory cannot be allocated
+ */
+int sig_fir_long_init_f(struct sig_fir_long_param_f *ptr, const float *taps, int tap_count, int block);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_fir_long_init_f()
+ */
+void sig_fir_long_free_f(struct sig_fir_long_param_f *ptr);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief FIR decimator
+ * @details if n = n_last, then the cached value (x_cst) is returned.
+ * returns the output of sig_fir_n_f() with the same taps at the input n * factor.
+ * @n Multirate sig-func are not described for the graph compiler: in a graph they are evaluated through (*x), so
+ * their source must not be shared with the signals running at the graph rate.
+ * @see sig_fir_decim_param_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n, at the output rate
+ */
+float sig_fir_decim_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_fir_decim_f(). The source is read by blocks of consecutive inputs
+ * @see sig_get_block_f
+ */
+void sig_fir_decim_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a FIR decimator
+ * @param[out] ptr parameters to setup. source and n_last are left untouched
+ * @param[in] taps taps array, copied
+ * @param[in] tap_count number of taps
+ * @param[in] factor decimation factor, 1 or more
+ * @return 0 on success, -1 if factor is not valid or the memory cannot be allocated
+ */
+int sig_fir_decim_init_f(struct sig_fir_decim_param_f *ptr, const float *taps, int tap_count, int factor);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_fir_decim_init_f()
+ */
+void sig_fir_decim_free_f(struct sig_fir_decim_param_f *ptr);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief polyphase FIR interpolator
+ * @details if n = n_last, then the cached value (x_cst) is returned.
+ * returns the output of sig_fir_n_f() with the same taps, fed with the zero-stuffed source.
+ * Not described for the graph compiler, see sig_fir_decim_f().
+ * @see sig_fir_interp_param_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n, at the output rate
+ */
+float sig_fir_interp_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_fir_interp_f(). The new inputs are read in one block
+ * @see sig_get_block_f
+ */
+void sig_fir_interp_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a polyphase FIR interpolator
+ * @details n_in is set so that the first evaluation reads its input, even at n = 0.
+ * @param[out] ptr parameters to setup. source and n_last are left untouched
+ * @param[in] taps taps array, copied
+ * @param[in] tap_count number of taps
+ * @param[in] factor interpolation factor, 1 or more
+ * @return 0 on success, -1 if factor is not valid or the memory cannot be allocated
+ */
+int sig_fir_interp_init_f(struct sig_fir_interp_param_f *ptr, const float *taps, int tap_count, int factor);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_fir_interp_init_f()
+ */
+void sig_fir_interp_free_f(struct sig_fir_interp_param_f *ptr);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief lookup-table: piecewise-linear mapping of the source
+ * @details if n = n_last, then the cached value (x_cst) is returned. Error -3 if the table is NULL.
+ * @see sig_lut_table_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+float sig_lut_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_lut_f()
+ * @details the AVX2 kernel maps 8 inputs at once with gathers (non-uniform tables: descending the search tree in
+ * the 8 lanes together). It gives the same values as sig_lut_f().
+ * @see sig_get_block_f
+ */
+void sig_lut_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a uniform table
+ * @param[out] table table to setup
+ * @param[in] x0 first breakpoint
+ * @param[in] x1 last breakpoint, greater than x0
+ * @param[in] y values at the size breakpoints, copied
+ * @param[in] size number of breakpoints, 2 or more
+ * @return 0 on success, -1 if the parameters are not valid or the memory cannot be allocated
+ */
+int sig_lut_uniform_init_f(struct sig_lut_table_f *table, float x0, float x1, const float *y, int size);
+
+
+/** @ingroup float
+ * @brief setup a non-uniform table
+ * @param[out] table table to setup
+ * @param[in] x size breakpoints, strictly increasing, copied
+ * @param[in] y values at the breakpoints, copied
+ * @param[in] size number of breakpoints, 2 or more
+ * @return 0 on success, -1 if the parameters are not valid or the memory cannot be allocated
+ */
+int sig_lut_pwl_init_f(struct sig_lut_table_f *table, const float *x, const float *y, int size);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_lut_uniform_init_f() or sig_lut_pwl_init_f()
+ */
+void sig_lut_free_f(struct sig_lut_table_f *table);
+
+
+/** @ingroup float
+ * @brief select the kernel used by sig_lut_block_f()
+ * @param[in] kernel SIG_FIR_KERNEL_C, SIG_FIR_KERNEL_AVX2, or SIG_FIR_KERNEL_AUTO for the best one supported by the CPU
+ * @return 0 on success, -1 if the kernel is not supported (the current kernel is kept)
+ */
+int sig_lut_kernel_f(enum sig_fir_kernel_t kernel);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief cascade of second-order IIR sections
+ * @details if n = n_last, then the cached value (x_cst) is returned.
+ * @see sig_biquad_cascade_param_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+float sig_biquad_cascade_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_biquad_cascade_f()
+ * @details The source is read as a block, then filtered in place. The AVX2 kernel runs 8 sections at once, each
+ * lane being one sample behind the previous one, so its cost barely depends on the number of sections up to 8. The results are bit-identical to
+ * sig_biquad_cascade_f() with every kernel.
+ * @see sig_get_block_f
+ */
+void sig_biquad_cascade_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief setup a biquad cascade
+ * @details allocates 64-byte aligned coefficients (copied from @p coef) and states (cleared) arrays.
+ * @param[out] ptr parameters to setup. source and n_last are left untouched
+ * @param[in] coef sections * 5 coefficients: b0, b1, b2, a1 and a2 of each section, a0 being normalized to 1
+ * @param[in] sections number of sections
+ * @return 0 on success, -1 if sections < 1 or the memory cannot be allocated
+ */
+int sig_biquad_cascade_init_f(struct sig_biquad_cascade_param_f *ptr, const float *coef, int sections);
+
+
+/** @ingroup float
+ * @brief free the arrays allocated by sig_biquad_cascade_init_f()
+ */
+void sig_biquad_cascade_free_f(struct sig_biquad_cascade_param_f *ptr);
+
+
+/** @ingroup float
+ * @brief select the kernel used by sig_biquad_cascade_block_f()
+ * @param[in] kernel SIG_FIR_KERNEL_AUTO, SIG_FIR_KERNEL_C or SIG_FIR_KERNEL_AVX2
+ * @return 0 on success, -1 if the kernel is not supported (the current kernel is kept)
+ */
+int sig_biquad_kernel_f(enum sig_fir_kernel_t kernel);
+
+
+/** @ingroup float
+ * @brief design a single biquad (bilinear transform of the analog prototype, frequency pre-warped)
+ * @param[out] coef b0, b1, b2, a1 and a2
+ * @param[in] type response
+ * @param[in] fc center or cutoff frequency, as a fraction of the sampling rate (0 < fc < 0.5)
+ * @param[in] q quality factor (0.7071 for a Butterworth low-pass or high-pass), or slope of the shelves (1 for the steepest monotonic slope)
+ * @param[in] gain_db gain of the peak and shelves, unused by the other responses
+ * @return 0 on success, -1 if a parameter is out of range
+ */
+int sig_biquad_design_f(float *coef, enum sig_biquad_type_t type, float fc, float q, float gain_db);
+
+
+/** @ingroup float
+ * @brief design a Butterworth low-pass or high-pass filter, -3dB at fc
+ * @details Odd orders end with a first-order section (b2 = a2 = 0).
+ * @param[out] coef (order + 1) / 2 * 5 coefficients
+ * @param[in] order filter order (1 or more)
+ * @param[in] fc cutoff frequency, as a fraction of the sampling rate (0 < fc < 0.5)
+ * @param[in] highpass 0 for a low-pass, 1 for a high-pass
+ * @return number of sections, -1 if a parameter is out of range
+ */
+int sig_biquad_butterworth_f(float *coef, int order, float fc, int highpass);
+
+
+/** @ingroup float
+ * @brief design a Chebyshev type I low-pass or high-pass filter, with ripple_db of ripple in the pass band
+ * @details fc is the edge of the pass band: the gain at fc is -ripple_db. The DC (low-pass) or Nyquist
+ * (high-pass) gain is 0dB for odd orders, -ripple_db for even orders.
+ * @param[out] coef (order + 1) / 2 * 5 coefficients
+ * @param[in] order filter order (1 or more)
+ * @param[in] fc pass band edge, as a fraction of the sampling rate (0 < fc < 0.5)
+ * @param[in] ripple_db pass band ripple, in dB (> 0)
+ * @param[in] highpass 0 for a low-pass, 1 for a high-pass
+ * @return number of sections, -1 if a parameter is out of range
+ */
+int sig_biquad_chebyshev_f(float *coef, int order, float fc, float ripple_db, int highpass);
+
 float sig_step_f(struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_step_f()
+ * @see sig_get_block_f
+ */
+void sig_step_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @ingroup sig-func
  * @brief PID computation, naive (trivial) version.
@@ -281,6 +851,14 @@ float sig_step_f(struct signal_float *self, n_t n);
 float sig_pid_naive_f (struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_pid_naive_f()
+ * @see sig_get_block_f
+ */
+void sig_pid_naive_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @ingroup sig-func
  * @brief PID computation, optimized version
@@ -294,6 +872,14 @@ float sig_pid_naive_f (struct signal_float *self, n_t n);
 float sig_pid_opt_f (struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_pid_opt_f()
+ * @see sig_get_block_f
+ */
+void sig_pid_opt_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
 /** @ingroup float
  * @ingroup sig-func
  * @brief PID K-params computation. Must be used each time the P,I or D parameters are modified
@@ -320,6 +906,22 @@ void sig_pid_compute_k_f (struct signal_float *self);
 float sig_buf_read_f (struct signal_float *self, n_t n);
 
 
+/** @ingroup float
+ * @ingroup sig-func
+ * @brief block version of sig_buf_read_f()
+ * @see sig_get_block_f
+ */
+void sig_buf_read_block_f(struct signal_float *self, n_t n, int count, float *out);
+
+
+/** @ingroup float
+ * @brief find the graph compiler description of a sig-func
+ * @param[in] x the sig-func
+ * @return the description, or NULL if the sig-func is unknown
+ */
+const struct sig_desc_f *sig_desc_find_f(sig_func_f x);
+
+
 #if SIG_DBG_NAME || defined(__DOXYGEN__)
 #if SIG_SEARCH || defined(__DOXYGEN__)
 /** @ingroup float
@@ -329,6 +931,7 @@ float sig_buf_read_f (struct signal_float *self, n_t n);
  * @param[in] *name string containing the signal you are searching for
  * @param[in] *array array of struct signal_float.
  * @param[in] len search until len is reached, or the signal is found.
+ * @note this is a linear scan: to resolve many names, register the signals in a struct sig_reg and use sig_reg_find_f()
  */
 struct signal_float *sig_search_f(char *name, struct signal_float *array, int len);
 
@@ -339,6 +942,7 @@ struct signal_float *sig_search_f(char *name, struct signal_float *array, int le
  * @details returns the pointer to the matching signal, or NULL if not found
  * @param[in] *name string containing the signal you are searching for
  * @param[in] **list array of pointers to struct signal_float. Must be ended with NULL
+ * @note this is a linear scan: to resolve many names, register the signals in a struct sig_reg and use sig_reg_find_f()
  */
 struct signal_float *sig_search_list_f(char *name, struct signal_float **list);
 #endif	// SIG_SEARCH
@@ -0,0 +1,260 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigfft.c
+ * SigLib Code, real Fast Fourier Transform
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "sigfft.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIG_FFT_X86		1
+#include <immintrin.h>
+#endif
+
+#define SIG_FFT_PI			3.14159265358979323846L		// long double: not affected by -fsingle-precision-constant
+
+static void sig_fft_stage_c(float *zr, float *zi, const float *wr, const float *wi, int m, int half);
+#if defined(SIG_FFT_X86)
+static void sig_fft_stage_avx2(float *zr, float *zi, const float *wr, const float *wi, int m, int half);
+#endif
+
+
+int sig_fft_init(struct sig_fft *self, int size)
+{
+	int m = size / 2;
+	int k, bits, r, i, half;
+
+	self->rev = NULL;
+	self->tw_re = self->tw_im = self->rtw = self->work = NULL;
+	if ((size < 4) || (size & (size - 1)))
+		return -1;
+	self->size = size;
+	self->rev = malloc(m * sizeof(int));
+	self->tw_re = malloc(m * sizeof(float));
+	self->tw_im = malloc(m * sizeof(float));
+	self->rtw = malloc(size * sizeof(float));
+	self->work = aligned_alloc(64, (size * sizeof(float) + 63) / 64 * 64);
+	if ((self->rev == NULL) || (self->tw_re == NULL) || (self->tw_im == NULL) || (self->rtw == NULL) ||
+		(self->work == NULL))
+	{
+		sig_fft_free(self);
+		return -1;
+	}
+
+	for (bits=0; (1 << bits) < m; bits++)
+		;
+	for (k=0; k<m; k++)
+	{
+		for (r=0, i=0; i<bits; i++)
+			r |= ((k >> i) & 1) << (bits - 1 - i);
+		self->rev[k] = r;
+	}
+	for (half=1; half<m; half*=2)
+		for (k=0; k<half; k++)
+		{
+			self->tw_re[half - 1 + k] = cos(-(double)SIG_FFT_PI * k / half);
+			self->tw_im[half - 1 + k] = sin(-(double)SIG_FFT_PI * k / half);
+		}
+	for (k=0; k<m; k++)
+	{
+		self->rtw[2*k] = cos(-2 * (double)SIG_FFT_PI * k / size);
+		self->rtw[2*k + 1] = sin(-2 * (double)SIG_FFT_PI * k / size);
+	}
+	sig_fft_kernel(self, SIG_FIR_KERNEL_AUTO);			// resolved once: the transforms only read the plan
+	return 0;
+}
+
+
+int sig_fft_kernel(struct sig_fft *self, enum sig_fir_kernel_t kernel)
+{
+#if defined(SIG_FFT_X86)
+	__builtin_cpu_init();
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = __builtin_cpu_supports("avx2") ? SIG_FIR_KERNEL_AVX2 : SIG_FIR_KERNEL_C;
+	if ((kernel == SIG_FIR_KERNEL_AVX2) && __builtin_cpu_supports("avx2"))
+	{
+		self->stage = sig_fft_stage_avx2;
+		return 0;
+	}
+#else
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+		kernel = SIG_FIR_KERNEL_C;
+#endif
+	if (kernel != SIG_FIR_KERNEL_C)
+		return -1;
+	self->stage = sig_fft_stage_c;
+	return 0;
+}
+
+
+void sig_fft_free(struct sig_fft *self)
+{
+	free(self->rev);
+	free(self->tw_re);
+	free(self->tw_im);
+	free(self->rtw);
+	free(self->work);
+	self->rev = NULL;
+	self->tw_re = self->tw_im = self->rtw = self->work = NULL;
+}
+
+
+/**
+ * @brief one radix-2 stage of the complex transform: butterflies between the points half apart
+ */
+static void sig_fft_stage_c(float *zr, float *zi, const float *wr, const float *wi, int m, int half)
+{
+	float tr, ti;
+	int s, j, a, b;
+
+	for (s=0; s<m; s+=2*half)
+		for (j=0; j<half; j++)
+		{
+			a = s + j;
+			b = a + half;
+			tr = wr[j] * zr[b] - wi[j] * zi[b];
+			ti = wr[j] * zi[b] + wi[j] * zr[b];
+			zr[b] = zr[a] - tr;
+			zi[b] = zi[a] - ti;
+			zr[a] += tr;
+			zi[a] += ti;
+		}
+}
+
+#if defined(SIG_FFT_X86)
+/**
+ * @brief sig_fft_stage_c(), 8 butterflies at once (the stages with half < 8 use sig_fft_stage_c()). No FMA, so that
+ * the results are the same
+ */
+__attribute__((target("avx2")))
+static void sig_fft_stage_avx2(float *zr, float *zi, const float *wr, const float *wi, int m, int half)
+{
+	__m256 ar, ai, br, bi, tr, ti, cr, ci;
+	int s, j;
+
+	if (half < 8)
+	{
+		sig_fft_stage_c(zr, zi, wr, wi, m, half);
+		return;
+	}
+
+	for (s=0; s<m; s+=2*half)
+		for (j=0; j<half; j+=8)
+		{
+			cr = _mm256_loadu_ps(wr + j);
+			ci = _mm256_loadu_ps(wi + j);
+			ar = _mm256_load_ps(zr + s + j);
+			ai = _mm256_load_ps(zi + s + j);
+			br = _mm256_load_ps(zr + s + j + half);
+			bi = _mm256_load_ps(zi + s + j + half);
+			tr = _mm256_sub_ps(_mm256_mul_ps(cr, br), _mm256_mul_ps(ci, bi));
+			ti = _mm256_add_ps(_mm256_mul_ps(cr, bi), _mm256_mul_ps(ci, br));
+			_mm256_store_ps(zr + s + j + half, _mm256_sub_ps(ar, tr));
+			_mm256_store_ps(zi + s + j + half, _mm256_sub_ps(ai, ti));
+			_mm256_store_ps(zr + s + j, _mm256_add_ps(ar, tr));
+			_mm256_store_ps(zi + s + j, _mm256_add_ps(ai, ti));
+		}
+}
+#endif
+
+
+/**
+ * @brief in-place complex transform of the bit-reversed points (zr, zi)
+ * @details the inverse transform is the forward transform with the real and imaginary parts swapped
+ */
+static void sig_fft_complex(struct sig_fft *self, float *zr, float *zi)
+{
+	int m = self->size / 2;
+	int half;
+
+	for (half=1; half<m; half*=2)
+		self->stage(zr, zi, self->tw_re + half - 1, self->tw_im + half - 1, m, half);
+}
+
+
+void sig_fft_real(struct sig_fft *self, const float *in, float *re, float *im)
+{
+	int m = self->size / 2;
+	float *zr = self->work;
+	float *zi = self->work + m;
+	float er, ei, or, oi, wr, wi;
+	int k;
+
+	// the even and odd points are the real and imaginary parts of a size / 2 points complex signal
+	for (k=0; k<m; k++)
+	{
+		zr[self->rev[k]] = in[2*k];
+		zi[self->rev[k]] = in[2*k + 1];
+	}
+	sig_fft_complex(self, zr, zi);
+
+	re[0] = zr[0] + zi[0];
+	im[0] = zr[0] - zi[0];
+	for (k=1; k<m; k++)
+	{
+		// E = (Z[k] + conj(Z[m-k])) / 2, O = (Z[k] - conj(Z[m-k])) / 2i, X[k] = E + W^k O
+		er = (zr[k] + zr[m-k]) / 2;
+		ei = (zi[k] - zi[m-k]) / 2;
+		or = (zi[k] + zi[m-k]) / 2;
+		oi = (zr[m-k] - zr[k]) / 2;
+		wr = self->rtw[2*k];
+		wi = self->rtw[2*k + 1];
+		re[k] = er + wr * or - wi * oi;
+		im[k] = ei + wr * oi + wi * or;
+	}
+}
+
+
+void sig_fft_real_inverse(struct sig_fft *self, const float *re, const float *im, float *out)
+{
+	int m = self->size / 2;
+	float *zr = self->work;
+	float *zi = self->work + m;
+	float er, ei, dr, di, or, oi, wr, wi;
+	int k, r;
+
+	zr[0] = re[0] + im[0];
+	zi[0] = re[0] - im[0];
+	for (k=1; k<m; k++)
+	{
+		// E = X[k] + conj(X[m-k]), O = (X[k] - conj(X[m-k])) conj(W^k), Z[k] = E + i O
+		er = re[k] + re[m-k];
+		ei = im[k] - im[m-k];
+		dr = re[k] - re[m-k];
+		di = im[k] + im[m-k];
+		wr = self->rtw[2*k];
+		wi = self->rtw[2*k + 1];
+		or = dr * wr + di * wi;
+		oi = di * wr - dr * wi;
+		r = self->rev[k];
+		zr[r] = er - oi;
+		zi[r] = ei + or;
+	}
+	sig_fft_complex(self, zi, zr);						// inverse: real and imaginary parts swapped
+	for (k=0; k<m; k++)
+	{
+		out[2*k] = zr[k];
+		out[2*k + 1] = zi[k];
+	}
+}
@@ -0,0 +1,97 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigfft.h
+ * SigLib Header, real Fast Fourier Transform
+ */
+
+#ifndef SIG_FFT_H__
+#define SIG_FFT_H__
+
+#include "sig.h"
+
+
+/** @ingroup fft
+ * @struct sig_fft
+ * @brief plan of a real FFT of size points
+ * @details The spectrum of size real points is stored as two arrays of size / 2 values: re[k] and im[k] are the
+ * real and imaginary parts of bin k, except for bin 0, whose imaginary part is always 0: im[0] holds the real part of
+ * bin size / 2 (Nyquist) instead.
+ * @n The transforms use the plan work buffer: a plan can't be shared by threads.
+ */
+struct sig_fft {
+	int size;											//!< number of real points, power of 2 (4 or more)
+	int *rev;											//!< bit reversal permutation of the size / 2 points complex transform
+	float *tw_re;										//!< twiddles of the stages of the complex transform. Stage of length len: exp(-2 i pi j / len), j < len / 2, at len / 2 - 1
+	float *tw_im;
+	float *rtw;											//!< twiddles of the real transform: exp(-2 i pi k / size), cos and sin interleaved
+	float *work;										//!< size floats: real parts then imaginary parts of size / 2 complex values
+	void (*stage)(float *zr, float *zi, const float *wr, const float *wi, int m, int half);	//!< radix-2 stage of the complex transform, see sig_fft_kernel()
+};
+
+
+/** @ingroup fft
+ * @brief allocate a plan
+ * @param[out] self plan
+ * @details the kernel is the best one supported by the CPU, see sig_fft_kernel()
+ * @param[in] size number of real points, power of 2 (4 or more)
+ * @return 0 on success, -1 if size is not valid or the memory cannot be allocated
+ */
+int sig_fft_init(struct sig_fft *self, int size);
+
+
+/** @ingroup fft
+ * @brief select the kernel of the transforms of a plan
+ * @details the kernels give the same results: the AVX2 one doesn't use FMA
+ * @param[in,out] self plan
+ * @param[in] kernel SIG_FIR_KERNEL_C, SIG_FIR_KERNEL_AVX2, or SIG_FIR_KERNEL_AUTO for the best one supported by the CPU
+ * @return 0 on success, -1 if the kernel is not supported (the current kernel is kept)
+ */
+int sig_fft_kernel(struct sig_fft *self, enum sig_fir_kernel_t kernel);
+
+
+/** @ingroup fft
+ * @brief free the arrays allocated by sig_fft_init()
+ */
+void sig_fft_free(struct sig_fft *self);
+
+
+/** @ingroup fft
+ * @brief forward transform of size real points
+ * @param[in] self plan
+ * @param[in] in size points
+ * @param[out] re size / 2 real parts, re[0] being the DC bin
+ * @param[out] im size / 2 imaginary parts, im[0] being the real part of the Nyquist bin
+ */
+void sig_fft_real(struct sig_fft *self, const float *in, float *re, float *im);
+
+
+/** @ingroup fft
+ * @brief inverse transform of a spectrum of size real points, not normalized
+ * @details out is size times the signal whose sig_fft_real() is (re, im).
+ * @param[in] self plan
+ * @param[in] re size / 2 real parts
+ * @param[in] im size / 2 imaginary parts
+ * @param[out] out size points
+ */
+void sig_fft_real_inverse(struct sig_fft *self, const float *re, const float *im, float *out);
+
+#endif
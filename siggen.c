@@ -0,0 +1,513 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file siggen.c
+ * SigLib Code, C code generator of compiled graphs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "siggen.h"
+
+#define SIG_GEN_OPERAND		64							//!< maximum length of an operand in the generated code
+
+/**
+ * @brief the generator walks the schedule once per pass
+ */
+enum sig_gen_pass_t {
+	SIG_GEN_CHECK,										//!< check the parameters and collect the inputs. Nothing is written
+	SIG_GEN_FIELDS,										//!< fields of the state struct, other than x
+	SIG_GEN_INIT,										//!< initial values of these fields
+	SIG_GEN_TABLES,										//!< constant tables
+	SIG_GEN_STEP,										//!< code of the step function
+};
+
+/**
+ * @brief state of the generator
+ */
+struct sig_gen_ctx {
+	struct sig_gen *gen;
+	struct sig_graph *graph;
+	const char *prefix;
+	FILE *out;
+	int i;												//!< schedule entry being written
+	struct signal_float *sig;							//!< its signal
+};
+
+/**
+ * @brief writes the code of a sig-func, for each pass
+ */
+struct sig_gen_desc {
+	sig_func_f x;
+	int (*write)(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass);
+};
+
+
+/**
+ * @brief exact float literal (hexadecimal)
+ */
+static void sig_gen_literal(char *s, float x)
+{
+	if (isnan(x))
+		strcpy(s, "NAN");
+	else if (isinf(x))
+		strcpy(s, x > 0 ? "INFINITY" : "(-INFINITY)");
+	else if (signbit(x))
+		snprintf(s, SIG_GEN_OPERAND, "(%af)", x);
+	else
+		snprintf(s, SIG_GEN_OPERAND, "%af", x);
+}
+
+
+/**
+ * @brief write an initializer of count floats, 8 per line. nested: the initializer is a struct member
+ */
+static void sig_gen_array(FILE *out, const float *x, int count, int nested)
+{
+	char s[SIG_GEN_OPERAND];
+	int i;
+
+	fprintf(out, "{");
+	for (i=0; i<count; i++)
+	{
+		sig_gen_literal(s, x[i]);
+		fprintf(out, "%s%s%s%s", (i % 8) ? " " : (nested ? "\n\t\t" : "\n\t"), s, (i < count - 1) ? "," : "\n",
+			(i < count - 1) || !nested ? "" : "\t");
+	}
+	fprintf(out, "}");
+}
+
+
+static int sig_gen_error(struct sig_gen_ctx *ctx, int err)
+{
+	ctx->gen->err_sig = ctx->sig;
+	return err;
+}
+
+
+/**
+ * @brief operand reading a variable. Variables are numbered in the order they are met
+ */
+static int sig_gen_var(struct sig_gen_ctx *ctx, float *var, char *s)
+{
+	int k;
+
+	for (k=0; (k<ctx->gen->vars) && (ctx->gen->var[k] != var); k++);
+	if (k == ctx->gen->vars)
+	{
+		if (k == SIG_GEN_MAX_INPUTS)
+			return sig_gen_error(ctx, SIG_ERR_FULL);
+		ctx->gen->var[ctx->gen->vars++] = var;
+	}
+	snprintf(s, SIG_GEN_OPERAND, "(*%s_var[%d])", ctx->prefix, k);
+	return 0;
+}
+
+
+/**
+ * @brief index of a buffer. Buffers are numbered in the order they are met
+ */
+static int sig_gen_buffer(struct sig_gen_ctx *ctx, const float *buffer)
+{
+	int k;
+
+	for (k=0; (k<ctx->gen->buffers) && (ctx->gen->buffer[k] != buffer); k++);
+	if (k == ctx->gen->buffers)
+	{
+		if (k == SIG_GEN_MAX_INPUTS)
+			return sig_gen_error(ctx, SIG_ERR_FULL);
+		ctx->gen->buffer[ctx->gen->buffers++] = buffer;
+	}
+	return k;
+}
+
+
+/**
+ * @brief operand of a source: source signal if not NULL, else variable if not NULL, else constant
+ * @details a sig-func source was scheduled before the current entry: its value is in the state. sig-ptr are
+ * variables, sig-cst are constants
+ */
+static int sig_gen_operand(struct sig_gen_ctx *ctx, struct signal_float *src, float *var, float cst, char *s)
+{
+	int k;
+
+	if (src && src->x)
+	{
+		for (k=ctx->i-1; (k>=0) && (ctx->graph->nodes[k].sig != src); k--);
+		if (k < 0)
+			return sig_gen_error(ctx, SIG_ERR_UNSUPPORTED);
+		snprintf(s, SIG_GEN_OPERAND, "s->x[%d]", k);
+		return 0;
+	}
+	if (src)
+	{
+		var = src->x_var;
+		cst = src->x_cst;
+	}
+	if (var)
+		return sig_gen_var(ctx, var, s);
+	sig_gen_literal(s, cst);
+	return 0;
+}
+
+
+static int sig_gen_sampler(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	char x[SIG_GEN_OPERAND];
+
+	if ((pass != SIG_GEN_CHECK) && (pass != SIG_GEN_STEP))
+		return 0;
+	if (ctx->sig->x_var == NULL)
+		return sig_gen_error(ctx, SIG_ERR_NO_CONFIG);
+	if (sig_gen_var(ctx, ctx->sig->x_var, x))
+		return SIG_ERR_FULL;
+	if (pass == SIG_GEN_STEP)
+		fprintf(ctx->out, "\ts->x[%d] = %s;\n", ctx->i, x);
+	return 0;
+}
+
+
+static int sig_gen_add(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_add_param_f *ptr = (struct sig_add_param_f *)ctx->sig->params;
+	char a[SIG_GEN_OPERAND], b[SIG_GEN_OPERAND];
+	int ret;
+
+	if ((pass != SIG_GEN_CHECK) && (pass != SIG_GEN_STEP))
+		return 0;
+	if ((ret = sig_gen_operand(ctx, ptr->a, ptr->a_var, ptr->a_cst, a)) ||
+		(ret = sig_gen_operand(ctx, ptr->b, ptr->b_var, ptr->b_cst, b)))
+		return ret;
+	if (pass == SIG_GEN_STEP)
+		fprintf(ctx->out, "\ts->x[%d] = %s + %s;\n", ctx->i, a, b);
+	return 0;
+}
+
+
+static int sig_gen_iirlp1(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_iirlp1_param_f *ptr = (struct sig_iirlp1_param_f *)ctx->sig->params;
+	char x[SIG_GEN_OPERAND], a[SIG_GEN_OPERAND], oma[SIG_GEN_OPERAND];
+	int ret;
+
+	if ((pass != SIG_GEN_CHECK) && (pass != SIG_GEN_STEP))
+		return 0;
+	if ((ret = sig_gen_operand(ctx, ptr->source, NULL, 0, x)))
+		return ret;
+	sig_gen_literal(a, ptr->a);
+	sig_gen_literal(oma, ptr->oma);
+	if (pass == SIG_GEN_STEP)
+		fprintf(ctx->out, "\ts->x[%d] = (s->x[%d] * %s) + (%s * %s);\n", ctx->i, ctx->i, oma, x, a);
+	return 0;
+}
+
+
+static int sig_gen_step(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_step_param_f *ptr = (struct sig_step_param_f *)ctx->sig->params;
+	char active[SIG_GEN_OPERAND], inact[SIG_GEN_OPERAND];
+
+	if (pass != SIG_GEN_STEP)
+		return 0;
+	sig_gen_literal(active, ptr->x_active);
+	sig_gen_literal(inact, ptr->x_inact);
+	fprintf(ctx->out, "\ts->x[%d] = ((n >= %uu) %s (n <= %uu)) ? %s : %s;\n", ctx->i,
+		ptr->n_min, ptr->n_min > ptr->n_max ? "||" : "&&", ptr->n_max, active, inact);
+	return 0;
+}
+
+
+/**
+ * @brief FIR filter. The mirrored layout is summed as sig_fir_dot_c() does
+ */
+static int sig_gen_fir_n(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_fir_n_param_f *ptr = (struct sig_fir_n_param_f *)ctx->sig->params;
+	char x[SIG_GEN_OPERAND];
+	const char *p = ctx->prefix;
+	FILE *out = ctx->out;
+	int i = ctx->i, ret;
+	int len = ptr->length ? ptr->length : ptr->tap_count;
+	int samples = ptr->length ? 2 * ptr->length : ptr->tap_count;
+
+	switch (pass)
+	{
+	case SIG_GEN_CHECK:
+		if ((ptr->taps == NULL) || (ptr->samples == NULL) || (ptr->tap_count <= 0))
+			return sig_gen_error(ctx, SIG_ERR_NO_CONFIG);
+		return sig_gen_operand(ctx, ptr->source, NULL, 0, x);
+	case SIG_GEN_FIELDS:
+		fprintf(out, "\tint s%d_index;\n\tfloat s%d_samples[%d];\n", i, i, samples);
+		return 0;
+	case SIG_GEN_INIT:
+		fprintf(out, "\t.s%d_index = %d,\n\t.s%d_samples = ", i, ptr->index_last, i);
+		sig_gen_array(out, ptr->samples, samples, 1);
+		fprintf(out, ",\n");
+		return 0;
+	case SIG_GEN_TABLES:
+		fprintf(out, "static const float %s_taps%d[%d] = ", p, i, len);
+		sig_gen_array(out, ptr->taps, len, 0);
+		fprintf(out, ";\n\n");
+		return 0;
+	case SIG_GEN_STEP:
+		break;
+	}
+
+	if ((ret = sig_gen_operand(ctx, ptr->source, NULL, 0, x)))
+		return ret;
+	if (ptr->length)
+	{
+		fprintf(out, "\t{\n\t\tconst float *x;\n\t\tfloat acc[4] = {0, 0, 0, 0};\n");
+		fprintf(out, "\t\tint k = s->s%d_index != 0 ? s->s%d_index - 1 : %d, j;\n\n", i, i, len - 1);
+		fprintf(out, "\t\ts->s%d_samples[k] = %s;\n", i, x);
+		fprintf(out, "\t\ts->s%d_samples[k + %d] = s->s%d_samples[k];\n", i, len, i);
+		fprintf(out, "\t\ts->s%d_index = k;\n\t\tx = s->s%d_samples + k;\n", i, i);
+		fprintf(out, "\t\tfor (j=0; j<%d; j+=4)\n\t\t{\n", len);
+		fprintf(out, "\t\t\tacc[0] += %s_taps%d[j] * x[j];\n", p, i);
+		fprintf(out, "\t\t\tacc[1] += %s_taps%d[j+1] * x[j+1];\n", p, i);
+		fprintf(out, "\t\t\tacc[2] += %s_taps%d[j+2] * x[j+2];\n", p, i);
+		fprintf(out, "\t\t\tacc[3] += %s_taps%d[j+3] * x[j+3];\n", p, i);
+		fprintf(out, "\t\t}\n\t\ts->x[%d] = (acc[0] + acc[1]) + (acc[2] + acc[3]);\n\t}\n", i);
+	}
+	else
+	{
+		fprintf(out, "\t{\n\t\tfloat y = 0;\n\t\tint k, j;\n\n");
+		fprintf(out, "\t\ts->s%d_samples[s->s%d_index++] = %s;\n", i, i, x);
+		fprintf(out, "\t\ts->s%d_index %%= %d;\n\t\tk = s->s%d_index;\n", i, len, i);
+		fprintf(out, "\t\tfor (j=0; j<%d; j++)\n\t\t{\n", len);
+		fprintf(out, "\t\t\tk = k != 0 ? k - 1 : %d;\n", len - 1);
+		fprintf(out, "\t\t\ty += s->s%d_samples[j] * %s_taps%d[k];\n", i, p, i);
+		fprintf(out, "\t\t}\n\t\ts->x[%d] = y;\n\t}\n", i);
+	}
+	return 0;
+}
+
+
+/**
+ * @brief PID, both forms. Same operations as sig_pid_step_f()
+ */
+static int sig_gen_pid(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_pid_param_f *ptr = (struct sig_pid_param_f *)ctx->sig->params;
+	struct signal_float *src[5] = {ptr->setpoint, ptr->feedback};
+	char x[5][SIG_GEN_OPERAND], k[3][SIG_GEN_OPERAND], m[SIG_GEN_OPERAND], s[SIG_GEN_OPERAND];
+	const char *p = ctx->prefix;
+	FILE *out = ctx->out;
+	int naive = (ctx->sig->x == sig_pid_naive_f);
+	int i = ctx->i, j, ret;
+
+#if SIG_PID_FF
+	src[2] = ptr->ff0;
+	src[3] = ptr->ff1;
+	src[4] = ptr->ff2;
+#endif
+	switch (pass)
+	{
+	case SIG_GEN_FIELDS:
+		fprintf(out, "\tfloat s%d_integral;\n\tfloat s%d_history[3];\n", i, i);
+		return 0;
+	case SIG_GEN_INIT:
+		sig_gen_literal(s, ptr->integral);
+		fprintf(out, "\t.s%d_integral = %s,\n\t.s%d_history = ", i, s, i);
+		sig_gen_array(out, ptr->history, 3, 1);
+		fprintf(out, ",\n");
+		return 0;
+	case SIG_GEN_TABLES:
+		return 0;
+	case SIG_GEN_CHECK:
+	case SIG_GEN_STEP:
+		break;
+	}
+
+	if (ptr->setpoint == NULL)
+		return sig_gen_error(ctx, SIG_ERR_NO_CONFIG);
+	for (j=0; j<5; j++)
+		if (src[j] && (ret = sig_gen_operand(ctx, src[j], NULL, 0, x[j])))
+			return ret;
+	if (pass == SIG_GEN_CHECK)
+		return 0;
+
+	sig_gen_literal(m, ptr->max_output);
+	fprintf(out, "\t{\n\t\tfloat x = %s%s%s;\n\n", x[0], src[1] ? " - " : "", src[1] ? x[1] : "");
+	fprintf(out, "\t\ts->s%d_history[2] = s->s%d_history[1];\n", i, i);
+	fprintf(out, "\t\ts->s%d_history[1] = s->s%d_history[0];\n", i, i);
+	fprintf(out, "\t\ts->s%d_history[0] = x;\n", i);
+	if (naive)
+	{
+		sig_gen_literal(k[0], ptr->p);
+		sig_gen_literal(k[1], ptr->i);
+		sig_gen_literal(k[2], ptr->d);
+		fprintf(out, "\t\tx = s->s%d_history[0] * %s;\n", i, k[0]);
+		fprintf(out, "\t\ts->s%d_integral += s->s%d_history[0] * %s;\n", i, i, k[1]);
+		fprintf(out, "\t\tx += s->s%d_integral;\n", i);
+		fprintf(out, "\t\tx += (s->s%d_history[0] - s->s%d_history[1]) * %s;\n", i, i, k[2]);
+	}
+	else
+	{
+		for (j=0; j<3; j++)
+		{
+			sig_gen_literal(k[j], ptr->k[j]);
+			fprintf(out, "\t\ts->s%d_integral += s->s%d_history[%d] * %s;\n", i, i, j, k[j]);
+		}
+		fprintf(out, "\t\ts->s%d_integral = %s_limit(s->s%d_integral, %s);\n", i, p, i, m);
+		fprintf(out, "\t\tx = s->s%d_integral;\n", i);
+	}
+#if SIG_PID_FF
+	for (j=0; j<3; j++)
+		if (src[2 + j])
+		{
+			sig_gen_literal(s, ptr->ff[j]);
+			fprintf(out, "\t\tx += %s * %s;\n", x[2 + j], s);
+		}
+#endif
+	if (naive)
+		fprintf(out, "\t\ts->s%d_integral = %s_limit(s->s%d_integral, %s);\n", i, p, i, m);
+	if (naive || SIG_PID_FF)
+		fprintf(out, "\t\tx = %s_limit(x, %s);\n", p, m);
+	fprintf(out, "\t\ts->x[%d] = x;\n\t}\n", i);
+	return 0;
+}
+
+
+static int sig_gen_buf_read(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	struct sig_buf_read_param_f *ptr = (struct sig_buf_read_param_f *)ctx->sig->params;
+	int b;
+
+	if ((pass != SIG_GEN_CHECK) && (pass != SIG_GEN_STEP))
+		return 0;
+	if ((ptr->buffer == NULL) || (ptr->size <= 0))
+		return sig_gen_error(ctx, SIG_ERR_NO_CONFIG);
+	b = sig_gen_buffer(ctx, ptr->buffer);
+	if (b < 0)
+		return b;
+	if (pass != SIG_GEN_STEP)
+		return 0;
+	if (ptr->circular)
+		fprintf(ctx->out, "\ts->x[%d] = %s_buffer[%d][(n + %uu) %% %uu];\n", ctx->i, ctx->prefix, b,
+			(n_t)ptr->delta, (n_t)ptr->size);
+	else
+		fprintf(ctx->out, "\ts->x[%d] = %s_buffer[%d][%s_stick(n + %uu, %uu)];\n", ctx->i, ctx->prefix, b,
+			ctx->prefix, (n_t)ptr->delta, (n_t)ptr->size - 1);
+	return 0;
+}
+
+
+static const struct sig_gen_desc sig_gen_table[] = {
+	{sig_sampler_f, sig_gen_sampler},
+	{sig_add_f, sig_gen_add},
+	{sig_iirlp1_f, sig_gen_iirlp1},
+	{sig_step_f, sig_gen_step},
+	{sig_fir_n_f, sig_gen_fir_n},
+	{sig_pid_opt_f, sig_gen_pid},
+	{sig_pid_naive_f, sig_gen_pid},
+	{sig_buf_read_f, sig_gen_buf_read},
+};
+
+static const struct sig_gen_desc *sig_gen_find(sig_func_f x)
+{
+	int i;
+
+	for (i=0; i<sizeof(sig_gen_table)/sizeof(sig_gen_table[0]); i++)
+		if (sig_gen_table[i].x == x)
+			return &sig_gen_table[i];
+	return NULL;
+}
+
+
+/**
+ * @brief run a pass on all the schedule entries
+ */
+static int sig_gen_pass(struct sig_gen_ctx *ctx, enum sig_gen_pass_t pass)
+{
+	const struct sig_gen_desc *desc;
+	int ret;
+
+	for (ctx->i=0; ctx->i<ctx->graph->count; ctx->i++)
+	{
+		ctx->sig = (struct signal_float *)ctx->graph->nodes[ctx->i].sig;
+		desc = sig_gen_find(ctx->sig->x);
+		if (desc == NULL)
+			return sig_gen_error(ctx, SIG_ERR_UNSUPPORTED);
+		if (ctx->sig->params == NULL)
+			return sig_gen_error(ctx, SIG_ERR_NO_CONFIG);
+#if SIG_DBG_NAME
+		if ((pass == SIG_GEN_STEP) && ctx->sig->name && (strchr(ctx->sig->name, '\n') == NULL))
+			fprintf(ctx->out, "\t// %d: %s\n", ctx->i, ctx->sig->name);
+#endif
+		ret = desc->write(ctx, pass);
+		if (ret)
+			return ret;
+	}
+	return 0;
+}
+
+
+int sig_gen_c(struct sig_gen *self, struct sig_graph *graph, const char *prefix, FILE *out)
+{
+	struct sig_gen_ctx ctx = {.gen = self, .graph = graph, .prefix = prefix, .out = out};
+	const char *p = prefix;
+	float *x;
+	int i, ret;
+
+	memset(self, 0, sizeof(*self));
+	ret = sig_gen_pass(&ctx, SIG_GEN_CHECK);
+	if (ret)
+		return ret;
+
+	fprintf(out, "// %s: generated by sig_gen_c() from a graph of %d signals\n\n", p, graph->count);
+	fprintf(out, "#include <math.h>\n\n");
+	if (self->vars)
+		fprintf(out, "float *%s_var[%d];\t\t\t\t\t\t// variables, see sig_gen.var\n", p, self->vars);
+	if (self->buffers)
+		fprintf(out, "const float *%s_buffer[%d];\t\t\t\t// buffers, see sig_gen.buffer\n", p, self->buffers);
+
+	fprintf(out, "\n// all the state of the graph. x[i] is the value of the schedule entry i\n");
+	fprintf(out, "struct %s_state {\n\tfloat x[%d];\n", p, graph->count ? graph->count : 1);
+	sig_gen_pass(&ctx, SIG_GEN_FIELDS);
+	fprintf(out, "};\n\n");
+
+	x = malloc(graph->count * sizeof(float));
+	if (x == NULL)
+		return SIG_ERR_FULL;
+	for (i=0; i<graph->count; i++)
+		x[i] = ((struct signal_float *)graph->nodes[i].sig)->x_cst;
+	fprintf(out, "struct %s_state %s_state = {\n\t.x = ", p, p);
+	sig_gen_array(out, x, graph->count, 1);
+	fprintf(out, ",\n");
+	free(x);
+	sig_gen_pass(&ctx, SIG_GEN_INIT);
+	fprintf(out, "};\n\n");
+
+	sig_gen_pass(&ctx, SIG_GEN_TABLES);
+	fprintf(out, "static inline float %s_limit(float x, float m)\n{\n", p);
+	fprintf(out, "\tif (x > m)\n\t\treturn m;\n\telse if (x < (-1 * m))\n\t\treturn -1 * m;\n\treturn x;\n}\n\n");
+	fprintf(out, "static inline unsigned int %s_stick(unsigned int m, unsigned int last)\n{\n", p);
+	fprintf(out, "\treturn m < last ? m : last;\n}\n\n");
+
+	fprintf(out, "void %s_step(unsigned int n)\n{\n\tstruct %s_state *s = &%s_state;\n\n\t(void)n;\n", p, p, p);
+	sig_gen_pass(&ctx, SIG_GEN_STEP);
+	fprintf(out, "}\n");
+	return ferror(out) ? SIG_ERR_FULL : 0;
+}
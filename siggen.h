@@ -0,0 +1,92 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file siggen.h
+ * SigLib Header, C code generator of compiled graphs
+ */
+
+#ifndef SIG_GEN_H__
+#define SIG_GEN_H__
+
+#include <stdio.h>
+#include "siggraph.h"
+
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup gen
+ * @brief Maximum number of variables, and of buffers, read by a generated graph
+ */
+#if !defined(SIG_GEN_MAX_INPUTS) || defined(__DOXYGEN__)
+	#define SIG_GEN_MAX_INPUTS		64
+#endif
+
+/** @} */
+
+
+/** @ingroup gen
+ * @struct sig_gen
+ * @brief inputs of a generated graph, filled by sig_gen_c()
+ * @details the generated code reads the variables through <prefix>_var[] and the buffers through <prefix>_buffer[].
+ * Before the first step, the program must set <prefix>_var[i] to its equivalent of var[i], and <prefix>_buffer[i] to
+ * its equivalent of buffer[i] (at least as long as the buffer of the graph).
+ */
+struct sig_gen {
+	float *var[SIG_GEN_MAX_INPUTS];						//!< variables read by the graph: x_var of the sig-ptr and samplers, a_var and b_var of the adders
+	int vars;											//!< number of variables
+	const float *buffer[SIG_GEN_MAX_INPUTS];			//!< buffers read by the buffer readers
+	int buffers;										//!< number of buffers
+	void *err_sig;										//!< signal that caused the last error
+};
+
+
+/** @ingroup gen
+ * @brief write a compiled graph as a standalone C source file
+ * @details The file defines <prefix>_step(n), which evaluates all the signals of the schedule at n, as
+ * sig_graph_run() does. The nodes are written inline, in schedule order, without function pointers nor memoization:
+ *   - the state of the graph is a single struct, <prefix>_state. x[i] is the value of the schedule entry i
+ *     (graph->nodes[i].sig). It starts from the current state of the signals (x_cst, history, integral...)
+ *   - the parameters (gains, taps, buffer sizes, n-Windows) and the sig-cst are written as constants: changing them
+ *     in the graph requires to generate the code again
+ *   - FIR filters are summed in the order of the C kernel (SIG_FIR_KERNEL_C)
+ *
+ * The generated code gives the same values as the graph compiled with the same floating-point options (no FMA
+ * contraction) and the C FIR kernel. It only includes math.h.
+ * @n Supported sig-func: sig_add_f(), sig_sampler_f(), sig_iirlp1_f(), sig_step_f(), sig_fir_n_f(), sig_pid_opt_f(),
+ * sig_pid_naive_f(), sig_buf_read_f().
+ * @pre sig_graph_compile() succeeded
+ * @param[out] self receives the inputs of the generated code
+ * @param[in] graph compiled graph
+ * @param[in] prefix prefix of the generated symbols (a C identifier)
+ * @param[out] out file the code is written to
+ * @return 0 on success, or
+ *   - SIG_ERR_UNSUPPORTED if a signal of the graph is not supported (integer, or sig-func not listed above)
+ *   - SIG_ERR_NO_CONFIG if a signal has no parameters, or a buffer reader no buffer
+ *   - SIG_ERR_FULL if the graph reads more than SIG_GEN_MAX_INPUTS variables or buffers
+ *
+ *   err_sig then points to the faulty signal
+ */
+int sig_gen_c(struct sig_gen *self, struct sig_graph *graph, const char *prefix, FILE *out);
+
+#endif
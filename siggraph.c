@@ -0,0 +1,359 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file siggraph.c
+ * SigLib Code, graph compiler
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "siggraph.h"
+
+enum sig_graph_state_t {SIG_GRAPH_NEW, SIG_GRAPH_VISITING, SIG_GRAPH_DONE};
+
+/**
+ * @brief set of the signals met during compilation (open addressing hash table)
+ */
+struct sig_graph_set {
+	void **keys;
+	char *state;
+	int mask;
+	int count;
+	int max;
+};
+
+
+/**
+ * @brief find the state of a signal, or insert it as SIG_GRAPH_NEW
+ * @return the state of the signal, or NULL if the set is full
+ */
+static char *sig_graph_state(struct sig_graph_set *set, void *sig)
+{
+	uintptr_t i = ((uintptr_t)sig >> 3) * 0x9E3779B1u;
+
+	for (;; i++)
+	{
+		i &= set->mask;
+		if (set->keys[i] == sig)
+			return &set->state[i];
+		if (set->keys[i] == NULL)
+			break;
+	}
+	if (set->count >= set->max)
+		return NULL;
+	set->count++;
+	set->keys[i] = sig;
+	set->state[i] = SIG_GRAPH_NEW;
+	return &set->state[i];
+}
+
+
+/**
+ * @brief location of the value of a float signal once it is evaluated
+ */
+static const float *sig_graph_value_f(struct signal_float *sig)
+{
+	if (sig->x)
+		return &sig->x_cst;
+	if (sig->x_var)
+		return sig->x_var;
+	return &sig->x_cst;
+}
+
+
+/**
+ * @brief step of the sig-func that are not described: evaluated through (*x)
+ */
+static void sig_graph_step_x_f(struct sig_graph_node *node, n_t n)
+{
+	struct signal_float *sig = (struct signal_float *)node->sig;
+	sig->x_cst = sig->x(sig, n);
+}
+
+static void sig_graph_step_x_i(struct sig_graph_node *node, n_t n)
+{
+	struct signal_int *sig = (struct signal_int *)node->sig;
+	sig->x_cst = sig->x(sig, n);
+}
+
+
+/**
+ * @brief append a node to the schedule
+ */
+static struct sig_graph_node *sig_graph_append(struct sig_graph *self, void *sig)
+{
+	struct sig_graph_node *node;
+
+	if (self->count >= self->size)
+	{
+		self->err_sig = sig;
+		return NULL;
+	}
+	node = &self->nodes[self->count++];
+	memset(node, 0, sizeof(*node));
+	node->sig = sig;
+	return node;
+}
+
+
+/**
+ * @brief depth-first visit of a float signal: schedules its sources, then itself
+ */
+static int sig_graph_visit_f(struct sig_graph *self, struct sig_graph_set *set, struct signal_float *sig)
+{
+	const struct sig_desc_f *desc;
+	struct signal_float *src[SIG_MAX_SOURCES];
+	const float *val[SIG_MAX_SOURCES];
+	struct sig_graph_node *node;
+	char *state;
+	int i, count = 0, ret;
+
+	if (sig->x == NULL)
+		return 0;									// sig-ptr and sig-cst are read in place
+
+	state = sig_graph_state(set, sig);
+	if (state == NULL)
+	{
+		self->err_sig = sig;
+		return SIG_ERR_FULL;
+	}
+	if (*state == SIG_GRAPH_DONE)
+		return 0;
+	if (*state == SIG_GRAPH_VISITING)
+	{
+		self->err_sig = sig;
+		return SIG_ERR_CYCLE;
+	}
+	*state = SIG_GRAPH_VISITING;
+
+	desc = sig_desc_find_f(sig->x);
+	if (desc)
+	{
+		if (sig->params == NULL)
+		{
+			self->err_sig = sig;
+			return SIG_ERR_NO_CONFIG;
+		}
+		for (i=0; i<SIG_MAX_SOURCES; i++)
+			val[i] = NULL;							// missing source, unless sources() gives its location
+		count = desc->sources(sig, src, val);
+		for (i=0; i<count; i++)
+		{
+			if (src[i] == NULL)
+				continue;
+			ret = sig_graph_visit_f(self, set, src[i]);
+			if (ret)
+				return ret;
+			val[i] = sig_graph_value_f(src[i]);
+		}
+	}
+
+	node = sig_graph_append(self, sig);
+	if (node == NULL)
+		return SIG_ERR_FULL;
+	node->step = desc ? desc->step : sig_graph_step_x_f;
+	for (i=0; i<count; i++)
+		node->src[i] = val[i];
+
+	*state = SIG_GRAPH_DONE;
+	return 0;
+}
+
+
+/**
+ * @brief visit of an integer signal. All integer sig-func are evaluated through (*x)
+ */
+static int sig_graph_visit_i(struct sig_graph *self, struct sig_graph_set *set, struct signal_int *sig)
+{
+	struct sig_graph_node *node;
+	char *state;
+
+	if (sig->x == NULL)
+		return 0;
+
+	state = sig_graph_state(set, sig);
+	if (state == NULL)
+	{
+		self->err_sig = sig;
+		return SIG_ERR_FULL;
+	}
+	if (*state != SIG_GRAPH_NEW)
+		return 0;
+
+	node = sig_graph_append(self, sig);
+	if (node == NULL)
+		return SIG_ERR_FULL;
+	node->step = sig_graph_step_x_i;
+	*state = SIG_GRAPH_DONE;
+	return 0;
+}
+
+
+void sig_graph_init(struct sig_graph *self, struct sig_graph_node *nodes, int size)
+{
+	memset(self, 0, sizeof(*self));
+	self->nodes = nodes;
+	self->size = size;
+}
+
+
+int sig_graph_compile(struct sig_graph *self, struct signal_float **roots_f, int count_f, struct signal_int **roots_i, int count_i)
+{
+	struct sig_graph_set set;
+	int i, capacity, ret = 0;
+
+	self->count = 0;
+	self->err_sig = NULL;
+
+	for (capacity = 16; capacity < 2 * self->size; capacity *= 2);
+	set.keys = calloc(capacity, sizeof(void *));
+	set.state = calloc(capacity, sizeof(char));
+	set.mask = capacity - 1;
+	set.count = 0;
+	set.max = self->size;
+	if ((set.keys == NULL) || (set.state == NULL))
+		ret = SIG_ERR_FULL;
+
+	for (i=0; (i<count_f) && (ret == 0); i++)
+		ret = sig_graph_visit_f(self, &set, roots_f[i]);
+	for (i=0; (i<count_i) && (ret == 0); i++)
+		ret = sig_graph_visit_i(self, &set, roots_i[i]);
+	for (i=0; (i<self->count) && (ret == 0); i++)
+		if ((self->nodes[i].step == sig_graph_step_x_f) || (self->nodes[i].step == sig_graph_step_x_i))
+			break;
+	if (i < self->count)
+		for (i=0; i<self->count; i++)
+			self->nodes[i].shared = 1;					// the undescribed sig-func may read any of them through (*x)
+
+	free(set.keys);
+	free(set.state);
+	if (ret)
+		self->count = 0;
+	return ret;
+}
+
+
+/**
+ * @brief location of the value computed by a schedule entry
+ */
+static const void *sig_graph_node_value(struct sig_graph_node *node)
+{
+	if (node->step == sig_graph_step_x_i)
+		return &((struct signal_int *)node->sig)->x_cst;
+	return &((struct signal_float *)node->sig)->x_cst;
+}
+
+static int sig_graph_find_root(int *parent, int i)
+{
+	while (parent[i] != i)
+		i = parent[i] = parent[parent[i]];
+	return i;
+}
+
+int sig_graph_components(struct sig_graph *self, int *component)
+{
+	const void **keys;
+	int *index, *parent;
+	int i, j, k, a, b, capacity, mask, count = 0, opaque = 0;
+	uintptr_t h;
+
+	for (capacity = 16; capacity < 2 * self->count; capacity *= 2);
+	mask = capacity - 1;
+	keys = calloc(capacity, sizeof(void *));
+	index = malloc(capacity * sizeof(int));
+	parent = malloc((self->count + 1) * sizeof(int));
+	if ((keys == NULL) || (index == NULL) || (parent == NULL))
+	{
+		free(keys);
+		free(index);
+		free(parent);
+		return SIG_ERR_FULL;
+	}
+
+	// index the entries by the location of their value
+	for (i=0; i<self->count; i++)
+	{
+		parent[i] = i;
+		h = ((uintptr_t)sig_graph_node_value(&self->nodes[i]) >> 2) * 0x9E3779B1u;
+		while (keys[h & mask])
+			h++;
+		keys[h & mask] = sig_graph_node_value(&self->nodes[i]);
+		index[h & mask] = i;
+	}
+
+	// merge each entry with its scheduled sources. An undescribed sig-func evaluates its sources through (*x): they
+	// are unknown and may be anywhere in the graph, so the whole graph is a single component
+	for (i=0; i<self->count; i++)
+	{
+		if ((self->nodes[i].step == sig_graph_step_x_f) || (self->nodes[i].step == sig_graph_step_x_i))
+			opaque = 1;
+		for (j=0; j<SIG_MAX_SOURCES; j++)
+		{
+			if (self->nodes[i].src[j] == NULL)
+				continue;
+			for (h = ((uintptr_t)self->nodes[i].src[j] >> 2) * 0x9E3779B1u; keys[h & mask]; h++)
+				if (keys[h & mask] == self->nodes[i].src[j])
+					break;
+			if (keys[h & mask] == NULL)
+				continue;								// sig-ptr or sig-cst
+			a = sig_graph_find_root(parent, i);
+			b = sig_graph_find_root(parent, index[h & mask]);
+			if (a != b)
+				parent[max(a, b)] = min(a, b);			// the root is always the first entry of the component
+		}
+	}
+	if (opaque)
+		for (i=0; i<self->count; i++)
+			parent[i] = 0;
+
+	// number the components
+	for (i=0; i<self->count; i++)
+	{
+		k = sig_graph_find_root(parent, i);
+		component[i] = (k == i) ? count++ : component[k];
+	}
+
+	free(keys);
+	free(index);
+	free(parent);
+	return count;
+}
+
+
+int sig_graph_run(struct sig_graph *self, n_t n)
+{
+	struct sig_graph_node *node = self->nodes;
+	struct sig_graph_node *end = self->nodes + self->count;
+	struct sig_err_state saved;
+
+	if (self->ctx.err)
+		return self->ctx.err;
+	self->ctx.n = n;
+	sig_err_save(&saved);								// error state of the caller, restored on exit
+	sig_errno = 0;
+	for (; node < end; node++)
+		node->step(node, n);
+	sig_ctx_collect(&self->ctx);
+	sig_err_restore(&saved);
+	return self->ctx.err;
+}
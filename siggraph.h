@@ -0,0 +1,124 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file siggraph.h
+ * SigLib Header, graph compiler
+ */
+
+#ifndef SIG_GRAPH_H__
+#define SIG_GRAPH_H__
+
+#include "sig.h"
+#include "sigf.h"
+
+
+/** @ingroup graph
+ * @struct sig_graph_node
+ * @brief one entry of a compiled graph schedule
+ */
+struct sig_graph_node {
+	void (*step)(struct sig_graph_node *node, n_t n);	//!< evaluates the signal. Its sources were evaluated by the previous entries
+	void *sig;											//!< struct signal_float or struct signal_int evaluated by this entry
+	const void *src[SIG_MAX_SOURCES];					//!< where to read the value of each source (NULL if absent)
+	int shared;											//!< the signal may also be read through (*x) by an undescribed sig-func of the graph: the step keeps a value already computed at n
+};
+
+
+/** @ingroup graph
+ * @struct sig_graph
+ * @brief a signal graph, compiled into a linear evaluation schedule
+ */
+struct sig_graph {
+	struct sig_graph_node *nodes;						//!< schedule, in evaluation order. Points to the memory given to sig_graph_init()
+	int size;											//!< maximum number of entries in nodes
+	int count;											//!< number of entries in the schedule
+	void *err_sig;										//!< signal that caused the last compilation error
+	struct sig_ctx ctx;									//!< evaluation context: error state and statistics of sig_graph_run()
+};
+
+
+/** @ingroup graph
+ * @brief graph init
+ * @param[out] self pointer to the graph
+ * @param[in] nodes memory holding the schedule
+ * @param[in] size number of entries nodes can hold (one per signal reachable from the roots)
+ */
+void sig_graph_init(struct sig_graph *self, struct sig_graph_node *nodes, int size);
+
+
+/** @ingroup graph
+ * @brief compile the graph made of all the signals reachable from the roots
+ * @details The reachable signals are sorted so that each signal comes after its sources. sig-func described by
+ * sig_desc_find_f() are linked to their sources, and are evaluated by their step function, without recursion nor
+ * memoization check. Other sig-func (and all signal_int) are evaluated by their (*x) function, which stores its
+ * result in x_cst; their own sources are not scheduled, they are read recursively as usual.
+ * @n The sources of an undescribed sig-func are not known: when the graph holds one, all the described sig-func are
+ * marked as shared, and their step keeps the value already computed at n through (*x), so that a stateful signal
+ * is not advanced twice per tick.
+ * @n sig-ptr and sig-cst are not scheduled: they are read in place.
+ * @n The graph must be compiled again when a source pointer is changed.
+ * @param[in,out] self pointer to the graph
+ * @param[in] roots_f array of float signals to evaluate at each tick. Can be NULL if count_f is 0
+ * @param[in] count_f number of float signals in roots_f
+ * @param[in] roots_i array of integer signals to evaluate at each tick. Can be NULL if count_i is 0
+ * @param[in] count_i number of integer signals in roots_i
+ * @return 0 on success, or
+ *   - SIG_ERR_NO_CONFIG if a described sig-func has no parameters
+ *   - SIG_ERR_CYCLE if a signal is its own source, directly or not (e.g. a PID feedback computed from the PID output)
+ *   - SIG_ERR_FULL if the schedule can't hold all the reachable signals
+ *   
+ *   err_sig then points to the faulty signal
+ */
+int sig_graph_compile(struct sig_graph *self, struct signal_float **roots_f, int count_f, struct signal_int **roots_i, int count_i);
+
+
+/** @ingroup graph
+ * @brief split a compiled graph into independent subgraphs
+ * @details two entries are in the same component if one is a source of the other, directly or through
+ * other entries. Components don't share any scheduled signal, so they can be evaluated concurrently.
+ * @n The sources of an undescribed sig-func (evaluated through (*x)) are not known: a graph holding one is not split,
+ * and is a single component.
+ * @pre sig_graph_compile() succeeded
+ * @param[in] self pointer to the graph
+ * @param[out] component array of count elements, receives the component of each entry. Components are numbered
+ * from 0, in the order of their first entry in the schedule
+ * @return the number of components, or SIG_ERR_FULL if the working memory can't be allocated
+ */
+int sig_graph_components(struct sig_graph *self, int *component);
+
+
+/** @ingroup graph
+ * @brief evaluate all the signals of the graph at n
+ * @details the values can then be read with sig_get_value_f() (memoized) or directly in x_cst.
+ * Signals are evaluated even if n = n_last, so the first tick is not skipped when n_last was initialized to n;
+ * except the shared ones (see sig_graph_compile()) and those evaluated through (*x), which are memoized.
+ * @n Errors are stored in the graph context (ctx), not in sig_errno: the error state of the calling thread is
+ * left untouched, and graphs can be evaluated concurrently by different threads. Once an error occurred, the graph
+ * is not evaluated anymore until sig_ctx_clear() is called on ctx.
+ * @pre sig_graph_compile() succeeded
+ * @param[in] self pointer to the graph
+ * @param[in] n the value of n
+ * @return ctx.err. If it is non-zero when the function is called, no signal is evaluated
+ */
+int sig_graph_run(struct sig_graph *self, n_t n);
+
+#endif
@@ -23,38 +23,939 @@
  * SigLib Code
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include "sig.h"
 #include "sigi.h"
 
+#if SIG_FIR_SIMD && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIG_FIR_X86		TRUE
+#include <immintrin.h>
+#endif
+
+
+/**
+ * @brief floor division by d > 0. The remainder is stored in *r, 0 <= *r < d
+ */
+static inline long long sig_floor_div_i(long long x, long long d, long long *r)
+{
+	long long q = x / d;
+
+	*r = x % d;
+	if (*r < 0)
+	{
+		*r += d;
+		q--;
+	}
+	return q;
+}
+
+
+/**
+ * @brief compute the state of the ramp (a * t + b) / div at t, in closed form
+ */
+static void sig_dda_set_i(struct sig_dda_i *dda, long long a, long long b, long long div, n_t t)
+{
+	long long s = (div < 0) ? -1 : 1;
+	long long qb, rb;
+	unsigned long long x;
+
+	dda->a = a;
+	dda->b = b;
+	dda->div = div;
+	dda->d = s * div;
+	dda->step_q = sig_floor_div_i(s * a, dda->d, &dda->step_r);
+	qb = sig_floor_div_i(s * b, dda->d, &rb);
+	// a * t + b = (step_q * t + qb) * d + step_r * t + rb, with step_r * t + rb below 2^64
+	x = (unsigned long long)dda->step_r * t + rb;
+	dda->q = dda->step_q * t + qb + (long long)(x / dda->d);
+	dda->r = x % dda->d;
+	dda->t = t;
+}
+
+
+/**
+ * @brief value of the ramp (a * t + b) / div at t, rounded toward 0. Incremental if t advanced by one
+ */
+static inline long long sig_dda_at_i(struct sig_dda_i *dda, long long a, long long b, long long div, n_t t)
+{
+	if ((t - 1 == dda->t) && (t != 0) && dda->d && (a == dda->a) && (b == dda->b) && (div == dda->div))
+	{
+		dda->q += dda->step_q;
+		dda->r += dda->step_r;
+		if (dda->r >= dda->d)
+		{
+			dda->r -= dda->d;
+			dda->q++;
+		}
+		dda->t = t;
+	}
+	else
+		sig_dda_set_i(dda, a, b, div, t);
+	return dda->q + ((dda->q < 0) && (dda->r != 0));		// floor to truncation
+}
+
 
 int sig_interpolate_lin(struct signal_int *self, n_t n)
 {
 	struct sig_interpolate_lin_param *ptr;
-	long int tmp;
-	
+
 	SIG_ERRNO_FAIL
-	
+
 	if(self == NULL)
 		SIG_ERRNO(-1);
-	
+
 	if(self->params == NULL)
 		SIG_ERRNO(-2);
-	
+
 	ptr = (struct sig_interpolate_lin_param*)self->params;
-	
-	n -= ptr->delay;
-	
-	tmp = (long int) ptr->a * n;
-	tmp += (long int) ptr->b;
-	tmp = (long int) tmp/ptr->div;
-	return (int) tmp;
+
+	if(ptr->div == 0)
+		SIG_ERRNO(-3);
+
+	if (ptr->n_last == n)
+		return self->x_cst;
+
+	self->x_cst = (int)sig_dda_at_i(&ptr->dda, ptr->a, ptr->b, ptr->div, n - ptr->delay);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_interpolate_lin_block(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_interpolate_lin_param *ptr;
+	int i;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_interpolate_lin_param*)self->params;
+
+	if(ptr->div == 0)
+		SIG_ERRNO_BLOCK(-3);
+
+	if (count > 0 && ptr->n_last == n)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	for (i=0; i<count; i++)
+		out[i] = (int)sig_dda_at_i(&ptr->dda, ptr->a, ptr->b, ptr->div, n + i - ptr->delay);
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
+}
+
+
+static inline int sig_interpolate_st_core(struct sig_interpolate_st_param *ptr, n_t n)
+{
+	n_t t = n - ptr->n_start;
+
+	if ((int)t < 0)
+		return ptr->start;
+	if (t >= ptr->length)
+		return ptr->stop;
+	// the offset can exceed the int range, the sum can't: it is between start and stop
+	return (int)(ptr->start + sig_dda_at_i(&ptr->dda, (long long)ptr->stop - ptr->start, 0, ptr->length, t));
 }
 
 
 int sig_interpolate_st(struct signal_int *self, n_t n)
 {
-	
+	struct sig_interpolate_st_param *ptr;
+
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	ptr = (struct sig_interpolate_st_param*)self->params;
+
+	if (ptr->n_last == n)
+		return self->x_cst;
+
+	self->x_cst = sig_interpolate_st_core(ptr, n);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_interpolate_st_block(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_interpolate_st_param *ptr;
+	int i;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_interpolate_st_param*)self->params;
+
+	if (count > 0 && ptr->n_last == n)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+	if (count <= 0)
+		return;
+
+	for (i=0; i<count; i++)
+		out[i] = sig_interpolate_st_core(ptr, n + i);
+	self->x_cst = out[count - 1];
+	ptr->n_last = n + count - 1;
+}
+
+
+void sig_get_block_i(struct signal_int *self, n_t n, int count, int *out)
+{
+	int i;
+	int value;
+
+	SIG_ERRNO_FAIL_BLOCK
+#if SIG_BLOCK
+	if(self->xb)
+	{
+		self->xb(self, n, count, out);
+		return;
+	}
+#endif
+	if(self->x)
+	{
+		for(i=0; i<count; i++)
+			out[i] = sig_value(self, n + i);
+		return;
+	}
+	value = self->x_var ? *self->x_var : self->x_cst;
+	for(i=0; i<count; i++)
+		out[i] = value;
+}
+
+
+/**
+ * @brief fill a block with the values of an operand that can be a signal, a variable or a constant
+ */
+static void sig_operand_block_i(struct signal_int *sig, int *var, int cst, n_t n, int count, int *out)
+{
+	int i;
+
+	if(sig)
+	{
+		sig_get_block_i(sig, n, count, out);
+		return;
+	}
+	if(var)
+		cst = *var;
+	for(i=0; i<count; i++)
+		out[i] = cst;
+}
+
+
+/***************************************************************************************/
+/*                                 Fixed-point                                         */
+/***************************************************************************************/
+
+/**
+ * @brief saturate x to the int range
+ */
+static inline int sig_sat_q(long long x)
+{
+	if (x > 0x7FFFFFFFLL)
+		return 0x7FFFFFFF;
+	if (x < -0x80000000LL)
+		return -0x7FFFFFFF - 1;
+	return (int)x;
+}
+
+
+/**
+ * @brief shift x right by q bits (1 <= q), rounding to nearest
+ */
+static inline long long sig_shift_q(long long x, int q)
+{
+	return (x + (1LL << (q - 1))) >> q;
+}
+
+
+int sig_float_to_q(float x, int q)
+{
+	double v = (double)x * (double)(1LL << q);
+
+	v += v >= 0 ? 0.5 : -0.5;
+	if (v >= 2147483647.0)
+		return 0x7FFFFFFF;
+	if (v <= -2147483648.0)
+		return -0x7FFFFFFF - 1;
+	return (int)v;
+}
+
+
+float sig_q_to_float(int x, int q)
+{
+	return (float)((double)x / (double)(1LL << q));
+}
+
+
+int sig_add_q(struct signal_int *self, n_t n)
+{
+	int a, b;
+	struct sig_add_param_q *ptr;
+
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	ptr = (struct sig_add_param_q*)self->params;
+
+	if (ptr->n_last == n)
+		return self->x_cst;
+
+	if(ptr->a)
+		a = sig_value(ptr->a, n);
+	else if(ptr->a_var)
+		a = *ptr->a_var;
+	else
+		a = ptr->a_cst;
+
+	SIG_ERRNO_FAIL
+
+	if(ptr->b)
+		b = sig_value(ptr->b, n);
+	else if(ptr->b_var)
+		b = *ptr->b_var;
+	else
+		b = ptr->b_cst;
+
+	SIG_ERRNO_FAIL
+
+	self->x_cst = sig_sat_q((long long)a + b);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_add_block_q(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_add_param_q *ptr;
+	int b[SIG_BLOCK_CHUNK];
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_add_param_q*)self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_operand_block_i(ptr->a, ptr->a_var, ptr->a_cst, n, len, out);
+		sig_operand_block_i(ptr->b, ptr->b_var, ptr->b_cst, n, len, b);
+		SIG_ERRNO_FAIL_BLOCK
+		for (i=0; i<len; i++)
+			out[i] = sig_sat_q((long long)out[i] + b[i]);
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+/**
+ * @brief one step of the fixed-point IIR low pass
+ */
+static inline int sig_iirlp1_core_q(struct sig_iirlp1_param_q *ptr, int y, int x)
+{
+	return sig_sat_q(y + sig_shift_q((long long)ptr->a * ((long long)x - y), ptr->q));
+}
+
+
+int sig_iirlp1_q(struct signal_int *self, n_t n)
+{
+	struct sig_iirlp1_param_q *ptr = (struct sig_iirlp1_param_q *) self->params;
+	int source_value;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	source_value = sig_value(ptr->source, n);
+
+	self->x_cst = sig_iirlp1_core_q(ptr, self->x_cst, source_value);
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_iirlp1_block_q(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_iirlp1_param_q *ptr;
+	int y;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_iirlp1_param_q *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_get_block_i(ptr->source, n, len, out);					// the source is read in place
+		SIG_ERRNO_FAIL_BLOCK
+		y = self->x_cst;
+		for (i=0; i<len; i++)
+		{
+			y = sig_iirlp1_core_q(ptr, y, out[i]);
+			out[i] = y;
+		}
+		self->x_cst = y;
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+/***************************************************************************************/
+/*                           16-bit FIR dot product kernels                            */
+/***************************************************************************************/
+
+/**
+ * @brief portable kernel. len is a multiple of SIG_FIR_PAD
+ */
+static long long sig_fir_dot_c_q(const short *taps, const short *x, int len)
+{
+	long long acc = 0;
+	int i;
+
+	for (i=0; i<len; i++)
+		acc += taps[i] * x[i];
+	return acc;
+}
+
+#if defined(SIG_FIR_X86)
+__attribute__((target("sse2")))
+static long long sig_fir_dot_sse2_q(const short *taps, const short *x, int len)
+{
+	__m128i acc = _mm_setzero_si128(), m;
+	long long out[2];
+	int i;
+
+	for (i=0; i<len; i+=8)
+	{
+		// 8 16-bit MACs into 4 32-bit pairs, then sign-extended into the 64-bit accumulators
+		m = _mm_madd_epi16(_mm_load_si128((const __m128i *)(taps + i)), _mm_loadu_si128((const __m128i *)(x + i)));
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(m, _mm_srai_epi32(m, 31)));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(m, _mm_srai_epi32(m, 31)));
+	}
+	_mm_storeu_si128((__m128i *)out, acc);
+	return out[0] + out[1];
+}
+
+__attribute__((target("avx2")))
+static long long sig_fir_dot_avx2_q(const short *taps, const short *x, int len)
+{
+	__m256i acc = _mm256_setzero_si256(), m;
+	long long out[4];
+	int i;
+
+	for (i=0; i<len; i+=16)
+	{
+		m = _mm256_madd_epi16(_mm256_load_si256((const __m256i *)(taps + i)), _mm256_loadu_si256((const __m256i *)(x + i)));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m)));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1)));
+	}
+	_mm256_storeu_si256((__m256i *)out, acc);
+	return (out[0] + out[1]) + (out[2] + out[3]);
+}
+
+__attribute__((target("avx512f,avx512bw,avx2")))
+static long long sig_fir_dot_avx512_q(const short *taps, const short *x, int len)
+{
+	__m512i acc = _mm512_setzero_si512(), m;
+	__m256i m8;
+	int i;
+
+	for (i=0; i+32<=len; i+=32)
+	{
+		m = _mm512_madd_epi16(_mm512_load_si512(taps + i), _mm512_loadu_si512(x + i));
+		acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(m)));
+		acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(m, 1)));
+	}
+	if (i < len)
+	{
+		m8 = _mm256_madd_epi16(_mm256_load_si256((const __m256i *)(taps + i)), _mm256_loadu_si256((const __m256i *)(x + i)));
+		acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(m8));
+	}
+	return _mm512_reduce_add_epi64(acc);
+}
+#endif	// SIG_FIR_X86
+
+static long long sig_fir_dot_auto_q(const short *taps, const short *x, int len);
+
+/** kernel used by sig_fir_n_q(). Resolved on first use */
+static long long (*sig_fir_dot_q)(const short *taps, const short *x, int len) = sig_fir_dot_auto_q;
+
+static long long sig_fir_dot_auto_q(const short *taps, const short *x, int len)
+{
+	sig_fir_kernel_q(SIG_FIR_KERNEL_AUTO);
+	return sig_fir_dot_q(taps, x, len);
+}
+
+int sig_fir_kernel_q(enum sig_fir_kernel_t kernel)
+{
+#if defined(SIG_FIR_X86)
+	__builtin_cpu_init();
+	if (kernel == SIG_FIR_KERNEL_AUTO)
+	{
+		if (__builtin_cpu_supports("avx512bw"))
+			kernel = SIG_FIR_KERNEL_AVX512;
+		else if (__builtin_cpu_supports("avx2"))
+			kernel = SIG_FIR_KERNEL_AVX2;
+		else if (__builtin_cpu_supports("sse2"))
+			kernel = SIG_FIR_KERNEL_SSE;
+		else
+			kernel = SIG_FIR_KERNEL_C;
+	}
+	switch (kernel)
+	{
+		case SIG_FIR_KERNEL_C:
+			sig_fir_dot_q = sig_fir_dot_c_q;
+			return 0;
+		case SIG_FIR_KERNEL_SSE:
+			if (!__builtin_cpu_supports("sse2"))
+				return -1;
+			sig_fir_dot_q = sig_fir_dot_sse2_q;
+			return 0;
+		case SIG_FIR_KERNEL_AVX2:
+			if (!__builtin_cpu_supports("avx2"))
+				return -1;
+			sig_fir_dot_q = sig_fir_dot_avx2_q;
+			return 0;
+		case SIG_FIR_KERNEL_AVX512:
+			if (!__builtin_cpu_supports("avx512bw"))
+				return -1;
+			sig_fir_dot_q = sig_fir_dot_avx512_q;
+			return 0;
+		default:
+			return -1;
+	}
+#else
+	if ((kernel != SIG_FIR_KERNEL_AUTO) && (kernel != SIG_FIR_KERNEL_C))
+		return -1;
+	sig_fir_dot_q = sig_fir_dot_c_q;
 	return 0;
-	
+#endif
+}
+
+
+int sig_fir_n_init_q(struct sig_fir_n_param_q *ptr, const short *taps, int tap_count, int q)
+{
+	int length = (tap_count + SIG_FIR_PAD - 1) / SIG_FIR_PAD * SIG_FIR_PAD;
+	short *t, *x;
+	int i;
+
+	// aligned_alloc() sizes must be a multiple of the alignment
+	t = aligned_alloc(64, (length * sizeof(short) + 63) & ~63);
+	x = aligned_alloc(64, (2 * length * sizeof(short) + 63) & ~63);
+	if ((t == NULL) || (x == NULL) || (tap_count <= 0))
+	{
+		free(t);
+		free(x);
+		return -1;
+	}
+	memset(t, 0, length * sizeof(short));
+	for (i=0; i<tap_count; i++)
+		t[i] = taps[i] < -32767 ? -32767 : taps[i];
+	memset(x, 0, 2 * length * sizeof(short));
+
+	ptr->tap_count = tap_count;
+	ptr->length = length;
+	ptr->q = q;
+	ptr->index_last = 0;
+	ptr->taps = t;
+	ptr->samples = x;
+	return 0;
+}
+
+
+void sig_fir_n_free_q(struct sig_fir_n_param_q *ptr)
+{
+	free(ptr->taps);
+	free(ptr->samples);
+	ptr->taps = NULL;
+	ptr->samples = NULL;
+	ptr->length = 0;
+}
+
+
+/**
+ * @brief push a new input sample into the FIR history and compute the filter output
+ */
+static inline int sig_fir_n_core_q(struct sig_fir_n_param_q *ptr, int x)
+{
+	int index;
+	short s;
+
+	s = x > 32767 ? 32767 : (x < -32768 ? -32768 : x);				// Q15 data path
+	index = ptr->index_last != 0 ? ptr->index_last - 1 : ptr->length - 1;
+	ptr->samples[index] = s;
+	ptr->samples[index + ptr->length] = s;
+	ptr->index_last = index;
+	return sig_sat_q(sig_shift_q(sig_fir_dot_q(ptr->taps, ptr->samples + index, ptr->length), ptr->q));
+}
+
+
+int sig_fir_n_q(struct signal_int *self, n_t n)
+{
+	struct sig_fir_n_param_q *ptr = (struct sig_fir_n_param_q *) self->params;
+	SIG_ERRNO_FAIL
+
+	if(self == NULL)
+		SIG_ERRNO(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+
+	if (n == ptr->n_last)
+		return self->x_cst;
+
+	self->x_cst = sig_fir_n_core_q(ptr, sig_value(ptr->source, n));
+	ptr->n_last = n;
+	return self->x_cst;
+}
+
+
+void sig_fir_n_block_q(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_fir_n_param_q *ptr;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_fir_n_param_q *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+		sig_get_block_i(ptr->source, n, len, out);					// the source is read in place
+		SIG_ERRNO_FAIL_BLOCK
+		for (i=0; i<len; i++)
+			out[i] = sig_fir_n_core_q(ptr, out[i]);
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+/**
+ * @brief clamp x to [-max_output; max_output]
+ */
+static inline int sig_pid_limit_q(struct sig_pid_param_q *ptr, long long x)
+{
+	if (x > ptr->max_output)
+		return ptr->max_output;
+	else if (x < -(long long)ptr->max_output)
+		return -ptr->max_output;
+	return (int)x;
+}
+
+
+/**
+ * @brief optimized form PID step, without Feed-Forward
+ */
+static inline int sig_pid_opt_core_q(struct sig_pid_param_q *ptr, int error)
+{
+	long long acc;
+
+	ptr->history[2] = ptr->history[1];
+	ptr->history[1] = ptr->history[0];
+	ptr->history[0] = error;
+
+	acc = (long long)ptr->history[0] * ptr->k[0];
+	acc += (long long)ptr->history[1] * ptr->k[1];
+	acc += (long long)ptr->history[2] * ptr->k[2];
+
+	// limit the integral part to max_output
+	ptr->integral = sig_pid_limit_q(ptr, ptr->integral + sig_shift_q(acc, ptr->q));
+	return ptr->integral;
+}
+
+
+int sig_pid_opt_q(struct signal_int *self, n_t n)
+{
+	struct sig_pid_param_q *ptr = (struct sig_pid_param_q *) self->params;
+	int error;
+#if SIG_PID_FF
+	long long ff;
+#endif
+
+	SIG_ERRNO_FAIL
+	if(self == NULL)
+		SIG_ERRNO(-1);
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+	if (n == ptr->n_last)
+		return self->x_cst;
+	ptr->n_last = n;
+
+	// get the current error
+	error = sig_value(ptr->setpoint, n);
+	if (ptr->feedback)
+		error = sig_sat_q((long long)error - sig_value(ptr->feedback, n));
+
+	self->x_cst = sig_pid_opt_core_q(ptr, error);
+	// compute Feed-Forward
+	#if SIG_PID_FF
+	ff = 0;
+	if (ptr->ff0)
+		ff += (long long)sig_value(ptr->ff0, n) * ptr->ff[0];
+	if (ptr->ff1)
+		ff += (long long)sig_value(ptr->ff1, n) * ptr->ff[1];
+	if (ptr->ff2)
+		ff += (long long)sig_value(ptr->ff2, n) * ptr->ff[2];
+
+	// limit the output to max_output
+	self->x_cst = sig_pid_limit_q(ptr, self->x_cst + sig_shift_q(ff, ptr->q));
+	#endif
+
+	return self->x_cst;
+}
+
+
+void sig_pid_opt_block_q(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_pid_param_q *ptr;
+	int fb[SIG_BLOCK_CHUNK];
+#if SIG_PID_FF
+	int ff0[SIG_BLOCK_CHUNK], ff1[SIG_BLOCK_CHUNK], ff2[SIG_BLOCK_CHUNK];
+	long long ff;
+#endif
+	int x;
+	int i, len;
+
+	SIG_ERRNO_FAIL_BLOCK
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_pid_param_q *) self->params;
+
+	if (count > 0 && n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+	}
+
+	while (count > 0)
+	{
+		len = min(count, SIG_BLOCK_CHUNK);
+
+		// get the inputs, in the same order as the per-sample evaluation
+		sig_get_block_i(ptr->setpoint, n, len, out);
+		if (ptr->feedback)
+			sig_get_block_i(ptr->feedback, n, len, fb);
+		#if SIG_PID_FF
+		if (ptr->ff0)
+			sig_get_block_i(ptr->ff0, n, len, ff0);
+		if (ptr->ff1)
+			sig_get_block_i(ptr->ff1, n, len, ff1);
+		if (ptr->ff2)
+			sig_get_block_i(ptr->ff2, n, len, ff2);
+		#endif
+		SIG_ERRNO_FAIL_BLOCK
+
+		for (i=0; i<len; i++)
+		{
+			x = out[i];
+			if (ptr->feedback)
+				x = sig_sat_q((long long)x - fb[i]);
+			x = sig_pid_opt_core_q(ptr, x);
+			#if SIG_PID_FF
+			ff = 0;
+			if (ptr->ff0)
+				ff += (long long)ff0[i] * ptr->ff[0];
+			if (ptr->ff1)
+				ff += (long long)ff1[i] * ptr->ff[1];
+			if (ptr->ff2)
+				ff += (long long)ff2[i] * ptr->ff[2];
+			x = sig_pid_limit_q(ptr, x + sig_shift_q(ff, ptr->q));
+			#endif
+			out[i] = x;
+		}
+		self->x_cst = out[len - 1];
+		ptr->n_last = n + len - 1;
+		n += len;
+		out += len;
+		count -= len;
+	}
+}
+
+
+void sig_pid_compute_k_q(struct signal_int *self)
+{
+	struct sig_pid_param_q *ptr = (struct sig_pid_param_q *) self->params;
+	if (ptr == NULL)
+		return;
+	ptr->k[0] = sig_sat_q((long long)ptr->p + ptr->i + ptr->d);
+	ptr->k[1] = sig_sat_q(-1 * (long long)ptr->p - 2 * (long long)ptr->d);
+	ptr->k[2] = ptr->d;
+}
+
+
+int sig_buf_read_q(struct signal_int *self, n_t n)
+{
+	struct sig_buf_read_param_q *ptr = (struct sig_buf_read_param_q *) self->params;
+	int index;
+
+	SIG_ERRNO_FAIL
+	if(self == NULL)
+		SIG_ERRNO(-1);
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+	if ((ptr->buffer == NULL) && (ptr->check_buffer))
+		SIG_ERRNO(-3);
+	if (n == ptr->n_last)
+		return self->x_cst;
+	ptr->n_last = n;
+
+	if (ptr->buffer)
+	{
+		if (ptr->circular)
+			index = (n + ptr->delta) % ptr->size;
+		else
+			index = min((n + (n_t)ptr->delta), (n_t)ptr->size - 1);
+
+		self->x_cst = ptr->buffer[index];
+	}
+	return self->x_cst;
+}
+
+
+void sig_buf_read_block_q(struct signal_int *self, n_t n, int count, int *out)
+{
+	struct sig_buf_read_param_q *ptr;
+	n_t m, last;
+	int i, index;
+
+	SIG_ERRNO_FAIL_BLOCK
+	if(self == NULL)
+		SIG_ERRNO_BLOCK(-1);
+	if(self->params == NULL)
+		SIG_ERRNO_BLOCK(-2);
+
+	ptr = (struct sig_buf_read_param_q *) self->params;
+	if ((ptr->buffer == NULL) && (ptr->check_buffer))
+		SIG_ERRNO_BLOCK(-3);
+	if (count <= 0)
+		return;
+	if (n == ptr->n_last)
+	{
+		*out++ = self->x_cst;
+		n++;
+		count--;
+		if (count == 0)
+			return;
+	}
+	ptr->n_last = n + count - 1;
+
+	if (ptr->buffer == NULL)
+	{
+		for (i=0; i<count; i++)
+			out[i] = self->x_cst;
+		return;
+	}
+
+	m = n + ptr->delta;
+	if (ptr->circular)
+	{
+		// walk the buffer instead of computing a modulo for each sample
+		index = m % ptr->size;
+		for (i=0; i<count; i++)
+		{
+			out[i] = ptr->buffer[index];
+			m++;
+			index++;
+			if ((index == ptr->size) | (m == 0))				// (n + delta) rollover restarts at index 0, as the modulo does
+				index = 0;
+		}
+	}
+	else
+	{
+		last = (n_t)ptr->size - 1;
+		for (i=0; i<count; i++, m++)
+			out[i] = ptr->buffer[min(m, last)];
+	}
+	self->x_cst = out[count - 1];
 }
@@ -23,6 +23,7 @@
  */
 
 #include "sig.h"
+#include "sigf.h"
 
 #ifndef SIG_LIBI_H__
 #define SIG_LIBI_H__
@@ -30,6 +31,7 @@
 
 /** @addtogroup config
  * @{
+ */
 
 /** @} */
 
@@ -40,22 +42,165 @@
 
 /** @} */
 
+/***************************************************************************************/
+/*                              Parameter Structures                                   */
+/***************************************************************************************/
+
+/** @ingroup int
+ * @struct sig_dda_i
+ * @brief incremental state of an integer ramp (a * t + b) / div, rounded toward 0
+ * @details The quotient is kept as q + r / |div|, with 0 <= r < |div| (the sign of div is moved to a and b). When t
+ * advances by one, a / |div| is added to the quotient, with a carry from the remainder (Bresenham / DDA): no
+ * multiplication nor division is done. The state is computed again if t jumps or rolls over, or if a, b or div
+ * changed. Starts at 0.
+ */
+struct sig_dda_i {
+	n_t t;												//!< t of the state
+	long long q;										//!< floor((a * t + b) / |div|)
+	long long r;										//!< remainder, 0 <= r < d
+	long long step_q;									//!< floor(a / |div|)
+	long long step_r;									//!< remainder of a / |div|, 0 <= step_r < d
+	long long d;										//!< |div|. 0 if the state is not set
+	long long a;										//!< a of the state
+	long long b;										//!< b of the state
+	long long div;										//!< div of the state
+};
+
 /** @ingroup int
  * @struct sig_interpolate_lin_param
  * @brief structure representing the parameters of a 'linear interpolation' signal
- * @details the 'linear interpolation' signal returns (a * (n - delay) + b) / div
+ * @details the 'linear interpolation' signal returns (a * (n - delay) + b) / div, n - delay being an n_t and
+ * the division rounding toward 0. Evaluated incrementally, see sig_dda_i.
  */
 struct sig_interpolate_lin_param {
 	int a;
 	int b;
 	n_t delay;
-	int div;
+	int div;											//!< divider, must not be 0
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	struct sig_dda_i dda;								//!< incremental state
 };
 
+/** @ingroup int
+ * @struct sig_interpolate_st_param
+ * @brief structure representing the parameters of a 'start to stop' ramp signal
+ * @details the signal is start until n_start, then ramps linearly to reach stop at n_start + length, and stays at
+ * stop after: start + (stop - start) * (n - n_start) / length, the division rounding toward 0. The ramp is
+ * n-Rollover safe: n is before n_start if (n - n_start) is negative as an int, so length must be below 2^31.
+ * Evaluated incrementally, see sig_dda_i.
+ */
+struct sig_interpolate_st_param {
+	int start;											//!< value before n_start
+	int stop;											//!< value after n_start + length
+	n_t n_start;										//!< n of the start of the ramp
+	n_t length;											//!< duration of the ramp. 0 for a step
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	struct sig_dda_i dda;								//!< incremental state
+};
+
+/** @ingroup int
+ * @struct sig_add_param_q
+ * @brief structure representing the parameters of a fixed-point saturating 'adder' signal
+ * @details the adder returns (a + b), saturated to the int range. a and b must share the same Q format.
+ * a and b can be (in order of priority)
+ * -# a pointer to another signal
+ * -# a pointer to a variable
+ * -# a constant value
+ */
+struct sig_add_param_q {
+	struct signal_int *a;								//!< signal source for a
+	struct signal_int *b;								//!< signal source for b
+	int *a_var;											//!< variable source for a
+	int *b_var;											//!< variable source for b
+	int a_cst;											//!< constant value of a
+	int b_cst;											//!< constant value of b
+	n_t n_last;											//!< the sample was taken at n = n_last
+};
+
+/** @ingroup int
+ * @struct sig_iirlp1_param_q
+ * @brief structure representing the parameters of a fixed-point IIR Low Pass 1st order filter
+ * @details y[n] = y[n-1] + a * (x[n] - y[n-1]), which is the float form y[n-1] * (1 - a) + x[n] * a.
+ * The output has the Q format of the source.
+ */
+struct sig_iirlp1_param_q {
+	int a;												//!< damping factor 0 <= a <= 1, in Q(q) format
+	int q;												//!< number of fractional bits of a (1 to 30)
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	struct signal_int *source;
+};
+
+/** @ingroup int
+ * @struct sig_fir_n_param_q
+ * @brief structure representing the parameters of a fixed-point n-tap FIR filter
+ * @details Q15 data path: the source is saturated to 16 bits before being stored in the history, so it should
+ * be a Q15 signal. Taps are 16 bits in Q(q) format (q = 15 for taps in [-1; 1[) and the products are
+ * accumulated on 64 bits. The output is rounded back to the format of the source and saturated to the int range.
+ *
+ * The history uses the mirrored layout of sig_fir_n_param_f: taps is padded with 0 up to length, and samples is
+ * 2 * length long, so that x[n-i] is at samples[index_last + i]. Set up by sig_fir_n_init_q().
+ */
+struct sig_fir_n_param_q {
+	int tap_count;										//!< how many taps are present
+	int index_last;										//!< index of x[n] in samples
+	short *taps;										//!< points to the taps array, in Q(q) format
+	short *samples;										//!< points to the x[n-i] history of the source
+	struct signal_int *source;							//!< source signal for the filter
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	int length;											//!< tap_count rounded up to SIG_FIR_PAD
+	int q;												//!< number of fractional bits of the taps (1 to 15)
+};
+
+/** @ingroup int
+ * @struct sig_pid_param_q
+ * @brief structure representing the parameters of a fixed-point PID controller (optimized form)
+ * @details Same as sig_pid_param_f. The gains are in Q(q) format, and the error, integral and output
+ * share the Q format of the setpoint. Products are computed on 64 bits and rounded.
+ */
+struct sig_pid_param_q {
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	int q;												//!< number of fractional bits of the gains (1 to 30)
+	int p;												//!< Proportional gain
+	int i;												//!< Integral gain
+	int d;												//!< Derivative gain
+	int k[3];											//!< K-params calculated from P, I and D terms. Computed from p, i and d by sig_pid_compute_k_q()
+	int max_output;										//!< output limit. Also used for anti-windup
+	int integral;										//!< integral term
+	int history[3];										//!< history of the error input
+	struct signal_int *setpoint;						//!< setpoint (target). Error input if feedback is NULL
+	struct signal_int *feedback;						//!< feedback (measured output). Set to NULL to use setpoint as an error input
+#if (SIG_PID_FF) || defined(__DOXYGEN__)
+	int ff[3];											//!< Feed-Forward parameters, in Q(q) format
+	struct signal_int *ff0;								//!< Feed-Forward source 0. Set to NULL will deactive this term
+	struct signal_int *ff1;								//!< Feed-Forward source 1. Set to NULL will deactive this term
+	struct signal_int *ff2;								//!< Feed-Forward source 2. Set to NULL will deactive this term
+#endif
+};
+
+/** @ingroup int
+ * @struct sig_buf_read_param_q
+ * @brief structure representing the parameters of a fixed-point buffer reader
+ * @see sig_buf_read_param_f
+ */
+struct sig_buf_read_param_q {
+	int *buffer;										//!< points to the data buffer
+	int size;											//!< Size of the buffer. If the buffer is circular, the index will be modulo size
+	int delta;											//!< delta between data index and n. index = n + delta
+	unsigned circular		: 1;						//!< if 1, buffer is circular (index = (n + delta) % size). If not, the output will stick when size is exceeded (index = min ((size-1), n + delta))
+	unsigned check_buffer	: 1;						//!< if 1, throw an error if the buffer is NULL<; If 0, return x_cst until buffer is not NULL
+	unsigned dummy			: 6;						//!< unused. Reserved for future use
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/***************************************************************************************/
+/*                              Function definitions                                   */
+/***************************************************************************************/
+
+
 /** @ingroup int
  * @brief linear interpolation (ax + b) form
  * @details if n = n_last, then the cached value (x_cst) is returned.
- * returns (a * (n - delay) + b) / div.
+ * returns (a * (n - delay) + b) / div. Error -3 if div is 0.
  * @see sig_interpolate_lin_param
  *
  * @param[in] self pointer to the signal structure
@@ -63,8 +208,152 @@ struct sig_interpolate_lin_param {
  */
 int sig_interpolate_lin(struct signal_int *self, n_t n);
 
+/** @ingroup int
+ * @brief block evaluation of sig_interpolate_lin()
+ * @see sig_get_block_i
+ */
+void sig_interpolate_lin_block(struct signal_int *self, n_t n, int count, int *out);
 
+/** @ingroup int
+ * @brief ramp from start to stop
+ * @details if n = n_last, then the cached value (x_cst) is returned.
+ * @see sig_interpolate_st_param
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
 int sig_interpolate_st(struct signal_int *self, n_t n);
 
+/** @ingroup int
+ * @brief block evaluation of sig_interpolate_st()
+ * @see sig_get_block_i
+ */
+void sig_interpolate_st_block(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief evaluate count consecutive samples of the signal, from n to n + count - 1
+ * @details Same as sig_get_block_f(), for integer signals.
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n of the first sample
+ * @param[in] count number of samples to evaluate
+ * @param[out] out array of count values
+ */
+void sig_get_block_i(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief convert x to the Q(q) fixed-point format, rounding to nearest and saturating to the int range
+ */
+int sig_float_to_q(float x, int q);
+
+/** @ingroup int
+ * @brief convert x from the Q(q) fixed-point format to float
+ */
+float sig_q_to_float(int x, int q);
+
+/** @ingroup int
+ * @brief saturating adder (a + b)
+ * @see sig_add_param_q
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+int sig_add_q(struct signal_int *self, n_t n);
+
+/** @ingroup int
+ * @brief block evaluation of sig_add_q()
+ * @see sig_get_block_i
+ */
+void sig_add_block_q(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief fixed-point IIR Low Pass 1st order filter
+ * @see sig_iirlp1_param_q
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+int sig_iirlp1_q(struct signal_int *self, n_t n);
+
+/** @ingroup int
+ * @brief block evaluation of sig_iirlp1_q()
+ * @see sig_get_block_i
+ */
+void sig_iirlp1_block_q(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief fixed-point n-tap FIR filter
+ * @see sig_fir_n_param_q
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+int sig_fir_n_q(struct signal_int *self, n_t n);
+
+/** @ingroup int
+ * @brief block evaluation of sig_fir_n_q()
+ * @see sig_get_block_i
+ */
+void sig_fir_n_block_q(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief allocate and fill the taps and history of a fixed-point FIR filter
+ * @details taps equal to -32768 are clamped to -32767, so that a pair of 16-bit products cannot overflow 32 bits.
+ *
+ * @param[out] ptr FIR parameters. tap_count, length, q, index_last, taps and samples are set
+ * @param[in] taps tap_count taps, in Q(q) format. Copied
+ * @param[in] tap_count number of taps
+ * @param[in] q number of fractional bits of the taps
+ * @return 0 on success, -1 if the allocation failed
+ */
+int sig_fir_n_init_q(struct sig_fir_n_param_q *ptr, const short *taps, int tap_count, int q);
+
+/** @ingroup int
+ * @brief free the arrays allocated by sig_fir_n_init_q()
+ */
+void sig_fir_n_free_q(struct sig_fir_n_param_q *ptr);
+
+/** @ingroup int
+ * @brief select the 16-bit dot product kernel used by sig_fir_n_q()
+ * @details By default the best kernel supported by the CPU is selected on first use.
+ * @return 0 on success, -1 if the kernel is not supported by this CPU or build
+ */
+int sig_fir_kernel_q(enum sig_fir_kernel_t kernel);
+
+/** @ingroup int
+ * @brief fixed-point PID controller, optimized form
+ * @see sig_pid_param_q sig_pid_opt_f
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+int sig_pid_opt_q(struct signal_int *self, n_t n);
+
+/** @ingroup int
+ * @brief block evaluation of sig_pid_opt_q()
+ * @see sig_get_block_i
+ */
+void sig_pid_opt_block_q(struct signal_int *self, n_t n, int count, int *out);
+
+/** @ingroup int
+ * @brief compute the K-params of a fixed-point PID from its p, i and d gains
+ */
+void sig_pid_compute_k_q(struct signal_int *self);
+
+/** @ingroup int
+ * @brief fixed-point buffer reader
+ * @see sig_buf_read_param_q
+ *
+ * @param[in] self pointer to the signal structure
+ * @param[in] n the value of n
+ */
+int sig_buf_read_q(struct signal_int *self, n_t n);
+
+/** @ingroup int
+ * @brief block evaluation of sig_buf_read_q()
+ * @see sig_get_block_i
+ */
+void sig_buf_read_block_q(struct signal_int *self, n_t n, int count, int *out);
+
 
 #endif
@@ -0,0 +1,322 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file sigmulti.c
+ * SigLib Code, multi-instance floating point signals
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sigmulti.h"
+#include "sigf.h"
+
+/** SIG_LANES floats, processed by one vector operation */
+typedef float sig_vf __attribute__((vector_size(SIG_LANES * sizeof(float))));
+/** comparison result of two sig_vf */
+typedef int sig_vi __attribute__((vector_size(SIG_LANES * sizeof(int))));
+
+/** number of vectors holding count instances */
+#define SIG_VECTORS(count)		(((count) + SIG_LANES - 1) / SIG_LANES)
+
+/** array of K floats, seen as vectors */
+#define SIG_VEC(p)				((sig_vf *)(p))
+
+/** returns a where mask is set, b elsewhere. Macros rather than functions: vectors wider than the native
+ * ones can't be passed by value without changing the ABI */
+#define SIG_VSEL(mask, a, b)	((sig_vf)(((mask) & (sig_vi)(a)) | (~(mask) & (sig_vi)(b))))
+
+/** clamp x to [-max; max], same as sig_pid_limit_f() */
+#define SIG_VLIMIT(x, max)		SIG_VSEL((x) > (max), (max), SIG_VSEL((x) < -(max), -(max), (x)))
+
+
+float *sig_multi_array_f(int count)
+{
+	size_t size = (SIG_VECTORS(count) * sizeof(sig_vf) + 63) / 64 * 64;
+	float *ptr = aligned_alloc(64, size ? size : 64);
+
+	if (ptr)
+		memset(ptr, 0, size);
+	return ptr;
+}
+
+
+float sig_get_lane_f(struct signal_multi_f *self, int lane, n_t n)
+{
+	SIG_ERRNO_FAIL
+	return sig_value_multi_f(self, n)[lane];
+}
+
+
+float sig_multi_lane_f(struct signal_float *self, n_t n)
+{
+	struct sig_multi_lane_param_f *ptr = (struct sig_multi_lane_param_f *)self->params;
+
+	SIG_ERRNO_FAIL
+	if(self == NULL)
+		SIG_ERRNO(-1);
+	if(self->params == NULL)
+		SIG_ERRNO(-2);
+	self->x_cst = sig_get_lane_f(ptr->source, ptr->lane, n);
+	return self->x_cst;
+}
+
+
+void sig_add_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_add_param_multi_f *ptr = (struct sig_add_param_multi_f *)self->params;
+	const float *a, *b;
+	int i;
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	a = sig_value_multi_f(ptr->a, n);
+	b = sig_value_multi_f(ptr->b, n);
+	SIG_ERRNO_FAIL_MULTI
+	for (i=0; i<SIG_VECTORS(self->count); i++)
+		SIG_VEC(self->x_cst)[i] = SIG_VEC(a)[i] + SIG_VEC(b)[i];
+}
+
+
+void sig_limit_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_limit_param_multi_f *ptr = (struct sig_limit_param_multi_f *)self->params;
+	const float *x;
+	sig_vf v;
+	int i;
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	x = sig_value_multi_f(ptr->source, n);
+	SIG_ERRNO_FAIL_MULTI
+	for (i=0; i<SIG_VECTORS(self->count); i++)
+	{
+		v = SIG_VEC(x)[i];
+		v = SIG_VSEL(v < SIG_VEC(ptr->x_min)[i], SIG_VEC(ptr->x_min)[i], v);
+		v = SIG_VSEL(v > SIG_VEC(ptr->x_max)[i], SIG_VEC(ptr->x_max)[i], v);
+		SIG_VEC(self->x_cst)[i] = v;
+	}
+}
+
+
+void sig_iirlp1_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_iirlp1_param_multi_f *ptr = (struct sig_iirlp1_param_multi_f *)self->params;
+	const float *x;
+	int i;
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	x = sig_value_multi_f(ptr->source, n);
+	SIG_ERRNO_FAIL_MULTI
+	for (i=0; i<SIG_VECTORS(self->count); i++)
+		SIG_VEC(self->x_cst)[i] = (SIG_VEC(self->x_cst)[i] * SIG_VEC(ptr->oma)[i]) + (SIG_VEC(x)[i] * SIG_VEC(ptr->a)[i]);
+}
+
+
+int sig_fir_n_init_multi_f(struct sig_fir_n_param_multi_f *ptr, int count)
+{
+	ptr->samples = sig_multi_array_f(2 * ptr->tap_count * SIG_VECTORS(count) * SIG_LANES);
+	ptr->index_last = 0;
+	return ptr->samples ? 0 : -1;
+}
+
+
+void sig_fir_n_free_multi_f(struct sig_fir_n_param_multi_f *ptr)
+{
+	free(ptr->samples);
+	ptr->samples = NULL;
+	ptr->index_last = 0;
+}
+
+
+void sig_fir_n_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_fir_n_param_multi_f *ptr = (struct sig_fir_n_param_multi_f *)self->params;
+	const float *x;
+	sig_vf *row, *y = SIG_VEC(self->x_cst);
+	sig_vf tap;
+	int i, t, vectors = SIG_VECTORS(self->count);
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	x = sig_value_multi_f(ptr->source, n);
+	SIG_ERRNO_FAIL_MULTI
+
+	// store x[n] twice, in rows index and index + tap_count
+	ptr->index_last = ptr->index_last != 0 ? ptr->index_last - 1 : ptr->tap_count - 1;
+	row = SIG_VEC(ptr->samples) + ptr->index_last * vectors;
+	for (i=0; i<vectors; i++)
+		row[i] = row[i + ptr->tap_count * vectors] = SIG_VEC(x)[i];
+
+	for (i=0; i<vectors; i++)
+		y[i] = row[i] * ptr->taps[0];
+	for (t=1; t<ptr->tap_count; t++)
+	{
+		row += vectors;
+		tap = (sig_vf){0} + ptr->taps[t];
+		for (i=0; i<vectors; i++)
+			y[i] += row[i] * tap;
+	}
+}
+
+
+/** arrays of K floats of the PID controllers */
+#define SIG_PID_ARRAYS_MULTI(ptr)	{&(ptr)->k[0], &(ptr)->k[1], &(ptr)->k[2], &(ptr)->max_output, &(ptr)->integral, \
+	&(ptr)->history[0], &(ptr)->history[1], &(ptr)->history[2], &(ptr)->ff[0], &(ptr)->ff[1], &(ptr)->ff[2]}
+
+int sig_pid_init_multi_f(struct sig_pid_param_multi_f *ptr, int count)
+{
+	float **arrays[] = SIG_PID_ARRAYS_MULTI(ptr);
+	int i;
+
+	for (i=0; i<sizeof(arrays)/sizeof(arrays[0]); i++)
+		*arrays[i] = NULL;
+	for (i=0; i<sizeof(arrays)/sizeof(arrays[0]); i++)
+	{
+		*arrays[i] = sig_multi_array_f(count);
+		if (*arrays[i] == NULL)
+		{
+			sig_pid_free_multi_f(ptr);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+void sig_pid_free_multi_f(struct sig_pid_param_multi_f *ptr)
+{
+	float **arrays[] = SIG_PID_ARRAYS_MULTI(ptr);
+	int i;
+
+	for (i=0; i<sizeof(arrays)/sizeof(arrays[0]); i++)
+	{
+		free(*arrays[i]);
+		*arrays[i] = NULL;
+	}
+}
+
+
+void sig_pid_compute_k_multi_f(struct sig_pid_param_multi_f *ptr, int lane, float p, float i, float d)
+{
+	ptr->k[0][lane] = p + i + d;
+	ptr->k[1][lane] = -1 * p - 2 * d;
+	ptr->k[2][lane] = d;
+}
+
+
+void sig_pid_opt_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_pid_param_multi_f *ptr = (struct sig_pid_param_multi_f *)self->params;
+	const float *sp, *fb = NULL, *ff0 = NULL, *ff1 = NULL, *ff2 = NULL;
+	sig_vf x, integral, max;
+	int i;
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	sp = sig_value_multi_f(ptr->setpoint, n);
+	if (ptr->feedback)
+		fb = sig_value_multi_f(ptr->feedback, n);
+	if (ptr->ff0)
+		ff0 = sig_value_multi_f(ptr->ff0, n);
+	if (ptr->ff1)
+		ff1 = sig_value_multi_f(ptr->ff1, n);
+	if (ptr->ff2)
+		ff2 = sig_value_multi_f(ptr->ff2, n);
+	SIG_ERRNO_FAIL_MULTI
+
+	for (i=0; i<SIG_VECTORS(self->count); i++)
+	{
+		// get the current error and push it into the history
+		x = SIG_VEC(sp)[i];
+		if (fb)
+			x -= SIG_VEC(fb)[i];
+		SIG_VEC(ptr->history[2])[i] = SIG_VEC(ptr->history[1])[i];
+		SIG_VEC(ptr->history[1])[i] = SIG_VEC(ptr->history[0])[i];
+		SIG_VEC(ptr->history[0])[i] = x;
+
+		// compute the PID output, and limit the integral part
+		max = SIG_VEC(ptr->max_output)[i];
+		integral = SIG_VEC(ptr->integral)[i];
+		integral += SIG_VEC(ptr->history[0])[i] * SIG_VEC(ptr->k[0])[i];
+		integral += SIG_VEC(ptr->history[1])[i] * SIG_VEC(ptr->k[1])[i];
+		integral += SIG_VEC(ptr->history[2])[i] * SIG_VEC(ptr->k[2])[i];
+		integral = SIG_VLIMIT(integral, max);
+		SIG_VEC(ptr->integral)[i] = integral;
+
+		// compute Feed-Forward, and limit the output
+		x = integral;
+		if (ff0)
+			x += SIG_VEC(ff0)[i] * SIG_VEC(ptr->ff[0])[i];
+		if (ff1)
+			x += SIG_VEC(ff1)[i] * SIG_VEC(ptr->ff[1])[i];
+		if (ff2)
+			x += SIG_VEC(ff2)[i] * SIG_VEC(ptr->ff[2])[i];
+		SIG_VEC(self->x_cst)[i] = SIG_VLIMIT(x, max);
+	}
+}
+
+
+void sig_buf_read_multi_f(struct signal_multi_f *self, n_t n)
+{
+	struct sig_buf_read_param_multi_f *ptr = (struct sig_buf_read_param_multi_f *)self->params;
+	int i, index;
+
+	SIG_ERRNO_FAIL_MULTI
+	if(ptr == NULL)
+		SIG_ERRNO_MULTI(-2);
+	if (n == ptr->n_last)
+		return;
+	ptr->n_last = n;
+
+	if (ptr->circular)
+		index = (n + ptr->delta) % ptr->size;
+	else
+		index = min((n + (n_t)ptr->delta), (n_t)ptr->size - 1);
+	for (i=0; i<self->count; i++)
+		self->x_cst[i] = ptr->buffer[i][index];
+}
@@ -0,0 +1,307 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+
+/** \file sigmulti.h
+ * SigLib Header, multi-instance floating point signals
+ */
+
+#ifndef SIG_MULTI_H__
+#define SIG_MULTI_H__
+
+#include "sig.h"
+
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup multi
+ * @brief Number of instances processed by one vector operation. Arrays are padded to a multiple of SIG_LANES
+ */
+#if !defined(SIG_LANES) || defined(__DOXYGEN__)
+	#define SIG_LANES		8
+#endif
+
+/** @} */
+
+
+/** @ingroup multi
+ * @struct signal_multi_f
+ * @brief structure representing K instances of the same floating-point signal
+ * @details values of the K instances are stored in arrays of K floats (structure of arrays). All the
+ * arrays of a multi-instance signal and its parameters must be allocated with sig_multi_array_f().
+ */
+struct signal_multi_f {
+	void (*x)(struct signal_multi_f *self, n_t n);		//!< pointer to the evaluation function (*x). Evaluates all the instances into x_cst
+	float *x_var;										//!< points to K variables. used if x == NULL
+	float *x_cst;										//!< K values: constant values if x == NULL && x_var == NULL, else output of (*x)
+	void *params;										//!< points to the signal parameter(s), if any.
+	int count;											//!< number of instances (K)
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	const char *name;									//!< name of the signal, NULL if unnamed
+#endif
+};
+typedef void (*sig_func_multi_f)(struct signal_multi_f *self, n_t n);
+
+#define SIG_FN_MULTI(a,b,k,c) {.x=a, .x_var=NULL, .x_cst=c, .params=(void*)b, .count=k}
+#define SIGN_FN_MULTI(n,a,b,k,c) {.name=n, .x=a, .x_var=NULL, .x_cst=c, .params=(void*)b, .count=k}
+
+
+/**
+ * @brief evaluate a multi-instance signal at n and return its K values
+ */
+#define sig_value_multi_f(s,n) ( (s)->x != NULL ? ((s)->x((s), n), (s)->x_cst) : ( (s)->x_var ? (s)->x_var : (s)->x_cst ) )
+
+/**
+ * @def SIG_ERRNO_MULTI(a)
+ * @brief end multi-instance function, fill errno and clear the outputs
+ */
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+	#define SIG_ERRNO_MULTI(a) {sig_errno = a; \
+	sig_err_name = SIG_NAME(self); \
+	sig_err_ptr = self; \
+	memset(self->x_cst, 0, self->count * sizeof(float)); \
+	return;}
+#else
+	#define SIG_ERRNO_MULTI(a) {sig_errno = a; \
+	sig_err_ptr = self; \
+	memset(self->x_cst, 0, self->count * sizeof(float)); \
+	return;}
+#endif
+
+/**
+ * @def SIG_ERRNO_FAIL_MULTI
+ * @brief Checks if an error occurred. If so, clear the outputs and return
+ */
+#define SIG_ERRNO_FAIL_MULTI if(sig_errno) { \
+	memset(self->x_cst, 0, self->count * sizeof(float)); \
+	return;}
+
+
+/***************************************************************************************/
+/*                              Parameter Structures                                   */
+/***************************************************************************************/
+
+/** @ingroup multi
+ * @struct sig_add_param_multi_f
+ * @brief parameters of a multi-instance adder: returns (a + b)
+ */
+struct sig_add_param_multi_f {
+	struct signal_multi_f *a;							//!< signal source for a
+	struct signal_multi_f *b;							//!< signal source for b
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup multi
+ * @struct sig_limit_param_multi_f
+ * @brief parameters of a multi-instance limiter: returns min(max(source, x_min), x_max)
+ */
+struct sig_limit_param_multi_f {
+	float *x_min;										//!< K lower limits
+	float *x_max;										//!< K upper limits
+	struct signal_multi_f *source;						//!< source signal
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup multi
+ * @struct sig_iirlp1_param_multi_f
+ * @brief parameters of K IIR Low Pass 1st order filters
+ */
+struct sig_iirlp1_param_multi_f {
+	float *a;											//!< K damping factors 0 <= n <= 1
+	float *oma;											//!< K (1 - a)
+	struct signal_multi_f *source;						//!< source signal
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup multi
+ * @struct sig_fir_n_param_multi_f
+ * @brief parameters of K FIR filters sharing the same taps
+ * @details samples holds 2 * tap_count rows of K samples; each input row is written twice so that the history
+ * is contiguous (see the mirrored layout of sig_fir_n_param_f)
+ */
+struct sig_fir_n_param_multi_f {
+	int tap_count;										//!< how many taps are present
+	int index_last;										//!< row of x[n] in samples
+	float *taps;										//!< tap_count taps, shared by all the instances
+	float *samples;										//!< 2 * tap_count rows of K samples. Row index_last + i holds x[n-i]
+	struct signal_multi_f *source;						//!< source signal
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup multi
+ * @struct sig_pid_param_multi_f
+ * @brief parameters of K PID controllers, optimized form
+ * @see sig_pid_param_f
+ */
+struct sig_pid_param_multi_f {
+	n_t n_last;											//!< the evaluation was done at n = n_last
+	float *k[3];										//!< K-params of each instance, see sig_pid_compute_k_f()
+	float *max_output;									//!< K output limits. Also used for anti-windup
+	float *integral;									//!< K integral terms
+	float *history[3];									//!< K error histories
+	struct signal_multi_f *setpoint;					//!< setpoint (target). Error input if feedback is NULL
+	struct signal_multi_f *feedback;					//!< feedback (measured output). Set to NULL to use setpoint as an error input
+	float *ff[3];										//!< K Feed-Forward parameters of each source
+	struct signal_multi_f *ff0;							//!< Feed-Forward source 0. Set to NULL will deactive this term
+	struct signal_multi_f *ff1;							//!< Feed-Forward source 1. Set to NULL will deactive this term
+	struct signal_multi_f *ff2;							//!< Feed-Forward source 2. Set to NULL will deactive this term
+};
+
+/** @ingroup multi
+ * @struct sig_buf_read_param_multi_f
+ * @brief parameters of K buffer readers
+ * @see sig_buf_read_param_f
+ */
+struct sig_buf_read_param_multi_f {
+	float **buffer;										//!< K data buffers
+	int size;											//!< Size of the buffers
+	int delta;											//!< delta between data index and n. index = n + delta
+	unsigned circular		: 1;						//!< if 1, buffers are circular. If not, the output will stick when size is exceeded
+	n_t n_last;											//!< the evaluation was done at n = n_last
+};
+
+/** @ingroup multi
+ * @struct sig_multi_lane_param_f
+ * @brief parameters of sig_multi_lane_f(), that reads one instance of a multi-instance signal
+ */
+struct sig_multi_lane_param_f {
+	struct signal_multi_f *source;						//!< multi-instance signal
+	int lane;											//!< instance to read
+};
+
+
+/***************************************************************************************/
+/*                              Function definitions                                   */
+/***************************************************************************************/
+
+/** @ingroup multi
+ * @brief allocate an array for count instances
+ * @details the array is 64-byte aligned, padded to a multiple of SIG_LANES and cleared. Free it with free()
+ * @return the array, or NULL
+ */
+float *sig_multi_array_f(int count);
+
+
+/** @ingroup multi
+ * @brief evaluate a multi-instance signal and return the value of one instance
+ * @param[in] self pointer to the signal structure
+ * @param[in] lane instance to read, 0 <= lane < count
+ * @param[in] n the value of n
+ */
+float sig_get_lane_f(struct signal_multi_f *self, int lane, n_t n);
+
+
+/** @ingroup multi
+ * @brief single-instance sig-func reading one instance of a multi-instance signal
+ * @details allows using an instance as a source of any float signal, or in the scope
+ * @see sig_multi_lane_param_f
+ */
+float sig_multi_lane_f(struct signal_float *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief K adders
+ * @see sig_add_param_multi_f
+ */
+void sig_add_multi_f(struct signal_multi_f *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief K limiters
+ * @see sig_limit_param_multi_f
+ */
+void sig_limit_multi_f(struct signal_multi_f *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief K IIR Low Pass 1st order filters
+ * @see sig_iirlp1_param_multi_f, sig_iirlp1_f
+ */
+void sig_iirlp1_multi_f(struct signal_multi_f *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief allocate the samples of K FIR filters
+ * @param[in,out] ptr parameters. tap_count and taps must be set
+ * @param[in] count number of instances
+ * @return 0 on success, -1 if the memory can't be allocated
+ */
+int sig_fir_n_init_multi_f(struct sig_fir_n_param_multi_f *ptr, int count);
+
+
+/** @ingroup multi
+ * @brief free the samples allocated by sig_fir_n_init_multi_f(). The taps belong to the caller
+ */
+void sig_fir_n_free_multi_f(struct sig_fir_n_param_multi_f *ptr);
+
+
+/** @ingroup multi
+ * @brief K FIR filters
+ * @see sig_fir_n_param_multi_f, sig_fir_n_f
+ */
+void sig_fir_n_multi_f(struct signal_multi_f *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief allocate the arrays of K PID controllers
+ * @details all the gains and states are cleared
+ * @param[in,out] ptr parameters
+ * @param[in] count number of instances
+ * @return 0 on success, -1 if the memory can't be allocated: the arrays are then freed, and NULL
+ */
+int sig_pid_init_multi_f(struct sig_pid_param_multi_f *ptr, int count);
+
+
+/** @ingroup multi
+ * @brief free the arrays allocated by sig_pid_init_multi_f()
+ */
+void sig_pid_free_multi_f(struct sig_pid_param_multi_f *ptr);
+
+
+/** @ingroup multi
+ * @brief compute the K-params of one instance
+ * @param[in,out] ptr parameters
+ * @param[in] lane instance
+ * @param[in] p proportional gain
+ * @param[in] i integral gain
+ * @param[in] d derivative gain
+ * @see sig_pid_compute_k_f
+ */
+void sig_pid_compute_k_multi_f(struct sig_pid_param_multi_f *ptr, int lane, float p, float i, float d);
+
+
+/** @ingroup multi
+ * @brief K PID controllers, optimized form, with Feed-Forward
+ * @details each instance gives the same output as sig_pid_opt_f() with SIG_PID_FF
+ * @see sig_pid_param_multi_f
+ */
+void sig_pid_opt_multi_f(struct signal_multi_f *self, n_t n);
+
+
+/** @ingroup multi
+ * @brief K buffer readers
+ * @see sig_buf_read_param_multi_f
+ */
+void sig_buf_read_multi_f(struct signal_multi_f *self, n_t n);
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigreg.c
+ * SigLib Code, signal registry
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sigreg.h"
+
+#if SIG_DBG_NAME
+
+uint32_t sig_reg_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+
+	while(*name)
+	{
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+static struct sig_reg sig_names;						//!< table of the interned names
+
+
+/**
+ * @brief name of a registered signal
+ */
+static inline const char *sig_reg_name(const struct sig_reg_entry *entry)
+{
+	if(entry->type == SIG_REG_FLOAT)
+		return ((struct signal_float*)entry->sig)->name;
+	if(entry->type == SIG_REG_INT)
+		return ((struct signal_int*)entry->sig)->name;
+	return (const char*)entry->sig;
+}
+
+
+/**
+ * @brief returns the slot of (name, type), or the empty slot where it should be inserted
+ */
+static struct sig_reg_entry *sig_reg_slot(const struct sig_reg *self, const char *name, uint32_t hash, int type)
+{
+	struct sig_reg_entry *entry;
+	unsigned int i = hash & self->mask;
+
+	for(;;)
+	{
+		entry = &self->table[i];
+		if(entry->type == 0)
+			return entry;
+		if((entry->hash == hash) && (entry->type == type) && (strcmp(sig_reg_name(entry), name) == 0))
+			return entry;
+		i = (i + 1) & self->mask;						// linear probing
+	}
+}
+
+
+/**
+ * @brief double the table size (or allocate it), re-inserting the entries from their stored hash
+ */
+static int sig_reg_grow(struct sig_reg *self)
+{
+	struct sig_reg_entry *old = self->table, *entry;
+	unsigned int size = old ? 2 * (self->mask + 1) : SIG_REG_INIT_SIZE;
+	unsigned int i, j;
+
+	self->table = calloc(size, sizeof(struct sig_reg_entry));
+	if(self->table == NULL)
+	{
+		self->table = old;
+		return -1;
+	}
+	j = old ? self->mask + 1 : 0;
+	self->mask = size - 1;
+	for(i=0; i<j; i++)
+	{
+		if(old[i].type == 0)
+			continue;
+		entry = &self->table[old[i].hash & self->mask];
+		while(entry->type)
+			entry = &self->table[(entry - self->table + 1) & self->mask];
+		*entry = old[i];
+	}
+	free(old);
+	return 0;
+}
+
+
+/**
+ * @brief add a signal of any type
+ */
+static int sig_reg_add(struct sig_reg *self, void *sig, const char *name, int type)
+{
+	struct sig_reg_entry *entry;
+	uint32_t hash = sig_reg_hash(name);
+
+	if((self->table == NULL) || (2 * (self->count + 1) > self->mask + 1))
+		if(sig_reg_grow(self))
+			return -1;
+
+	entry = sig_reg_slot(self, name, hash, type);
+	if(entry->type)
+		return -1;										// already registered
+	entry->hash = hash;
+	entry->type = type;
+	entry->sig = sig;
+	self->count++;
+	return 0;
+}
+
+
+int sig_reg_add_f(struct sig_reg *self, struct signal_float *sig)
+{
+	if(sig->name == NULL)
+		return -1;
+	return sig_reg_add(self, sig, sig->name, SIG_REG_FLOAT);
+}
+
+
+int sig_reg_add_i(struct sig_reg *self, struct signal_int *sig)
+{
+	if(sig->name == NULL)
+		return -1;
+	return sig_reg_add(self, sig, sig->name, SIG_REG_INT);
+}
+
+
+struct signal_float *sig_reg_find_f(const struct sig_reg *self, const char *name)
+{
+	if(self->table == NULL)
+		return NULL;
+	return (struct signal_float*)sig_reg_slot(self, name, sig_reg_hash(name), SIG_REG_FLOAT)->sig;
+}
+
+
+struct signal_int *sig_reg_find_i(const struct sig_reg *self, const char *name)
+{
+	if(self->table == NULL)
+		return NULL;
+	return (struct signal_int*)sig_reg_slot(self, name, sig_reg_hash(name), SIG_REG_INT)->sig;
+}
+
+
+void sig_reg_free(struct sig_reg *self)
+{
+	free(self->table);
+	memset(self, 0, sizeof(struct sig_reg));
+}
+
+
+const char *sig_name_intern(const char *name)
+{
+	char *copy;
+
+	if(sig_names.table)
+	{
+		copy = (char*)sig_reg_slot(&sig_names, name, sig_reg_hash(name), SIG_REG_NAME)->sig;
+		if(copy)
+			return copy;
+	}
+	copy = strdup(name);
+	if((copy == NULL) || sig_reg_add(&sig_names, copy, copy, SIG_REG_NAME))
+	{
+		free(copy);
+		return NULL;
+	}
+	return copy;
+}
+
+#endif	// SIG_DBG_NAME
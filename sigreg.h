@@ -0,0 +1,129 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file sigreg.h
+ * SigLib Header, signal registry
+ */
+
+#ifndef SIG_REG_H__
+#define SIG_REG_H__
+
+#include <stdint.h>
+#include "sig.h"
+
+/** @addtogroup config
+ * @{
+ */
+
+/**
+ * @brief Initial capacity (in entries) of a signal registry. Must be a power of 2
+ */
+#if !defined(SIG_REG_INIT_SIZE) || defined(__DOXYGEN__)
+#define SIG_REG_INIT_SIZE			64
+#endif
+
+/** @} */
+
+/** @ingroup registry
+ * @brief type of a registered signal
+ */
+enum sig_reg_type_t {
+	SIG_REG_FLOAT = 1,									//!< struct signal_float
+	SIG_REG_INT = 2,									//!< struct signal_int
+	SIG_REG_NAME = 3,									//!< interned name (char *), see sig_name_intern()
+};
+
+/** @ingroup registry
+ * @struct sig_reg_entry
+ * @brief slot of the registry hash table
+ */
+struct sig_reg_entry {
+	uint32_t hash;										//!< hash of the name, see sig_reg_hash()
+	int type;											//!< enum sig_reg_type_t. 0 if the slot is empty
+	void *sig;											//!< the registered signal
+};
+
+/** @ingroup registry
+ * @struct sig_reg
+ * @brief signal registry: an open addressing hash table of signals, indexed by name and type
+ * @details The table grows by doubling, and is kept at most half full, so that a lookup is one or two probes.
+ * The name hashes are stored in the table: growing does not read the names again, and a probe compares
+ * the names only when the hashes match.
+ * The names are not copied: a signal name must not change while it is registered.
+ * A zeroed struct sig_reg is a valid empty registry.
+ */
+struct sig_reg {
+	struct sig_reg_entry *table;						//!< hash table, mask + 1 slots
+	unsigned int mask;									//!< size of the table - 1
+	int count;											//!< number of registered signals
+};
+
+#if SIG_DBG_NAME || defined(__DOXYGEN__)
+
+/** @ingroup registry
+ * @brief FNV-1a hash of a signal name
+ */
+uint32_t sig_reg_hash(const char *name);
+
+/** @ingroup registry
+ * @brief add a signal_float to the registry
+ * @param[in] self the registry
+ * @param[in] sig the signal. Its name is the key
+ * @return 0 on success, -1 if the signal is unnamed, if a signal_float with the same name is already registered or on
+ * allocation failure
+ */
+int sig_reg_add_f(struct sig_reg *self, struct signal_float *sig);
+
+/** @ingroup registry
+ * @brief add a signal_int to the registry
+ * @see sig_reg_add_f
+ */
+int sig_reg_add_i(struct sig_reg *self, struct signal_int *sig);
+
+/** @ingroup registry
+ * @brief search a signal_float by its name
+ * @return the signal, or NULL if not found
+ */
+struct signal_float *sig_reg_find_f(const struct sig_reg *self, const char *name);
+
+/** @ingroup registry
+ * @brief search a signal_int by its name
+ * @return the signal, or NULL if not found
+ */
+struct signal_int *sig_reg_find_i(const struct sig_reg *self, const char *name);
+
+/** @ingroup registry
+ * @brief free the memory of the registry. The registry is empty and can be used again
+ */
+void sig_reg_free(struct sig_reg *self);
+
+/** @ingroup registry
+ * @brief intern a signal name
+ * @details Signals only hold a pointer to their name. Names built at run time are copied once in a global string
+ * table, and equal names share the same copy. The copies are never freed.
+ * @n Not thread-safe: names are expected to be interned while setting up the signals.
+ * @param[in] name the name to intern
+ * @return the interned copy of name, or NULL on allocation failure
+ */
+const char *sig_name_intern(const char *name);
+
+#endif	// SIG_DBG_NAME
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigreplay.c
+ * SigLib Code, offline replay of datasets through a signal graph
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "sigreplay.h"
+
+
+/**
+ * @brief state shared by the threads of a replay
+ */
+struct sig_replay_pool {
+	struct sig_replay *self;
+	int next;											//!< index of the next dataset to run
+	pthread_mutex_t lock;								//!< protects results and the counters below
+	int failed;
+	uint64_t samples;
+};
+
+
+static double sig_replay_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+
+/**
+ * @brief save the output of a run in output_dir, as a dataset named after the replayed one
+ */
+static int sig_replay_save(const struct sig_replay *self, const char *dataset, const float *out, size_t length)
+{
+	static const char * const name[1] = {"output"};
+	const char *base = strrchr(dataset, '/');
+	char *path;
+	int ret;
+
+	base = base ? base + 1 : dataset;
+	path = malloc(strlen(self->output_dir) + strlen(base) + 6);
+	if(path == NULL)
+		return -1;
+	sprintf(path, "%s/%s.out", self->output_dir, base);
+	ret = sig_ds_write_f(path, name, &out, 1, length);
+	free(path);
+	return ret;
+}
+
+
+/**
+ * @brief run one dataset through its own graph instance
+ */
+static void sig_replay_one(const struct sig_replay *self, const char *dataset, struct sig_replay_result *res)
+{
+	struct sig_replay_run run;
+	struct sig_ds ds;
+	float *out = NULL, x, e;
+	double sq = 0, start = sig_replay_now();
+	uint64_t i, length;
+
+	memset(res, 0, sizeof(struct sig_replay_result));
+	res->dataset = dataset;
+	if(sig_ds_open(&ds, dataset))
+	{
+		res->err = -1;
+		return;
+	}
+	memset(&run, 0, sizeof(run));
+	res->err = self->build(&run, &ds, self->arg);
+	if(res->err == 0)
+	{
+		length = ds.header->length;
+		if(self->output_dir)
+			out = calloc(length, sizeof(float));		// out[0] is the initial state, not evaluated
+		sig_errno = 0;
+		for(i=1; i<length; i++)
+		{
+			if(run.graph && sig_graph_run(run.graph, (n_t)i))
+				break;
+			x = sig_get_value_f(run.output, (n_t)i);		// memoized if the graph evaluated it
+			if(run.reference)
+			{
+				e = x - sig_get_value_f(run.reference, (n_t)i);
+				sq += (double)e * e;
+			}
+			if(sig_errno)
+				break;
+			if(fabsf(x) > res->max_output)
+				res->max_output = fabsf(x);
+			if((self->saturation > 0) && (fabsf(x) >= self->saturation))
+				res->saturated++;
+			if(out)
+				out[i] = x;
+		}
+		res->samples = i ? i - 1 : 0;
+		res->rms_error = (run.reference && res->samples) ? sqrt(sq / res->samples) : 0;
+		if(run.graph && run.graph->ctx.err)
+			res->err = run.graph->ctx.err;
+		else if(sig_errno)
+			res->err = sig_errno;
+		sig_errno = 0;
+		if(self->output_dir && (res->err == 0) && ((out == NULL) || sig_replay_save(self, dataset, out, length)))
+			res->err = -1;
+		free(out);
+		if(self->release)
+			self->release(&run, self->arg);
+	}
+	sig_ds_close(&ds);
+	res->seconds = sig_replay_now() - start;
+}
+
+
+static void *sig_replay_thread(void *arg)
+{
+	struct sig_replay_pool *pool = (struct sig_replay_pool *)arg;
+	struct sig_replay *self = pool->self;
+	struct sig_replay_result res;
+	int i;
+
+	while((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < self->count)
+	{
+		sig_replay_one(self, self->datasets[i], &res);
+		pthread_mutex_lock(&pool->lock);
+		if(self->result)
+			self->result[i] = res;
+		if(self->results)
+		{
+			fprintf(self->results, "%s,%d,%llu,%g,%llu,%g,%g\n", res.dataset, res.err, (unsigned long long)res.samples,
+				res.rms_error, (unsigned long long)res.saturated, res.max_output, res.seconds);
+			fflush(self->results);
+		}
+		pool->failed += (res.err != 0);
+		pool->samples += res.samples;
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+
+int sig_replay_run(struct sig_replay *self, struct sig_replay_stats *stats)
+{
+	pthread_t thread[SIG_REPLAY_MAX_THREADS];
+	struct sig_replay_pool pool = {.self = self};
+	double start = sig_replay_now();
+	int i, started, threads = self->threads;
+	struct sig_err_state saved;
+
+	if(threads < 1)
+		threads = 1;
+	if(threads > SIG_REPLAY_MAX_THREADS)
+		threads = SIG_REPLAY_MAX_THREADS;
+	pthread_mutex_init(&pool.lock, NULL);
+	if(self->results)
+		fprintf(self->results, "dataset,err,samples,rms_error,saturated,max_output,seconds\n");
+
+	// the calling thread is one of the threads. Its error state is restored after its runs
+	sig_err_save(&saved);
+	for(started=1; started<threads; started++)
+		if(pthread_create(&thread[started], NULL, sig_replay_thread, &pool))
+			break;
+	sig_replay_thread(&pool);
+	for(i=1; i<started; i++)
+		pthread_join(thread[i], NULL);
+	pthread_mutex_destroy(&pool.lock);
+	sig_err_restore(&saved);
+
+	if(stats)
+	{
+		stats->runs = self->count;
+		stats->failed = pool.failed;
+		stats->samples = pool.samples;
+		stats->seconds = sig_replay_now() - start;
+		stats->samples_per_s = stats->seconds > 0 ? stats->samples / stats->seconds : 0;
+	}
+	return pool.failed ? -1 : 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigreplay.h
+ * SigLib Header, offline replay of datasets through a signal graph
+ */
+
+#ifndef SIG_REPLAY_H__
+#define SIG_REPLAY_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "sigds.h"
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup replay
+ * @brief Maximum number of threads of a replay
+ */
+#if !defined(SIG_REPLAY_MAX_THREADS) || defined(__DOXYGEN__)
+	#define SIG_REPLAY_MAX_THREADS	64
+#endif
+
+/** @} */
+
+
+/** @ingroup replay
+ * @struct sig_replay_run
+ * @brief one instance of the replayed graph, built for one dataset by the factory
+ */
+struct sig_replay_run {
+	struct signal_float *output;						//!< recorded signal
+	struct signal_float *reference;						//!< the error is output - reference. NULL if there is no reference
+	struct sig_graph *graph;							//!< compiled graph evaluating output. NULL to evaluate output recursively
+	void *user;											//!< free for the factory, e.g. to find its memory back in release
+};
+
+/** @ingroup replay
+ * @brief builds a graph instance reading the dataset ds, typically with sig_ds_buf_read_f()
+ * @param[out] run the instance. Zeroed before the call
+ * @param[in] ds the opened dataset. It stays mapped until release is called
+ * @param[in] arg sig_replay::arg
+ * @return 0 on success. Any other value is reported as the error of the run
+ */
+typedef int (*sig_replay_build)(struct sig_replay_run *run, const struct sig_ds *ds, void *arg);
+
+/** @ingroup replay
+ * @brief releases a graph instance built by sig_replay_build
+ */
+typedef void (*sig_replay_release)(struct sig_replay_run *run, void *arg);
+
+/** @ingroup replay
+ * @struct sig_replay_result
+ * @brief metrics of one run
+ */
+struct sig_replay_result {
+	const char *dataset;								//!< path of the dataset
+	int err;											//!< 0, -1 if the dataset can't be opened, the error of the factory, or the signal error (sig_errno or ctx.err)
+	uint64_t samples;									//!< number of evaluated samples (length of the dataset - 1 if no error)
+	double rms_error;									//!< RMS of output - reference. 0 if there is no reference
+	uint64_t saturated;									//!< number of samples where |output| >= saturation
+	float max_output;									//!< maximum of |output|
+	double seconds;										//!< duration of the run
+};
+
+/** @ingroup replay
+ * @struct sig_replay_stats
+ * @brief aggregate metrics of a replay
+ */
+struct sig_replay_stats {
+	int runs;											//!< number of runs
+	int failed;											//!< number of runs with an error
+	uint64_t samples;									//!< samples evaluated by all the runs
+	double seconds;										//!< wall-clock duration of the replay
+	double samples_per_s;								//!< aggregate throughput
+};
+
+/** @ingroup replay
+ * @struct sig_replay
+ * @brief a replay: each dataset is run through its own instance of the graph, on a pool of threads
+ */
+struct sig_replay {
+	sig_replay_build build;								//!< graph factory
+	sig_replay_release release;							//!< releases an instance. Can be NULL
+	void *arg;											//!< argument of build and release
+	const char * const *datasets;						//!< paths of the dataset files
+	int count;											//!< number of datasets
+	int threads;										//!< number of threads (1 to SIG_REPLAY_MAX_THREADS)
+	float saturation;									//!< output level counted as saturated. 0 to disable
+	FILE *results;										//!< CSV results file: one line per run, written as the runs complete. Can be NULL
+	const char *output_dir;								//!< if not NULL, the output of each run is saved in output_dir as a dataset file
+	struct sig_replay_result *result;					//!< if not NULL, receives the count results, in dataset order
+};
+
+/** @ingroup replay
+ * @brief run all the datasets
+ * @details Each thread takes the next dataset, maps it, builds a graph instance with build, and evaluates output
+ * from n = 1 to the length of the dataset - 1 (n = 0 is the initial state of the signals, whose n_last is 0). Then the metrics of the run are written to results, and the output
+ * (a column named "output") to output_dir/<dataset file name>.out.
+ * @n Runs don't share any state: the factory must build independent instances. Errors are collected per run, in
+ * the graph context or in the error state of the thread.
+ * @param[in] self the replay
+ * @param[out] stats aggregate metrics. Can be NULL
+ * @return 0 if all the runs succeeded, -1 otherwise
+ */
+int sig_replay_run(struct sig_replay *self, struct sig_replay_stats *stats);
+
+#endif
@@ -0,0 +1,428 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigtune.c
+ * SigLib Code, parallel PID gain search
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "sigtune.h"
+
+
+/**
+ * @brief closed loop evaluated by one thread. The columns are shared, the state is private
+ */
+struct sig_tune_loop {
+	struct signal_float setpoint, ff[3], drive, plant, pid;
+	struct sig_buf_read_param_f setpoint_param, ff_param[3];
+	struct sig_iirlp1_param_f plant_param;
+	struct sig_pid_param_f pid_param;
+	float drive_value;									//!< plant_gain * output[n-1]
+};
+
+/**
+ * @brief ranked candidate: the search order breaks the ties of the cost
+ */
+struct sig_tune_entry {
+	struct sig_tune_candidate cand;
+	int64_t index;
+};
+
+/**
+ * @brief best candidates found by one thread
+ */
+struct sig_tune_rank {
+	struct sig_tune_entry *entry;						//!< lowest cost first
+	int count;
+	int size;
+};
+
+/**
+ * @brief a batch of candidates, shared by the threads
+ */
+struct sig_tune_pool {
+	const struct sig_tune *self;
+	int64_t next;										//!< index of the next candidate of the batch
+	int64_t total;										//!< number of candidates of the batch
+	int64_t offset;										//!< search index of the first candidate of the batch
+	float base[SIG_TUNE_PARAMS];						//!< descent: current best parameters
+	int param;											//!< descent: searched parameter
+	float lo, hi;										//!< descent: searched window
+	int steps;											//!< descent: number of values of the window
+	pthread_mutex_t lock;								//!< protects the ranks below
+	struct sig_tune_rank rank;							//!< best candidates of the whole search
+	struct sig_tune_rank best;							//!< best candidate of the batch
+};
+
+
+static void sig_tune_buf(struct signal_float *sig, struct sig_buf_read_param_f *param, const float *column, int length)
+{
+	memset(param, 0, sizeof(*param));
+	param->buffer = (float *)column;					// only read
+	param->size = length;
+	*sig = (struct signal_float) SIG_FN(sig_buf_read_f, param);
+}
+
+
+static void sig_tune_loop_init(const struct sig_tune *self, struct sig_tune_loop *loop)
+{
+	int i;
+
+	memset(loop, 0, sizeof(*loop));
+	sig_tune_buf(&loop->setpoint, &loop->setpoint_param, self->setpoint, self->length);
+	loop->drive = (struct signal_float) SIG_PTR(&loop->drive_value);
+	loop->plant_param.a = self->plant_a;
+	loop->plant_param.oma = 1 - self->plant_a;
+	loop->plant_param.source = &loop->drive;
+	loop->plant = (struct signal_float) SIG_FN(sig_iirlp1_f, &loop->plant_param);
+	loop->pid_param.setpoint = &loop->setpoint;
+	loop->pid_param.feedback = &loop->plant;
+	for(i=0; i<3; i++)
+		if(self->ff[i])
+			sig_tune_buf(&loop->ff[i], &loop->ff_param[i], self->ff[i], self->length);
+#if SIG_PID_FF
+	loop->pid_param.ff0 = self->ff[0] ? &loop->ff[0] : NULL;
+	loop->pid_param.ff1 = self->ff[1] ? &loop->ff[1] : NULL;
+	loop->pid_param.ff2 = self->ff[2] ? &loop->ff[2] : NULL;
+#endif
+	loop->pid = (struct signal_float) SIG_FN(sig_pid_opt_f, &loop->pid_param);
+}
+
+
+/**
+ * @brief evaluate a candidate on a loop, from its initial state
+ */
+static void sig_tune_loop_eval(const struct sig_tune *self, struct sig_tune_loop *loop, struct sig_tune_candidate *cand)
+{
+	struct sig_pid_param_f *pid = &loop->pid_param;
+	double iae = 0, ise = 0, overshoot = 0, effort = 0, cost = 0;
+	float sp, sp_last = 0, y, u, e, dir = 0;
+	int i, n, weighted = 0;
+
+	// reset the state
+	loop->setpoint_param.n_last = 0;
+	for(i=0; i<3; i++)
+		loop->ff_param[i].n_last = 0;
+	loop->plant_param.n_last = 0;
+	loop->plant.x_cst = 0;
+	loop->pid.x_cst = 0;
+	loop->drive_value = 0;
+	pid->n_last = 0;
+	pid->integral = 0;
+	memset(pid->history, 0, sizeof(pid->history));
+
+	pid->p = cand->param[SIG_TUNE_P];
+	pid->i = cand->param[SIG_TUNE_I];
+	pid->d = cand->param[SIG_TUNE_D];
+#if SIG_PID_FF
+	pid->ff[0] = cand->param[SIG_TUNE_FF0];
+	pid->ff[1] = cand->param[SIG_TUNE_FF1];
+	pid->ff[2] = cand->param[SIG_TUNE_FF2];
+#endif
+	pid->max_output = cand->param[SIG_TUNE_MAX_OUTPUT];
+	sig_pid_compute_k_f(&loop->pid);
+
+	sig_errno = 0;
+	for(n=1; n<self->length; n++)
+	{
+		u = sig_get_value_f(&loop->pid, n);
+		y = loop->plant.x_cst;							// evaluated by the PID at n
+		sp = self->setpoint[n];
+		e = sp - y;
+		iae += fabsf(e);
+		ise += (double)e * e;
+		effort += (double)u * u;
+		if(sp != sp_last)
+			dir = (sp > sp_last) ? 1 : -1;
+		sp_last = sp;
+		if((double)dir * (y - sp) > overshoot)
+			overshoot = (double)dir * (y - sp);
+		loop->drive_value = self->plant_gain * u;
+	}
+
+	cand->metric[SIG_TUNE_IAE] = iae;
+	cand->metric[SIG_TUNE_ISE] = ise;
+	cand->metric[SIG_TUNE_OVERSHOOT] = overshoot;
+	cand->metric[SIG_TUNE_EFFORT] = effort;
+	for(i=0; i<SIG_TUNE_METRICS; i++)
+		if(self->weight[i] != 0)
+		{
+			cost += (double)self->weight[i] * cand->metric[i];
+			weighted = 1;
+		}
+	cand->cost = weighted ? cost : iae;
+	if(sig_errno || !isfinite(cand->cost))
+		cand->cost = HUGE_VAL;
+	sig_errno = 0;
+}
+
+
+void sig_tune_eval(const struct sig_tune *self, struct sig_tune_candidate *cand)
+{
+	struct sig_tune_loop loop;
+	struct sig_err_state saved;
+
+	sig_err_save(&saved);
+	sig_tune_loop_init(self, &loop);
+	sig_tune_loop_eval(self, &loop, cand);
+	sig_err_restore(&saved);
+}
+
+
+/**
+ * @brief number of values of a range
+ */
+static int sig_tune_steps(const struct sig_tune_range *range)
+{
+	return ((range->max > range->min) && (range->steps > 1)) ? range->steps : 1;
+}
+
+
+/**
+ * @brief value k of the steps values from lo to hi
+ */
+static float sig_tune_step(float lo, float hi, int k, int steps)
+{
+	return (steps > 1) ? lo + (hi - lo) * k / (steps - 1) : lo;
+}
+
+
+/**
+ * @brief uniform value in [0; 1[, hash of the seed and of a counter
+ */
+static float sig_tune_random(uint32_t seed, uint64_t counter)
+{
+	uint64_t z = ((uint64_t)seed << 32) + counter * 0x9E3779B97F4A7C15ULL;
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;	// splitmix64 finalizer
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	return (float)(z >> 40) / (float)(1 << 24);
+}
+
+
+/**
+ * @brief parameters of candidate i of the batch
+ */
+static void sig_tune_candidate(const struct sig_tune_pool *pool, int64_t i, struct sig_tune_candidate *cand)
+{
+	const struct sig_tune *self = pool->self;
+	const struct sig_tune_range *range;
+	int p, steps;
+
+	memset(cand, 0, sizeof(*cand));
+	for(p=0; p<SIG_TUNE_PARAMS; p++)
+	{
+		range = &self->range[p];
+		switch(self->search)
+		{
+		case SIG_TUNE_GRID:
+			steps = sig_tune_steps(range);
+			cand->param[p] = sig_tune_step(range->min, range->max, (int)(i % steps), steps);
+			i /= steps;
+			break;
+		case SIG_TUNE_RANDOM:
+			if(range->max > range->min)
+				cand->param[p] = range->min + (range->max - range->min) *
+					sig_tune_random(self->seed, (uint64_t)(pool->offset + i) * SIG_TUNE_PARAMS + p);
+			else
+				cand->param[p] = range->min;
+			break;
+		default:
+			cand->param[p] = (p == pool->param) ? sig_tune_step(pool->lo, pool->hi, (int)i, pool->steps) : pool->base[p];
+			break;
+		}
+	}
+}
+
+
+/**
+ * @brief insert a candidate in a rank, if it is better than the worst one
+ */
+static void sig_tune_insert(struct sig_tune_rank *rank, const struct sig_tune_candidate *cand, int64_t index)
+{
+	int i;
+
+	if(rank->size < 1)
+		return;
+	if(rank->count == rank->size)
+	{
+		i = rank->count - 1;
+		if((rank->entry[i].cand.cost < cand->cost) || ((rank->entry[i].cand.cost == cand->cost) && (rank->entry[i].index < index)))
+			return;
+	}
+	else
+		i = rank->count++;
+	for(; (i > 0) && ((rank->entry[i-1].cand.cost > cand->cost) ||
+		((rank->entry[i-1].cand.cost == cand->cost) && (rank->entry[i-1].index > index))); i--)
+		rank->entry[i] = rank->entry[i-1];
+	rank->entry[i].cand = *cand;
+	rank->entry[i].index = index;
+}
+
+
+static void *sig_tune_thread(void *arg)
+{
+	struct sig_tune_pool *pool = (struct sig_tune_pool *)arg;
+	const struct sig_tune *self = pool->self;
+	struct sig_tune_loop loop;
+	struct sig_tune_candidate cand;
+	struct sig_tune_entry best_entry;
+	struct sig_tune_rank rank, best = {&best_entry, 0, 1};
+	int64_t i;
+
+	rank.entry = malloc(pool->rank.size * sizeof(struct sig_tune_entry));
+	rank.count = 0;
+	rank.size = rank.entry ? pool->rank.size : 0;		// without memory, only the batch best is kept
+	sig_tune_loop_init(self, &loop);
+	while((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->total)
+	{
+		sig_tune_candidate(pool, i, &cand);
+		sig_tune_loop_eval(self, &loop, &cand);
+		sig_tune_insert(&rank, &cand, pool->offset + i);
+		sig_tune_insert(&best, &cand, pool->offset + i);
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	for(i=0; i<rank.count; i++)
+		sig_tune_insert(&pool->rank, &rank.entry[i].cand, rank.entry[i].index);
+	if(best.count)
+		sig_tune_insert(&pool->best, &best_entry.cand, best_entry.index);
+	pthread_mutex_unlock(&pool->lock);
+	free(rank.entry);
+	return NULL;
+}
+
+
+/**
+ * @brief evaluate the total candidates of a batch on all the threads
+ */
+static void sig_tune_batch(struct sig_tune_pool *pool, int64_t total)
+{
+	pthread_t thread[SIG_TUNE_MAX_THREADS];
+	int i, started, threads = pool->self->threads;
+
+	if(threads < 1)
+		threads = 1;
+	if(threads > SIG_TUNE_MAX_THREADS)
+		threads = SIG_TUNE_MAX_THREADS;
+	if(threads > total)
+		threads = (int)total;
+	pool->next = 0;
+	pool->total = total;
+	pool->best.count = 0;
+
+	// the calling thread is one of the threads
+	for(started=1; started<threads; started++)
+		if(pthread_create(&thread[started], NULL, sig_tune_thread, pool))
+			break;
+	sig_tune_thread(pool);
+	for(i=1; i<started; i++)
+		pthread_join(thread[i], NULL);
+	pool->offset += total;
+}
+
+
+int64_t sig_tune_run(struct sig_tune *self)
+{
+	struct sig_tune_pool pool = {.self = self};
+	struct sig_tune_entry best_entry;
+	float lo[SIG_TUNE_PARAMS], hi[SIG_TUNE_PARAMS], half;
+	double cost;
+	int64_t total = 1;
+	int i, p, round;
+	struct sig_err_state saved;
+
+	if((self->setpoint == NULL) || (self->length < 2) || (self->result == NULL) || (self->result_size < 1))
+		return -1;
+	for(p=0; p<SIG_TUNE_PARAMS; p++)
+	{
+		total *= sig_tune_steps(&self->range[p]);
+		if(total > INT32_MAX)
+			return -1;
+	}
+	pool.rank.entry = malloc(self->result_size * sizeof(struct sig_tune_entry));
+	if(pool.rank.entry == NULL)
+		return -1;
+	pool.rank.size = self->result_size;
+	pool.best.entry = &best_entry;
+	pool.best.size = 1;
+	pthread_mutex_init(&pool.lock, NULL);
+	sig_err_save(&saved);
+
+	switch(self->search)
+	{
+	case SIG_TUNE_GRID:
+		sig_tune_batch(&pool, total);
+		break;
+	case SIG_TUNE_RANDOM:
+		if(self->count > 0)
+			sig_tune_batch(&pool, self->count);
+		break;
+	default:
+		for(p=0; p<SIG_TUNE_PARAMS; p++)
+		{
+			lo[p] = self->range[p].min;
+			hi[p] = (self->range[p].max > lo[p]) ? self->range[p].max : lo[p];
+			pool.base[p] = (lo[p] + hi[p]) / 2;
+		}
+		// the starting point is ranked too, so the descent never returns worse
+		pool.param = -1;
+		sig_tune_batch(&pool, 1);
+		cost = best_entry.cand.cost;
+		for(round=0; round<self->count; round++)
+			for(p=0; p<SIG_TUNE_PARAMS; p++)
+			{
+				pool.steps = sig_tune_steps(&self->range[p]);
+				if(pool.steps < 2)
+					continue;
+				half = ldexpf((hi[p] - lo[p]) / 2, -round);		// the window halves at each round
+				pool.param = p;
+				pool.lo = (pool.base[p] - half > lo[p]) ? pool.base[p] - half : lo[p];
+				pool.hi = (pool.base[p] + half < hi[p]) ? pool.base[p] + half : hi[p];
+				sig_tune_batch(&pool, pool.steps);
+				if(best_entry.cand.cost < cost)
+				{
+					cost = best_entry.cand.cost;
+					pool.base[p] = best_entry.cand.param[p];
+				}
+			}
+		break;
+	}
+	pthread_mutex_destroy(&pool.lock);
+	sig_err_restore(&saved);
+
+	for(i=0; i<self->result_size; i++)
+	{
+		if(i < pool.rank.count)
+			self->result[i] = pool.rank.entry[i].cand;
+		else
+		{
+			memset(&self->result[i], 0, sizeof(struct sig_tune_candidate));
+			self->result[i].cost = HUGE_VAL;
+		}
+	}
+	free(pool.rank.entry);
+	return pool.offset;
+}
@@ -0,0 +1,144 @@
+/**
+ * SigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of SigLib.
+ * 
+ * SigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * SigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with SigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+
+/** \file sigtune.h
+ * SigLib Header, parallel PID gain search
+ */
+
+#ifndef SIG_TUNE_H__
+#define SIG_TUNE_H__
+
+#include <stdint.h>
+#include "sig.h"
+#include "sigf.h"
+
+/** @addtogroup config
+ * @{
+ */
+
+/** @ingroup tune
+ * @brief Maximum number of threads of a search
+ */
+#if !defined(SIG_TUNE_MAX_THREADS) || defined(__DOXYGEN__)
+	#define SIG_TUNE_MAX_THREADS	64
+#endif
+
+/** @} */
+
+
+/** @ingroup tune
+ * @brief tuned parameters of struct sig_pid_param_f
+ */
+enum sig_tune_param_t {
+	SIG_TUNE_P,											//!< p
+	SIG_TUNE_I,											//!< i
+	SIG_TUNE_D,											//!< d
+	SIG_TUNE_FF0,										//!< ff[0]
+	SIG_TUNE_FF1,										//!< ff[1]
+	SIG_TUNE_FF2,										//!< ff[2]
+	SIG_TUNE_MAX_OUTPUT,								//!< max_output
+	SIG_TUNE_PARAMS,									//!< number of tuned parameters
+};
+
+/** @ingroup tune
+ * @brief search strategy
+ */
+enum sig_tune_search_t {
+	SIG_TUNE_GRID,										//!< every combination of the steps of all the ranges
+	SIG_TUNE_RANDOM,									//!< count candidates drawn uniformly in the ranges
+	SIG_TUNE_DESCENT,									//!< count rounds of coordinate descent, see sig_tune_run()
+};
+
+/** @ingroup tune
+ * @brief metrics used by the cost function, see sig_tune::weight
+ */
+enum sig_tune_metric_t {
+	SIG_TUNE_IAE,										//!< integral of |setpoint - feedback|
+	SIG_TUNE_ISE,										//!< integral of (setpoint - feedback)^2
+	SIG_TUNE_OVERSHOOT,									//!< largest excursion of the feedback past the setpoint, in the direction of the last setpoint change
+	SIG_TUNE_EFFORT,									//!< integral of output^2
+	SIG_TUNE_METRICS,									//!< number of metrics
+};
+
+/** @ingroup tune
+ * @struct sig_tune_range
+ * @brief range of a tuned parameter
+ */
+struct sig_tune_range {
+	float min;											//!< lowest value
+	float max;											//!< highest value. The parameter is fixed to min if max <= min
+	int steps;											//!< number of values from min to max, both included, for the grid and the descent
+};
+
+/** @ingroup tune
+ * @struct sig_tune_candidate
+ * @brief a set of PID parameters, and its evaluation
+ */
+struct sig_tune_candidate {
+	float param[SIG_TUNE_PARAMS];						//!< parameter values, indexed by enum sig_tune_param_t
+	double metric[SIG_TUNE_METRICS];					//!< metrics, indexed by enum sig_tune_metric_t
+	double cost;										//!< weighted sum of the metrics
+};
+
+/** @ingroup tune
+ * @struct sig_tune
+ * @brief a PID gain search
+ * @details Each candidate is a sig_pid_opt_f() PID closing the loop around a first order plant:
+ * feedback[n] = iirlp1(plant_gain * output[n-1]), with the damping factor plant_a. The setpoint and the
+ * Feed-Forward inputs are read from columns shared by all the threads, and never copied.
+ */
+struct sig_tune {
+	const float *setpoint;								//!< setpoint column, length values
+	const float *ff[3];									//!< Feed-Forward columns, NULL to disable the term
+	int length;											//!< number of values of the columns
+	float plant_a;										//!< damping factor of the plant, 0 < plant_a <= 1
+	float plant_gain;									//!< static gain of the plant
+	struct sig_tune_range range[SIG_TUNE_PARAMS];		//!< searched ranges, indexed by enum sig_tune_param_t
+	enum sig_tune_search_t search;						//!< search strategy
+	int count;											//!< candidates of the random search, or rounds of the descent
+	uint32_t seed;										//!< seed of the random search
+	float weight[SIG_TUNE_METRICS];						//!< cost = sum of weight[m] * metric[m]. All 0 means IAE
+	int threads;										//!< number of threads (1 to SIG_TUNE_MAX_THREADS)
+	struct sig_tune_candidate *result;					//!< receives the best candidates, lowest cost first
+	int result_size;									//!< number of candidates result can hold
+};
+
+/** @ingroup tune
+ * @brief evaluate one candidate
+ * @param[in] self the search. Only the columns, the plant and the weights are used
+ * @param[in,out] cand candidate. param is read, metric and cost are written
+ */
+void sig_tune_eval(const struct sig_tune *self, struct sig_tune_candidate *cand);
+
+/** @ingroup tune
+ * @brief run the search, spreading the candidates on threads
+ * @details The coordinate descent starts from the middle of the ranges. Each round searches the steps of each
+ * parameter in turn, the others being fixed to the best values so far, then halves the ranges around the best
+ * values.
+ * @n Candidates with the same cost are ranked by their order in the search, so the results don't depend on the
+ * number of threads.
+ * @param[in,out] self the search
+ * @return the number of evaluated candidates, or -1 if the search is not valid (no columns, no result, too many
+ * grid combinations)
+ */
+int64_t sig_tune_run(struct sig_tune *self);
+
+#endif
@@ -19,102 +19,328 @@
  */
 
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "csv.h"
 
 
- int csv_load(char *path, int *size, float ***data)
- {
-	FILE *fd;
-	char *cell, line[CSV_BUFF_LEN], *ret;
-	int i, ncols = 0, nlines = 0, curr_line = 0;
-	float **output;
-	fd = fopen(path, "r");
-	if(fd == NULL)
+/**
+ * @brief loader state shared by the threads
+ */
+struct csv_loader {
+	const char *text;					//!< mapped file
+	size_t length;						//!< size of the file
+	int ncols;							//!< number of columns
+	float **output;						//!< columns
+	double pow10[23];					//!< exact powers of 10 for the fast float parser
+};
+
+/**
+ * @brief one chunk of the file, made of whole lines
+ */
+struct csv_chunk {
+	struct csv_loader *loader;
+	size_t start;						//!< offset of the first line of the chunk
+	size_t end;							//!< offset after the last line of the chunk
+	int first_line;						//!< data index of the first line of the chunk
+	int lines;							//!< number of lines of the chunk
+	int error;							//!< 0, or the error code of the chunk
+	int error_line;						//!< data index of the faulty line
+	int error_cols;						//!< number of columns of the faulty line
+	pthread_t thread;
+};
+
+
+static inline int csv_is_sep(char c)
+{
+	return (c == ',') || (c == ';') || (c == '\t');
+}
+
+
+/**
+ * @brief parse a float with strtof(). The cell is copied, as the mapped file is not NUL-terminated
+ */
+static float csv_strtof(const char *p, const char *end)
+{
+	char cell[CSV_CELL_LEN];
+	size_t len = end - p;
+
+	if (len >= CSV_CELL_LEN)
+		len = CSV_CELL_LEN - 1;
+	memcpy(cell, p, len);
+	cell[len] = 0;
+	return strtof(cell, NULL);
+}
+
+
+/**
+ * @brief parse the float of the cell [p; end[
+ * @details decimal numbers of up to 19 significant digits with a power of 10 within 1e22 are computed exactly in
+ * double, and rounded once to float. Other numbers (long, tiny, huge, nan, inf...) and the rare doubles halfway
+ * between two floats are handed to strtof(), so the result is always the one of strtof().
+ */
+static float csv_parse_float(const struct csv_loader *self, const char *p, const char *end)
+{
+	const char *start = p;
+	uint64_t m = 0;
+	int digits = 0, seen = 0, inexact = 0, exp = 0, e = 0, neg = 0, eneg = 0;
+	double x;
+	union {double d; uint64_t u;} bits;
+
+	if ((p < end) && ((*p == '-') || (*p == '+')))
+		neg = (*p++ == '-');
+	for (; (p < end) && ((unsigned)(*p - '0') < 10); p++, seen = 1)
+	{
+		if (digits < 19)
+		{
+			m = m * 10 + (*p - '0');
+			digits += (m != 0);
+		}
+		else
+		{
+			inexact |= (*p != '0');
+			exp++;
+		}
+	}
+	if ((p < end) && (*p == '.'))
+	{
+		for (p++; (p < end) && ((unsigned)(*p - '0') < 10); p++, seen = 1)
+		{
+			if (digits < 19)
+			{
+				m = m * 10 + (*p - '0');
+				digits += (m != 0);
+				exp--;
+			}
+			else
+				inexact |= (*p != '0');
+		}
+	}
+	if (seen && (p < end) && ((*p == 'e') || (*p == 'E')))
+	{
+		p++;
+		if ((p < end) && ((*p == '-') || (*p == '+')))
+			eneg = (*p++ == '-');
+		for (; (p < end) && ((unsigned)(*p - '0') < 10) && (e < 10000); p++)
+			e = e * 10 + (*p - '0');
+		exp += eneg ? -e : e;
+	}
+	if ((p != end) || !seen || inexact || (m > (1ull << 53)) || (exp < -22) || (exp > 22))
+		return csv_strtof(start, end);
+	if (m == 0)
+		return neg ? -0.0f : 0.0f;
+
+	x = exp < 0 ? (double)m / self->pow10[-exp] : (double)m * self->pow10[exp];
+	bits.d = x;
+	if ((x < 1.2e-38) || (x > 3.4e38) || ((bits.u & 0x1fffffff) - 0x0fffffff <= 2))
+		return csv_strtof(start, end);					// subnormal, overflow, or double rounding
+	return neg ? -(float)x : (float)x;
+}
+
+
+/**
+ * @brief parse the lines of a chunk, straight into the columns
+ */
+static void *csv_parse_chunk(void *arg)
+{
+	struct csv_chunk *chunk = (struct csv_chunk *)arg;
+	struct csv_loader *self = chunk->loader;
+	const char *p = self->text + chunk->start;
+	const char *end = self->text + chunk->end;
+	const char *eol, *cell;
+	int line, col;
+
+	for (line = chunk->first_line; p < end; line++, p = eol + 1)
+	{
+		eol = memchr(p, '\n', end - p);
+		if (eol == NULL)
+			eol = end;
+		for (col = 0, cell = p; ; col++)
+		{
+			const char *sep = cell;
+			const char *cell_end;
+
+			while ((sep < eol) && !csv_is_sep(*sep))
+				sep++;
+			cell_end = ((sep == eol) && (sep > cell) && (sep[-1] == '\r')) ? sep - 1 : sep;
+			if (col < self->ncols)
+				self->output[col][line] = csv_parse_float(self, cell, cell_end);
+			if (sep == eol)
+				break;
+			cell = sep + 1;
+		}
+		if (col + 1 != self->ncols)
+		{
+			chunk->error = (col + 1 > self->ncols) ? -3 : -4;
+			chunk->error_line = line;
+			chunk->error_cols = col + 1;
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief count the lines of a chunk
+ */
+static void *csv_count_chunk(void *arg)
+{
+	struct csv_chunk *chunk = (struct csv_chunk *)arg;
+	const char *p = chunk->loader->text + chunk->start;
+	const char *end = chunk->loader->text + chunk->end;
+	int lines = 0;
+
+	while ((p < end) && (p = memchr(p, '\n', end - p)))
+	{
+		lines++;
+		p++;
+	}
+	if ((chunk->end > chunk->start) && (chunk->loader->text[chunk->end - 1] != '\n'))
+		lines++;										// last line of the file, without end of line
+	chunk->lines = lines;
+	return NULL;
+}
+
+
+/**
+ * @brief run fn on all the chunks: chunks 1 to count - 1 in their own thread, chunk 0 in the calling thread
+ */
+static void csv_run_chunks(struct csv_chunk *chunk, int count, void *(*fn)(void *))
+{
+	int i, started;
+
+	for (started = 1; started < count; started++)
+		if (pthread_create(&chunk[started].thread, NULL, fn, &chunk[started]))
+			break;
+	for (i = started; i < count; i++)					// no more threads: run the remaining chunks here
+		fn(&chunk[i]);
+	fn(&chunk[0]);
+	for (i = 1; i < started; i++)
+		pthread_join(chunk[i].thread, NULL);
+}
+
+
+int csv_load(char *path, int *size, float ***data)
+{
+	return csv_load_threads(path, size, data, CSV_THREADS ? CSV_THREADS : sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+
+int csv_load_threads(char *path, int *size, float ***data, int threads)
+{
+	struct csv_loader self;
+	struct csv_chunk *chunk = NULL;
+	struct stat st;
+	const char *p, *eol, *body;
+	size_t column_size, offset;
+	float **output = NULL;
+	int fd, i, nlines, ret = 0;
+
+	*data = NULL;
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
 	{
 		printf("can't open file %s\n", path);
 		return -1;
 	}
-	rewind(fd);
-	
-	// get first line to get the header
-	ret = fgets(line, CSV_BUFF_LEN, fd);
-	if(ferror(fd))
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0))
 	{
 		printf("can't read file\n");
+		close(fd);
 		return -2;
 	}
-	cell = strtok(line, ",;\t");
-	while (cell)
+	memset(&self, 0, sizeof(self));
+	self.length = st.st_size;
+	self.text = mmap(NULL, self.length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (self.text == MAP_FAILED)
 	{
-		++ncols;
-		cell = strtok(NULL,",;\t");
+		printf("can't read file\n");
+		return -2;
 	}
-	
-	// create a table containing pointers to the data tables
-	output = calloc(ncols + 1, sizeof(float *));
-	*data = output;
-	
-	// count the lines in our file
-	do
+	madvise((void *)self.text, self.length, MADV_SEQUENTIAL);		// advices are values, not flags: one call each
+	madvise((void *)self.text, self.length, MADV_WILLNEED);
+	self.pow10[0] = 1;
+	for (i=1; i<23; i++)
+		self.pow10[i] = self.pow10[i-1] * 10;
+
+	// the header gives the number of columns
+	eol = memchr(self.text, '\n', self.length);
+	body = eol ? eol + 1 : self.text + self.length;
+	for (p = self.text, self.ncols = 1; p < body; p++)
+		self.ncols += csv_is_sep(*p);
+
+	// split the data in chunks of whole lines, one per thread
+	if (threads > (self.text + self.length - body) / CSV_CHUNK_MIN)
+		threads = (self.text + self.length - body) / CSV_CHUNK_MIN;
+	if (threads < 1)
+		threads = 1;
+	chunk = calloc(threads, sizeof(struct csv_chunk));
+	if (chunk == NULL)
 	{
-		++nlines;
-		ret = fgets(line, CSV_BUFF_LEN, fd);
-	} while (ret);
-	
-	// get memory for that
-	for(i=0; i<ncols; i++)
+		printf("cannot allocate memory for %d threads\n", threads);
+		ret = -3;
+		goto out;
+	}
+	for (i=0; i<threads; i++)
 	{
-		output[i] = malloc(nlines * sizeof(float));
-		if(output[i] == NULL)
+		chunk[i].loader = &self;
+		chunk[i].start = (i == 0) ? (size_t)(body - self.text) : chunk[i-1].end;
+		offset = (body - self.text) + (self.length - (body - self.text)) * (i + 1) / threads;
+		if (offset > chunk[i].start)					// extend the chunk to the end of its last line
 		{
-			printf("cannot allocate memory for the data of colum %d (%d lines)\n", i, nlines);
-			return -3;
+			eol = memchr(self.text + offset - 1, '\n', self.length - offset + 1);
+			offset = eol ? (size_t)(eol - self.text) + 1 : self.length;
 		}
+		chunk[i].end = (offset > chunk[i].start) ? offset : chunk[i].start;
 	}
-	
-	// got to the start of the file, and ignore first line
-	rewind(fd);
-	ret = fgets(line, CSV_BUFF_LEN, fd);
-	
-	// read the first line of data
-	ret = fgets(line, CSV_BUFF_LEN, fd);
-	while (feof(fd) == 0)
+	csv_run_chunks(chunk, threads, csv_count_chunk);
+	for (i=0, nlines=0; i<threads; i++)
 	{
-		if(ferror(fd))
-		{
-			printf("can't read file at line %d (data index %d)\n", curr_line+1, curr_line);
-			return -2;
-		}
-		
-		i = 0;
-		cell = strtok(line, ",;\t");
-		while(cell)
-		{
-			if(i >= ncols)
-			{	
-				printf("line %d has %d columns, expecting %d\n", curr_line+1, i, ncols);
-				return -3;
-			}
-			output[i][curr_line] = strtof(cell, NULL);
-			cell = strtok(NULL, ",;\t");
-			i++;
-		}
-		if(i < ncols)
+		chunk[i].first_line = nlines;
+		nlines += chunk[i].lines;
+	}
+
+	// one allocation: the NULL-terminated array of columns, then each column on its own cache lines
+	column_size = ((size_t)nlines * sizeof(float) + 63) / 64 * 64;
+	offset = ((self.ncols + 1) * sizeof(float *) + 63) / 64 * 64;
+	output = aligned_alloc(64, offset + self.ncols * column_size);
+	if (output == NULL)
+	{
+		printf("cannot allocate memory for the data (%d columns, %d lines)\n", self.ncols, nlines);
+		ret = -3;
+		goto out;
+	}
+	for (i=0; i<self.ncols; i++)
+		output[i] = (float *)((char *)output + offset + i * column_size);
+	output[self.ncols] = NULL;
+	self.output = output;
+
+	csv_run_chunks(chunk, threads, csv_parse_chunk);
+	for (i=0; i<threads; i++)
+		if (chunk[i].error)
 		{
-			
-			printf("line %d has %d columns, expecting %d\n", curr_line+1, i, ncols);
-			return -4;
+			printf("line %d has %d columns, expecting %d\n", chunk[i].error_line + 1, chunk[i].error_cols, self.ncols);
+			ret = chunk[i].error;
+			free(output);
+			goto out;
 		}
-		
-		curr_line++;
-		// get a line of values
-		ret = fgets(line, CSV_BUFF_LEN, fd);
-	}
-	*size = nlines-1;
-	return 0;
+	*data = output;
+	*size = nlines;
+
+out:
+	free(chunk);
+	munmap((void *)self.text, self.length);
+	return ret;
 }
 
 
@@ -145,13 +371,5 @@ int csv_display(float **csv, int csv_l)
 
 void csv_free(float **csv)
 {
-	int i=0;
-	
-	if(csv == NULL)
-		return;
-	
-	while(csv[i])
-		free(csv[i++]);
-	
 	free(csv);
 }
@@ -22,21 +22,36 @@
 #define CSV_H_
 
 
-#define CSV_BUFF_LEN	1024	//!< Lenght of the buffer used to read a single line from CSV file
 #define FILE_PATH_LEN	1024	//!< max file path lenght
+#define CSV_CELL_LEN	64		//!< max length of a cell handed to strtof() (cells the fast parser can't handle exactly)
+#define CSV_THREADS		0		//!< number of loader threads. 0 for one per CPU
+#define CSV_CHUNK_MIN	(1 << 20)	//!< minimum bytes of data per loader thread
 
 
 /**
  * @brief loads a CSV file, and reads its data into a table
+ * @details The file is mapped in memory and split into chunks of whole lines, one per thread (see CSV_THREADS).
+ * Each thread counts the lines of its chunk, then parses them straight into the columns. The first line is the
+ * header: it gives the number of columns. Cells are separated by ',', ';' or tab, lines end with LF or CRLF, and
+ * the values are the ones strtof() would return.
  * @param[in] path path to the file
+ * @param[out] size number of lines of data
  * @param[in] data pointer to a float[][]. The application using this function must provide
  * a pointer to a float[][] element. After the operation completed, the variable pointer by this
- * variable contains the address of an array of pointers to array of floats.
- * @return 0 if no error
+ * variable contains the address of a NULL-terminated array of pointers to array of floats.
+ * The array and all the columns are a single allocation, released by csv_free(). NULL on error.
+ * @return 0 if no error, -1 if the file can't be opened, -2 if it can't be read or is empty, -3 on allocation
+ * failure or if a line has too many columns, -4 if a line has too few columns
  */
 int csv_load(char *path, int *size, float ***data);
 
 
+/**
+ * @brief same as csv_load(), with at most threads threads (each thread handles at least CSV_CHUNK_MIN bytes)
+ */
+int csv_load_threads(char *path, int *size, float ***data, int threads);
+
+
 /**
  * @brief displays the data read from a CSV file
  * @param[in] csv pointer to a float[][]
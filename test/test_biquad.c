@@ -0,0 +1,270 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+
+#define TEST_BIQUAD_LEN			3000
+#define TEST_BIQUAD_MAX			11
+#define TEST_BIQUAD_PI			3.14159265358979323846L
+
+static const int test_biquad_sections[] = {1, 3, 8, 11};
+static const int test_biquad_blocks[] = {1, 7, 100, 1500, 1392};
+
+/**
+ * @brief gain of a cascade at the frequency f (fraction of the sampling rate)
+ */
+static double test_biquad_gain(const float *coef, int sections, double f)
+{
+	double w = 2 * (double)TEST_BIQUAD_PI * f, gain = 1, nr, ni, dr, di;
+	int k;
+
+	for (k=0; k<sections; k++, coef+=5)
+	{
+		nr = coef[0] + coef[1] * cos(w) + coef[2] * cos(2 * w);
+		ni = -coef[1] * sin(w) - coef[2] * sin(2 * w);
+		dr = 1 + coef[3] * cos(w) + coef[4] * cos(2 * w);
+		di = -coef[3] * sin(w) - coef[4] * sin(2 * w);
+		gain *= sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+	}
+	return gain;
+}
+
+static int test_biquad_expect(const char *name, const float *coef, int sections, double f, double expected)
+{
+	double gain = test_biquad_gain(coef, sections, f);
+
+	if (fabs(gain - expected) > 1e-3)
+	{
+		printf("biquad: %s gain at %g is %g, expected %g\n", name, f, gain, expected);
+		return -1;
+	}
+	return 0;
+}
+
+static int test_biquad_designs(void)
+{
+	float coef[TEST_BIQUAD_MAX * 5];
+	int ret = 0;
+
+	if (sig_biquad_butterworth_f(coef, 4, 0.1, 0) != 2)
+		return -1;
+	ret |= test_biquad_expect("butterworth", coef, 2, 0, 1);
+	ret |= test_biquad_expect("butterworth", coef, 2, 0.1, sqrt(0.5));
+	ret |= test_biquad_expect("butterworth", coef, 2, 0.4, 0.000171);
+
+	if (sig_biquad_butterworth_f(coef, 3, 0.2, 1) != 2)
+		return -1;
+	ret |= test_biquad_expect("butterworth hp", coef, 2, 0.5, 1);
+	ret |= test_biquad_expect("butterworth hp", coef, 2, 0.2, sqrt(0.5));
+
+	if (sig_biquad_chebyshev_f(coef, 5, 0.05, 1.0, 0) != 3)
+		return -1;
+	ret |= test_biquad_expect("chebyshev", coef, 3, 0, 1);
+	ret |= test_biquad_expect("chebyshev", coef, 3, 0.05, pow(10, -1.0 / 20));
+
+	if (sig_biquad_chebyshev_f(coef, 4, 0.05, 0.5, 0) != 2)
+		return -1;
+	ret |= test_biquad_expect("chebyshev", coef, 2, 0, pow(10, -0.5 / 20));
+	ret |= test_biquad_expect("chebyshev", coef, 2, 0.05, pow(10, -0.5 / 20));
+
+	sig_biquad_design_f(coef, SIG_BIQUAD_NOTCH, 0.125, 2, 0);
+	ret |= test_biquad_expect("notch", coef, 1, 0.125, 0);
+	ret |= test_biquad_expect("notch", coef, 1, 0, 1);
+	sig_biquad_design_f(coef, SIG_BIQUAD_BANDPASS, 0.125, 2, 0);
+	ret |= test_biquad_expect("bandpass", coef, 1, 0.125, 1);
+	sig_biquad_design_f(coef, SIG_BIQUAD_PEAK, 0.125, 1, 6);
+	ret |= test_biquad_expect("peak", coef, 1, 0.125, pow(10, 6.0 / 20));
+	ret |= test_biquad_expect("peak", coef, 1, 0, 1);
+	sig_biquad_design_f(coef, SIG_BIQUAD_LOWSHELF, 0.05, 1, -6);
+	ret |= test_biquad_expect("lowshelf", coef, 1, 0, pow(10, -6.0 / 20));
+	ret |= test_biquad_expect("lowshelf", coef, 1, 0.5, 1);
+	sig_biquad_design_f(coef, SIG_BIQUAD_HIGHSHELF, 0.05, 1, 6);
+	ret |= test_biquad_expect("highshelf", coef, 1, 0.5, pow(10, 6.0 / 20));
+
+	if ((sig_biquad_design_f(coef, SIG_BIQUAD_LOWPASS, 0.5, 1, 0) != -1) ||
+		(sig_biquad_butterworth_f(coef, 0, 0.1, 0) != -1) || (sig_biquad_chebyshev_f(coef, 2, 0.1, 0, 0) != -1))
+		ret = -1;
+	return ret;
+}
+
+
+/**
+ * @brief cascade of sections cycling through several designs
+ */
+static void test_biquad_cascade(float *coef, int sections)
+{
+	int k;
+
+	for (k=0; k<sections; k++)
+		switch (k % 4)
+		{
+			case 0: sig_biquad_design_f(coef + 5*k, SIG_BIQUAD_LOWPASS, 0.2, 0.9, 0); break;
+			case 1: sig_biquad_design_f(coef + 5*k, SIG_BIQUAD_NOTCH, 0.05, 2, 0); break;
+			case 2: sig_biquad_design_f(coef + 5*k, SIG_BIQUAD_PEAK, 0.1, 1, 3); break;
+			default: sig_biquad_design_f(coef + 5*k, SIG_BIQUAD_HIGHPASS, 0.01, 0.7, 0); break;
+		}
+}
+
+
+/**
+ * @brief per-sample, block and compiled evaluations side by side, the first one against a double-precision reference
+ */
+static int test_biquad_sections_count(const float *input, int sections)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = (float*)input, .size = TEST_BIQUAD_LEN, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_biquad_cascade_param_f sample_p = {.source = &src}, block_p = {.source = &src}, graph_p = {.source = &src};
+	struct signal_float sample = SIG_FN(sig_biquad_cascade_f, &sample_p);
+	struct signal_float block = SIG_FNB(sig_biquad_cascade_f, sig_biquad_cascade_block_f, &block_p);
+	struct signal_float compiled = SIG_FN(sig_biquad_cascade_f, &graph_p);
+	struct signal_float *roots[1] = {&compiled};
+	struct sig_graph_node nodes[4];
+	struct sig_graph graph;
+	float coef[TEST_BIQUAD_MAX * 5], *out;
+	double s[TEST_BIQUAD_MAX][2], x, y;
+	int k, b, ret = 0;
+	n_t n;
+
+	test_biquad_cascade(coef, sections);
+	if (sig_biquad_cascade_init_f(&sample_p, coef, sections) || sig_biquad_cascade_init_f(&block_p, coef, sections) ||
+		sig_biquad_cascade_init_f(&graph_p, coef, sections))
+		return -1;
+	sig_graph_init(&graph, nodes, 4);
+	if (sig_graph_compile(&graph, roots, 1, NULL, 0))
+		return -1;
+	out = malloc(TEST_BIQUAD_LEN * sizeof(float));
+	memset(s, 0, sizeof(s));
+
+	// block path, in irregular blocks
+	for (n=1, b=0; n<TEST_BIQUAD_LEN; n+=k, b++)
+	{
+		k = min(test_biquad_blocks[b % 5], TEST_BIQUAD_LEN - (int)n);
+		sig_get_block_f(&block, n, k, out + n);
+	}
+
+	for (n=1; n<TEST_BIQUAD_LEN; n++)
+	{
+		x = input[n];
+		for (k=0; k<sections; k++)
+		{
+			y = coef[5*k] * x + s[k][0];
+			s[k][0] = coef[5*k + 1] * x - coef[5*k + 3] * y + s[k][1];
+			s[k][1] = coef[5*k + 2] * x - coef[5*k + 4] * y;
+			x = y;
+		}
+		sig_graph_run(&graph, n);
+		y = sig_get_value_f(&sample, n);
+		if ((fabs(y - x) > 1e-4 * (1 + fabs(x))) || (out[n] != y) || (compiled.x_cst != y))
+		{
+			printf("biquad: %d sections, n=%u: sample %g, block %g, compiled %g, expected %g\n", sections, n, y,
+				out[n], compiled.x_cst, x);
+			ret = -1;
+			break;
+		}
+	}
+	if ((ret == 0) && memcmp(sample_p.state, block_p.state, 2 * sample_p.length * sizeof(float)))
+	{
+		printf("biquad: %d sections: block states differ\n", sections);
+		ret = -1;
+	}
+
+	free(out);
+	sig_biquad_cascade_free_f(&sample_p);
+	sig_biquad_cascade_free_f(&block_p);
+	sig_biquad_cascade_free_f(&graph_p);
+	return ret;
+}
+
+
+/**
+ * @brief impulse response of a slow filter: the states decay to 0 without going through denormal values
+ */
+static int test_biquad_denormal(void)
+{
+	struct signal_float src = SIG_CST(1.0);
+	struct sig_biquad_cascade_param_f p = {.source = &src};
+	struct signal_float bq = SIG_FNB(sig_biquad_cascade_f, sig_biquad_cascade_block_f, &p);
+	float coef[10], out[1000];
+	int i, k, ret = 0;
+	n_t n;
+
+	sig_biquad_butterworth_f(coef, 4, 0.01, 0);
+	if (sig_biquad_cascade_init_f(&p, coef, 2))
+		return -1;
+	sig_get_value_f(&bq, 1);
+	src.x_cst = 0;
+	for (n=2; n<100000; n+=1000)
+	{
+		sig_get_block_f(&bq, n, 1000, out);
+		for (k=0; k<2*p.length; k++)
+			if ((p.state[k] != 0) && (fabsf(p.state[k]) < FLT_MIN))
+				ret = -1;
+		for (i=0; i<1000; i++)
+			if ((out[i] != 0) && (fabsf(out[i]) < FLT_MIN))
+				ret = -1;
+	}
+	for (k=0; k<2*p.length; k++)
+		if (p.state[k] != 0)
+			ret = -1;
+	if (ret)
+		printf("biquad: denormal states\n");
+	sig_biquad_cascade_free_f(&p);
+	return ret;
+}
+
+
+int test_biquad(void)
+{
+	float input[TEST_BIQUAD_LEN];
+	unsigned int seed = 7;
+	enum sig_fir_kernel_t kernel;
+	int i, ret = 0;
+
+	for (i=0; i<TEST_BIQUAD_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		input[i] = (float)(seed >> 8) / (1 << 24) * 2.0 - 1.0;
+	}
+
+	if (test_biquad_designs())
+		ret = -1;
+	for (kernel = SIG_FIR_KERNEL_C; kernel <= SIG_FIR_KERNEL_AVX512; kernel++)
+	{
+		if (sig_biquad_kernel_f(kernel))
+			continue;						// not supported by this CPU
+		for (i=0; i<sizeof(test_biquad_sections)/sizeof(test_biquad_sections[0]); i++)
+			if (test_biquad_sections_count(input, test_biquad_sections[i]))
+			{
+				printf("biquad: kernel %d failed\n", kernel);
+				ret = -1;
+			}
+		if (test_biquad_denormal())
+			ret = -1;
+	}
+	sig_biquad_kernel_f(SIG_FIR_KERNEL_AUTO);
+	return ret;
+}
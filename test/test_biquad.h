@@ -0,0 +1,34 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_BIQUAD_H_
+#define TEST_BIQUAD_H_
+
+
+/**
+ * @brief test the biquad designs against their frequency response, and the per-sample, block and compiled
+ * evaluations of a biquad cascade against each other and against a double-precision reference
+ * @details the block path is tested with all the kernels supported by the CPU
+ * @return 0 on success
+ */
+int test_biquad(void);
+
+
+#endif	// TEST_BIQUAD_H_
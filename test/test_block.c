@@ -0,0 +1,143 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "sig.h"
+#include "sigf.h"
+
+#define TEST_BLOCK_TAPS		8
+#define TEST_BLOCK_LEN		150		// above SIG_BLOCK_CHUNK and not a multiple of it, to cross the chunk boundaries
+#define TEST_BLOCK_SAMPLES	500		// several blocks: the buffer readers stick at the last value of the data
+
+/**
+ * two independent graphs:
+ * - pid_opt(setpoint, feedback, ff0, ff1, ff2)
+ * - pid_naive(iirlp1(setpoint) + fir(feedback), step)
+ */
+struct test_block_graph {
+	struct sig_buf_read_param_f buf_p[7];
+	struct signal_float buf[7];
+	struct sig_iirlp1_param_f iir_p;
+	struct signal_float iir;
+	float fir_taps[TEST_BLOCK_TAPS];
+	float fir_samples[TEST_BLOCK_TAPS];
+	struct sig_fir_n_param_f fir_p;
+	struct signal_float fir;
+	struct sig_add_param_f add_p;
+	struct signal_float add;
+	struct sig_step_param_f step_p;
+	struct signal_float step;
+	struct sig_pid_param_f pid_opt_p;
+	struct signal_float pid_opt;
+	struct sig_pid_param_f pid_naive_p;
+	struct signal_float pid_naive;
+};
+
+static void test_block_graph_init(struct test_block_graph *g, float **data, int data_l)
+{
+	int i;
+
+	memset(g, 0, sizeof(*g));
+	for(i=0; i<7; i++)
+	{
+		g->buf_p[i].buffer = data[i < 5 ? i : i - 5];
+		g->buf_p[i].size = data_l;
+		g->buf_p[i].check_buffer = 1;
+		g->buf[i] = (struct signal_float) SIG_FNB(sig_buf_read_f, sig_buf_read_block_f, &g->buf_p[i]);
+	}
+
+	g->iir_p = (struct sig_iirlp1_param_f) {.a = 0.3, .oma = 0.7, .source = &g->buf[5]};
+	g->iir = (struct signal_float) SIG_FNB(sig_iirlp1_f, sig_iirlp1_block_f, &g->iir_p);
+
+	for(i=0; i<TEST_BLOCK_TAPS; i++)
+		g->fir_taps[i] = 1.0 / (i + 2);
+	g->fir_p = (struct sig_fir_n_param_f) {.tap_count = TEST_BLOCK_TAPS, .taps = g->fir_taps, .samples = g->fir_samples, .source = &g->buf[6]};
+	g->fir = (struct signal_float) SIG_FNB(sig_fir_n_f, sig_fir_n_block_f, &g->fir_p);
+
+	g->add_p = (struct sig_add_param_f) {.a = &g->iir, .b = &g->fir};
+	g->add = (struct signal_float) SIG_FNB(sig_add_f, sig_add_block_f, &g->add_p);
+
+	g->step_p = (struct sig_step_param_f) {.n_min = 20, .n_max = 50, .x_active = 0.5, .x_inact = -0.25};
+	g->step = (struct signal_float) SIG_FNB(sig_step_f, sig_step_block_f, &g->step_p);
+
+	g->pid_opt_p = (struct sig_pid_param_f) {
+		.p = 1.0, .i = 0.1, .d = 1.0, .max_output = 5.0,
+		.setpoint = &g->buf[0], .feedback = &g->buf[1],
+		.ff = {1.0, 2.0, 3.0}, .ff0 = &g->buf[2], .ff1 = &g->buf[3], .ff2 = &g->buf[4]
+	};
+	g->pid_opt = (struct signal_float) SIG_FNB(sig_pid_opt_f, sig_pid_opt_block_f, &g->pid_opt_p);
+	sig_pid_compute_k_f(&g->pid_opt);
+
+	g->pid_naive_p = (struct sig_pid_param_f) {
+		.p = 0.8, .i = 0.2, .d = 0.5, .max_output = 2.0,
+		.setpoint = &g->add, .feedback = &g->step
+	};
+	g->pid_naive = (struct signal_float) SIG_FNB(sig_pid_naive_f, sig_pid_naive_block_f, &g->pid_naive_p);
+}
+
+int test_block(float **data, int data_l, float* output)
+{
+	struct test_block_graph *sample, *block;
+	float *out[4];
+	n_t n;
+	int i, len, ret = 0, count = max(data_l, TEST_BLOCK_SAMPLES);
+
+	sample = malloc(sizeof(*sample));
+	block = malloc(sizeof(*block));
+	for(i=0; i<4; i++)
+		out[i] = malloc(sizeof(float) * count);
+	test_block_graph_init(sample, data, data_l);
+	test_block_graph_init(block, data, data_l);
+
+	// reference: per-sample evaluation
+	for(n=0; n<count; n++)
+	{
+		out[0][n] = sig_get_value_f(&sample->pid_opt, n);
+		out[1][n] = sig_get_value_f(&sample->pid_naive, n);
+	}
+
+	// block evaluation
+	for(n=0; n<count; n+=len)
+	{
+		len = min(TEST_BLOCK_LEN, count - (int)n);
+		sig_get_block_f(&block->pid_opt, n, len, &out[2][n]);
+		sig_get_block_f(&block->pid_naive, n, len, &out[3][n]);
+	}
+
+	if(memcmp(out[0], out[2], sizeof(float) * count))
+	{
+		printf("sig_pid_opt_block_f output differs from sig_pid_opt_f\n");
+		ret = -1;
+	}
+	if(memcmp(out[1], out[3], sizeof(float) * count))
+	{
+		printf("sig_pid_naive_block_f output differs from sig_pid_naive_f\n");
+		ret = -1;
+	}
+	memcpy(output, out[2], sizeof(float) * data_l);
+
+	for(i=0; i<4; i++)
+		free(out[i]);
+	free(block);
+	free(sample);
+	return ret;
+}
@@ -0,0 +1,130 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "csv.h"
+
+#define TEST_CSV_COLS		4
+#define TEST_CSV_LINES		200000							// about 5 MB: several chunks of CSV_CHUNK_MIN
+#define TEST_CSV_THREADS	4
+
+/**
+ * @brief print a random value in one of several formats, and return what strtof() reads from it
+ */
+static float test_csv_cell(FILE *f, unsigned int r)
+{
+	static const char *special[] = {"0", "-0", "1e-40", "3.5e38", "nan", "-inf", "0.1234567890123456789012",
+		"123456789012345678901234", "16777217", "1.00000005960464477539", "+.5", "7."};
+	char cell[64];
+	float x = (float)rand() / RAND_MAX * 2000 - 1000;
+
+	switch (r % 8)
+	{
+		case 0: sprintf(cell, "%.9g", x); break;
+		case 1: sprintf(cell, "%e", x / 1e6); break;
+		case 2: sprintf(cell, "%.3f", x); break;
+		case 3: sprintf(cell, "%d", (int)x); break;
+		case 4: sprintf(cell, "%.17g", (double)x * 1e-20); break;
+		case 5: sprintf(cell, "%s", special[(r / 8) % (sizeof(special) / sizeof(special[0]))]); break;
+		default: sprintf(cell, "%.6g", x); break;
+	}
+	fputs(cell, f);
+	return strtof(cell, NULL);
+}
+
+/**
+ * @brief write text to a temporary file, load it, and return the result of csv_load()
+ */
+static int test_csv_text(const char *text, int *size, float ***data)
+{
+	char path[] = "/tmp/test_csv_XXXXXX";
+	int fd = mkstemp(path), ret;
+
+	if (write(fd, text, strlen(text)) != (ssize_t)strlen(text))
+		return -100;
+	close(fd);
+	ret = csv_load(path, size, data);
+	unlink(path);
+	return ret;
+}
+
+int test_csv(void)
+{
+	char path[] = "/tmp/test_csv_XXXXXX";
+	const char sep[TEST_CSV_COLS] = {',', ';', '\t', '\n'};
+	float *expected, **data;
+	int i, j, fd, size, ret = 0;
+	FILE *f;
+
+	expected = malloc(TEST_CSV_LINES * TEST_CSV_COLS * sizeof(float));
+	fd = mkstemp(path);
+	f = fdopen(fd, "w");
+	fprintf(f, "a,b;c\td\r\n");
+	srand(7);
+	for (i=0; i<TEST_CSV_LINES; i++)
+		for (j=0; j<TEST_CSV_COLS; j++)
+		{
+			expected[i * TEST_CSV_COLS + j] = test_csv_cell(f, rand());
+			if ((j == TEST_CSV_COLS - 1) && (i % 3 == 0))
+				fputc('\r', f);
+			if ((i < TEST_CSV_LINES - 1) || (j < TEST_CSV_COLS - 1))	// no end of line after the last line
+				fputc(sep[j], f);
+		}
+	fclose(f);
+
+	if (csv_load_threads(path, &size, &data, TEST_CSV_THREADS) || (size != TEST_CSV_LINES) || (data[TEST_CSV_COLS] != NULL))
+	{
+		printf("csv: load failed (%d lines)\n", size);
+		ret = -1;
+	}
+	for (i=0; (i<TEST_CSV_LINES) && (ret == 0); i++)
+		for (j=0; j<TEST_CSV_COLS; j++)
+			if (memcmp(&data[j][i], &expected[i * TEST_CSV_COLS + j], sizeof(float)))
+			{
+				printf("csv: line %d column %d: %g instead of %g\n", i, j, data[j][i], expected[i * TEST_CSV_COLS + j]);
+				ret = -1;
+				break;
+			}
+	if (ret == 0)
+		csv_free(data);
+	unlink(path);
+	free(expected);
+
+	// malformed files
+	if ((test_csv_text("a,b\n1,2\n3,4,5\n", &size, &data) != -3) || data
+			|| (test_csv_text("a,b\n1,2\n3\n", &size, &data) != -4) || data
+			|| (test_csv_text("", &size, &data) != -2)
+			|| (csv_load("/nonexistent/test.csv", &size, &data) != -1))
+	{
+		printf("csv: malformed file not detected\n");
+		ret = -1;
+	}
+	if (test_csv_text("a,b\n", &size, &data) || (size != 0))
+	{
+		printf("csv: header only file not loaded\n");
+		ret = -1;
+	}
+	else
+		csv_free(data);
+	return ret;
+}
@@ -0,0 +1,144 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "sigexec.h"
+
+#define TEST_EXEC_LOOPS		12
+#define TEST_EXEC_WORKERS	3
+
+/**
+ * one control loop: pid_opt(iirlp1(setpoint), feedback, ff0, ff1, ff2)
+ */
+struct test_exec_loop {
+	struct sig_buf_read_param_f buf_p[5];
+	struct signal_float buf[5];
+	struct sig_iirlp1_param_f iir_p;
+	struct signal_float iir;
+	struct sig_pid_param_f pid_p;
+	struct signal_float pid;
+};
+
+static void test_exec_loop_init(struct test_exec_loop *l, int id, float **data, int data_l)
+{
+	int i;
+
+	memset(l, 0, sizeof(*l));
+	for(i=0; i<5; i++)
+	{
+		l->buf_p[i].buffer = data[i];
+		l->buf_p[i].size = data_l;
+		l->buf_p[i].delta = id;
+		l->buf_p[i].circular = 1;
+		l->buf_p[i].check_buffer = 1;
+		l->buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &l->buf_p[i]);
+	}
+	l->iir_p = (struct sig_iirlp1_param_f) {.a = 0.1 * (id + 1), .oma = 1.0 - 0.1 * (id + 1), .source = &l->buf[0]};
+	l->iir = (struct signal_float) SIG_FN(sig_iirlp1_f, &l->iir_p);
+	l->pid_p = (struct sig_pid_param_f) {
+		.p = 1.0, .i = 0.05 * id, .d = 0.5, .max_output = 5.0,
+		.setpoint = &l->iir, .feedback = &l->buf[1],
+		.ff = {1.0, 2.0, 3.0}, .ff0 = &l->buf[2], .ff1 = &l->buf[3], .ff2 = &l->buf[4]
+	};
+	l->pid = (struct signal_float) SIG_FN(sig_pid_opt_f, &l->pid_p);
+	sig_pid_compute_k_f(&l->pid);
+}
+
+/** undescribed sig-func: its source is not known by the graph compiler */
+static float test_exec_opaque_f(struct signal_float *self, n_t n)
+{
+	return sig_value((struct signal_float *)self->params, n);
+}
+
+int test_exec(float **data, int data_l, float* output)
+{
+	struct test_exec_loop *serial, *parallel;
+	struct signal_float *roots_serial[TEST_EXEC_LOOPS], *roots_parallel[TEST_EXEC_LOOPS];
+	struct sig_graph_node nodes_serial[TEST_EXEC_LOOPS * 7], nodes_parallel[TEST_EXEC_LOOPS * 7];
+	struct sig_graph graph_serial, graph_parallel;
+	static struct sig_exec exec;
+	int i, ret = 0;
+	n_t n;
+
+	serial = malloc(sizeof(*serial) * TEST_EXEC_LOOPS);
+	parallel = malloc(sizeof(*parallel) * TEST_EXEC_LOOPS);
+	for(i=0; i<TEST_EXEC_LOOPS; i++)
+	{
+		test_exec_loop_init(&serial[i], i, data, data_l);
+		test_exec_loop_init(&parallel[i], i, data, data_l);
+		roots_serial[i] = &serial[i].pid;
+		roots_parallel[i] = &parallel[i].pid;
+	}
+
+	sig_graph_init(&graph_serial, nodes_serial, TEST_EXEC_LOOPS * 7);
+	sig_graph_init(&graph_parallel, nodes_parallel, TEST_EXEC_LOOPS * 7);
+	if(sig_graph_compile(&graph_serial, roots_serial, TEST_EXEC_LOOPS, NULL, 0)
+		|| sig_graph_compile(&graph_parallel, roots_parallel, TEST_EXEC_LOOPS, NULL, 0)
+		|| sig_exec_init(&exec, &graph_parallel, TEST_EXEC_WORKERS, NULL))
+	{
+		printf("exec: setup failed\n");
+		free(serial);
+		free(parallel);
+		return -1;
+	}
+	if(exec.components != TEST_EXEC_LOOPS)
+	{
+		printf("exec: %d components found, expecting %d\n", exec.components, TEST_EXEC_LOOPS);
+		ret = -1;
+	}
+
+	for(n=1; (n<data_l) && (ret == 0); n++)
+	{
+		sig_graph_run(&graph_serial, n);
+		sig_exec_run(&exec, n);
+		output[n] = parallel[0].pid.x_cst;
+		for(i=0; i<TEST_EXEC_LOOPS; i++)
+			if(memcmp(&serial[i].pid.x_cst, &parallel[i].pid.x_cst, sizeof(float)))
+			{
+				printf("exec: n=%u, loop %d: %f, expecting %f\n", n, i, parallel[i].pid.x_cst, serial[i].pid.x_cst);
+				ret = -1;
+			}
+	}
+
+	sig_exec_free(&exec);
+
+	// an undescribed sig-func reading the IIR of loop 1 from loop 0: the graph can't be split
+	{
+		struct signal_float opaque = SIG_FN(test_exec_opaque_f, &parallel[1].iir);
+		struct signal_float *roots[3] = {&parallel[0].pid, &parallel[1].pid, &opaque};
+		int component[16];
+
+		sig_graph_init(&graph_parallel, nodes_parallel, TEST_EXEC_LOOPS * 7);
+		if(sig_graph_compile(&graph_parallel, roots, 3, NULL, 0) || (sig_graph_components(&graph_parallel, component) != 1))
+		{
+			printf("exec: graph with an undescribed sig-func split\n");
+			ret = -1;
+		}
+	}
+
+	free(serial);
+	free(parallel);
+	return ret;
+}
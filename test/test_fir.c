@@ -0,0 +1,430 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigfft.h"
+#include "siggraph.h"
+
+#define TEST_FIR_LEN		1024
+#define TEST_FIR_LONG_LEN	12000
+#define TEST_FIR_PI			3.14159265358979323846L
+#define TEST_FIR_MULTI_LEN	256
+#define TEST_FIR_MULTI_OUT	500
+#define TEST_FIR_MULTI_TAPS	100
+
+static const int test_fir_taps[] = {1, 5, 16, 33, 128, 257, 512};
+
+/**
+ * @brief runs the legacy and the mirrored layouts side by side, and checks both against a double-precision reference
+ */
+static int test_fir_taps_count(const float *input, int tap_count)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = (float*)input, .size = TEST_FIR_LEN, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_fir_n_param_f legacy_p = {.tap_count = tap_count, .source = &src};
+	struct signal_float legacy = SIG_FN(sig_fir_n_f, &legacy_p);
+	struct sig_fir_n_param_f mirrored_p = {.source = &src};
+	struct signal_float mirrored = SIG_FN(sig_fir_n_f, &mirrored_p);
+	float *taps;
+	double ref, sum_abs, tol;
+	float y_legacy, y_mirrored;
+	int i, ret = 0;
+	n_t n;
+
+	taps = malloc(tap_count * sizeof(float));
+	legacy_p.taps = taps;
+	legacy_p.samples = calloc(tap_count, sizeof(float));
+	for (i=0; i<tap_count; i++)
+		taps[i] = 1.0 / (i + 1) - 0.3;
+	if (sig_fir_n_init_f(&mirrored_p, taps, tap_count))
+		return -1;
+
+	for (n=1; n<TEST_FIR_LEN; n++)
+	{
+		y_legacy = sig_get_value_f(&legacy, n);
+		y_mirrored = sig_get_value_f(&mirrored, n);
+
+		ref = sum_abs = 0;
+		for (i=0; (i<tap_count) && (i<n); i++)
+		{
+			ref += (double)taps[i] * input[n - i];
+			sum_abs += fabs((double)taps[i] * input[n - i]);
+		}
+		tol = tap_count * FLT_EPSILON * sum_abs + FLT_MIN;
+		if ((fabs(y_legacy - ref) > tol) || (fabs(y_mirrored - ref) > tol))
+		{
+			printf("fir: %d taps, n=%u: legacy %f, mirrored %f, expected %f\n", tap_count, n, y_legacy, y_mirrored, ref);
+			ret = -1;
+			break;
+		}
+	}
+
+	sig_fir_n_free_f(&mirrored_p);
+	free(legacy_p.samples);
+	free(taps);
+	return ret;
+}
+
+int test_fir(void)
+{
+	float input[TEST_FIR_LEN];
+	unsigned int seed = 1;
+	enum sig_fir_kernel_t kernel;
+	int i, ret = 0;
+
+	for (i=0; i<TEST_FIR_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		input[i] = (float)(seed >> 8) / (1 << 24) * 2.0 - 1.0;
+	}
+
+	for (kernel = SIG_FIR_KERNEL_C; kernel <= SIG_FIR_KERNEL_AVX512; kernel++)
+	{
+		if (sig_fir_kernel_f(kernel))
+			continue;						// not supported by this CPU
+		for (i=0; i<sizeof(test_fir_taps)/sizeof(test_fir_taps[0]); i++)
+			if (test_fir_taps_count(input, test_fir_taps[i]))
+			{
+				printf("fir: kernel %d failed\n", kernel);
+				ret = -1;
+			}
+	}
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+	return ret;
+}
+
+
+/**
+ * @brief forward and inverse FFT against a double-precision DFT. The kernels give the same spectrum
+ */
+static int test_fir_fft(const float *input, int size)
+{
+	struct sig_fft fft;
+	float re[1024], im[1024], out[2048], re_c[1024], im_c[1024];
+	double sr, si, gr, gi, err = 0, sum = 0;
+	int k, i, ret = 0;
+
+	if (sig_fft_init(&fft, size))
+		return -1;
+	sig_fft_real(&fft, input, re, im);
+	for (k=0; k<=size/2; k++)
+	{
+		sr = si = 0;
+		for (i=0; i<size; i++)
+		{
+			sr += input[i] * cos(2 * (double)TEST_FIR_PI * k * i / size);
+			si -= input[i] * sin(2 * (double)TEST_FIR_PI * k * i / size);
+		}
+		gr = (k == 0) ? re[0] : (k == size / 2) ? im[0] : re[k];
+		gi = ((k == 0) || (k == size / 2)) ? 0 : im[k];
+		err = fmax(err, fabs(gr - sr) + fabs(gi - si));
+	}
+	for (i=0; i<size; i++)
+		sum += fabs(input[i]);
+	if (err > 4 * log2(size) * FLT_EPSILON * sum)
+	{
+		printf("fft: %d points, error %g\n", size, err);
+		ret = -1;
+	}
+	sig_fft_real_inverse(&fft, re, im, out);
+	for (i=0; i<size; i++)
+		if (fabs(out[i] / size - input[i]) > 4 * log2(size) * FLT_EPSILON)
+		{
+			printf("fft: %d points, inverse %g != %g\n", size, out[i] / size, input[i]);
+			ret = -1;
+			break;
+		}
+	sig_fft_kernel(&fft, SIG_FIR_KERNEL_C);
+	sig_fft_real(&fft, input, re_c, im_c);
+	if (memcmp(re, re_c, size / 2 * sizeof(float)) || memcmp(im, im_c, size / 2 * sizeof(float)))
+	{
+		printf("fft: %d points, the C kernel gives another spectrum\n", size);
+		ret = -1;
+	}
+	sig_fft_free(&fft);
+	return ret;
+}
+
+
+/**
+ * @brief per-sample, block and compiled partitioned convolutions, against the direct form delayed by the latency
+ */
+static int test_fir_long_taps(const float *input, int tap_count, int block)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = (float*)input, .size = TEST_FIR_LONG_LEN, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_fir_n_param_f direct_p = {.source = &src};
+	struct signal_float direct = SIG_FN(sig_fir_n_f, &direct_p);
+	struct sig_fir_long_param_f sample_p = {.source = &src}, block_p = {.source = &src}, graph_p = {.source = &src};
+	struct signal_float sample = SIG_FN(sig_fir_long_f, &sample_p);
+	struct signal_float blk = SIG_FNB(sig_fir_long_f, sig_fir_long_block_f, &block_p);
+	struct signal_float compiled = SIG_FN(sig_fir_long_f, &graph_p);
+	struct signal_float *roots[1] = {&compiled};
+	struct sig_graph_node nodes[4];
+	struct sig_graph graph;
+	float *taps, *ref, *out;
+	double sum_abs, tol;
+	int i, k, ret = 0;
+	n_t n, m;
+
+	taps = malloc(tap_count * sizeof(float));
+	ref = calloc(TEST_FIR_LONG_LEN, sizeof(float));
+	out = malloc(TEST_FIR_LONG_LEN * sizeof(float));
+	for (i=0; i<tap_count; i++)
+		taps[i] = 1.0 / (i + 1) - 0.3 / (1 + i % 7);
+	if (sig_fir_n_init_f(&direct_p, taps, tap_count) || sig_fir_long_init_f(&sample_p, taps, tap_count, block) ||
+		sig_fir_long_init_f(&block_p, taps, tap_count, block) || sig_fir_long_init_f(&graph_p, taps, tap_count, block))
+		return -1;
+	if ((sample_p.latency != sample_p.block) || ((block == 0) && (tap_count <= SIG_FIR_LONG_DIRECT) && sample_p.block) ||
+		((block != 0) && (sample_p.block != block)))
+	{
+		printf("fir_long: %d taps, block %d: latency %d\n", tap_count, sample_p.block, sample_p.latency);
+		ret = -1;
+	}
+	sig_graph_init(&graph, nodes, 4);
+	if (sig_graph_compile(&graph, roots, 1, NULL, 0))
+		return -1;
+
+	for (n=1; n<TEST_FIR_LONG_LEN; n++)
+		ref[n] = sig_get_value_f(&direct, n);
+	for (n=1; n<TEST_FIR_LONG_LEN; n+=k)
+	{
+		k = min(1 + (n % 677), TEST_FIR_LONG_LEN - n);			// irregular blocks
+		sig_get_block_f(&blk, n, k, out + n);
+	}
+
+	tol = 2 * log2(2 * max(sample_p.block, 1)) * FLT_EPSILON;
+	for (n=1; (n<TEST_FIR_LONG_LEN) && (ret == 0); n++)
+	{
+		sig_graph_run(&graph, n);
+		out[0] = sig_get_value_f(&sample, n);
+		m = n - sample_p.latency;
+		sum_abs = 0;
+		for (i=0; (i<tap_count) && (n > sample_p.latency + i); i++)
+			sum_abs += fabs((double)taps[i] * input[m - i]);
+		if ((fabs(out[0] - ((n > sample_p.latency) ? ref[m] : 0)) > tol * sum_abs + FLT_MIN) ||
+			(out[n] != out[0]) || (compiled.x_cst != out[0]))
+		{
+			printf("fir_long: %d taps, block %d, n=%u: sample %g, block %g, compiled %g, expected %g\n", tap_count,
+				sample_p.block, n, out[0], out[n], compiled.x_cst, (n > sample_p.latency) ? ref[m] : 0);
+			ret = -1;
+		}
+	}
+
+	sig_fir_n_free_f(&direct_p);
+	sig_fir_long_free_f(&sample_p);
+	sig_fir_long_free_f(&block_p);
+	sig_fir_long_free_f(&graph_p);
+	free(taps);
+	free(ref);
+	free(out);
+	return ret;
+}
+
+int test_fir_long(void)
+{
+	static const int taps[] = {100, 300, 2048, 5000};
+	static const int blocks[] = {0, 16, 256};
+	float *input = malloc(TEST_FIR_LONG_LEN * sizeof(float));
+	unsigned int seed = 3;
+	enum sig_fir_kernel_t kernel;
+	int i, j, ret = 0;
+
+	for (i=0; i<TEST_FIR_LONG_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		input[i] = (float)(seed >> 8) / (1 << 24) * 2.0 - 1.0;
+	}
+	for (i=4; i<=2048; i*=2)
+		if (test_fir_fft(input, i))
+			ret = -1;
+
+	for (kernel = SIG_FIR_KERNEL_C; kernel <= SIG_FIR_KERNEL_AVX512; kernel++)
+	{
+		if (sig_fir_kernel_f(kernel))
+			continue;						// not supported by this CPU
+		for (i=0; i<sizeof(taps)/sizeof(taps[0]); i++)
+			for (j=0; j<sizeof(blocks)/sizeof(blocks[0]); j++)
+				if (test_fir_long_taps(input, taps[i], blocks[j]))
+				{
+					printf("fir_long: kernel %d failed\n", kernel);
+					ret = -1;
+				}
+	}
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+	free(input);
+	return ret;
+}
+
+
+/**
+ * @brief per-sample and block decimator against the full rate filter, from n0 (output rate)
+ * @details the source buffer is circular, and its size divides 2^32: it stays continuous when n rolls over
+ */
+static int test_fir_decim_taps(float *input, int tap_count, int factor, n_t n0)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = input, .size = TEST_FIR_MULTI_LEN, .circular = 1, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_buf_read_param_f ref_src_p = src_p;
+	struct signal_float ref_src = SIG_FN(sig_buf_read_f, &ref_src_p);
+	struct sig_fir_n_param_f ref_p = {.source = &ref_src};
+	struct signal_float ref = SIG_FN(sig_fir_n_f, &ref_p);
+	struct sig_fir_decim_param_f sample_p = {.source = &src, .n_last = n0 - 1}, block_p = sample_p;
+	struct signal_float sample = SIG_FN(sig_fir_decim_f, &sample_p);
+	struct signal_float blk = SIG_FNB(sig_fir_decim_f, sig_fir_decim_block_f, &block_p);
+	float taps[TEST_FIR_MULTI_TAPS], out[TEST_FIR_MULTI_OUT], y, y_ref = 0;
+	int i, k, ret = 0;
+	n_t n, m;
+
+	for (i=0; i<tap_count; i++)
+		taps[i] = 1.0 / (i + 1) - 0.2;
+	ref_p.n_last = src_p.n_last = ref_src_p.n_last = (n0 - 1) * factor;
+	if (sig_fir_n_init_f(&ref_p, taps, tap_count) || sig_fir_decim_init_f(&sample_p, taps, tap_count, factor) ||
+		sig_fir_decim_init_f(&block_p, taps, tap_count, factor))
+		return -1;
+
+	for (i=0; i<TEST_FIR_MULTI_OUT; i+=k)
+	{
+		k = min(1 + (i % 37), TEST_FIR_MULTI_OUT - i);					// irregular blocks
+		sig_get_block_f(&blk, n0 + i, k, out + i);
+	}
+	for (i=0, n=n0; (i<TEST_FIR_MULTI_OUT) && (ret == 0); i++, n++)
+	{
+		for (m=(n - 1) * factor + 1; m != n * factor + 1; m++)			// full rate, every input
+			y_ref = sig_get_value_f(&ref, m);
+		y = sig_get_value_f(&sample, n);
+		if ((y != y_ref) || (out[i] != y_ref) || (sig_get_value_f(&sample, n) != y))
+		{
+			printf("fir_decim: %d taps, factor %d, n=%u: sample %g, block %g, expected %g\n", tap_count, factor, n, y,
+				out[i], y_ref);
+			ret = -1;
+		}
+	}
+
+	sig_fir_n_free_f(&ref_p);
+	sig_fir_decim_free_f(&sample_p);
+	sig_fir_decim_free_f(&block_p);
+	return ret;
+}
+
+
+/**
+ * @brief per-sample and block interpolator against the full rate filter fed with the zero-stuffed source
+ */
+static int test_fir_interp_taps(float *input, int tap_count, int factor, n_t n0)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = input, .size = TEST_FIR_MULTI_LEN, .circular = 1, .check_buffer = 1};
+	struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+	struct sig_buf_read_param_f stuffed_p = {.size = TEST_FIR_MULTI_LEN * factor, .circular = 1, .check_buffer = 1};
+	struct signal_float stuffed = SIG_FN(sig_buf_read_f, &stuffed_p);
+	struct sig_fir_n_param_f ref_p = {.source = &stuffed};
+	struct signal_float ref = SIG_FN(sig_fir_n_f, &ref_p);
+	struct sig_fir_interp_param_f sample_p = {.source = &src, .n_last = n0 - 1}, block_p = sample_p;
+	struct signal_float sample = SIG_FN(sig_fir_interp_f, &sample_p);
+	struct signal_float blk = SIG_FNB(sig_fir_interp_f, sig_fir_interp_block_f, &block_p);
+	float taps[TEST_FIR_MULTI_TAPS], out[TEST_FIR_MULTI_OUT], y, y_ref;
+	double sum_abs;
+	int i, k, ret = 0;
+	n_t n;
+
+	stuffed_p.buffer = calloc(TEST_FIR_MULTI_LEN * factor, sizeof(float));
+	for (i=0; i<TEST_FIR_MULTI_LEN; i++)
+		stuffed_p.buffer[i * factor] = input[i];
+	for (i=0; i<tap_count; i++)
+		taps[i] = 1.0 / (i + 1) - 0.2;
+	ref_p.n_last = stuffed_p.n_last = n0 - 1;
+	src_p.n_last = (n0 - 1) / factor;
+	if (sig_fir_n_init_f(&ref_p, taps, tap_count) || sig_fir_interp_init_f(&sample_p, taps, tap_count, factor) ||
+		sig_fir_interp_init_f(&block_p, taps, tap_count, factor))
+		return -1;
+	sample_p.n_in = block_p.n_in = (n0 - 1) / factor;					// its input was seen by the reference
+	if ((n0 - 1) % factor)
+		ret = -1;														// the test starts on a phase 0
+
+	for (i=0; i<TEST_FIR_MULTI_OUT; i+=k)
+	{
+		k = min(1 + (i % 37), TEST_FIR_MULTI_OUT - i);					// irregular blocks
+		sig_get_block_f(&blk, n0 + i, k, out + i);
+	}
+	for (k=0, sum_abs=0; k<tap_count; k++)
+		sum_abs += fabs(taps[k]);
+	for (i=0, n=n0; (i<TEST_FIR_MULTI_OUT) && (ret == 0); i++, n++)
+	{
+		y_ref = sig_get_value_f(&ref, n);
+		y = sig_get_value_f(&sample, n);
+		// the zeros are skipped: same products, summed in another order
+		if ((fabs(y - y_ref) > tap_count * FLT_EPSILON * sum_abs) || (out[i] != y))
+		{
+			printf("fir_interp: %d taps, factor %d, n=%u: sample %g, block %g, expected %g\n", tap_count, factor, n, y,
+				out[i], y_ref);
+			ret = -1;
+		}
+	}
+
+	sig_fir_n_free_f(&ref_p);
+	sig_fir_interp_free_f(&sample_p);
+	sig_fir_interp_free_f(&block_p);
+	free(stuffed_p.buffer);
+	return ret;
+}
+
+int test_fir_multirate(void)
+{
+	static const int taps[] = {1, 7, 33, 100};
+	static const int factors[] = {1, 2, 3, 4, 16};
+	float input[TEST_FIR_MULTI_LEN];
+	unsigned int seed = 5;
+	enum sig_fir_kernel_t kernel;
+	int i, j, ret = 0;
+
+	for (i=0; i<TEST_FIR_MULTI_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		input[i] = (float)(seed >> 8) / (1 << 24) * 2.0 - 1.0;
+	}
+
+	for (kernel = SIG_FIR_KERNEL_C; kernel <= SIG_FIR_KERNEL_AVX512; kernel++)
+	{
+		if (sig_fir_kernel_f(kernel))
+			continue;						// not supported by this CPU
+		for (i=0; i<sizeof(taps)/sizeof(taps[0]); i++)
+			for (j=0; j<sizeof(factors)/sizeof(factors[0]); j++)
+			{
+				// from the start, then across the roll over of n (decimator: of n * factor too)
+				if (test_fir_decim_taps(input, taps[i], factors[j], 1) ||
+					test_fir_decim_taps(input, taps[i], factors[j], -TEST_FIR_MULTI_OUT / 2))
+					ret = -1;
+				// the input n of the interpolator only rolls over with n if factor is a power of 2
+				if (test_fir_interp_taps(input, taps[i], factors[j], 1) || (((factors[j] & (factors[j] - 1)) == 0) &&
+					test_fir_interp_taps(input, taps[i], factors[j], 1 - TEST_FIR_MULTI_OUT / 2 * factors[j])))
+					ret = -1;
+			}
+		if (ret)
+			printf("fir_multirate: kernel %d failed\n", kernel);
+	}
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+	return ret;
+}
@@ -0,0 +1,49 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_FIR_H_
+#define TEST_FIR_H_
+
+
+/**
+ * @brief test the mirrored (vectorized) FIR layout against the legacy layout
+ * @details all the kernels supported by the CPU are tested, with several tap counts
+ * @return 0 on success
+ */
+int test_fir(void);
+
+
+/**
+ * @brief test the real FFT against a direct DFT, and the partitioned FFT convolution against the direct form
+ * @details all the spectral product kernels supported by the CPU are tested, with several tap counts and block sizes
+ * @return 0 on success
+ */
+int test_fir_long(void);
+
+
+/**
+ * @brief test the FIR decimator and the polyphase interpolator against the full rate filter
+ * @details per-sample and block paths, with several factors, from the start and across the roll over of n
+ * @return 0 on success
+ */
+int test_fir_multirate(void);
+
+
+#endif	// TEST_FIR_H_
@@ -0,0 +1,126 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggen.h"
+#include "test_gen.h"
+
+// code generated from the controller by test_gen.out, see the test_gen target of the Makefile
+#if !__has_include("test_gen_step.c")
+#error "test/test_gen_step.c is missing: it is generated by test/test_gen.out (make test_gen)"
+#endif
+#include "test_gen_step.c"
+
+#define TEST_GEN_OVER		16						// ticks after the end of the data (sticking readers)
+
+
+/**
+ * @brief a graph with a sig-func unknown to the generator must be refused
+ */
+static int test_gen_unsupported(void)
+{
+	struct sig_fir_decim_param_f decim_p = {.factor = 2};
+	struct signal_float decim = SIG_FN(sig_fir_decim_f, &decim_p);
+	struct signal_float *root = &decim;
+	struct sig_graph_node nodes[1];
+	struct sig_graph graph;
+	struct sig_gen gen;
+	FILE *out = tmpfile();
+	int ret;
+
+	if (out == NULL)
+		return -1;
+	sig_graph_init(&graph, nodes, 1);
+	ret = sig_graph_compile(&graph, &root, 1, NULL, 0);
+	if (ret == 0)
+		ret = sig_gen_c(&gen, &graph, "unsupported", out);
+	fclose(out);
+	if ((ret != SIG_ERR_UNSUPPORTED) || (gen.err_sig != &decim))
+	{
+		printf("gen: unsupported sig-func: %d\n", ret);
+		return -1;
+	}
+	return 0;
+}
+
+
+int test_gen(float **data, int data_l)
+{
+	static struct test_gen_graph g;
+	struct signal_float *sig;
+	struct sig_gen gen;
+	char *text = NULL;
+	size_t len = 0;
+	int i, ret = 0;
+	n_t n;
+
+	// the generated FIR is summed as the C kernel
+	sig_fir_kernel_f(SIG_FIR_KERNEL_C);
+	if (test_gen_build(&g, data, data_l) || test_gen_code(&g, &gen, &text, &len))
+	{
+		printf("gen: cannot generate the code\n");
+		ret = -1;
+	}
+	if ((ret == 0) && ((test_gen_checksum(text, len) != test_gen_code_checksum) ||
+		(gen.vars != sizeof(test_gen_var) / sizeof(test_gen_var[0])) ||
+		(gen.buffers != sizeof(test_gen_buffer) / sizeof(test_gen_buffer[0])) ||
+		(g.graph.count != sizeof(test_gen_state.x) / sizeof(test_gen_state.x[0]))))
+	{
+		printf("gen: test_gen_step.c is stale: regenerate it with make test_gen\n");
+		ret = -1;
+	}
+	free(text);
+	for (i=0; (i<gen.vars) && (ret == 0); i++)
+		test_gen_var[i] = gen.var[i];
+	for (i=0; (i<gen.buffers) && (ret == 0); i++)
+		test_gen_buffer[i] = gen.buffer[i];
+
+	for (n=1; (n<data_l + TEST_GEN_OVER) && (ret == 0); n++)
+	{
+		g.offset = n * 0.125;
+		g.level = (n % 7) * 0.5;
+		sig_graph_run(&g.graph, n);
+		test_gen_step(n);
+		for (i=0; i<g.graph.count; i++)
+		{
+			sig = (struct signal_float *)g.graph.nodes[i].sig;
+			if (memcmp(&sig->x_cst, &test_gen_state.x[i], sizeof(float)))
+			{
+				printf("gen: n=%u, %s: generated %.9g, graph %.9g\n", n, sig->name, test_gen_state.x[i], sig->x_cst);
+				ret = -1;
+			}
+		}
+	}
+	if (g.graph.ctx.err)
+	{
+		printf("gen: graph error %d\n", g.graph.ctx.err);
+		ret = -1;
+	}
+	test_gen_free(&g);
+	sig_fir_kernel_f(SIG_FIR_KERNEL_AUTO);
+
+	if (test_gen_unsupported())
+		ret = -1;
+	return ret;
+}
@@ -0,0 +1,97 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_GEN_H_
+#define TEST_GEN_H_
+
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "siggen.h"
+
+
+/**
+ * @brief controller used to test the code generator: the PID of test_pidf(), followed by a FIR, a low pass and an
+ * adder, and a naive PID gated by an n-Window
+ */
+struct test_gen_graph {
+	struct sig_buf_read_param_f buf_p[5];
+	struct signal_float buf[5];
+	struct sig_pid_param_f pid_p;
+	struct signal_float pid;
+	struct sig_fir_n_param_f fir_p;
+	struct signal_float fir;
+	struct sig_iirlp1_param_f lp_p;
+	struct signal_float lp;
+	struct sig_add_param_f add_p;
+	struct signal_float add;
+	struct sig_step_param_f step_p;
+	struct signal_float step;
+	struct sig_sampler_param_f sampler_p;
+	struct signal_float sampler;
+	struct signal_float ff;
+	struct sig_pid_param_f naive_p;
+	struct signal_float naive;
+	float offset;										//!< variable read by the adder
+	float level;										//!< variable read by the sampler
+	struct sig_graph_node nodes[16];
+	struct sig_graph graph;
+};
+
+
+/**
+ * @brief build and compile the controller on the columns of the test data
+ * @return 0 on success
+ */
+int test_gen_build(struct test_gen_graph *self, float **data, int data_l);
+
+
+/**
+ * @brief free the controller
+ */
+void test_gen_free(struct test_gen_graph *self);
+
+
+/**
+ * @brief generate the code of the controller into a string
+ * @param[out] gen generator state (variables and buffers of the code)
+ * @param[out] text receives the code, '\0' terminated. free() it
+ * @param[out] len length of the code
+ * @return 0 on success
+ */
+int test_gen_code(struct test_gen_graph *self, struct sig_gen *gen, char **text, size_t *len);
+
+
+/**
+ * @brief checksum (FNV-1a) of the generated code. test_gen.out writes it after the code, as test_gen_code_checksum,
+ * so that a stale test_gen_step.c is detected
+ */
+unsigned long test_gen_checksum(const char *text, size_t len);
+
+
+/**
+ * @brief test the code generated from the controller (test_gen_step.c, written by test_gen.out) against the graph
+ * @details every signal of the schedule must have the same value, at each tick. Unsupported signals must be reported
+ * @return 0 on success
+ */
+int test_gen(float **data, int data_l);
+
+
+#endif	// TEST_GEN_H_
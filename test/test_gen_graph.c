@@ -0,0 +1,115 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_gen.h"
+
+#define TEST_GEN_TAPS		20
+
+
+int test_gen_build(struct test_gen_graph *self, float **data, int data_l)
+{
+	struct signal_float *roots[3];
+	float taps[TEST_GEN_TAPS];
+	int i;
+
+	memset(self, 0, sizeof(*self));
+	for (i=0; i<5; i++)
+	{
+		self->buf_p[i] = (struct sig_buf_read_param_f) {.buffer = data[i], .size = data_l, .check_buffer = 1};
+		self->buf[i] = (struct signal_float) SIGN_FN("buf", sig_buf_read_f, &self->buf_p[i]);
+	}
+	self->buf_p[4].circular = 1;
+	self->buf_p[4].delta = 5;
+
+	// PID of test_pidf()
+	self->pid_p = (struct sig_pid_param_f) {.p = 1.0, .i = 0.1, .d = 1.0, .max_output = 5.0,
+		.setpoint = &self->buf[0], .feedback = &self->buf[1], .ff = {1.0, 2.0, 3.0},
+		.ff0 = &self->buf[2], .ff1 = &self->buf[3], .ff2 = &self->buf[4]};
+	self->pid = (struct signal_float) SIGN_FN("pid", sig_pid_opt_f, &self->pid_p);
+	sig_pid_compute_k_f(&self->pid);
+
+	for (i=0; i<TEST_GEN_TAPS; i++)
+		taps[i] = (i + 1) * (TEST_GEN_TAPS - i) / 600.0;
+	if (sig_fir_n_init_f(&self->fir_p, taps, TEST_GEN_TAPS))
+		return -1;
+	self->fir_p.source = &self->pid;
+	self->fir = (struct signal_float) SIGN_FN("fir", sig_fir_n_f, &self->fir_p);
+	self->lp_p = (struct sig_iirlp1_param_f) {.a = 0.3, .oma = 0.7, .source = &self->fir};
+	self->lp = (struct signal_float) SIGN_FN("lp", sig_iirlp1_f, &self->lp_p);
+	self->add_p = (struct sig_add_param_f) {.a = &self->lp, .b_var = &self->offset};
+	self->add = (struct signal_float) SIGN_FN("add", sig_add_f, &self->add_p);
+
+	// naive PID, enabled from n = 10 to 50, following the low pass
+	self->step_p = (struct sig_step_param_f) {.n_min = 10, .n_max = 50, .x_active = 1.5, .x_inact = 0};
+	self->step = (struct signal_float) SIGN_FN("step", sig_step_f, &self->step_p);
+	self->sampler = (struct signal_float) {.name = "level", .x = sig_sampler_f, .x_var = &self->level, .params = &self->sampler_p};
+	self->ff = (struct signal_float) SIG_CST(-0.25);
+	self->naive_p = (struct sig_pid_param_f) {.p = 0.5, .i = 0.2, .d = 0.1, .max_output = 2.0,
+		.setpoint = &self->step, .feedback = &self->lp, .ff = {1.0, 0.5, 0},
+		.ff0 = &self->sampler, .ff1 = &self->ff};
+	self->naive = (struct signal_float) SIGN_FN("naive", sig_pid_naive_f, &self->naive_p);
+
+	roots[0] = &self->pid;
+	roots[1] = &self->add;
+	roots[2] = &self->naive;
+	sig_graph_init(&self->graph, self->nodes, 16);
+	return sig_graph_compile(&self->graph, roots, 3, NULL, 0);
+}
+
+
+void test_gen_free(struct test_gen_graph *self)
+{
+	sig_fir_n_free_f(&self->fir_p);
+}
+
+
+int test_gen_code(struct test_gen_graph *self, struct sig_gen *gen, char **text, size_t *len)
+{
+	FILE *out;
+	int ret;
+
+	*text = NULL;
+	out = open_memstream(text, len);
+	if (out == NULL)
+		return -1;
+	ret = sig_gen_c(gen, &self->graph, "test_gen", out);
+	if (fclose(out) && (ret == 0))
+		ret = -1;
+	if (ret)
+	{
+		free(*text);
+		*text = NULL;
+	}
+	return ret;
+}
+
+
+unsigned long test_gen_checksum(const char *text, size_t len)
+{
+	unsigned long h = 2166136261u;
+	size_t i;
+
+	for (i=0; i<len; i++)
+		h = ((h ^ (unsigned char)text[i]) * 16777619u) & 0xffffffffu;
+	return h;
+}
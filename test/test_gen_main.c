@@ -0,0 +1,87 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file test_gen_main.c
+ * writes the code of the test_gen() controller
+ * usage: test_gen.out prefix file.c (reads prefix_pidf.csv, as testf.out)
+ * The file is removed on error, so that the test build fails on the missing file rather than on a stale one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csv.h"
+#include "siggen.h"
+#include "test_gen.h"
+
+int main(int argc, char *argv[])
+{
+	static struct test_gen_graph graph;
+	struct sig_gen gen;
+	char filename[1024];
+	float **data;
+	FILE *out;
+	char *text;
+	size_t len;
+	int data_l, ret;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s prefix file.c\n", argv[0]);
+		return -1;
+	}
+	remove(argv[2]);
+	snprintf(filename, sizeof(filename), "%s_pidf.csv", argv[1]);
+	if (csv_load(filename, &data_l, &data))
+	{
+		fprintf(stderr, "cannot load %s\n", filename);
+		return -1;
+	}
+	if (test_gen_build(&graph, data, data_l))
+	{
+		fprintf(stderr, "cannot build the graph\n");
+		return -1;
+	}
+	ret = test_gen_code(&graph, &gen, &text, &len);
+	if (ret)
+		fprintf(stderr, "cannot generate the code: %d\n", ret);
+	else
+	{
+		// the code, then its checksum
+		out = fopen(argv[2], "w");
+		if (out)
+		{
+			if ((fwrite(text, 1, len, out) != len)
+					|| (fprintf(out, "\nconst unsigned long test_gen_code_checksum = 0x%lxUL;\n", test_gen_checksum(text, len)) < 0))
+				ret = -1;
+			if (fclose(out))
+				ret = -1;
+		}
+		if ((out == NULL) || ret)
+		{
+			fprintf(stderr, "cannot write %s\n", argv[2]);
+			remove(argv[2]);
+			ret = -1;
+		}
+		free(text);
+	}
+	test_gen_free(&graph);
+	csv_free(data);
+	return ret;
+}
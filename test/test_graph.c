@@ -0,0 +1,408 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+
+#define TEST_GRAPH_TAPS		8
+
+/**
+ * - pid_opt(setpoint, feedback, ff0, ff1, ff2)
+ * - pid_naive(iirlp1(setpoint) + fir(feedback), step)
+ * setpoint and feedback are shared by both PID
+ */
+struct test_graph {
+	struct sig_buf_read_param_f buf_p[5];
+	struct signal_float buf[5];
+	struct sig_iirlp1_param_f iir_p;
+	struct signal_float iir;
+	float fir_taps[TEST_GRAPH_TAPS];
+	float fir_samples[TEST_GRAPH_TAPS];
+	struct sig_fir_n_param_f fir_p;
+	struct signal_float fir;
+	struct sig_add_param_f add_p;
+	struct signal_float add;
+	struct sig_step_param_f step_p;
+	struct signal_float step;
+	struct sig_pid_param_f pid_opt_p;
+	struct signal_float pid_opt;
+	struct sig_pid_param_f pid_naive_p;
+	struct signal_float pid_naive;
+};
+
+static void test_graph_init(struct test_graph *g, float **data, int data_l)
+{
+	int i;
+
+	memset(g, 0, sizeof(*g));
+	for(i=0; i<5; i++)
+	{
+		g->buf_p[i].buffer = data[i];
+		g->buf_p[i].size = data_l;
+		g->buf_p[i].check_buffer = 1;
+		g->buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &g->buf_p[i]);
+	}
+
+	g->iir_p = (struct sig_iirlp1_param_f) {.a = 0.3, .oma = 0.7, .source = &g->buf[0]};
+	g->iir = (struct signal_float) SIG_FN(sig_iirlp1_f, &g->iir_p);
+
+	for(i=0; i<TEST_GRAPH_TAPS; i++)
+		g->fir_taps[i] = 1.0 / (i + 2);
+	g->fir_p = (struct sig_fir_n_param_f) {.tap_count = TEST_GRAPH_TAPS, .taps = g->fir_taps, .samples = g->fir_samples, .source = &g->buf[1]};
+	g->fir = (struct signal_float) SIG_FN(sig_fir_n_f, &g->fir_p);
+
+	g->add_p = (struct sig_add_param_f) {.a = &g->iir, .b = &g->fir};
+	g->add = (struct signal_float) SIG_FN(sig_add_f, &g->add_p);
+
+	g->step_p = (struct sig_step_param_f) {.n_min = 20, .n_max = 50, .x_active = 0.5, .x_inact = -0.25};
+	g->step = (struct signal_float) SIG_FN(sig_step_f, &g->step_p);
+
+	g->pid_opt_p = (struct sig_pid_param_f) {
+		.p = 1.0, .i = 0.1, .d = 1.0, .max_output = 5.0,
+		.setpoint = &g->buf[0], .feedback = &g->buf[1],
+		.ff = {1.0, 2.0, 3.0}, .ff0 = &g->buf[2], .ff1 = &g->buf[3], .ff2 = &g->buf[4]
+	};
+	g->pid_opt = (struct signal_float) SIG_FN(sig_pid_opt_f, &g->pid_opt_p);
+	sig_pid_compute_k_f(&g->pid_opt);
+
+	g->pid_naive_p = (struct sig_pid_param_f) {
+		.p = 0.8, .i = 0.2, .d = 0.5, .max_output = 2.0,
+		.setpoint = &g->add, .feedback = &g->step
+	};
+	g->pid_naive = (struct signal_float) SIG_FN(sig_pid_naive_f, &g->pid_naive_p);
+}
+
+int test_graph(float **data, int data_l, float* output)
+{
+	struct test_graph *rec, *cmp;
+	struct sig_graph graph;
+	struct sig_graph_node nodes[16];
+	struct signal_float *roots[2];
+	float x[2];
+	n_t n;
+	int ret = 0;
+
+	rec = malloc(sizeof(*rec));
+	cmp = malloc(sizeof(*cmp));
+	test_graph_init(rec, data, data_l);
+	test_graph_init(cmp, data, data_l);
+
+	roots[0] = &cmp->pid_opt;
+	roots[1] = &cmp->pid_naive;
+	sig_graph_init(&graph, nodes, 16);
+	if (sig_graph_compile(&graph, roots, 2, NULL, 0) || (graph.count != 11))
+	{
+		printf("graph: compilation failed (%d nodes)\n", graph.count);
+		ret = -1;
+	}
+
+	// n starts at 1: the recursive evaluation considers n = 0 as already evaluated (n_last = 0)
+	for(n=1; (n<data_l) && (ret == 0); n++)
+	{
+		x[0] = sig_get_value_f(&rec->pid_opt, n);
+		x[1] = sig_get_value_f(&rec->pid_naive, n);
+		sig_graph_run(&graph, n);
+		output[n] = cmp->pid_opt.x_cst;
+		if (memcmp(&x[0], &cmp->pid_opt.x_cst, sizeof(float)) || memcmp(&x[1], &cmp->pid_naive.x_cst, sizeof(float)))
+		{
+			printf("graph: n=%u: compiled %f %f, recursive %f %f\n", n, cmp->pid_opt.x_cst, cmp->pid_naive.x_cst, x[0], x[1]);
+			ret = -1;
+		}
+	}
+
+	// schedule too small
+	sig_graph_init(&graph, nodes, 10);
+	if (sig_graph_compile(&graph, roots, 2, NULL, 0) != SIG_ERR_FULL)
+	{
+		printf("graph: full schedule not detected\n");
+		ret = -1;
+	}
+
+	// the PID feedback is computed from its own output
+	cmp->add_p.a = &cmp->pid_naive;
+	sig_graph_init(&graph, nodes, 16);
+	if ((sig_graph_compile(&graph, roots, 2, NULL, 0) != SIG_ERR_CYCLE) || (graph.count != 0))
+	{
+		printf("graph: cycle not detected\n");
+		ret = -1;
+	}
+
+	free(cmp);
+	free(rec);
+	return ret;
+}
+
+
+/**
+ * - pid_opt(setpoint), without feedback nor Feed-Forward
+ * - opaque(iirlp1(setpoint)) and iirlp1(setpoint) + feedback: the IIR is evaluated both through (*x), by an
+ *   undescribed sig-func, and by its node
+ */
+struct test_graph_partial {
+	struct sig_buf_read_param_f buf_p[2];
+	struct signal_float buf[2];
+	struct sig_pid_param_f pid_p;
+	struct signal_float pid;
+	struct sig_iirlp1_param_f iir_p;
+	struct signal_float iir;
+	struct signal_float opaque;
+	struct sig_add_param_f add_p;
+	struct signal_float add;
+};
+
+/** undescribed sig-func: twice its source */
+static float test_graph_opaque_f(struct signal_float *self, n_t n)
+{
+	return 2 * sig_value((struct signal_float *)self->params, n);
+}
+
+static void test_graph_partial_init(struct test_graph_partial *g, float **data, int data_l)
+{
+	int i;
+
+	memset(g, 0, sizeof(*g));
+	for(i=0; i<2; i++)
+	{
+		g->buf_p[i].buffer = data[i];
+		g->buf_p[i].size = data_l;
+		g->buf_p[i].check_buffer = 1;
+		g->buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &g->buf_p[i]);
+	}
+	g->pid_p = (struct sig_pid_param_f) {.p = 1.0, .i = 0.1, .d = 1.0, .max_output = 5.0, .setpoint = &g->buf[0]};
+	g->pid = (struct signal_float) SIG_FN(sig_pid_opt_f, &g->pid_p);
+	sig_pid_compute_k_f(&g->pid);
+
+	g->iir_p = (struct sig_iirlp1_param_f) {.a = 0.5, .oma = 0.5, .source = &g->buf[0]};
+	g->iir = (struct signal_float) SIG_FN(sig_iirlp1_f, &g->iir_p);
+	g->opaque = (struct signal_float) SIG_FN(test_graph_opaque_f, &g->iir);
+	g->add_p = (struct sig_add_param_f) {.a = &g->iir, .b = &g->buf[1]};
+	g->add = (struct signal_float) SIG_FN(sig_add_f, &g->add_p);
+}
+
+/** fill the stack with garbage, so that the uninitialized locals of the next calls are not 0 */
+static void __attribute__((noinline)) test_graph_dirty_stack(void)
+{
+	volatile char junk[4096];
+	int i;
+
+	for(i=0; i<(int)sizeof(junk); i++)
+		junk[i] = 0xa5;
+}
+
+int test_graph_partial(float **data, int data_l)
+{
+	struct test_graph_partial *rec, *cmp;
+	struct sig_graph graph;
+	struct sig_graph_node nodes[16];
+	struct signal_float *roots[3];
+	float x[3];
+	n_t n;
+	int i, ret = 0;
+
+	rec = malloc(sizeof(*rec));
+	cmp = malloc(sizeof(*cmp));
+	test_graph_partial_init(rec, data, data_l);
+	test_graph_partial_init(cmp, data, data_l);
+
+	// the opaque node is scheduled first: it evaluates the IIR before the IIR node does
+	roots[0] = &cmp->pid;
+	roots[1] = &cmp->opaque;
+	roots[2] = &cmp->add;
+	sig_graph_init(&graph, nodes, 16);
+	test_graph_dirty_stack();
+	if (sig_graph_compile(&graph, roots, 3, NULL, 0))
+	{
+		printf("graph partial: compilation failed\n");
+		ret = -1;
+	}
+
+	for(n=1; (n<data_l) && (ret == 0); n++)
+	{
+		x[0] = sig_get_value_f(&rec->pid, n);
+		x[1] = sig_get_value_f(&rec->opaque, n);
+		x[2] = sig_get_value_f(&rec->add, n);
+		if (sig_graph_run(&graph, n))
+		{
+			printf("graph partial: error %d at n=%u\n", graph.ctx.err, n);
+			ret = -1;
+		}
+		for(i=0; i<3; i++)
+		{
+			if (memcmp(&x[i], &roots[i]->x_cst, sizeof(float)))
+			{
+				printf("graph partial: n=%u, root %d: %f instead of %f\n", n, i, roots[i]->x_cst, x[i]);
+				ret = -1;
+			}
+		}
+	}
+
+	// without undescribed sig-func nothing is shared: the first tick is evaluated, though n_last was initialized to n
+	test_graph_partial_init(cmp, data, data_l);
+	roots[0] = &cmp->add;
+	if (sig_graph_compile(&graph, roots, 1, NULL, 0) || nodes[0].shared)
+	{
+		printf("graph partial: clean graph compiled as shared\n");
+		ret = -1;
+	}
+	n = data_l - 1;
+	cmp->buf_p[0].n_last = cmp->buf_p[1].n_last = cmp->iir_p.n_last = cmp->add_p.n_last = n;
+	sig_graph_run(&graph, n);
+	if (cmp->add.x_cst != data[0][n] * 0.5 + data[1][n])
+	{
+		printf("graph partial: n=n_last skipped, %f instead of %f\n", cmp->add.x_cst, data[0][n] * 0.5 + data[1][n]);
+		ret = -1;
+	}
+
+	free(cmp);
+	free(rec);
+	return ret;
+}
+
+
+struct test_graph_ctx {
+	struct test_graph g;
+	struct sig_graph graph;
+	struct sig_graph_node nodes[16];
+	float *output;
+	int data_l;
+	int ret;
+};
+
+static void *test_graph_ctx_thread(void *arg)
+{
+	struct test_graph_ctx *t = (struct test_graph_ctx *)arg;
+	n_t n;
+
+	t->ret = 0;
+	for(n=1; n<t->data_l; n++)
+	{
+		if (sig_graph_run(&t->graph, n) && (t->ret == 0))
+			t->ret = t->graph.ctx.err;
+		t->output[n] = t->g.pid_opt.x_cst;
+	}
+	return NULL;
+}
+
+static int test_graph_ctx_init(struct test_graph_ctx *t, float **data, int data_l)
+{
+	struct signal_float *roots[2];
+
+	test_graph_init(&t->g, data, data_l);
+	roots[0] = &t->g.pid_opt;
+	roots[1] = &t->g.pid_naive;
+	sig_graph_init(&t->graph, t->nodes, 16);
+	t->output = calloc(data_l, sizeof(float));
+	t->data_l = data_l;
+	return sig_graph_compile(&t->graph, roots, 2, NULL, 0);
+}
+
+int test_graph_ctx(float **data, int data_l)
+{
+	struct test_graph_ctx *ok, *ko;
+	struct test_graph *rec;
+	pthread_t thread[2];
+	float x;
+	n_t n;
+	int ret = 0;
+
+	ok = aligned_alloc(64, sizeof(*ok));
+	ko = aligned_alloc(64, sizeof(*ko));
+	rec = malloc(sizeof(*rec));
+	test_graph_init(rec, data, data_l);
+	if (test_graph_ctx_init(ok, data, data_l) || test_graph_ctx_init(ko, data, data_l))
+	{
+		printf("graph ctx: compilation failed\n");
+		ret = -1;
+	}
+
+	// both graphs run concurrently, ko fails on its first tick
+	ko->g.buf_p[2].buffer = NULL;
+	pthread_create(&thread[0], NULL, test_graph_ctx_thread, ok);
+	pthread_create(&thread[1], NULL, test_graph_ctx_thread, ko);
+	pthread_join(thread[0], NULL);
+	pthread_join(thread[1], NULL);
+
+	if ((ok->ret != 0) || (ok->graph.ctx.ticks != data_l - 1) || (ok->graph.ctx.errors != 0))
+	{
+		printf("graph ctx: error %d in the valid graph\n", ok->ret);
+		ret = -1;
+	}
+	for(n=1; (n<data_l) && (ret == 0); n++)
+	{
+		x = sig_get_value_f(&rec->pid_opt, n);
+		if (memcmp(&x, &ok->output[n], sizeof(float)))
+		{
+			printf("graph ctx: n=%u: %f instead of %f\n", n, ok->output[n], x);
+			ret = -1;
+		}
+	}
+	if ((ko->ret != -3) || (ko->graph.ctx.err_ptr != &ko->g.buf[2]) || (ko->graph.ctx.ticks != 1) || (ko->graph.ctx.errors != 1))
+	{
+		printf("graph ctx: error %d (%lu ticks) in the failing graph\n", ko->ret, ko->graph.ctx.ticks);
+		ret = -1;
+	}
+#if SIG_DBG_NAME
+	if ((ko->graph.ctx.err_name == NULL) || (ko->graph.ctx.err_name[0] != '\0'))
+	{
+		printf("graph ctx: the name of an unnamed signal is not \"\"\n");	// unnamed: SIG_FN()
+		ret = -1;
+	}
+#endif
+	if (sig_errno)
+	{
+		printf("graph ctx: sig_errno = %d\n", sig_errno);
+		ret = -1;
+	}
+
+	// the error is kept until cleared
+	ko->g.buf_p[2].buffer = data[2];
+	if (sig_graph_run(&ko->graph, data_l) != -3)
+	{
+		printf("graph ctx: error not kept\n");
+		ret = -1;
+	}
+	sig_ctx_clear(&ko->graph.ctx);
+	if (sig_graph_run(&ko->graph, data_l) != 0)
+	{
+		printf("graph ctx: error not cleared\n");
+		ret = -1;
+	}
+
+	// the legacy error state of the calling thread is not touched by the graph
+	sig_errno = SIG_ERR_NWINDOW;
+	if ((sig_graph_run(&ok->graph, 1) != 0) || (sig_errno != SIG_ERR_NWINDOW))
+	{
+		printf("graph ctx: legacy error state mixed with the graph context\n");
+		ret = -1;
+	}
+	sig_errno = 0;
+
+	free(ok->output);
+	free(ko->output);
+	free(ok);
+	free(ko);
+	free(rec);
+	return ret;
+}
@@ -0,0 +1,51 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_GRAPH_H_
+#define TEST_GRAPH_H_
+
+
+/**
+ * @brief test the compiled graph evaluation against the recursive evaluation
+ * @param[in] data array of array of float
+ * @param[in] data_l number of elements in the arrays
+ * @param[in] output array the test will write the PID output to
+ * @return 0 on success
+ */
+int test_graph(float **data, int data_l, float* output);
+
+/**
+ * @brief test a compiled graph with missing sources, and a source shared by an undescribed sig-func and a node
+ * @param[in] data array of array of float
+ * @param[in] data_l number of elements in the arrays
+ * @return 0 on success
+ */
+int test_graph_partial(float **data, int data_l);
+
+/**
+ * @brief run two graphs concurrently, one of them failing, and check that their evaluation contexts are independent
+ * @param[in] data array of array of float
+ * @param[in] data_l number of elements in the arrays
+ * @return 0 on success
+ */
+int test_graph_ctx(float **data, int data_l);
+
+
+#endif	// TEST_GRAPH_H_
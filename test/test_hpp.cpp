@@ -0,0 +1,125 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdio.h>
+#include "sig.hpp"
+#include "test_hpp.h"
+
+#define TEST_HPP_OVER	16							// samples evaluated after the end of the data (sticking readers)
+
+
+/**
+ * @brief sig_buf_read_f() parameters reading a column of the data
+ */
+static struct sig_buf_read_param_f test_hpp_buf(float *column, int data_l)
+{
+	struct sig_buf_read_param_f p = {};
+
+	p.buffer = column;
+	p.size = data_l;
+	p.check_buffer = 1;
+	return p;
+}
+
+
+int test_hpp(float **data, int data_l)
+{
+	struct sig_buf_read_param_f buf_p[5];
+	struct signal_float buf[5];
+	struct sig_pid_param_f pid_p = {};
+	struct signal_float pid = SIG_FN(sig_pid_opt_f, &pid_p);
+	struct sig_iirlp1_param_f lp_p = {.a = 0.25, .oma = 0.75, .n_last = 0, .source = &pid};
+	struct signal_float lp = SIG_FN(sig_iirlp1_f, &lp_p);
+	const sig::pid_gains gains = {1.0, 0.1, 1.0, 5.0, {1.0, 2.0, 3.0}};
+	float out[2][64], scale = 0.5, y, x;
+	int i, k, ret = 0;
+	n_t n;
+
+	for (i=0; i<5; i++)
+	{
+		buf_p[i] = test_hpp_buf(data[i], data_l);
+		buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &buf_p[i]);
+	}
+	pid_p.p = gains.p;
+	pid_p.i = gains.i;
+	pid_p.d = gains.d;
+	pid_p.max_output = gains.max_output;
+	for (i=0; i<3; i++)
+		pid_p.ff[i] = gains.ff[i];
+	pid_p.setpoint = &buf[0];
+	pid_p.feedback = &buf[1];
+	pid_p.ff0 = &buf[2];
+	pid_p.ff1 = &buf[3];
+	pid_p.ff2 = &buf[4];
+	sig_pid_compute_k_f(&pid);
+
+	// the same graph, as an expression
+	auto expr = sig::pid(sig::buf(data[0], data_l) - sig::buf(data[1], data_l), gains,
+		sig::buf(data[2], data_l), sig::buf(data[3], data_l), sig::buf(data[4], data_l));
+	// adapter from a signal_float: filter the C PID
+	auto filtered = sig::iirlp1(sig::from(pid), 0.25);
+	// arithmetic, with a number and a variable
+	auto arith = (-sig::buf_circular(data[0], data_l, 3) * 2 + 1) / sig::var(scale) - sig::cst(0.5);
+	// adapter to a signal_float, evaluated by blocks
+	auto node = sig::to_signal(sig::pid(sig::buf(data[0], data_l) - sig::buf(data[1], data_l), gains,
+		sig::buf(data[2], data_l), sig::buf(data[3], data_l), sig::buf(data[4], data_l)));
+	auto node_ref = sig::to_signal(expr);
+
+	for (n=1; (n<(n_t)data_l + TEST_HPP_OVER) && (ret == 0); n++)
+	{
+		y = expr(n);
+		if (y != sig_get_value_f(&pid, n))
+		{
+			printf("hpp: pid n=%u: %.9g, expected %.9g\n", n, y, pid.x_cst);
+			ret = -1;
+		}
+		y = filtered(n);
+		if (y != sig_get_value_f(&lp, n))
+		{
+			printf("hpp: from n=%u: %.9g, expected %.9g\n", n, y, lp.x_cst);
+			ret = -1;
+		}
+		x = (-data[0][(n + 3) % data_l] * 2 + 1) / scale - 0.5;
+		y = arith(n);
+		if (y != x)
+		{
+			printf("hpp: arithmetic n=%u: %.9g, expected %.9g\n", n, y, x);
+			ret = -1;
+		}
+		if ((n % 7) == 0)
+			scale += 0.25;
+	}
+
+	// block and per-sample evaluations of the adapter, irregular blocks overlapping by one sample (memoization)
+	for (n=1; (n<(n_t)data_l + TEST_HPP_OVER) && (ret == 0); n+=k-1)
+	{
+		k = 2 + (n % 23);
+		sig_get_block_f(&node.signal, n, k, out[0]);
+		for (i=0; i<k; i++)
+			out[1][i] = sig_get_value_f(&node_ref.signal, n + i);
+		for (i=0; (i<k) && (ret == 0); i++)
+			if (out[0][i] != out[1][i])
+			{
+				printf("hpp: to_signal n=%u: block %.9g, sample %.9g\n", n + i, out[0][i], out[1][i]);
+				ret = -1;
+			}
+	}
+	return ret;
+}
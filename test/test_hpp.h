@@ -0,0 +1,37 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_HPP_H_
+#define TEST_HPP_H_
+
+
+/**
+ * @brief test the C++ expression templates (sig.hpp) against the equivalent sig-func
+ * @details a PID with Feed-Forward, written as an expression, must give the same values as sig_pid_opt_f().
+ * The signal_float adapters are tested in both directions, per-sample and by block
+ * @return 0 on success
+ */
+#ifdef __cplusplus
+extern "C"
+#endif
+int test_hpp(float **data, int data_l);
+
+
+#endif	// TEST_HPP_H_
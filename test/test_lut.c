@@ -0,0 +1,183 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+
+#define TEST_LUT_LEN		3000					// inputs of each run
+
+
+/**
+ * @brief linear interpolation of the breakpoints in double precision, x clamped to the table
+ */
+static double test_lut_ref(const float *bx, const float *by, int size, float x)
+{
+	int i;
+
+	if (!(x > bx[0]))
+		return by[0];
+	if (x >= bx[size - 1])
+		return by[size - 1];
+	for (i=0; bx[i + 1] <= x; i++)
+		;
+	return by[i] + ((double)x - bx[i]) * ((double)by[i + 1] - by[i]) / ((double)bx[i + 1] - bx[i]);
+}
+
+
+/**
+ * @brief run one table on the inputs, two signals sharing it
+ */
+static int test_lut_run(const struct sig_lut_table_f *table, const float *bx, const float *by, float *input)
+{
+	struct sig_buf_read_param_f src_p = {.buffer = input, .size = TEST_LUT_LEN, .check_buffer = 1};
+	struct signal_float src = SIG_FNB(sig_buf_read_f, sig_buf_read_block_f, &src_p);
+	struct sig_lut_param_f sample_p = {.table = table, .source = &src}, block_p = sample_p, graph_p = sample_p;
+	struct signal_float sample = SIG_FN(sig_lut_f, &sample_p);
+	struct signal_float blk = SIG_FNB(sig_lut_f, sig_lut_block_f, &block_p);
+	struct signal_float compiled = SIG_FN(sig_lut_f, &graph_p);
+	struct signal_float *roots[1] = {&compiled};
+	struct sig_graph_node nodes[2];
+	struct sig_graph graph;
+	float out[TEST_LUT_LEN], y, y_max = 0;
+	double ref, tol;
+	int i, k, ret = 0;
+	n_t n;
+
+	sig_graph_init(&graph, nodes, 2);
+	if (sig_graph_compile(&graph, roots, 1, NULL, 0))
+		return -1;
+	for (i=0; i<table->size; i++)
+		y_max = max(y_max, fabsf(by[i]));
+
+	for (n=1; n<TEST_LUT_LEN; n+=k)
+	{
+		k = min(1 + (n % 53), TEST_LUT_LEN - n);						// irregular blocks
+		sig_get_block_f(&blk, n, k, out + n);
+	}
+	for (n=1; (n<TEST_LUT_LEN) && (ret == 0); n++)
+	{
+		y = sig_get_value_f(&sample, n);
+		sig_graph_run(&graph, n);
+		ref = test_lut_ref(bx, by, table->size, input[n]);
+		// the uniform grid rounds the position of the input: about slope * |x| * FLT_EPSILON, slope and |x| below 4
+		tol = FLT_EPSILON * (4 * y_max + (table->uniform ? 32 : 0));
+		if ((fabs(y - ref) > tol) || (out[n] != y) || (compiled.x_cst != y))
+		{
+			printf("lut: %s table of %d, n=%u, x=%g: sample %.9g, block %.9g, compiled %.9g, expected %.9g\n",
+				table->uniform ? "uniform" : "non-uniform", table->size, n, input[n], y, out[n], compiled.x_cst, ref);
+			ret = -1;
+		}
+	}
+	return ret;
+}
+
+
+/**
+ * @brief uniform and non-uniform tables of size breakpoints, on the same inputs
+ */
+static int test_lut_size(float *input, int size)
+{
+	struct sig_lut_table_f uniform, pwl;
+	float *bx = malloc(size * sizeof(float)), *by = malloc(size * sizeof(float));
+	int i, ret = 0;
+
+	// uniform grid from -2 to 3
+	for (i=0; i<size; i++)
+	{
+		bx[i] = -2 + 5.0 * i / (size - 1);
+		by[i] = sin(bx[i] * 3) + 0.1 * bx[i];
+	}
+	bx[size - 1] = 3;
+	if (sig_lut_uniform_init_f(&uniform, -2, 3, by, size))
+		return -1;
+	if (test_lut_run(&uniform, bx, by, input))
+		ret = -1;
+	sig_lut_free_f(&uniform);
+
+	// non-uniform grid, denser around 0
+	for (i=0; i<size; i++)
+	{
+		bx[i] = (double)(2 * i - (size - 1)) / (size - 1);
+		bx[i] = 2.5 * bx[i] * fabs(bx[i]) + 0.5 + 0.01 * bx[i];
+		by[i] = sin(bx[i] * 3) + 0.1 * bx[i];
+	}
+	if (sig_lut_pwl_init_f(&pwl, bx, by, size))
+		return -1;
+	if (test_lut_run(&pwl, bx, by, input))
+		ret = -1;
+	sig_lut_free_f(&pwl);
+
+	free(bx);
+	free(by);
+	return ret;
+}
+
+
+int test_lut(void)
+{
+	static const int sizes[] = {2, 3, 17, 256, 1000, 4096};
+	static const float bad_x[] = {0, 1, 1, 2};
+	struct sig_lut_table_f table;
+	float input[TEST_LUT_LEN];
+	unsigned int seed = 7;
+	enum sig_fir_kernel_t kernel;
+	int i, ret = 0;
+
+	// slow walk, then random jumps, then out of range values and NaN
+	for (i=0; i<TEST_LUT_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		if (i < TEST_LUT_LEN / 2)
+			input[i] = 2.5 * sin(i * 0.01);
+		else
+			input[i] = (float)(seed >> 8) / (1 << 24) * 6.0 - 2.5;
+	}
+	input[TEST_LUT_LEN - 10] = NAN;
+	input[TEST_LUT_LEN - 9] = INFINITY;
+	input[TEST_LUT_LEN - 8] = -INFINITY;
+	input[TEST_LUT_LEN - 7] = 1e30;
+
+	if (!sig_lut_pwl_init_f(&table, bad_x, bad_x, 4) || !sig_lut_pwl_init_f(&table, bad_x, bad_x, 1) ||
+		!sig_lut_uniform_init_f(&table, 1, 1, bad_x, 4))
+	{
+		printf("lut: invalid table accepted\n");
+		ret = -1;
+	}
+
+	for (kernel = SIG_FIR_KERNEL_C; kernel <= SIG_FIR_KERNEL_AVX512; kernel++)
+	{
+		if (sig_lut_kernel_f(kernel))
+			continue;						// not supported by this CPU
+		for (i=0; i<sizeof(sizes)/sizeof(sizes[0]); i++)
+			if (test_lut_size(input, sizes[i]))
+			{
+				printf("lut: kernel %d failed\n", kernel);
+				ret = -1;
+			}
+	}
+	sig_lut_kernel_f(SIG_FIR_KERNEL_AUTO);
+	return ret;
+}
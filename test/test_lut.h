@@ -0,0 +1,34 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#ifndef TEST_LUT_H_
+#define TEST_LUT_H_
+
+
+/**
+ * @brief test the uniform and non-uniform lookup tables against a double-precision interpolation
+ * @details per-sample, block (all the kernels supported by the CPU) and compiled evaluations must give the same
+ * values. Inputs are slow walks (cursor hits), random jumps, out of range values and NaN
+ * @return 0 on success
+ */
+int test_lut(void);
+
+
+#endif	// TEST_LUT_H_
@@ -0,0 +1,169 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigmulti.h"
+
+#define TEST_MULTI_K		19			// not a multiple of SIG_LANES, to check the padding
+#define TEST_MULTI_TAPS		6
+
+int test_multi(float **data, int data_l, float* output)
+{
+	// multi-instance graph: buf_read -> pid_opt -> limit
+	float **buffers[5];
+	struct sig_buf_read_param_multi_f buf_p[5];
+	struct signal_multi_f buf[5];
+	struct sig_pid_param_multi_f pid_p = {0};
+	struct signal_multi_f pid;
+	struct sig_limit_param_multi_f limit_p = {0};
+	struct signal_multi_f limit;
+	struct sig_multi_lane_param_f lane_p;
+	struct signal_float lane;
+	float taps[TEST_MULTI_TAPS] = {0.5, 0.25, -0.125, 0.1, 0.05, 0.025};
+	struct sig_fir_n_param_multi_f fir_p = {.tap_count = TEST_MULTI_TAPS, .taps = taps};
+	struct signal_multi_f fir;
+
+	// single-instance references
+	struct sig_buf_read_param_f ref_buf_p[TEST_MULTI_K][5];
+	struct signal_float ref_buf[TEST_MULTI_K][5];
+	struct sig_pid_param_f ref_pid_p[TEST_MULTI_K];
+	struct signal_float ref_pid[TEST_MULTI_K];
+	float ref_fir_samples[TEST_MULTI_K][TEST_MULTI_TAPS];
+	struct sig_fir_n_param_f ref_fir_p[TEST_MULTI_K];
+	struct signal_float ref_fir[TEST_MULTI_K];
+
+	float x, y;
+	int i, k, ret = 0;
+	n_t n;
+
+	for (i=0; i<5; i++)
+	{
+		buffers[i] = malloc(TEST_MULTI_K * sizeof(float *));
+		for (k=0; k<TEST_MULTI_K; k++)
+		{
+			buffers[i][k] = malloc(data_l * sizeof(float));
+			for (n=0; n<data_l; n++)
+				buffers[i][k][n] = data[i][n] * (1.0 + 0.1 * k);
+			ref_buf_p[k][i] = (struct sig_buf_read_param_f) {.buffer = buffers[i][k], .size = data_l, .check_buffer = 1};
+			ref_buf[k][i] = (struct signal_float) SIG_FN(sig_buf_read_f, &ref_buf_p[k][i]);
+		}
+		buf_p[i] = (struct sig_buf_read_param_multi_f) {.buffer = buffers[i], .size = data_l};
+		buf[i] = (struct signal_multi_f) SIG_FN_MULTI(sig_buf_read_multi_f, &buf_p[i], TEST_MULTI_K, sig_multi_array_f(TEST_MULTI_K));
+	}
+
+	sig_pid_init_multi_f(&pid_p, TEST_MULTI_K);
+	pid_p.setpoint = &buf[0];
+	pid_p.feedback = &buf[1];
+	pid_p.ff0 = &buf[2];
+	pid_p.ff1 = &buf[3];
+	pid_p.ff2 = &buf[4];
+	pid = (struct signal_multi_f) SIG_FN_MULTI(sig_pid_opt_multi_f, &pid_p, TEST_MULTI_K, sig_multi_array_f(TEST_MULTI_K));
+
+	limit_p.x_min = sig_multi_array_f(TEST_MULTI_K);
+	limit_p.x_max = sig_multi_array_f(TEST_MULTI_K);
+	limit_p.source = &pid;
+	limit = (struct signal_multi_f) SIG_FN_MULTI(sig_limit_multi_f, &limit_p, TEST_MULTI_K, sig_multi_array_f(TEST_MULTI_K));
+
+	for (k=0; k<TEST_MULTI_K; k++)
+	{
+		ref_pid_p[k] = (struct sig_pid_param_f) {
+			.p = 1.0, .i = 0.02 * k, .d = 0.5, .max_output = 2.0 + k * 0.25,
+			.setpoint = &ref_buf[k][0], .feedback = &ref_buf[k][1],
+			.ff = {1.0, 0.5, 0.1 * k}, .ff0 = &ref_buf[k][2], .ff1 = &ref_buf[k][3], .ff2 = &ref_buf[k][4]
+		};
+		ref_pid[k] = (struct signal_float) SIG_FN(sig_pid_opt_f, &ref_pid_p[k]);
+		sig_pid_compute_k_f(&ref_pid[k]);
+
+		sig_pid_compute_k_multi_f(&pid_p, k, ref_pid_p[k].p, ref_pid_p[k].i, ref_pid_p[k].d);
+		pid_p.max_output[k] = ref_pid_p[k].max_output;
+		pid_p.ff[0][k] = ref_pid_p[k].ff[0];
+		pid_p.ff[1][k] = ref_pid_p[k].ff[1];
+		pid_p.ff[2][k] = ref_pid_p[k].ff[2];
+		limit_p.x_min[k] = -1.0 - k * 0.1;
+		limit_p.x_max[k] = 1.0 + k * 0.1;
+	}
+
+	sig_fir_n_init_multi_f(&fir_p, TEST_MULTI_K);
+	fir_p.source = &buf[1];
+	fir = (struct signal_multi_f) SIG_FN_MULTI(sig_fir_n_multi_f, &fir_p, TEST_MULTI_K, sig_multi_array_f(TEST_MULTI_K));
+	memset(ref_fir_samples, 0, sizeof(ref_fir_samples));
+	for (k=0; k<TEST_MULTI_K; k++)
+	{
+		ref_fir_p[k] = (struct sig_fir_n_param_f) {.tap_count = TEST_MULTI_TAPS, .taps = taps, .samples = ref_fir_samples[k], .source = &ref_buf[k][1]};
+		ref_fir[k] = (struct signal_float) SIG_FN(sig_fir_n_f, &ref_fir_p[k]);
+	}
+
+	lane_p = (struct sig_multi_lane_param_f) {.source = &limit, .lane = 0};
+	lane = (struct signal_float) SIG_FN(sig_multi_lane_f, &lane_p);
+
+	for (n=1; (n<data_l) && (ret == 0); n++)
+	{
+		output[n] = sig_get_value_f(&lane, n);
+		for (k=0; k<TEST_MULTI_K; k++)
+		{
+			x = sig_get_value_f(&ref_pid[k], n);
+			if (memcmp(&x, &pid.x_cst[k], sizeof(float)))
+			{
+				printf("multi: n=%u, instance %d: pid %f, expecting %f\n", n, k, pid.x_cst[k], x);
+				ret = -1;
+			}
+			x = min(max(x, limit_p.x_min[k]), limit_p.x_max[k]);
+			y = sig_get_lane_f(&limit, k, n);
+			if (x != y)
+			{
+				printf("multi: n=%u, instance %d: limit %f, expecting %f\n", n, k, y, x);
+				ret = -1;
+			}
+			x = sig_get_value_f(&ref_fir[k], n);
+			y = sig_get_lane_f(&fir, k, n);
+			if (fabsf(x - y) > 1e-5 * (1 + fabsf(x)))
+			{
+				printf("multi: n=%u, instance %d: fir %f, expecting %f\n", n, k, y, x);
+				ret = -1;
+			}
+		}
+	}
+
+	for (i=0; i<5; i++)
+	{
+		for (k=0; k<TEST_MULTI_K; k++)
+			free(buffers[i][k]);
+		free(buffers[i]);
+		free(buf[i].x_cst);
+	}
+	free(fir.x_cst);
+	sig_fir_n_free_multi_f(&fir_p);
+	free(pid.x_cst);
+	free(limit.x_cst);
+	free(limit_p.x_min);
+	free(limit_p.x_max);
+	sig_pid_free_multi_f(&pid_p);
+	if (pid_p.integral || fir_p.samples)
+	{
+		printf("multi: arrays not cleared when freed\n");
+		ret = -1;
+	}
+	return ret;
+}
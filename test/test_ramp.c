@@ -0,0 +1,209 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigi.h"
+#include "siggraph.h"
+
+#define TEST_RAMP_LEN		300						// samples of each run
+
+/** n of the samples of a run: consecutive, with a jump in the middle */
+#define TEST_RAMP_N(n0, i)	((n_t)((n0) + (i) + ((i) >= TEST_RAMP_LEN / 2 ? 1000 : 0)))
+
+
+/**
+ * @brief length of the irregular block starting at sample i. Blocks stop at the jump, and at the parameter change
+ */
+static int test_ramp_block(int i)
+{
+	int k = min(1 + (i % 29), TEST_RAMP_LEN - i);
+
+	if (i < TEST_RAMP_LEN / 2)
+		k = min(k, TEST_RAMP_LEN / 2 - i);
+	else if (i < TEST_RAMP_LEN * 3 / 4)
+		k = min(k, TEST_RAMP_LEN * 3 / 4 - i);
+	return k;
+}
+
+
+/**
+ * @brief float ramp, per-sample, block and compiled, against (a * t + b) computed in double precision
+ * @details a changes after 3/4 of the run. n0 is the first n of the run
+ */
+static int test_ramp_f(float a, float b, n_t delay, n_t n0)
+{
+	struct sig_interpolate_lin_param_f sample_p = {.a = a, .b = b, .delay = delay, .n_last = n0 - 1};
+	struct sig_interpolate_lin_param_f block_p = sample_p, graph_p = sample_p;
+	struct signal_float sample = SIG_FN(sig_interpolate_lin_f, &sample_p);
+	struct signal_float blk = SIG_FNB(sig_interpolate_lin_f, sig_interpolate_lin_block_f, &block_p);
+	struct signal_float compiled = SIG_FN(sig_interpolate_lin_f, &graph_p);
+	struct signal_float *roots[1] = {&compiled};
+	struct sig_graph_node nodes[1];
+	struct sig_graph graph;
+	float out[TEST_RAMP_LEN], y, ref;
+	int i, k, ret = 0;
+	n_t n;
+
+	sig_graph_init(&graph, nodes, 1);
+	if (sig_graph_compile(&graph, roots, 1, NULL, 0))
+		return -1;
+
+	for (i=0; i<TEST_RAMP_LEN; i+=k)
+	{
+		k = test_ramp_block(i);
+		if (i == TEST_RAMP_LEN * 3 / 4)
+			block_p.a = -a;
+		sig_get_block_f(&blk, TEST_RAMP_N(n0, i), k, out + i);
+	}
+	for (i=0; (i<TEST_RAMP_LEN) && (ret == 0); i++)
+	{
+		if (i == TEST_RAMP_LEN * 3 / 4)
+			sample_p.a = graph_p.a = -a;
+		n = TEST_RAMP_N(n0, i);
+		y = sig_get_value_f(&sample, n);
+		sig_graph_run(&graph, n);
+		ref = (float)((double)sample_p.a * (n_t)(n - delay) + (double)b);
+		if ((y != ref) || (out[i] != ref) || (compiled.x_cst != ref) || (sig_get_value_f(&sample, n) != y))
+		{
+			printf("ramp_f: a=%g b=%g, t=%u: sample %.9g, block %.9g, compiled %.9g, expected %.9g\n", sample_p.a, b,
+				n - delay, y, out[i], compiled.x_cst, ref);
+			ret = -1;
+		}
+	}
+	return ret;
+}
+
+
+/**
+ * @brief integer ramp, per-sample and block, against the closed form. b changes after 3/4 of the run
+ */
+static int test_ramp_lin(int a, int b, int div, n_t delay, n_t n0)
+{
+	struct sig_interpolate_lin_param sample_p = {.a = a, .b = b, .delay = delay, .div = div, .n_last = n0 - 1};
+	struct sig_interpolate_lin_param block_p = sample_p;
+	struct signal_int sample = SIG_FN(sig_interpolate_lin, &sample_p);
+	struct signal_int blk = SIG_FNB(sig_interpolate_lin, sig_interpolate_lin_block, &block_p);
+	int out[TEST_RAMP_LEN], y, ref;
+	int i, k, ret = 0;
+	n_t n;
+
+	for (i=0; i<TEST_RAMP_LEN; i+=k)
+	{
+		k = test_ramp_block(i);
+		if (i == TEST_RAMP_LEN * 3 / 4)
+			block_p.b = b + 7;
+		sig_get_block_i(&blk, TEST_RAMP_N(n0, i), k, out + i);
+	}
+	for (i=0; (i<TEST_RAMP_LEN) && (ret == 0); i++)
+	{
+		if (i == TEST_RAMP_LEN * 3 / 4)
+			sample_p.b = b + 7;
+		n = TEST_RAMP_N(n0, i);
+		y = sig_value(&sample, n);
+		ref = (int)(((long long)a * (n_t)(n - delay) + sample_p.b) / div);
+		if ((y != ref) || (out[i] != ref))
+		{
+			printf("ramp_lin: a=%d b=%d div=%d, t=%u: sample %d, block %d, expected %d\n", a, sample_p.b, div,
+				n - delay, y, out[i], ref);
+			ret = -1;
+		}
+	}
+	return ret;
+}
+
+
+/**
+ * @brief start to stop ramp, per-sample and block, against the closed form
+ */
+static int test_ramp_st(int start, int stop, n_t n_start, n_t length, n_t n0)
+{
+	struct sig_interpolate_st_param sample_p = {.start = start, .stop = stop, .n_start = n_start, .length = length,
+		.n_last = n0 - 1};
+	struct sig_interpolate_st_param block_p = sample_p;
+	struct signal_int sample = SIG_FN(sig_interpolate_st, &sample_p);
+	struct signal_int blk = SIG_FNB(sig_interpolate_st, sig_interpolate_st_block, &block_p);
+	int out[TEST_RAMP_LEN], y, ref;
+	int i, k, ret = 0;
+	n_t n, t;
+
+	for (i=0; i<TEST_RAMP_LEN; i+=k)
+	{
+		k = test_ramp_block(i);
+		sig_get_block_i(&blk, TEST_RAMP_N(n0, i), k, out + i);
+	}
+	for (i=0; (i<TEST_RAMP_LEN) && (ret == 0); i++)
+	{
+		n = TEST_RAMP_N(n0, i);
+		y = sig_value(&sample, n);
+		t = n - n_start;
+		if ((int)t < 0)
+			ref = start;
+		else if (t >= length)
+			ref = stop;
+		else
+			ref = (int)(start + ((long long)stop - start) * t / (long long)length);
+		if ((y != ref) || (out[i] != ref))
+		{
+			printf("ramp_st: %d to %d in %u, t=%d: sample %d, block %d, expected %d\n", start, stop, length, (int)t, y,
+				out[i], ref);
+			ret = -1;
+		}
+	}
+	return ret;
+}
+
+
+int test_ramp(void)
+{
+	static const float a_f[] = {0.1, -3.7e-3, 1.5, 12345.678, 1e-30, 0};
+	static const int a_i[] = {1, -7, 1000, 2147483647, -2147483647 - 1, 0};
+	static const int div_i[] = {1, 3, -5, 1000, -2147483647 - 1};
+	int i, j, ret = 0;
+
+	for (i=0; i<sizeof(a_f)/sizeof(a_f[0]); i++)
+	{
+		if (test_ramp_f(a_f[i], 0.25, 0, 1) ||					// from the start
+			test_ramp_f(a_f[i], -3, 100, 1) ||					// n - delay rolls over to 0
+			test_ramp_f(a_f[i], 7, 0, 715827882 - 100) ||		// t_max of 1.5: 2^53 / (3 * 2^22)
+			test_ramp_f(a_f[i], 1, 1 << 30, (1u << 31) - 100) ||	// t_max of 0.1
+			test_ramp_f(a_f[i], 1, 0, 0xFFFFFFFF - 100))		// n rolls over
+			ret = -1;
+	}
+
+	for (i=0; i<sizeof(a_i)/sizeof(a_i[0]); i++)
+		for (j=0; j<sizeof(div_i)/sizeof(div_i[0]); j++)
+			if (test_ramp_lin(a_i[i], -12, div_i[j], 0, 1) ||
+				test_ramp_lin(a_i[i], 5, div_i[j], 100, 1) ||
+				test_ramp_lin(a_i[i], 2147483600, div_i[j], 0, 0xFFFFFFFF - 100))
+				ret = -1;
+
+	if (test_ramp_st(-100, 900, 20, 100, 1) ||
+		test_ramp_st(1000, -3, 20, 7, 1) ||
+		test_ramp_st(5, 6, 0, 250, 1) ||
+		test_ramp_st(-2147483647 - 1, 2147483647, 1, 200, 1) ||
+		test_ramp_st(3, 9, 50, 0, 1) ||						// step
+		test_ramp_st(-100, 900, 0xFFFFFF00, 400, 0xFFFFFF00 - 20))	// n rolls over during the ramp
+		ret = -1;
+	return ret;
+}
@@ -0,0 +1,217 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "sig.h"
+#include "sigf.h"
+#include "siggraph.h"
+#include "sigds.h"
+#include "sigreplay.h"
+
+#define TEST_REPLAY_RUNS		8
+#define TEST_REPLAY_COLS		5
+#define TEST_REPLAY_MAX_OUTPUT	5.0
+
+static const char *test_replay_names[TEST_REPLAY_COLS] = {"setpoint", "feedback", "ff0", "ff1", "ff2"};
+
+/**
+ * pid_opt(setpoint, feedback, ff0, ff1, ff2), compared to the setpoint
+ */
+struct test_replay_inst {
+	struct sig_buf_read_param_f buf_p[TEST_REPLAY_COLS];
+	struct signal_float buf[TEST_REPLAY_COLS];
+	struct sig_pid_param_f pid_p;
+	struct signal_float pid;
+	struct sig_graph_node nodes[8];
+	struct sig_graph graph;
+};
+
+static void test_replay_init(struct test_replay_inst *inst)
+{
+	int i;
+
+	for(i=0; i<TEST_REPLAY_COLS; i++)
+		inst->buf[i] = (struct signal_float) SIG_FN(sig_buf_read_f, &inst->buf_p[i]);
+	inst->pid_p = (struct sig_pid_param_f) {
+		.p = 1.0, .i = 0.1, .d = 1.0, .max_output = TEST_REPLAY_MAX_OUTPUT,
+		.setpoint = &inst->buf[0], .feedback = &inst->buf[1],
+		.ff = {1.0, 2.0, 3.0}, .ff0 = &inst->buf[2], .ff1 = &inst->buf[3], .ff2 = &inst->buf[4]
+	};
+	inst->pid = (struct signal_float) SIG_FN(sig_pid_opt_f, &inst->pid_p);
+	sig_pid_compute_k_f(&inst->pid);
+}
+
+/**
+ * @brief factory: every other instance is evaluated recursively
+ */
+static int test_replay_build(struct sig_replay_run *run, const struct sig_ds *ds, void *arg)
+{
+	struct test_replay_inst *inst = aligned_alloc(64, sizeof(struct test_replay_inst));
+	struct signal_float *root;
+	int i;
+
+	memset(inst, 0, sizeof(*inst));
+	test_replay_init(inst);
+	for(i=0; i<TEST_REPLAY_COLS; i++)
+		if(sig_ds_buf_read_f(ds, test_replay_names[i], &inst->buf_p[i]))
+		{
+			free(inst);
+			return SIG_ERR_NO_CONFIG;
+		}
+	run->output = &inst->pid;
+	run->reference = &inst->buf[0];
+	run->user = inst;
+	if(ds->header->length % 2)
+	{
+		root = &inst->pid;
+		sig_graph_init(&inst->graph, inst->nodes, 8);
+		if(sig_graph_compile(&inst->graph, &root, 1, NULL, 0))
+		{
+			free(inst);
+			return SIG_ERR_FULL;
+		}
+		run->graph = &inst->graph;
+	}
+	return 0;
+}
+
+static void test_replay_release(struct sig_replay_run *run, void *arg)
+{
+	free(run->user);
+}
+
+int test_replay(float **data, int data_l)
+{
+	char dir[] = "/tmp/test_replay_XXXXXX";
+	char path[TEST_REPLAY_RUNS + 2][64];
+	const char *datasets[TEST_REPLAY_RUNS + 2];
+	struct sig_replay_result result[TEST_REPLAY_RUNS + 2];
+	struct test_replay_inst *inst;
+	struct sig_replay_stats stats;
+	struct sig_replay replay;
+	struct sig_ds out;
+	float *setpoint, *column[TEST_REPLAY_COLS], *expected, x, e, max_output;
+	double sq;
+	int i, k, length, saturated, lines = 0, ret = 0;
+	char line[256];
+	FILE *results;
+	n_t n;
+
+	if(mkdtemp(dir) == NULL)
+		return -1;
+	inst = aligned_alloc(64, sizeof(struct test_replay_inst));
+	expected = calloc(data_l, sizeof(float));
+	setpoint = malloc(data_l * sizeof(float));
+	column[0] = setpoint;
+	memcpy(&column[1], &data[1], (TEST_REPLAY_COLS - 1) * sizeof(float*));
+
+	// run k: setpoint scaled by 1 + k, length data_l - k % 2 (odd lengths are evaluated by a compiled graph)
+	for(k=0; k<TEST_REPLAY_RUNS; k++)
+	{
+		for(i=0; i<data_l; i++)
+			setpoint[i] = data[0][i] * (1 + k);
+		sprintf(path[k], "%s/run%d", dir, k);
+		datasets[k] = path[k];
+		if(sig_ds_write_f(path[k], test_replay_names, (const float * const*)column, TEST_REPLAY_COLS, data_l - k % 2))
+			ret = -1;
+	}
+	// a dataset without ff2, and a missing file
+	sprintf(path[k], "%s/noff2", dir);
+	datasets[k] = path[k];
+	if(sig_ds_write_f(path[k], test_replay_names, (const float * const*)data, TEST_REPLAY_COLS - 1, data_l))
+		ret = -1;
+	sprintf(path[k + 1], "%s/missing", dir);
+	datasets[k + 1] = path[k + 1];
+
+	results = tmpfile();
+	replay = (struct sig_replay) {.build = test_replay_build, .release = test_replay_release, .datasets = datasets,
+		.count = TEST_REPLAY_RUNS + 2, .threads = 4, .saturation = TEST_REPLAY_MAX_OUTPUT, .results = results,
+		.output_dir = dir, .result = result};
+	if((sig_replay_run(&replay, &stats) != -1) || (stats.runs != TEST_REPLAY_RUNS + 2) || (stats.failed != 2)
+			|| (result[TEST_REPLAY_RUNS].err != SIG_ERR_NO_CONFIG) || (result[TEST_REPLAY_RUNS + 1].err != -1))
+	{
+		printf("replay: %d runs, %d failed\n", stats.runs, stats.failed);
+		ret = -1;
+	}
+
+	// serial evaluation of each run
+	for(k=0; (k<TEST_REPLAY_RUNS) && (ret == 0); k++)
+	{
+		length = data_l - k % 2;
+		for(i=0; i<data_l; i++)
+			setpoint[i] = data[0][i] * (1 + k);
+		memset(inst, 0, sizeof(*inst));
+		test_replay_init(inst);
+		for(i=0; i<TEST_REPLAY_COLS; i++)
+			inst->buf_p[i] = (struct sig_buf_read_param_f) {.buffer = column[i], .size = length};
+		sq = 0;
+		max_output = 0;
+		saturated = 0;
+		for(n=1; n<length; n++)
+		{
+			x = sig_get_value_f(&inst->pid, n);
+			e = x - setpoint[n];
+			sq += (double)e * e;
+			max_output = fmaxf(max_output, fabsf(x));
+			saturated += fabsf(x) >= TEST_REPLAY_MAX_OUTPUT;
+			expected[n] = x;
+		}
+		if(result[k].err || (result[k].samples != length - 1) || (result[k].rms_error != sqrt(sq / (length - 1)))
+				|| (result[k].max_output != max_output) || (result[k].saturated != saturated))
+		{
+			printf("replay: run %d: err %d, %llu samples, rms %g (%g), max %g (%g), saturated %llu (%d)\n", k, result[k].err,
+				(unsigned long long)result[k].samples, result[k].rms_error, sqrt(sq / (length - 1)), result[k].max_output,
+				max_output, (unsigned long long)result[k].saturated, saturated);
+			ret = -1;
+		}
+		sprintf(line, "%s.out", path[k]);
+		if(sig_ds_open(&out, line) || (out.header->length != (uint64_t)length)
+				|| memcmp(sig_ds_column_f(&out, 0) + 1, expected + 1, (length - 1) * sizeof(float)))
+		{
+			printf("replay: run %d: wrong output\n", k);
+			ret = -1;
+		}
+		sig_ds_close(&out);
+		unlink(line);
+	}
+
+	// one results line per run, after the header
+	rewind(results);
+	while(fgets(line, sizeof(line), results))
+		lines++;
+	fclose(results);
+	if(lines != TEST_REPLAY_RUNS + 3)
+	{
+		printf("replay: %d lines of results\n", lines);
+		ret = -1;
+	}
+
+	for(k=0; k<TEST_REPLAY_RUNS + 1; k++)
+		unlink(path[k]);
+	rmdir(dir);
+	free(setpoint);
+	free(expected);
+	free(inst);
+	return ret;
+}
@@ -20,6 +20,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include "sig.h"
 #include "sigf.h"
 #include "scope.h"
@@ -132,5 +134,401 @@ int test_scope(float **data, int data_l, float* output)
 	for(i=0; i<(scope.samples * scope.signals_count_float); i++)
 		printf("%f%c", ((float*)scope.buffer)[i], ( (i+1) % scope.signals_count_float ? ',' : '\n'));
 	
+	scope_free(&scope);
 	return 0;
 }
+
+
+#define TEST_STREAM_TICKS	200000
+
+struct test_stream_ctx {
+	const float *ref;									//!< expected value at n. NULL: the value is n
+	n_t n_last;											//!< n of the last received frame
+	int frames;											//!< frames received
+	int errors;
+};
+
+static void test_stream_cb(scope_t *self, const void *frames, int count, void *arg)
+{
+	struct test_stream_ctx *ctx = (struct test_stream_ctx*)arg;
+	const char *frame = (const char*)frames;
+	n_t n;
+	float x;
+	int i;
+
+	for(i=0; i<count; i++, frame += self->frame_bytes)
+	{
+		n = *(const n_t*)frame;
+		x = *(const float*)(frame + sizeof(n_t));
+		if((ctx->frames && (n <= ctx->n_last)) || (x != (ctx->ref ? ctx->ref[n] : (float)n)))
+			ctx->errors++;
+		ctx->n_last = n;
+		ctx->frames++;
+	}
+}
+
+int test_scope_stream(float **data, int data_l, float* output)
+{
+	static char ring[8 * (sizeof(n_t) + sizeof(float)) + 10];	// rounded down to 8 frames
+	static char ring_thread[4096];
+	struct sig_buf_read_param_f src_p = {.buffer = data[0], .size = data_l, .check_buffer = 1};
+	struct signal_float src = SIGN_FN("setpoint", sig_buf_read_f, &src_p);
+	float counter;
+	struct signal_float counter_sig = SIGN_PTR("counter", &counter);
+	struct test_stream_ctx ctx;
+	scope_t s;
+	n_t n;
+	int ret = 0;
+
+	// drained by the caller: every sample is received
+	scope_init(&s, ring, sizeof(ring));
+	s.signals_float[0] = &src;
+	s.signals_count_float = 1;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.ref = data[0];
+	if(scope_stream_start(&s, test_stream_cb, &ctx, 0) || (s.stream_mask != 7))
+		return -1;
+	for(n=1; n<data_l; n++)
+	{
+		scope_update(&s, n);
+		if((n % 4) == 0)
+			scope_stream_drain(&s);
+	}
+	scope_stream_stop(&s);
+	if(ctx.errors || (ctx.frames != data_l - 1) || s.overruns)
+	{
+		printf("scope stream: %d frames, %d errors, %u overruns\n", ctx.frames, ctx.errors, s.overruns);
+		ret = -1;
+	}
+
+	// not drained: the ring keeps the first 8 frames, the others are counted as overruns
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.ref = data[0];
+	scope_stream_start(&s, test_stream_cb, &ctx, 0);
+	for(n=1; n<=20; n++)
+		scope_update(&s, n);
+	scope_stream_stop(&s);
+	if(ctx.errors || (ctx.frames != 8) || (ctx.n_last != 8) || (s.overruns != 12))
+	{
+		printf("scope stream overrun: %d frames, %d errors, %u overruns\n", ctx.frames, ctx.errors, s.overruns);
+		ret = -1;
+	}
+
+	// predivisor
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.ref = data[0];
+	s.prediv = 3;
+	scope_stream_start(&s, test_stream_cb, &ctx, 0);
+	for(n=1; n<=21; n++)
+	{
+		scope_update(&s, n);
+		scope_stream_drain(&s);
+	}
+	scope_stream_stop(&s);
+	if(ctx.errors || (ctx.frames != 7) || (ctx.n_last != 19))
+	{
+		printf("scope stream prediv: %d frames, %d errors\n", ctx.frames, ctx.errors);
+		ret = -1;
+	}
+
+	// consumer thread: frames are in order, and every sample is either received or counted as an overrun
+	scope_init(&s, ring_thread, sizeof(ring_thread));
+	s.signals_float[0] = &counter_sig;
+	s.signals_count_float = 1;
+	memset(&ctx, 0, sizeof(ctx));
+	if(scope_stream_start(&s, test_stream_cb, &ctx, 1))
+		return -1;
+	for(n=0; n<TEST_STREAM_TICKS; n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+	}
+	scope_stream_stop(&s);
+	if(ctx.errors || (ctx.frames + s.overruns != TEST_STREAM_TICKS))
+	{
+		printf("scope stream thread: %d frames, %d errors, %u overruns\n", ctx.frames, ctx.errors, s.overruns);
+		ret = -1;
+	}
+
+	return ret;
+}
+
+
+#define TEST_TRIG_LEN		200
+#define TEST_TRIG_DEPTH		16
+
+/**
+ * @brief run a triggered capture of (n, pulse) and check it holds n = first to first + samples - 1
+ */
+static int test_trigger_run(const char *name, const struct scope_trigger_t *trig, n_t trig_n, int trig_index, int samples)
+{
+	static float pulse[TEST_TRIG_LEN];
+	static char buffer[TEST_TRIG_DEPTH * 2 * sizeof(float)];
+	struct sig_buf_read_param_f pulse_p = {.buffer = pulse, .size = TEST_TRIG_LEN, .check_buffer = 1};
+	struct signal_float pulse_sig = SIGN_FN("pulse", sig_buf_read_f, &pulse_p);
+	float counter;
+	struct signal_float counter_sig = SIGN_PTR("counter", &counter);
+	scope_t s;
+	n_t n, first;
+	int i;
+
+	for(i=0; i<TEST_TRIG_LEN; i++)
+		pulse[i] = ((i >= 100) && (i < 106)) ? 1.0 : 0.0;
+
+	scope_init(&s, buffer, sizeof(buffer));
+	s.signals_float[0] = &counter_sig;
+	s.signals_float[1] = &pulse_sig;
+	s.signals_count_float = 2;
+	s.state = SCOPE_READY;
+	if(scope_set_trigger(&s, trig))
+	{
+		printf("scope trigger %s: rejected\n", name);
+		return -1;
+	}
+	for(n=1; n<TEST_TRIG_LEN; n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+	}
+
+	if((s.state != SCOPE_SAMPLED) || (s.trig_n != trig_n) || (s.trig_index != trig_index) || (s.samples != samples))
+	{
+		printf("scope trigger %s: state %d, trig_n %u, trig_index %d, samples %d\n", name, s.state, s.trig_n, s.trig_index, s.samples);
+		return -1;
+	}
+	first = trig_n - trig_index;
+	for(i=0; i<samples; i++)
+	{
+		if((((float*)buffer)[2 * i] != (float)(first + i)) || (((float*)buffer)[2 * i + 1] != pulse[first + i]))
+		{
+			printf("scope trigger %s: sample %d is (%f, %f)\n", name, i, ((float*)buffer)[2 * i], ((float*)buffer)[2 * i + 1]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int test_scope_trigger(void)
+{
+	struct scope_trigger_t trig = {.channel = 1, .level = 0.5, .high = 0.5, .pretrig = 4};
+	int ret = 0;
+
+	trig.type = SCOPE_TRIG_RISING;
+	ret |= test_trigger_run("rising", &trig, 100, 4, TEST_TRIG_DEPTH);
+	trig.type = SCOPE_TRIG_FALLING;
+	ret |= test_trigger_run("falling", &trig, 106, 4, TEST_TRIG_DEPTH);
+	trig.type = SCOPE_TRIG_LEVEL;
+	ret |= test_trigger_run("level", &trig, 100, 4, TEST_TRIG_DEPTH);
+	trig.type = SCOPE_TRIG_WINDOW;
+	trig.level = -0.5;
+	ret |= test_trigger_run("window", &trig, 100, 4, TEST_TRIG_DEPTH);
+
+	// n-window, and pre-trigger depth not reached yet
+	trig.type = SCOPE_TRIG_NWINDOW;
+	trig.n_min = 3;
+	trig.n_max = 10;
+	trig.pretrig = 6;
+	ret |= test_trigger_run("n-window", &trig, 3, 2, 2 + TEST_TRIG_DEPTH - 6);
+
+	// trigger on the first channel, no pre-trigger
+	trig.type = SCOPE_TRIG_LEVEL;
+	trig.channel = 0;
+	trig.level = 50;
+	trig.pretrig = 0;
+	ret |= test_trigger_run("no pretrig", &trig, 50, 0, TEST_TRIG_DEPTH);
+
+	// the pre-trigger depth must leave room for the trigger sample
+	{
+		static float buffer[TEST_TRIG_DEPTH];
+		struct signal_float sig = SIGN_CST("cst", 0.0);
+		scope_t s;
+
+		scope_init(&s, buffer, sizeof(buffer));
+		s.signals_float[0] = &sig;
+		s.signals_count_float = 1;
+		trig.pretrig = TEST_TRIG_DEPTH;
+		if(scope_set_trigger(&s, &trig) == 0)
+			ret = -1;
+	}
+
+	// a setup after scope_set_trigger() halves the depth below pretrig: the scope is not armed
+	{
+		static float buffer[TEST_TRIG_DEPTH];
+		struct signal_float a = SIGN_CST("a", 0.0);
+		struct signal_float b = SIGN_CST("b", 0.0);
+		scope_t s;
+		n_t n;
+
+		scope_init(&s, buffer, sizeof(buffer));
+		scope_enlist_sig_float(&s, &a);
+		scope_enlist_sig_float(&s, &b);
+		scope_setup(&s, "a", 1);
+		trig.level = -1;
+		trig.pretrig = TEST_TRIG_DEPTH - 2;
+		if(scope_set_trigger(&s, &trig))
+			ret = -1;
+		scope_setup(&s, "a,b", 1);
+		for(n=1; n<TEST_TRIG_LEN; n++)
+			scope_update(&s, n);
+		if(s.state != SCOPE_READY)
+		{
+			printf("scope trigger: armed with pretrig %d in %d samples (state %d)\n", s.trig.pretrig, scope_max_samples(&s), s.state);
+			ret = -1;
+		}
+		scope_free(&s);
+	}
+
+	return ret;
+}
+
+
+#define TEST_FMT_LEN		600
+
+/**
+ * @brief check count decoded samples of channel against x, within tol + rel * |x|. Samples [skip_from; skip_to[ are not checked
+ */
+static int test_format_check(scope_t *s, const char *name, int channel, const float *x, float tol, float rel, int skip_from, int skip_to)
+{
+	static float out[TEST_FMT_LEN];
+	int i;
+
+	if(scope_read_f(s, channel, 0, s->samples, out))
+	{
+		printf("scope format %s: read failed\n", name);
+		return -1;
+	}
+	for(i=0; i<s->samples; i++)
+	{
+		if((i >= skip_from) && (i < skip_to))
+			continue;
+		if(!(fabsf(out[i] - x[i]) <= tol + rel * fabsf(x[i])))
+		{
+			printf("scope format %s: sample %d is %f instead of %f\n", name, i, out[i], x[i]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int test_scope_format(void)
+{
+	static char buffer[1024];
+	static float wave[TEST_FMT_LEN], step[TEST_FMT_LEN], expect[TEST_FMT_LEN];
+	struct sig_buf_read_param_f wave_p = {.buffer = wave, .size = TEST_FMT_LEN, .check_buffer = 1};
+	struct sig_buf_read_param_f wave8_p = wave_p, wave16_p = wave_p;
+	struct sig_buf_read_param_f step_p = {.buffer = step, .size = TEST_FMT_LEN, .check_buffer = 1};
+	struct signal_float wave_sig = SIGN_FN("wave", sig_buf_read_f, &wave_p);
+	struct signal_float step_sig = SIGN_FN("step", sig_buf_read_f, &step_p);
+	struct signal_float wave8 = SIGN_FN("wave8", sig_buf_read_f, &wave8_p);
+	struct signal_float wave16 = SIGN_FN("wave16", sig_buf_read_f, &wave16_p);
+	int counter;
+	struct signal_int counter_sig = SIGN_PTR("counter", &counter);
+	struct scope_format_t formats[] = {
+		{SCOPE_FMT_RAW, 1, 0},
+		{SCOPE_FMT_INT8, 0.015, 0},
+		{SCOPE_FMT_INT16, 1e-4, 0},
+		{SCOPE_FMT_FLOAT16, 1, 0},
+		{SCOPE_FMT_DELTA16, 1e-3, 0},
+	};
+	struct scope_trigger_t trig = {.type = SCOPE_TRIG_LEVEL, .channel = 0, .level = 300, .pretrig = 10};
+	char names[] = "counter,wave8,wave16,wave,step";
+	char names_trig[] = "counter,step";
+	scope_t s;
+	n_t n;
+	int i, ret = 0;
+
+	for(i=0; i<TEST_FMT_LEN; i++)
+	{
+		wave[i] = sinf(i * 0.1) * 1.5;
+		step[i] = (i < 50 ? 0 : 100) + sinf(i * 0.05) * 3;			// a jump of 100000 codes, caught up in 4 samples
+	}
+
+	scope_init(&s, buffer, sizeof(buffer));
+	scope_enlist_sig_int(&s, &counter_sig);
+	scope_enlist_sig_float(&s, &wave8);
+	scope_enlist_sig_float(&s, &wave16);
+	scope_enlist_sig_float(&s, &wave_sig);
+	scope_enlist_sig_float(&s, &step_sig);
+
+	// raw: 4 bytes per channel
+	scope_setup(&s, names, 1);
+	if(scope_max_samples(&s) != sizeof(buffer) / (5 * 4))
+	{
+		printf("scope format: raw depth %d\n", scope_max_samples(&s));
+		ret = -1;
+	}
+
+	// int32 + int8 + int16 + float16 + delta16: 11 bytes per sample
+	scope_setup_format(&s, names, 1, formats);
+	if(scope_max_samples(&s) != sizeof(buffer) / 11)
+	{
+		printf("scope format: depth %d\n", scope_max_samples(&s));
+		ret = -1;
+	}
+	for(n=0; (n<TEST_FMT_LEN) && (s.state != SCOPE_SAMPLED); n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+	}
+	if((s.state != SCOPE_SAMPLED) || (s.samples != sizeof(buffer) / 11) || (s.n_first != 0))
+	{
+		printf("scope format: state %d, %d samples\n", s.state, s.samples);
+		return -1;
+	}
+	for(i=0; i<s.samples; i++)
+		expect[i] = i;
+	ret |= test_format_check(&s, "raw", 0, expect, 0, 0, 0, 0);
+	ret |= test_format_check(&s, "int8", 1, wave, 0.0075 * 1.001, 0, 0, 0);
+	ret |= test_format_check(&s, "int16", 2, wave, 5e-5 * 1.001, 0, 0, 0);
+	ret |= test_format_check(&s, "float16", 3, wave, 1e-7, 1.0 / 2048, 0, 0);
+	ret |= test_format_check(&s, "delta16", 4, step, 5e-4 + 1e-5, 0, 50, 54);
+	if((scope_read_f(&s, 5, 0, 1, expect) == 0) || (scope_read_f(&s, 0, 1, s.samples, expect) == 0))
+	{
+		printf("scope format: out of range read accepted\n");
+		ret = -1;
+	}
+
+	// triggered: the circular buffer wraps before the trigger, the delta base follows the oldest sample
+	scope_setup_format(&s, names_trig, 1, (struct scope_format_t[]){formats[0], formats[4]});
+	if(scope_set_trigger(&s, &trig))
+		return -1;
+	for(n=1; n<TEST_FMT_LEN; n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+	}
+	if((s.state != SCOPE_SAMPLED) || (s.samples != sizeof(buffer) / 6) || (s.trig_n != 300))
+	{
+		printf("scope format: triggered state %d, %d samples\n", s.state, s.samples);
+		return -1;
+	}
+	for(i=0; i<s.samples; i++)
+		expect[i] = s.n_first + i;
+	ret |= test_format_check(&s, "triggered raw", 0, expect, 0, 0, 0, 0);
+	ret |= test_format_check(&s, "triggered delta16", 1, step + s.n_first, 5e-4 + 1e-5, 0, 0, 0);
+
+	// a jump of 2^31 codes is caught up in the right direction
+	{
+		static float jump[5] = {0, -2e9, 2e9, 2e9, 2e9};
+		struct sig_buf_read_param_f jump_p = {.buffer = jump, .size = 5, .check_buffer = 1};
+		struct signal_float jump_sig = SIGN_FN("jump", sig_buf_read_f, &jump_p);
+		scope_t d;
+
+		scope_init(&d, buffer, 4 * sizeof(int16_t));
+		d.signals_float[0] = &jump_sig;
+		d.signals_count_float = 1;
+		d.channel[0].format = (struct scope_format_t){SCOPE_FMT_DELTA16, 1, 0};
+		d.state = SCOPE_READY;
+		for(n=1; n<6; n++)
+			scope_update(&d, n);
+		if(scope_read_f(&d, 0, 0, 4, expect) || (expect[0] != -(float)(1 << 30)) || (expect[3] != (float)(-(1 << 30) + 3 * 32767)))
+		{
+			printf("scope format: delta jump decoded as %f, %f\n", expect[0], expect[3]);
+			ret = -1;
+		}
+		scope_free(&d);
+	}
+
+	scope_free(&s);
+	return ret;
+}
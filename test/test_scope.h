@@ -31,5 +31,26 @@
  */
 int test_scope(float **data, int data_l, float* output);
 
+/**
+ * @brief test the streaming scope: drained by the caller, on overrun, with a predivisor, and by a consumer thread
+ * @param[in] data array of array of float
+ * @param[in] data_l number of elements in the arrays
+ * @param[in] output unused
+ * @return 0 on success
+ */
+int test_scope_stream(float **data, int data_l, float* output);
+
+/**
+ * @brief test the scope triggers and the pre-trigger window
+ * @return 0 on success
+ */
+int test_scope_trigger(void);
+
+/**
+ * @brief test the quantized storage formats: capture depth, decoding error, delta catch-up and triggered wrap
+ * @return 0 on success
+ */
+int test_scope_format(void);
+
 
 #endif	// TEST_PIDF_H_
@@ -0,0 +1,182 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "sig.h"
+#include "sigf.h"
+#include "scope.h"
+#include "scopefile.h"
+
+/**
+ * @brief save the scope, map the file, and check it holds (counter, setpoint) sampled from n_first every prediv
+ */
+static int test_scopefile_check(scope_t *s, float **data, int samples, n_t n_first, n_t trig_n, int trig_index)
+{
+	char path[] = "/tmp/test_scopefile_XXXXXX";
+	struct scope_file file;
+	const char *counter, *setpoint;
+	int fd, i, ret = 0;
+	n_t n;
+
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	close(fd);
+	if(scope_file_save(s, path) || scope_file_open(&file, path))
+	{
+		unlink(path);
+		return -1;
+	}
+
+	if((file.header->samples != samples) || (file.header->n_first != n_first) || (file.header->prediv != s->prediv)
+			|| (file.header->trig_n != trig_n) || (file.header->trig_index != trig_index) || (file.header->channels != 2)
+			|| (scope_file_find(&file, "counter") != 0) || (scope_file_find(&file, "setpoint") != 1)
+			|| (file.channel[0].type != SCOPE_FILE_INT32) || (file.channel[1].type != SCOPE_FILE_FLOAT32))
+	{
+		printf("scopefile: bad header: %u samples, n_first %llu, trigger %llu at %u\n", file.header->samples,
+				(unsigned long long)file.header->n_first, (unsigned long long)file.header->trig_n, file.header->trig_index);
+		ret = -1;
+	}
+
+	counter = scope_file_channel(&file, 0);
+	setpoint = scope_file_channel(&file, 1);
+	for(i=0; (ret == 0) && (i<samples); i++)
+	{
+		n = n_first + i * s->prediv;
+		if((*(const int*)counter != n) || (*(const float*)setpoint != data[0][n]))
+		{
+			printf("scopefile: sample %d is (%d, %f)\n", i, *(const int*)counter, *(const float*)setpoint);
+			ret = -1;
+		}
+		counter += file.header->frame_bytes;
+		setpoint += file.header->frame_bytes;
+	}
+
+	scope_file_close(&file);
+	unlink(path);
+	return ret;
+}
+
+int test_scopefile(float **data, int data_l, float* output)
+{
+	static char buffer[1024];
+	struct sig_buf_read_param_f setpoint_p = {.buffer = data[0], .size = data_l, .check_buffer = 1};
+	struct signal_float setpoint = SIGN_FN("setpoint", sig_buf_read_f, &setpoint_p);
+	int counter;
+	struct signal_int counter_sig = SIGN_PTR("counter", &counter);
+	struct scope_trigger_t trig = {.type = SCOPE_TRIG_NWINDOW, .n_min = 40, .n_max = 50, .pretrig = 3};
+	scope_t s;
+	n_t n;
+	int ret = 0;
+
+	// plain capture, with a predivisor
+	scope_init(&s, buffer, sizeof(buffer));
+	s.signals_int[0] = &counter_sig;
+	s.signals_count_int = 1;
+	s.signals_float[0] = &setpoint;
+	s.signals_count_float = 1;
+	s.prediv = 2;
+	s.state = SCOPE_READY;
+	for(n=10; n<data_l; n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+	}
+	ret |= test_scopefile_check(&s, data, (data_l - 10 + 1) / 2, 10, 0, 0);
+
+	// triggered capture, in 16 samples
+	scope_init(&s, buffer, 16 * (sizeof(int) + sizeof(float)));
+	s.signals_int[0] = &counter_sig;
+	s.signals_count_int = 1;
+	s.signals_float[0] = &setpoint;
+	s.signals_count_float = 1;
+	s.prediv = 2;
+	s.state = SCOPE_READY;
+	if(scope_set_trigger(&s, &trig))
+		return -1;
+	for(n=10; n<data_l; n++)
+	{
+		counter = n;
+		scope_update(&s, n);
+		if((s.state == SCOPE_ARMED) && (scope_file_write(&s, -1) == 0))
+			ret = -1;										// the buffer is circular while armed
+	}
+	ret |= test_scopefile_check(&s, data, 16, 34, 40, 3);
+
+	// quantized triggered capture: the file decodes as the scope
+	{
+		static float from_scope[32], from_file[32];
+		char path[] = "/tmp/test_scopefile_XXXXXX";
+		struct scope_file file;
+		int fd, i;
+
+		scope_init(&s, buffer, 32 * 2 * sizeof(int16_t));
+		s.signals_int[0] = &counter_sig;
+		s.signals_count_int = 1;
+		s.signals_float[0] = &setpoint;
+		s.signals_count_float = 1;
+		s.channel[0].format = (struct scope_format_t){SCOPE_FMT_INT16, 1, 0};
+		s.channel[1].format = (struct scope_format_t){SCOPE_FMT_DELTA16, 1e-4, 0};
+		s.state = SCOPE_READY;
+		trig.n_min = 50;
+		trig.n_max = 60;
+		trig.pretrig = 20;										// the buffer wraps before the trigger
+		if(scope_set_trigger(&s, &trig))
+			return -1;
+		for(n=10; n<data_l; n++)
+		{
+			counter = n;
+			scope_update(&s, n);
+		}
+		fd = mkstemp(path);
+		if(fd < 0)
+			return -1;
+		close(fd);
+		if((s.samples != 32) || scope_file_save(&s, path) || scope_file_open(&file, path))
+		{
+			unlink(path);
+			return -1;
+		}
+		if((file.header->frame_bytes != 2 * sizeof(int16_t)) || (file.channel[0].type != SCOPE_FILE_INT16)
+				|| (file.channel[1].type != SCOPE_FILE_DELTA16) || (file.channel[1].offset != sizeof(int16_t)))
+		{
+			printf("scopefile: bad quantized header\n");
+			ret = -1;
+		}
+		for(i=0; (ret == 0) && (i<2); i++)
+		{
+			if(scope_read_f(&s, i, 0, 32, from_scope) || scope_file_read_f(&file, i, 0, 32, from_file)
+					|| memcmp(from_scope, from_file, sizeof(from_file))
+					|| !(fabsf(from_scope[0] - (i ? data[0][s.n_first] : s.n_first)) <= 5e-5))
+			{
+				printf("scopefile: quantized channel %d differs\n", i);
+				ret = -1;
+			}
+		}
+		scope_file_close(&file);
+		unlink(path);
+	}
+
+	return ret;
+}
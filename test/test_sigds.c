@@ -0,0 +1,103 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigds.h"
+
+#define TEST_SIGDS_COLS		5
+
+int test_sigds(float **data, int data_l)
+{
+	const char *names[TEST_SIGDS_COLS] = {"setpoint", "feedback", "ff0", "ff1", "ff2"};
+	char path[] = "/tmp/test_sigds_XXXXXX";
+	struct sig_buf_read_param_f buf_p = {.check_buffer = 1};
+	struct signal_float buf = SIG_FN(sig_buf_read_f, &buf_p);
+	struct sig_ds ds;
+	const float *column;
+	float x;
+	FILE *f;
+	n_t n;
+	int i, ret = 0;
+
+	close(mkstemp(path));
+	if(sig_ds_write_f(path, names, (const float * const*)data, TEST_SIGDS_COLS, data_l) || sig_ds_open(&ds, path))
+	{
+		printf("sigds: cannot write or open %s\n", path);
+		unlink(path);
+		return -1;
+	}
+	if((ds.header->columns != TEST_SIGDS_COLS) || (ds.header->length != (uint64_t)data_l) || (sig_ds_find(&ds, "nope") != -1))
+	{
+		printf("sigds: wrong header\n");
+		ret = -1;
+	}
+	for(i=0; i<TEST_SIGDS_COLS; i++)
+	{
+		column = sig_ds_column_f(&ds, sig_ds_find(&ds, names[i]));
+		if((column == NULL) || ((uintptr_t)column % SIG_DS_ALIGN) || memcmp(column, data[i], data_l * sizeof(float)))
+		{
+			printf("sigds: column %s differs\n", names[i]);
+			ret = -1;
+		}
+	}
+
+	// the buffer reader reads the mapping directly
+	if(sig_ds_buf_read_f(&ds, "feedback", &buf_p) || (buf_p.buffer != sig_ds_column_f(&ds, 1)) || (buf_p.size != data_l)
+			|| (sig_ds_buf_read_f(&ds, "nope", &buf_p) == 0))
+	{
+		printf("sigds: buffer reader not set\n");
+		ret = -1;
+	}
+	for(n=1; (n<data_l) && (ret == 0); n++)
+	{
+		x = sig_get_value_f(&buf, n);
+		if(memcmp(&x, &data[1][n], sizeof(float)))
+		{
+			printf("sigds: n=%u: %f instead of %f\n", n, x, data[1][n]);
+			ret = -1;
+		}
+	}
+	sig_ds_close(&ds);
+
+	// truncated file and bad magic
+	if((truncate(path, SIG_DS_ALIGN + 4) != 0) || (sig_ds_open(&ds, path) == 0))
+	{
+		printf("sigds: truncated file opened\n");
+		ret = -1;
+	}
+	if(sig_ds_write_f(path, names, (const float * const*)data, TEST_SIGDS_COLS, data_l))
+		ret = -1;
+	f = fopen(path, "r+");
+	fputc('X', f);
+	fclose(f);
+	if(sig_ds_open(&ds, path) == 0)
+	{
+		printf("sigds: file with a bad magic opened\n");
+		ret = -1;
+	}
+	unlink(path);
+	return ret;
+}
@@ -0,0 +1,261 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigi.h"
+#include "test_pidf.h"
+
+#define TEST_SIGI_Q			16						// Q format of the PID, IIR and adder
+#define TEST_SIGI_TAPS		31
+
+/**
+ * @brief compare a fixed-point output to a float reference
+ */
+static int test_sigi_compare(const char *name, const int *x, int q, const float *ref, int len, float tol)
+{
+	int i;
+
+	for (i=0; i<len; i++)
+	{
+		if (fabsf(sig_q_to_float(x[i], q) - ref[i]) > tol)
+		{
+			printf("sigi: %s, n=%d: %f, expected %f\n", name, i, sig_q_to_float(x[i], q), ref[i]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Q16 PID over the 5 columns of data, against test_pidf()
+ */
+static int test_sigi_pid(int **qdata, int data_l, const float *ref, int block)
+{
+	struct sig_buf_read_param_q src_p[5];
+	struct signal_int src[5];
+	struct sig_pid_param_q pid_p = {
+		.q = TEST_SIGI_Q,
+		.p = sig_float_to_q(1.0, TEST_SIGI_Q),
+		.i = sig_float_to_q(0.1, TEST_SIGI_Q),
+		.d = sig_float_to_q(1.0, TEST_SIGI_Q),
+		.max_output = sig_float_to_q(5.0, TEST_SIGI_Q),
+		.setpoint = &src[0],
+		.feedback = &src[1],
+		.ff = {sig_float_to_q(1.0, TEST_SIGI_Q), sig_float_to_q(2.0, TEST_SIGI_Q), sig_float_to_q(3.0, TEST_SIGI_Q)},
+		.ff0 = &src[2],
+		.ff1 = &src[3],
+		.ff2 = &src[4],
+	};
+	struct signal_int pid = SIG_FN(sig_pid_opt_q, &pid_p);
+	int *out;
+	int i, ret;
+	n_t n;
+
+	for (i=0; i<5; i++)
+	{
+		src_p[i] = (struct sig_buf_read_param_q) {.buffer = qdata[i], .size = data_l, .check_buffer = 1};
+		src[i] = (struct signal_int) SIG_FNB(sig_buf_read_q, sig_buf_read_block_q, &src_p[i]);
+	}
+	sig_pid_compute_k_q(&pid);
+
+	out = malloc(data_l * sizeof(int));
+	if (block)
+	{
+		pid.xb = sig_pid_opt_block_q;
+		sig_get_block_i(&pid, 0, data_l, out);
+	}
+	else
+		for (n=0; n<data_l; n++)
+			out[n] = sig_value(&pid, n);
+	ret = test_sigi_compare(block ? "pid block" : "pid", out, TEST_SIGI_Q, ref, data_l, 1e-3);
+	free(out);
+	return ret;
+}
+
+
+/**
+ * @brief Q16 IIR low pass and adder, per-sample and block evaluations
+ * @param[out] out 2 * data_l values: the IIR then the adder outputs
+ */
+static void test_sigi_iir_add(int **qdata, int data_l, int *out, int block)
+{
+	struct sig_buf_read_param_q src_p = {.buffer = qdata[0], .size = data_l, .check_buffer = 1};
+	struct signal_int src = SIG_FNB(sig_buf_read_q, sig_buf_read_block_q, &src_p);
+	struct sig_iirlp1_param_q iir_p = {.a = sig_float_to_q(0.1, TEST_SIGI_Q), .q = TEST_SIGI_Q, .source = &src};
+	struct signal_int iir = SIG_FNB(sig_iirlp1_q, sig_iirlp1_block_q, &iir_p);
+	struct sig_buf_read_param_q b_p = {.buffer = qdata[1], .size = data_l, .check_buffer = 1};
+	struct signal_int b = SIG_FNB(sig_buf_read_q, sig_buf_read_block_q, &b_p);
+	struct sig_add_param_q add_p = {.a = &b, .b_cst = sig_float_to_q(-0.25, TEST_SIGI_Q)};
+	struct signal_int add = SIG_FNB(sig_add_q, sig_add_block_q, &add_p);
+	n_t n;
+
+	if (block)
+	{
+		sig_get_block_i(&iir, 1, data_l - 1, out + 1);
+		sig_get_block_i(&add, 1, data_l - 1, out + data_l + 1);
+	}
+	else
+	{
+		for (n=1; n<data_l; n++)
+		{
+			out[n] = sig_value(&iir, n);
+			out[data_l + n] = sig_value(&add, n);
+		}
+	}
+	out[0] = out[data_l] = 0;
+}
+
+
+/**
+ * @brief Q15 FIR of the setpoint column, against sig_fir_n_f() with the quantized taps and inputs
+ */
+static int test_sigi_fir(int **qdata, int data_l)
+{
+	static const enum sig_fir_kernel_t kernels[] = {SIG_FIR_KERNEL_C, SIG_FIR_KERNEL_SSE, SIG_FIR_KERNEL_AVX2, SIG_FIR_KERNEL_AVX512};
+	short taps_q[TEST_SIGI_TAPS];
+	float taps[TEST_SIGI_TAPS], *input, *ref;
+	int *in15, *out, *out_ref;
+	int i, k, ret = 0;
+	n_t n;
+
+	input = malloc(data_l * sizeof(float));
+	ref = malloc(data_l * sizeof(float));
+	in15 = malloc(data_l * sizeof(int));
+	out = malloc(data_l * sizeof(int));
+	out_ref = malloc(data_l * sizeof(int));
+
+	for (i=0; i<TEST_SIGI_TAPS; i++)
+	{
+		taps_q[i] = sig_float_to_q(0.5 / (i + 1) - 0.1, 15);
+		taps[i] = sig_q_to_float(taps_q[i], 15);
+	}
+	for (i=0; i<data_l; i++)
+	{
+		// Q15 saturates 1.0: the float filter gets the same quantized input
+		in15[i] = min(sig_float_to_q(sig_q_to_float(qdata[0][i], TEST_SIGI_Q), 15), 32767);
+		input[i] = sig_q_to_float(in15[i], 15);
+	}
+
+	{
+		struct sig_buf_read_param_f src_p = {.buffer = input, .size = data_l, .check_buffer = 1};
+		struct signal_float src = SIG_FN(sig_buf_read_f, &src_p);
+		struct sig_fir_n_param_f fir_p = {.source = &src};
+		struct signal_float fir = SIG_FN(sig_fir_n_f, &fir_p);
+
+		if (sig_fir_n_init_f(&fir_p, taps, TEST_SIGI_TAPS))
+			return -1;
+		for (n=0; n<data_l; n++)
+			ref[n] = sig_value(&fir, n);
+		sig_fir_n_free_f(&fir_p);
+	}
+
+	for (k=0; k<(int)(sizeof(kernels)/sizeof(kernels[0])); k++)
+	{
+		struct sig_buf_read_param_q src_p = {.buffer = in15, .size = data_l, .check_buffer = 1};
+		struct signal_int src = SIG_FNB(sig_buf_read_q, sig_buf_read_block_q, &src_p);
+		struct sig_fir_n_param_q fir_p = {.source = &src};
+		struct signal_int fir = SIG_FNB(sig_fir_n_q, sig_fir_n_block_q, &fir_p);
+
+		if (sig_fir_kernel_q(kernels[k]))
+			continue;
+		if (sig_fir_n_init_q(&fir_p, taps_q, TEST_SIGI_TAPS, 15))
+			return -1;
+		if (k & 1)
+			sig_get_block_i(&fir, 0, data_l, out);
+		else
+			for (n=0; n<data_l; n++)
+				out[n] = sig_value(&fir, n);
+		sig_fir_n_free_q(&fir_p);
+
+		if (k == 0)
+		{
+			memcpy(out_ref, out, data_l * sizeof(int));
+			ret |= test_sigi_compare("fir", out, 15, ref, data_l, 1e-3);
+		}
+		else if (memcmp(out_ref, out, data_l * sizeof(int)))
+		{
+			printf("sigi: fir kernel %d differs from the C kernel\n", kernels[k]);
+			ret = -1;
+		}
+	}
+	sig_fir_kernel_q(SIG_FIR_KERNEL_AUTO);
+
+	free(input);
+	free(ref);
+	free(in15);
+	free(out);
+	free(out_ref);
+	return ret;
+}
+
+
+int test_sigi(float **data, int data_l, float* output)
+{
+	int *qdata[5], *iir_add, *iir_add_block;
+	float *ref;
+	int i, j, ret = 0;
+
+	for (j=0; j<5; j++)
+	{
+		qdata[j] = malloc(data_l * sizeof(int));
+		for (i=0; i<data_l; i++)
+			qdata[j][i] = sig_float_to_q(data[j][i], TEST_SIGI_Q);
+	}
+
+	// PID: float reference from test_pidf()
+	test_pidf(data, data_l, output);
+	ret |= test_sigi_pid(qdata, data_l, output, 0);
+	ret |= test_sigi_pid(qdata, data_l, output, 1);
+
+	// IIR and adder: float references computed inline, block path must be bitwise equal
+	iir_add = malloc(2 * data_l * sizeof(int));
+	iir_add_block = malloc(2 * data_l * sizeof(int));
+	ref = malloc(2 * data_l * sizeof(float));
+	test_sigi_iir_add(qdata, data_l, iir_add, 0);
+	test_sigi_iir_add(qdata, data_l, iir_add_block, 1);
+	ref[0] = ref[data_l] = 0;
+	for (i=1; i<data_l; i++)
+	{
+		ref[i] = ref[i - 1] * 0.9 + data[0][i] * 0.1;
+		ref[data_l + i] = data[1][i] - 0.25;
+	}
+	ret |= test_sigi_compare("iirlp1", iir_add, TEST_SIGI_Q, ref, data_l, 1e-3);
+	ret |= test_sigi_compare("add", iir_add + data_l, TEST_SIGI_Q, ref + data_l, data_l, 1e-4);
+	if (memcmp(iir_add, iir_add_block, 2 * data_l * sizeof(int)))
+	{
+		printf("sigi: iirlp1/add block differs from per-sample\n");
+		ret = -1;
+	}
+
+	ret |= test_sigi_fir(qdata, data_l);
+
+	free(iir_add);
+	free(iir_add_block);
+	free(ref);
+	for (j=0; j<5; j++)
+		free(qdata[j]);
+	return ret;
+}
@@ -0,0 +1,152 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "sig.h"
+#include "sigf.h"
+#include "sigreg.h"
+#include "scope.h"
+
+#define TEST_REG_FLOAT		5000
+#define TEST_REG_INT		100
+
+int test_sigreg(void)
+{
+	struct signal_float *sig_f, *list[4];
+	struct signal_int *sig_i, same_name = SIGN_CST("f7", 0);
+	struct signal_float unnamed = SIG_CST(0);
+	struct sig_reg reg;
+	char name[SIG_DBG_NAME_LENGHT];
+	scope_t scope;
+	int i, ret = 0;
+
+	sig_f = calloc(TEST_REG_FLOAT, sizeof(struct signal_float));
+	sig_i = calloc(TEST_REG_INT, sizeof(struct signal_int));
+	for(i=0; i<TEST_REG_FLOAT; i++)
+	{
+		sprintf(name, "f%d", i);
+		sig_f[i].name = sig_name_intern(name);
+	}
+	for(i=0; i<TEST_REG_INT; i++)
+	{
+		sprintf(name, "i%d", i);
+		sig_i[i].name = sig_name_intern(name);
+	}
+
+	// names are interned once, and kept out of the evaluation fields
+	if((sig_name_intern("f42") != sig_f[42].name) || (sig_name_intern("f7") == same_name.name) || strcmp(sig_f[42].name, "f42"))
+	{
+		printf("sigreg: interning failed\n");
+		ret = -1;
+	}
+	if((offsetof(struct signal_float, params) + sizeof(void*) > 32) || (offsetof(struct signal_int, params) + sizeof(void*) > 32))
+	{
+		printf("sigreg: evaluation fields don't fit in 32 bytes\n");
+		ret = -1;
+	}
+
+	// the table grows several times
+	memset(&reg, 0, sizeof(reg));
+	for(i=0; i<TEST_REG_FLOAT; i++)
+		ret |= sig_reg_add_f(&reg, &sig_f[i]);
+	for(i=0; i<TEST_REG_INT; i++)
+		ret |= sig_reg_add_i(&reg, &sig_i[i]);
+	ret |= sig_reg_add_i(&reg, &same_name);						// same name, other type
+	if(ret || (reg.count != TEST_REG_FLOAT + TEST_REG_INT + 1))
+	{
+		printf("sigreg: add failed\n");
+		ret = -1;
+	}
+	if(sig_reg_add_f(&reg, &sig_f[42]) == 0)
+	{
+		printf("sigreg: duplicate added\n");
+		ret = -1;
+	}
+	if(sig_reg_add_f(&reg, &unnamed) == 0)
+	{
+		printf("sigreg: unnamed signal added\n");
+		ret = -1;
+	}
+
+	for(i=0; i<TEST_REG_FLOAT; i++)
+	{
+		sprintf(name, "f%d", i);
+		if(sig_reg_find_f(&reg, name) != &sig_f[i])
+		{
+			printf("sigreg: %s not found\n", name);
+			ret = -1;
+			break;
+		}
+	}
+	for(i=0; i<TEST_REG_INT; i++)
+	{
+		sprintf(name, "i%d", i);
+		if(sig_reg_find_i(&reg, name) != &sig_i[i])
+		{
+			printf("sigreg: %s not found\n", name);
+			ret = -1;
+			break;
+		}
+	}
+	if((sig_reg_find_i(&reg, "f7") != &same_name) || sig_reg_find_f(&reg, "i7") || sig_reg_find_f(&reg, "f5000")
+			|| sig_reg_find_f(&reg, ""))
+	{
+		printf("sigreg: wrong type or missing name found\n");
+		ret = -1;
+	}
+	sig_reg_free(&reg);
+	if(sig_reg_find_f(&reg, "f1"))
+		ret = -1;
+
+	// the list search must look at the first element
+	list[0] = &sig_f[0];
+	list[1] = &unnamed;
+	list[2] = &sig_f[1];
+	list[3] = NULL;
+	if((sig_search_list_f("f0", list) != &sig_f[0]) || (sig_search_list_f("f1", list) != &sig_f[1])
+			|| sig_search_list_f("f2", list) || (sig_search_f("f4999", sig_f, TEST_REG_FLOAT) != &sig_f[4999]))
+	{
+		printf("sigreg: search failed\n");
+		ret = -1;
+	}
+
+	// scope: no cap on the known signals, a name selects both types
+	scope_init(&scope, NULL, 0);
+	for(i=0; i<TEST_REG_FLOAT; i++)
+		ret |= scope_enlist_sig_float(&scope, &sig_f[i]);
+	for(i=0; i<TEST_REG_INT; i++)
+		ret |= scope_enlist_sig_int(&scope, &sig_i[i]);
+	ret |= scope_enlist_sig_int(&scope, &same_name);
+	scope_setup(&scope, "f4000,nope,f7,i3", 1);
+	if((scope.signals_count_float != 2) || (scope.signals_float[0] != &sig_f[4000]) || (scope.signals_float[1] != &sig_f[7])
+			|| (scope.signals_count_int != 2) || (scope.signals_int[0] != &same_name) || (scope.signals_int[1] != &sig_i[3]))
+	{
+		printf("sigreg: scope got %d float and %d int signals\n", scope.signals_count_float, scope.signals_count_int);
+		ret = -1;
+	}
+	scope_free(&scope);
+
+	free(sig_f);
+	free(sig_i);
+	return ret;
+}
@@ -0,0 +1,159 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sig.h"
+#include "sigtune.h"
+
+#define TEST_SIGTUNE_RESULTS	8
+#define TEST_SIGTUNE_RANDOM		256
+
+
+static void test_sigtune_setup(struct sig_tune *tune, float **data, int data_l, struct sig_tune_candidate *result)
+{
+	memset(tune, 0, sizeof(*tune));
+	tune->setpoint = data[0];
+	tune->ff[0] = data[2];
+	tune->ff[1] = data[3];
+	tune->ff[2] = data[4];
+	tune->length = data_l;
+	tune->plant_a = 0.2;
+	tune->plant_gain = 1.0;
+	tune->range[SIG_TUNE_P] = (struct sig_tune_range) {0.0, 2.0, 5};
+	tune->range[SIG_TUNE_I] = (struct sig_tune_range) {0.0, 0.6, 4};
+	tune->range[SIG_TUNE_D] = (struct sig_tune_range) {0.0, 0.2, 3};
+	tune->range[SIG_TUNE_MAX_OUTPUT] = (struct sig_tune_range) {5.0, 5.0, 1};
+	tune->weight[SIG_TUNE_IAE] = 1.0;
+	tune->weight[SIG_TUNE_OVERSHOOT] = 10.0;
+	tune->weight[SIG_TUNE_EFFORT] = 0.01;
+	tune->threads = 4;
+	tune->result = result;
+	tune->result_size = TEST_SIGTUNE_RESULTS;
+}
+
+
+static int test_sigtune_sorted(const struct sig_tune_candidate *result)
+{
+	int i;
+
+	for(i=1; i<TEST_SIGTUNE_RESULTS; i++)
+		if(result[i].cost < result[i-1].cost)
+			return -1;
+	return 0;
+}
+
+
+int test_sigtune(float **data, int data_l)
+{
+	struct sig_tune tune;
+	struct sig_tune_candidate result[TEST_SIGTUNE_RESULTS], result1[TEST_SIGTUNE_RESULTS], cand, best;
+	int p, i, d, ret = 0;
+
+	// grid: the best candidate is the minimum of a serial exhaustive evaluation
+	test_sigtune_setup(&tune, data, data_l, result);
+	tune.search = SIG_TUNE_GRID;
+	if(sig_tune_run(&tune) != 5 * 4 * 3)
+	{
+		printf("test_sigtune: grid candidate count\n");
+		return -1;
+	}
+	best.cost = HUGE_VAL;
+	for(d=0; d<3; d++)
+		for(i=0; i<4; i++)
+			for(p=0; p<5; p++)
+			{
+				memset(&cand, 0, sizeof(cand));
+				cand.param[SIG_TUNE_P] = 2.0 * p / 4;
+				cand.param[SIG_TUNE_I] = 0.6 * i / 3;
+				cand.param[SIG_TUNE_D] = 0.2 * d / 2;
+				cand.param[SIG_TUNE_MAX_OUTPUT] = 5.0;
+				sig_tune_eval(&tune, &cand);
+				if(cand.cost < best.cost)
+					best = cand;
+			}
+	if(test_sigtune_sorted(result) || (result[0].cost != best.cost) ||
+		memcmp(result[0].param, best.param, sizeof(best.param)) || (result[0].metric[SIG_TUNE_IAE] <= 0))
+	{
+		printf("test_sigtune: grid best %g != %g\n", result[0].cost, best.cost);
+		ret = -1;
+	}
+	if((result[0].param[SIG_TUNE_P] == 0) || (result[TEST_SIGTUNE_RESULTS-1].cost >= HUGE_VAL))
+	{
+		printf("test_sigtune: grid results\n");
+		ret = -1;
+	}
+
+	// random: the results don't depend on the number of threads
+	tune.search = SIG_TUNE_RANDOM;
+	tune.count = TEST_SIGTUNE_RANDOM;
+	tune.seed = 1234;
+	tune.range[SIG_TUNE_FF0] = (struct sig_tune_range) {-1.0, 1.0, 0};
+	tune.range[SIG_TUNE_FF1] = (struct sig_tune_range) {-1.0, 1.0, 0};
+	if(sig_tune_run(&tune) != TEST_SIGTUNE_RANDOM)
+		ret = -1;
+	tune.threads = 1;
+	tune.result = result1;
+	sig_tune_run(&tune);
+	if(test_sigtune_sorted(result) || memcmp(result, result1, sizeof(result)))
+	{
+		printf("test_sigtune: random results differ between 1 and 4 threads\n");
+		ret = -1;
+	}
+	for(i=0; i<TEST_SIGTUNE_RESULTS; i++)
+		if((result[i].param[SIG_TUNE_FF0] < -1.0) || (result[i].param[SIG_TUNE_FF0] >= 1.0) ||
+			(result[i].param[SIG_TUNE_FF2] != 0) || (result[i].param[SIG_TUNE_MAX_OUTPUT] != 5.0))
+		{
+			printf("test_sigtune: random candidate %d out of the ranges\n", i);
+			ret = -1;
+		}
+
+	// descent: never worse than the starting point, the middle of the ranges
+	tune.search = SIG_TUNE_DESCENT;
+	tune.count = 4;
+	tune.threads = 4;
+	tune.result = result;
+	tune.range[SIG_TUNE_FF0] = (struct sig_tune_range) {-1.0, 1.0, 5};
+	tune.range[SIG_TUNE_FF1] = (struct sig_tune_range) {-1.0, 1.0, 5};
+	if(sig_tune_run(&tune) != 1 + 4 * (5 + 4 + 3 + 5 + 5))
+	{
+		printf("test_sigtune: descent candidate count\n");
+		ret = -1;
+	}
+	memset(&cand, 0, sizeof(cand));
+	cand.param[SIG_TUNE_P] = 1.0;
+	cand.param[SIG_TUNE_I] = 0.3;
+	cand.param[SIG_TUNE_D] = 0.1;
+	cand.param[SIG_TUNE_MAX_OUTPUT] = 5.0;
+	sig_tune_eval(&tune, &cand);
+	if(test_sigtune_sorted(result) || (result[0].cost >= cand.cost))
+	{
+		printf("test_sigtune: descent %g, start %g\n", result[0].cost, cand.cost);
+		ret = -1;
+	}
+
+	// invalid searches
+	tune.result = NULL;
+	if(sig_tune_run(&tune) != -1)
+		ret = -1;
+	return ret;
+}
@@ -25,12 +25,29 @@
 #include "csv.h"
 #include "test_pidf.h"
 #include "test_scope.h"
+#include "test_block.h"
+#include "test_fir.h"
+#include "test_ramp.h"
+#include "test_lut.h"
+#include "test_hpp.h"
+#include "test_gen.h"
+#include "test_biquad.h"
+#include "test_graph.h"
+#include "test_exec.h"
+#include "test_multi.h"
+#include "test_sigi.h"
+#include "test_scopefile.h"
+#include "test_sigreg.h"
+#include "test_csv.h"
+#include "test_sigds.h"
+#include "test_replay.h"
+#include "test_sigtune.h"
 
 
 int main ( int argc, char *argv[])
 {
 	float *data_out, **data;
-	int data_l;
+	int data_l, ret = 0;
 	char filename[1024];
 	
 	if(argc < 2)
@@ -47,9 +64,129 @@ int main ( int argc, char *argv[])
 		return -1;
 	}
 	data_out = malloc(sizeof(float) * data_l);
+	if(test_csv())
+	{
+		printf("test_csv failed\n");
+		ret = -1;
+	}
 	test_scope(data, data_l, data_out);
+	if(test_scope_stream(data, data_l, data_out))
+	{
+		printf("test_scope_stream failed\n");
+		ret = -1;
+	}
+	if(test_scope_trigger())
+	{
+		printf("test_scope_trigger failed\n");
+		ret = -1;
+	}
+	if(test_scope_format())
+	{
+		printf("test_scope_format failed\n");
+		ret = -1;
+	}
+	if(test_scopefile(data, data_l, data_out))
+	{
+		printf("test_scopefile failed\n");
+		ret = -1;
+	}
+	if(test_sigds(data, data_l))
+	{
+		printf("test_sigds failed\n");
+		ret = -1;
+	}
+	if(test_replay(data, data_l))
+	{
+		printf("test_replay failed\n");
+		ret = -1;
+	}
+	if(test_sigtune(data, data_l))
+	{
+		printf("test_sigtune failed\n");
+		ret = -1;
+	}
+	if(test_sigreg())
+	{
+		printf("test_sigreg failed\n");
+		ret = -1;
+	}
+	if(test_block(data, data_l, data_out))
+	{
+		printf("test_block failed\n");
+		ret = -1;
+	}
+	if(test_fir())
+	{
+		printf("test_fir failed\n");
+		ret = -1;
+	}
+	if(test_fir_long())
+	{
+		printf("test_fir_long failed\n");
+		ret = -1;
+	}
+	if(test_fir_multirate())
+	{
+		printf("test_fir_multirate failed\n");
+		ret = -1;
+	}
+	if(test_ramp())
+	{
+		printf("test_ramp failed\n");
+		ret = -1;
+	}
+	if(test_lut())
+	{
+		printf("test_lut failed\n");
+		ret = -1;
+	}
+	if(test_hpp(data, data_l))
+	{
+		printf("test_hpp failed\n");
+		ret = -1;
+	}
+	if(test_gen(data, data_l))
+	{
+		printf("test_gen failed\n");
+		ret = -1;
+	}
+	if(test_biquad())
+	{
+		printf("test_biquad failed\n");
+		ret = -1;
+	}
+	if(test_graph(data, data_l, data_out))
+	{
+		printf("test_graph failed\n");
+		ret = -1;
+	}
+	if(test_graph_partial(data, data_l))
+	{
+		printf("test_graph_partial failed\n");
+		ret = -1;
+	}
+	if(test_graph_ctx(data, data_l))
+	{
+		printf("test_graph_ctx failed\n");
+		ret = -1;
+	}
+	if(test_exec(data, data_l, data_out))
+	{
+		printf("test_exec failed\n");
+		ret = -1;
+	}
+	if(test_multi(data, data_l, data_out))
+	{
+		printf("test_multi failed\n");
+		ret = -1;
+	}
+	if(test_sigi(data, data_l, data_out))
+	{
+		printf("test_sigi failed\n");
+		ret = -1;
+	}
 	csv_free(data);
 	free(data_out);
 	
-	return 0;
+	return ret;
 }
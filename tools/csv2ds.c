@@ -0,0 +1,76 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file csv2ds.c
+ * converts a CSV file (as read by csv_load()) into a dataset file
+ *
+ * usage: csv2ds.out file.csv file.ds
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csv.h"
+#include "sigds.h"
+
+int main(int argc, char *argv[])
+{
+	char *header = NULL, *name, *save;
+	const char **names;
+	float **data;
+	size_t header_l = 0;
+	int count = 0, length, ret = 0;
+	FILE *f;
+
+	if(argc != 3)
+	{
+		fprintf(stderr, "usage: %s file.csv file.ds\n", argv[0]);
+		return -1;
+	}
+
+	// the column names are the cells of the first line
+	f = fopen(argv[1], "r");
+	if((f == NULL) || (getline(&header, &header_l, f) < 0))
+	{
+		fprintf(stderr, "%s: cannot read the header\n", argv[1]);
+		return -1;
+	}
+	fclose(f);
+	if(csv_load(argv[1], &length, &data))
+		return -1;
+	while(data[count])
+		count++;
+	names = calloc(count, sizeof(char*));
+	for(name = strtok_r(header, ",;\t\r\n", &save); name && (ret < count); name = strtok_r(NULL, ",;\t\r\n", &save))
+		names[ret++] = name;
+	while(ret < count)
+		names[ret++] = "";
+
+	ret = sig_ds_write_f(argv[2], names, (const float * const*)data, count, length);
+	if(ret)
+		perror(argv[2]);
+	else
+		printf("%s: %d columns, %d values\n", argv[2], count, length);
+	free(names);
+	free(header);
+	csv_free(data);
+	return ret;
+}
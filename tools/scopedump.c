@@ -0,0 +1,102 @@
+/**
+ * sigLib, simple Signals Library
+ * 
+ * Copyright (C) 2013 Charles-Henri Mousset
+ * 
+ * This file is part of sigLib.
+ * 
+ * sigLib is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU Lesser General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * sigLib is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * 
+ * See the GNU Lesser General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with sigLib. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * Authors: Charles-Henri Mousset
+ */
+
+/** \file scopedump.c
+ * prints a scope capture file as CSV
+ *
+ * usage: scopedump.out [-h] file
+ *   -h  print the header only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scopefile.h"
+
+static const char *type_names[] = {"?", "int32", "float32", "int8", "int16", "float16", "delta16"};
+
+int main(int argc, char *argv[])
+{
+	struct scope_file file;
+	const char *ptr[2 * SCOPE_MAX_SIGNALS];
+	float *values[2 * SCOPE_MAX_SIGNALS];
+	const char *path = argv[argc - 1];
+	int header_only = (argc == 3) && (strcmp(argv[1], "-h") == 0);
+	uint32_t i, c, channels;
+
+	if((argc < 2) || (argc > 3) || ((argc == 3) && !header_only))
+	{
+		fprintf(stderr, "usage: %s [-h] file\n", argv[0]);
+		return -1;
+	}
+	if(scope_file_open(&file, path))
+	{
+		fprintf(stderr, "%s: not a capture file\n", path);
+		return -1;
+	}
+
+	if(header_only)
+	{
+		printf("samples: %u\nprediv: %u\nn_first: %llu\n", file.header->samples, file.header->prediv, (unsigned long long)file.header->n_first);
+		printf("trigger: n=%llu index=%u\n", (unsigned long long)file.header->trig_n, file.header->trig_index);
+		for(c=0; c<file.header->channels; c++)
+			printf("channel %u: %s (%s)\n", c, file.channel[c].name,
+					type_names[file.channel[c].type <= SCOPE_FILE_DELTA16 ? file.channel[c].type : 0]);
+		scope_file_close(&file);
+		return 0;
+	}
+
+	channels = min(file.header->channels, (uint32_t)(2 * SCOPE_MAX_SIGNALS));
+	printf("n");
+	for(c=0; c<channels; c++)
+	{
+		ptr[c] = scope_file_channel(&file, c);
+		values[c] = NULL;
+		printf(",%s", file.channel[c].name);
+		if(file.channel[c].type == SCOPE_FILE_INT32)
+			continue;
+		// floats and quantized channels: decode the whole channel
+		values[c] = malloc(max(1u, file.header->samples) * sizeof(float));
+		if(values[c] == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			return -1;
+		}
+		scope_file_read_f(&file, c, 0, file.header->samples, values[c]);
+	}
+	printf("\n");
+	for(i=0; i<file.header->samples; i++)
+	{
+		printf("%llu", (unsigned long long)(file.header->n_first + (uint64_t)i * file.header->prediv));
+		for(c=0; c<channels; c++)
+		{
+			if(file.channel[c].type == SCOPE_FILE_INT32)
+				printf(",%d", *(const int*)ptr[c]);
+			else
+				printf(",%g", values[c][i]);
+			ptr[c] += file.header->frame_bytes;
+		}
+		printf("\n");
+	}
+	for(c=0; c<channels; c++)
+		free(values[c]);
+	scope_file_close(&file);
+	return 0;
+}